@@ -40,6 +40,7 @@
 #include "comp_attach_pt_t.h"
 #include "interfaces/trc_tgt_mem_access_i.h"
 #include "interfaces/trc_instr_decode_i.h"
+#include "common/trc_mem_acc_span.h"
 
 /*!
  * @class OcsdCodeFollower
@@ -63,27 +64,31 @@ public:
     void setArchProfile(const ocsd_arch_profile_t profile);             //!< core profile
     void setMemSpaceAccess(const ocsd_mem_space_acc_t mem_acc_rule);    //!< memory space to use for access (filtered by S/NS, EL etc).
     void setMemSpaceCSID(const uint8_t csid);                           //!< memory spaces might be partitioned by CSID
+    void setMemAccContext(const ocsd_pe_context *p_context);            //!< PE context supplied on memory access
+    void setMemAccSpan(TrcMemAccSpan *p_span);                          //!< owning decoder memory span - used for opcode reads if set.
     void setISA(const ocsd_isa isa);    //!< set the ISA for the decode.
     void setDSBDMBasWP();   //!< DSB and DMB can be treated as WP in some archs.
 
 //********** code following API
 
     // standard WP search - for program flow trace
-    //ocsd_err_t followToAtomWP(idec_res_t &op_result, const ocsd_vaddr_t addrStart, const ocsd_atm_val A);
+    ocsd_err_t followToAtomWP(const ocsd_vaddr_t addrStart, const ocsd_atm_val A);
 
     // PTM exception code may require follow to an address
-    //ocsd_err_t followToAddress(idec_res_t &op_result, const ocsd_vaddr_t addrStart, const ocsd_atm_val A, const ocsd_vaddr_t addrMatch);
+    ocsd_err_t followToAddress(const ocsd_vaddr_t addrStart, const ocsd_atm_val A, const ocsd_vaddr_t addrMatch);
 
     // single instruction atom format such as ETMv3
     ocsd_err_t followSingleAtom(const ocsd_vaddr_t addrStart, const ocsd_atm_val A);
 
-    // follow N instructions
-    // ocsd_err_t followNInstructions(idec_res_t &op_result) // ETMv4 Q elements
+    // follow N instructions - one atom per instruction as ETMv3, stopping at the first waypoint.
+    ocsd_err_t followNInstructions(const ocsd_vaddr_t addrStart, const ocsd_pkt_atom &atoms);
 
 //*********************** results API
     const ocsd_vaddr_t getRangeSt() const;  //!< inclusive start address of decoded range (value passed in)
     const ocsd_vaddr_t getRangeEn() const;  //!< exclusive end address of decoded range (first instruction _not_ executed / potential next instruction).
     const bool hasRange() const;            //!< we have a valid range executed (may be false if nacc).
+    const uint32_t getNumInstr() const;     //!< number of instructions in the range.
+    const bool isWPFound() const;           //!< range ended on a waypoint instruction.
 
     const bool hasNextAddr() const;         //!< we have calulated the next address - otherwise this is needed from trace packets.
     const ocsd_vaddr_t getNextAddr() const; //!< next address - valid if hasNextAddr() true.
@@ -107,6 +112,8 @@ private:
     bool initFollowerState();       //!< clear all the o/p data and flags, check init valid.
 
     ocsd_err_t decodeSingleOpCode();      //!< decode single opcode address from current m_inst_info packet
+    ocsd_err_t followRange(const uint32_t maxInstr, const bool bMatchAddr, const ocsd_vaddr_t addrMatch); //!< decode from m_st_range_addr to a waypoint or limit.
+    void setNextAddr(const ocsd_atm_val A);   //!< set the next address from the last instruction and atom.
 
     ocsd_instr_info m_instr_info;
 
@@ -114,11 +121,17 @@ private:
     ocsd_vaddr_t m_en_range_addr;   //!< end of executed range - exclusive address.
     ocsd_vaddr_t m_next_addr;       //!< calcuated next address (could be eo range of branch address, not set for indirect branches)
     bool m_b_next_valid;            //!< true if next address valid, false if need address from trace packets.
+    uint32_t m_num_instr;           //!< number of instructions in executed range.
+    bool m_b_wp_found;              //!< executed range ends on a waypoint.
 
     //! memory space rule to use when accessing memory.
     ocsd_mem_space_acc_t m_mem_acc_rule;
     //! memory space csid to use when accessing memory.
     uint8_t              m_mem_space_csid;
+    //! current PE context to use when accessing memory.
+    const ocsd_pe_context *m_p_mem_acc_ctxt;
+    //! decoder memory span used for opcode reads - 0 to read direct from memory access interface.
+    TrcMemAccSpan *m_p_mem_span;
     
     ocsd_vaddr_t m_nacc_address;    //!< memory address that was inaccessible - failed read @ start, or during follow operation
     bool m_b_nacc_err;              //!< memory NACC error - required address was unavailable.
@@ -152,6 +165,16 @@ inline void  OcsdCodeFollower::setMemSpaceCSID(const uint8_t csid)
     m_mem_space_csid = csid;
 }
 
+inline void OcsdCodeFollower::setMemAccContext(const ocsd_pe_context *p_context)
+{
+    m_p_mem_acc_ctxt = p_context;
+}
+
+inline void OcsdCodeFollower::setMemAccSpan(TrcMemAccSpan *p_span)
+{
+    m_p_mem_span = p_span;
+}
+
 inline void OcsdCodeFollower::setISA(const ocsd_isa isa)
 {
     m_instr_info.isa = isa;
@@ -178,6 +201,16 @@ inline const bool OcsdCodeFollower::hasRange() const
     return m_st_range_addr < m_en_range_addr;
 }
 
+inline const uint32_t OcsdCodeFollower::getNumInstr() const
+{
+    return m_num_instr;
+}
+
+inline const bool OcsdCodeFollower::isWPFound() const
+{
+    return m_b_wp_found;
+}
+
 inline const bool OcsdCodeFollower::hasNextAddr() const
 {
     return m_b_next_valid;
@@ -0,0 +1,277 @@
+/*
+ * \file       ocsd_dcd_chunk.h
+ * \brief      OpenCSD : Parallel decode of a single trace ID stream split at sync points.
+ * 
+ * \copyright  Copyright (c) 2026, ARM Limited. All Rights Reserved.
+ */
+
+
+/* 
+ * Redistribution and use in source and binary forms, with or without modification, 
+ * are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, 
+ * this list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright notice, 
+ * this list of conditions and the following disclaimer in the documentation 
+ * and/or other materials provided with the distribution. 
+ * 
+ * 3. Neither the name of the copyright holder nor the names of its contributors 
+ * may be used to endorse or promote products derived from this software without 
+ * specific prior written permission. 
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 'AS IS' AND 
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED 
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. 
+ * IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, 
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES 
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; 
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND 
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT 
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS 
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. 
+ */ 
+
+#ifndef ARM_OCSD_DCD_CHUNK_H_INCLUDED
+#define ARM_OCSD_DCD_CHUNK_H_INCLUDED
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "opencsd/ocsd_if_types.h"
+#include "opencsd/trc_gen_elem_types.h"
+#include "interfaces/trc_data_raw_in_i.h"
+#include "interfaces/trc_gen_elem_in_i.h"
+#include "interfaces/trc_instr_decode_i.h"
+#include "interfaces/trc_tgt_mem_access_i.h"
+#include "interfaces/trc_error_log_i.h"
+#include "interfaces/trc_pkt_raw_in_i.h"
+#include "common/trc_gen_elem.h"
+#include "common/ocsd_error.h"
+#include "opencsd/etmv4/trc_pkt_elem_etmv4i.h"
+
+class IDecoderMngr;
+class TraceComponent;
+
+/** @addtogroup dcd_tree
+@{*/
+
+/* chunk size limits (bytes) - minimum trace data in a chunk before splitting at the next sync point */
+#define DCD_CHUNK_MIN_SIZE      0x400
+#define DCD_CHUNK_MAX_SIZE      0x10000000
+#define DCD_CHUNK_DEFAULT_SIZE  0x100000
+
+/* maximum decode threads for a chunked stream. 0 selects the number of hardware threads. */
+#define DCD_CHUNK_MAX_THREADS   64
+
+/* bytes from the start of the next chunk decoded after a split, to output elements still pending at the split point */
+#define DCD_CHUNK_OVERLAP       0x1000
+
+/* input block within the chunk data - replayed to the decoder with the original index */
+typedef struct _dcd_chunk_block_t {
+    ocsd_trc_index_t index;
+    uint32_t offset;
+    uint32_t size;
+} dcd_chunk_block_t;
+
+/* error logged while decoding a chunk - logged in order with the chunk elements on output */
+typedef struct _dcd_chunk_err_t {
+    size_t elem_pos;    //!< logged before this element in the chunk.
+    ocsd_hndl_err_log_t handle;
+    ocsdError error;
+} dcd_chunk_err_t;
+
+/* chunk of trace data for a single stream, and the elements decoded from it */
+typedef struct _dcd_chunk_t {
+    std::vector<uint8_t> data;
+    std::vector<dcd_chunk_block_t> blocks;
+    bool stream_start;  //!< first chunk after start or reset - keep initial not synced element.
+    bool after_reset;   //!< input reset before this chunk.
+    bool end_eot;       //!< input EOT at end of chunk - keep end of trace element.
+    bool split_start;   //!< chunk starts at a split - elements before the handover are output by the previous chunk.
+    bool split_end;     //!< chunk ends at a split - data past split_index is overlap with the next chunk.
+    ocsd_trc_index_t split_index;   //!< index of the first byte in the next chunk.
+    bool overlap_limit; //!< previous chunk decoded part of this chunk as overlap.
+    ocsd_trc_index_t overlap_end;   //!< index of the first byte not in the previous chunk overlap.
+    std::vector<ocsd_gen_elem_batch_entry_t> elems;
+    size_t out_pos;     //!< next element to output.
+    std::vector<dcd_chunk_err_t> errs;
+    size_t err_pos;     //!< next error to output.
+    ocsd_datapath_resp_t resp;
+    bool done;          //!< decode complete - protected by the chunker lock.
+} dcd_chunk_t;
+
+/* handover from the decode of one chunk to the next at a split point.
+   Found identically by the decode of both chunks from the packets after the split. */
+typedef struct _dcd_chunk_handover_t {
+    ocsd_trc_index_t split_index;   //!< handover follows the TraceInfo at or after this index.
+    bool use_limit;     //!< handover at the overlap end if not found before.
+    ocsd_trc_index_t limit;
+    bool tinfo;         //!< TraceInfo seen.
+    bool ctxt;          //!< context seen since the TraceInfo.
+    bool cid;
+    bool vmid;
+    bool found;
+    ocsd_trc_index_t index; //!< first packet decoded by the next chunk.
+} dcd_chunk_handover_t;
+
+class DecodeIDChunker;
+
+/*!
+ * @class DecodeChunkWorker
+ * @brief Decoder instance and thread decoding chunks for a DecodeIDChunker.
+ *
+ * Owns a packet processor / decoder pair created with the configuration of the 
+ * chunked decoder. Elements output while decoding a chunk are copied into the chunk.
+ * Errors are held with the chunk in the same way, so that they are logged in order 
+ * with the elements, and errors from the overlap are not logged twice. Messages are
+ * passed directly to the error logger.
+ *
+ * Monitors the packets to find the handover points at the start and end of the chunk.
+ */
+class DecodeChunkWorker : public ITrcGenElemIn, public ITraceErrorLog, public IPktRawDataMon<EtmV4ITrcPacket>
+{
+public:
+    DecodeChunkWorker();
+    virtual ~DecodeChunkWorker() {};
+
+    virtual ocsd_datapath_resp_t TraceElemIn(const ocsd_trc_index_t index_sop,
+                                             const uint8_t trc_chan_id,
+                                             const OcsdTraceElement &elem);
+
+    /* ITraceErrorLog - errors held with the chunk, other calls passed to the error logger. */
+    virtual const ocsd_hndl_err_log_t RegisterErrorSource(const std::string &component_name);
+    virtual const ocsd_err_severity_t GetErrorLogVerbosity() const;
+    virtual void LogError(const ocsd_hndl_err_log_t handle, const ocsdError *Error);
+    virtual void LogMessage(const ocsd_hndl_err_log_t handle, const ocsd_err_severity_t filter_level, const std::string &msg);
+    virtual ocsdError *GetLastError();
+    virtual ocsdError *GetLastIDError(const uint8_t chan_id);
+    virtual ocsdMsgLogger *getOutputLogger();
+    virtual void setOutputLogger(ocsdMsgLogger *pLogger);
+
+    /* IPktRawDataMon - packets seen before the decoder, to set the handover before elements for the packet. */
+    virtual void RawPacketDataMon(const ocsd_datapath_op_t op,
+                                  const ocsd_trc_index_t index_sop,
+                                  const EtmV4ITrcPacket *pkt,
+                                  const uint32_t size,
+                                  const uint8_t *p_data);
+
+private:
+    friend class DecodeIDChunker;
+
+    void initHandover(dcd_chunk_handover_t &handover, const ocsd_trc_index_t split_index);
+    void checkHandover(dcd_chunk_handover_t &handover, const ocsd_trc_index_t index_sop, const uint32_t size, const EtmV4ITrcPacket *pkt);
+    const bool keepIndex(const ocsd_trc_index_t index, const bool bNoIndex) const;
+
+    TraceComponent *m_pDecoder;
+    ITrcDataIn *m_pDataIn;      //!< packet processor input.
+    std::thread m_thread;
+    bool m_used;                //!< decoder has state from a previous chunk.
+    dcd_chunk_t *m_pChunk;      //!< chunk being decoded.
+    uint32_t m_num_elem;        //!< elements output for the current chunk.
+    ITraceErrorLog *m_pErrLog;  //!< error logger for the tree.
+    bool m_cid_en;              //!< context ID traced - required in the context before the handover.
+    bool m_vmid_en;             //!< VMID traced - required in the context before the handover.
+    dcd_chunk_handover_t m_start_handover;  //!< handover from the previous chunk.
+    dcd_chunk_handover_t m_end_handover;    //!< handover to the next chunk.
+};
+
+/*!
+ * @class DecodeIDChunker
+ * @brief Decode a single ETMv4 / ETE trace stream in parallel chunks.
+ *
+ * Attached in place of the packet processor input for the stream. Trace data is 
+ * collected into chunks, which are split at A-sync + TraceInfo sync points once 
+ * the chunk size is reached. Only TraceInfo packets with a zero speculation depth are 
+ * used, so no elements before the split remain uncommitted.
+ *
+ * Each chunk is decoded from its sync point by one of the worker decoders. Decode 
+ * continues into the start of the next chunk, as a single decoder would with the address 
+ * and context state from before the split. The decode of the next chunk takes over at the 
+ * first address packet after the split TraceInfo once the full context is known - or at the 
+ * end of the overlap if none found. Each chunk keeps only the elements on its side of the 
+ * handover. Elements are held with the chunk, then output on the calling thread in chunk 
+ * order, so the output matches a single decoder for the stream.
+ */
+class DecodeIDChunker : public ITrcDataIn
+{
+public:
+    DecodeIDChunker(const uint8_t CSID);
+    virtual ~DecodeIDChunker();
+
+    /* create worker decoders copying the protocol configuration and op flags of pDecoder. ETMv4 / ETE only. */
+    ocsd_err_t init(IDecoderMngr *pDcdMngr, TraceComponent *pDecoder, const bool bUseInstID, const uint32_t num_threads, const uint32_t chunk_size);
+
+    /* attach interfaces to the worker decoders, and set the element output. Call while idle. */
+    void setInterfaces(IInstrDecode *i_instr_decode, ITargetMemAccess *i_mem_access, ITraceErrorLog *i_err_log, ITrcGenElemIn *i_gen_elem_out);
+
+    /* set the element type output mask on the worker decoders. Call while idle. */
+    void setElemOutMask(const uint32_t elem_mask);
+
+    void waitIdle();    //!< wait for all queued chunks to decode, and output the elements.
+    void flushInput();  //!< decode and output the data held for the current chunk - on a fatal error before the chunker.
+    const ocsd_datapath_resp_t getResp() const { return m_resp; };  //!< current response from the decode
+    const uint8_t getCSID() const { return m_CSID; };
+    const uint32_t getNumThreads() const { return (uint32_t)m_workers.size(); };
+    const uint64_t getNumChunks() const { return m_num_chunks; };   //!< chunks decoded
+
+    virtual ocsd_datapath_resp_t TraceDataIn(const ocsd_datapath_op_t op,
+                                             const ocsd_trc_index_t index,
+                                             const uint32_t dataBlockSize,
+                                             const uint8_t *pDataBlock,
+                                             uint32_t *numBytesProcessed);
+
+private:
+    dcd_chunk_t *newChunk();
+    void addData(const ocsd_trc_index_t index, const uint32_t size, const uint8_t *pData);
+    bool splitChunk(const size_t split_pos);
+    void queueSplitChunk();
+    void queueChunk(dcd_chunk_t *pChunk);
+    void endChunk(const bool bEOT, const bool bReset);
+    ocsd_datapath_resp_t outputChunks(const bool bWaitAll);
+    void outputErrors(dcd_chunk_t *pChunk, const size_t elem_pos);
+    static int checkTraceInfo(const uint8_t *pData, const size_t avail);
+
+    void workerFn(DecodeChunkWorker *pWorker);
+    void decodeChunk(DecodeChunkWorker *pWorker, dcd_chunk_t *pChunk);
+    void destroyWorkers();
+
+    const uint8_t m_CSID;
+    uint32_t m_chunk_size;
+    IDecoderMngr *m_pDcdMngr;
+    ITrcGenElemIn *m_i_gen_elem_out;
+    ITraceErrorLog *m_i_err_log;
+    OcsdTraceElement m_out_elem;
+
+    /* input side - calling thread only */
+    dcd_chunk_t *m_pCurrChunk;  //!< chunk collecting input data.
+    dcd_chunk_t *m_pSplitChunk; //!< chunk before the split, waiting for overlap data from the current chunk.
+    size_t m_scan_pos;      //!< next byte to check for a sync point.
+    uint32_t m_zero_run;    //!< zero bytes before m_scan_pos.
+    size_t m_tinfo_pos;     //!< TraceInfo position after A-sync being checked, 0 if none.
+    bool m_next_start;      //!< next chunk starts the stream.
+    bool m_next_reset;      //!< next chunk follows a reset.
+    bool m_flush_all;       //!< EOT / RESET - output all chunks before continuing.
+    uint64_t m_num_chunks;
+    size_t m_max_chunks;    //!< chunks queued before input waits on the output.
+    ocsd_datapath_resp_t m_resp;
+
+    /* chunks queued for decode, and for output in order */
+    std::vector<DecodeChunkWorker *> m_workers;
+    std::deque<dcd_chunk_t *> m_decode_queue;
+    std::deque<dcd_chunk_t *> m_output_queue;
+    std::mutex m_lock;
+    std::condition_variable m_decode_cv;
+    std::condition_variable m_done_cv;
+    bool m_stop;
+};
+
+/** @}*/
+
+#endif // ARM_OCSD_DCD_CHUNK_H_INCLUDED
+
+/* End of File ocsd_dcd_chunk.h */
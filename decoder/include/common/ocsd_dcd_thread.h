@@ -0,0 +1,207 @@
+/*
+ * \file       ocsd_dcd_thread.h
+ * \brief      OpenCSD : Threaded decode of individual trace ID streams.
+ * 
+ * \copyright  Copyright (c) 2026, ARM Limited. All Rights Reserved.
+ */
+
+
+/* 
+ * Redistribution and use in source and binary forms, with or without modification, 
+ * are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, 
+ * this list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright notice, 
+ * this list of conditions and the following disclaimer in the documentation 
+ * and/or other materials provided with the distribution. 
+ * 
+ * 3. Neither the name of the copyright holder nor the names of its contributors 
+ * may be used to endorse or promote products derived from this software without 
+ * specific prior written permission. 
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 'AS IS' AND 
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED 
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. 
+ * IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, 
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES 
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; 
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND 
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT 
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS 
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. 
+ */ 
+
+#ifndef ARM_OCSD_DCD_THREAD_H_INCLUDED
+#define ARM_OCSD_DCD_THREAD_H_INCLUDED
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "opencsd/ocsd_if_types.h"
+#include "interfaces/trc_data_raw_in_i.h"
+#include "interfaces/trc_gen_elem_in_i.h"
+#include "interfaces/trc_tgt_mem_access_i.h"
+
+/** @addtogroup dcd_tree
+@{*/
+
+/* queue size limits (bytes) for each thread */
+#define DCD_THREAD_QUEUE_MIN_SIZE      0x1000
+#define DCD_THREAD_QUEUE_MAX_SIZE      0x1000000
+#define DCD_THREAD_QUEUE_DEFAULT_SIZE  0x40000
+
+/*!
+ * @class TrcSpscByteQueue
+ * @brief Lock free byte queue for a single producer and single consumer thread.
+ *
+ * Data is written and read in blocks. Blocks written by a single push() become 
+ * visible to the consumer together.
+ */
+class TrcSpscByteQueue
+{
+public:
+    TrcSpscByteQueue() : m_mask(0), m_head(0), m_tail(0) {};
+    ~TrcSpscByteQueue() {};
+
+    ocsd_err_t init(const uint32_t size);   //!< set size - power of 2 - while queue unused.
+
+    /* producer - push header and data blocks, false if insufficient space */
+    bool push(const void *p_hdr, const uint32_t hdr_len, const uint8_t *p_data, const uint32_t data_len);
+
+    /* consumer - read len bytes. false if not enough data */
+    bool pop(void *p_buffer, const uint32_t len);
+    bool empty() const { return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_relaxed); };
+
+private:
+    void copyIn(const size_t pos, const uint8_t *p_data, const uint32_t len);
+    void copyOut(const size_t pos, uint8_t *p_data, const uint32_t len) const;
+
+    std::vector<uint8_t> m_buffer;
+    size_t m_mask;
+    std::atomic<size_t> m_head;     //!< write position - updated by producer.
+    std::atomic<size_t> m_tail;     //!< read position - updated by consumer.
+};
+
+/*!
+ * @class DecodeIDThread
+ * @brief Run the decode of a single trace ID stream on a worker thread.
+ *
+ * Attached to the frame deformatter output for the ID in place of the packet processor.
+ * Data and operations are queued, to be passed to the packet processor input by the worker. 
+ * 
+ * The worker holds the decoder in a wait state until the output sink accepts more 
+ * elements, using flush operations. A fatal response from the decoder is returned on
+ * the next call from the deformatter, and further data is discarded until a reset,
+ * which returns once the worker has reset the decoder.
+ */
+class DecodeIDThread : public ITrcDataIn
+{
+public:
+    DecodeIDThread(const uint8_t CSID);
+    virtual ~DecodeIDThread();
+
+    ocsd_err_t start(ITrcDataIn *pDataIn, const uint32_t queue_size);
+    void stop();        //!< stop the worker thread - discards any queued data.
+
+    void waitIdle();    //!< wait till all queued data and operations are processed.
+    const ocsd_datapath_resp_t getResp() const { return m_resp.load(); };    //!< current response from the decode
+    const uint8_t getCSID() const { return m_CSID; };
+
+    virtual ocsd_datapath_resp_t TraceDataIn(const ocsd_datapath_op_t op,
+                                             const ocsd_trc_index_t index,
+                                             const uint32_t dataBlockSize,
+                                             const uint8_t *pDataBlock,
+                                             uint32_t *numBytesProcessed);
+
+private:
+    /* queued record header - followed by data_size bytes */
+    typedef struct _queue_rec_hdr_t {
+        ocsd_trc_index_t index;
+        uint32_t op;
+        uint32_t data_size;
+    } queue_rec_hdr_t;
+
+    static const uint32_t MAX_REC_DATA = 1024;  //!< split larger data blocks into multiple records.
+
+    bool pushRecord(const ocsd_datapath_op_t op, const ocsd_trc_index_t index, const uint8_t *p_data, const uint32_t size);
+    void wakeWorker();
+    void producerBackoff(int &spin);    //!< producer waiting on the worker - yield then sleep.
+    bool waitForData();     //!< worker waiting for data - false if stopping.
+    void threadFn();
+    void processRecord(const queue_rec_hdr_t &hdr, const uint8_t *p_data);
+
+    const uint8_t m_CSID;
+    ITrcDataIn *m_pDataIn;  //!< packet processor input.
+    TrcSpscByteQueue m_queue;
+
+    std::thread m_thread;
+    std::atomic<bool> m_stop;
+    std::atomic<bool> m_worker_sleeping;
+    std::mutex m_wake_mutex;
+    std::condition_variable m_wake_cv;
+
+    uint64_t m_recs_pushed;                 //!< records queued - producer only.
+    std::atomic<uint64_t> m_recs_done;      //!< records processed - worker.
+    std::atomic<ocsd_datapath_resp_t> m_resp;
+};
+
+/*!
+ * @class TrcMemAccLocked
+ * @brief Serialise memory access from multiple decode threads.
+ *
+ * Pointer reads are passed through - the target must only return pointers 
+ * that remain valid while the memory image is unchanged.
+ */
+class TrcMemAccLocked : public ITargetMemAccess
+{
+public:
+    TrcMemAccLocked() : m_p_mem_acc(0) {};
+    virtual ~TrcMemAccLocked() {};
+
+    void setMemAccessI(ITargetMemAccess *p_mem_acc) { m_p_mem_acc = p_mem_acc; };
+    ITargetMemAccess *getMemAccessI() const { return m_p_mem_acc; };
+
+    virtual ocsd_err_t ReadTargetMemory(const ocsd_vaddr_t address, const uint8_t cs_trace_id, const ocsd_mem_space_acc_t mem_space,
+                                        uint32_t *num_bytes, uint8_t *p_buffer);
+    virtual ocsd_err_t ReadTargetMemoryCtxt(const ocsd_vaddr_t address, const uint8_t cs_trace_id, const ocsd_mem_space_acc_t mem_space,
+                                            const ocsd_pe_context *p_context, uint32_t *num_bytes, uint8_t *p_buffer);
+    virtual ocsd_err_t ReadTargetMemoryPtr(const ocsd_vaddr_t address, const uint8_t cs_trace_id, const ocsd_mem_space_acc_t mem_space,
+                                           const ocsd_pe_context *p_context, uint32_t *num_bytes, const uint8_t **pp_data);
+    virtual void InvalidateMemAccCache(const uint8_t cs_trace_id);
+
+private:
+    ITargetMemAccess *m_p_mem_acc;
+    std::mutex m_mutex;
+};
+
+/*!
+ * @class TrcGenElemLocked
+ * @brief Serialise generic element output from multiple decode threads to a single sink.
+ */
+class TrcGenElemLocked : public ITrcGenElemIn
+{
+public:
+    TrcGenElemLocked() : m_p_gen_elem_out(0) {};
+    virtual ~TrcGenElemLocked() {};
+
+    void setGenElemOutI(ITrcGenElemIn *p_gen_elem_out) { m_p_gen_elem_out = p_gen_elem_out; };
+
+    virtual ocsd_datapath_resp_t TraceElemIn(const ocsd_trc_index_t index_sop,
+                                             const uint8_t trc_chan_id,
+                                             const OcsdTraceElement &elem);
+
+private:
+    ITrcGenElemIn *m_p_gen_elem_out;
+    std::mutex m_mutex;
+};
+
+/** @}*/
+
+#endif // ARM_OCSD_DCD_THREAD_H_INCLUDED
+
+/* End of File ocsd_dcd_thread.h */
@@ -41,6 +41,12 @@
 
 #include "opencsd.h"
 #include "ocsd_dcd_tree_elem.h"
+#include "common/trc_gen_elem_batch.h"
+#include "common/ocsd_dcd_thread.h"
+#include "common/ocsd_dcd_chunk.h"
+#include "common/trc_sync_indexer.h"
+#include "common/trc_ring_buf_in.h"
+#include "common/trc_afdo_sink.h"
 
 /** @defgroup dcd_tree OpenCSD Library : Trace Decode Tree.
     @brief Create a multi source decode tree for a single trace capture buffer.
@@ -137,6 +143,119 @@ public:
     /*! @brief Return the connected generic element interface */
     ITrcGenElemIn *getGenTraceElemOutI() const { return m_i_gen_elem_out; };
 
+    /*!
+     * @brief Set the generic element types output by the full decoders in the tree.
+     *
+     * One bit per ocsd_gen_trc_elem_t value - use OCSD_GEN_TRC_ELEM_MASK(). Decoders do not
+     * build masked out elements, or track state used only by them - e.g. with CYCLE_COUNT masked
+     * out, cycle counts are not accumulated or set on other element types. Default outputs all.
+     *
+     * Applies to existing decoders and any created later.
+     *
+     * @param elem_mask : element types to output.
+     */
+    void setGenElemOutMask(const uint32_t elem_mask);
+
+    /*! @brief Return the current element type output mask */
+    const uint32_t getGenElemOutMask() const { return m_elem_out_mask; };
+
+    /*!
+     * @brief Batched decoded trace output.
+     *
+     * Alternative to setGenTraceElemOutI(). Decoded elements are copied into batches 
+     * of up to batch_size elements, which are output at the end of each block of data 
+     * input on TraceDataIn(), when full, or when an element has extended data.
+     * 
+     * Replaces any interface set by setGenTraceElemOutI(). A 0 interface pointer 
+     * outputs any current batch, and detaches batched output.
+     *
+     * @param *i_gen_elem_batch : Pointer to the interface.
+     * @param batch_size        : number of elements in a batch (1 - 65536).
+     *
+     * @return ocsd_err_t  : Library error code or OCSD_OK if successful.
+     */
+    ocsd_err_t setGenTraceElemBatchOutI(ITrcGenElemBatchIn *i_gen_elem_batch, const uint32_t batch_size = GEN_ELEM_BATCH_DEFAULT_SIZE);
+
+    /*! @brief Return the connected batch generic element interface - 0 if not in use */
+    ITrcGenElemBatchIn *getGenTraceElemBatchOutI() const;
+
+    /*!
+     * @brief Decoded trace output for a single trace ID.
+     *
+     * Elements decoded for the ID are output on this interface rather than the one set 
+     * by setGenTraceElemOutI(). Frame formatted trees only.
+     *
+     * @param CSID              : CoreSight trace ID.
+     * @param *i_gen_trace_elem : Pointer to the interface. 0 to return to the common output.
+     *
+     * @return ocsd_err_t  : Library error code or OCSD_OK if successful.
+     */
+    ocsd_err_t setIDGenTraceElemOutI(const uint8_t CSID, ITrcGenElemIn *i_gen_trace_elem);
+
+    /*!
+     * @brief Decode each trace ID on a separate thread.
+     *
+     * Frame formatted trees only. The deformatter runs on the calling thread, and queues 
+     * the data for each trace ID to a worker thread running the packet processor and decoder 
+     * for that ID. TraceDataIn() returns once data is queued - EOT and RESET operations 
+     * return once all queued data is decoded, with the worst response from the decoders.
+     * A fatal response from a decoder is returned on the next input call after it occurs.
+     *
+     * Generic elements are output on the worker threads. Elements for a single ID remain in 
+     * order, elements for different IDs are interleaved in no fixed order. Output to the 
+     * interface set by setGenTraceElemOutI() is serialised, interfaces set by 
+     * setIDGenTraceElemOutI() are called from the thread for that ID only. A WAIT response
+     * from an output interface holds the worker, which flushes the decoder until it continues.
+     * Batched output is passed on when a batch is full, or at EOT / RESET.
+     *
+     * Memory reads from the decoders are serialised, and the memory mapper will only return 
+     * pointers into memory images held by accessors, not into the accessor cache. Changes to 
+     * memory accessors made through the decode tree wait for queued decode to complete - other 
+     * changes to the memory image must only be made after EOT or RESET.
+     * Alternate error loggers and memory access interfaces must be thread safe.
+     *
+     * The decoded instruction block cache is not used in this mode.
+     *
+     * @param enable     : true to start threaded decode, false to decode on the calling thread.
+     * @param queue_size : Size in bytes of the data queue for each ID (power of 2, 4096 - 16M).
+     *
+     * @return ocsd_err_t  : Library error code or OCSD_OK if successful.
+     */
+    ocsd_err_t setThreadedDecode(const bool enable, const uint32_t queue_size = DCD_THREAD_QUEUE_DEFAULT_SIZE);
+
+    /*! @brief true if decoding trace IDs on separate threads */
+    const bool usingThreadedDecode() const { return m_threaded_decode; };
+
+    /*!
+     * @brief Decode a single ETMv4 / ETE trace stream in parallel chunks.
+     *
+     * Trace data for the stream is split into chunks at A-sync + TraceInfo sync points, 
+     * once a chunk holds at least chunk_size bytes. Each chunk is decoded from its sync 
+     * point by one of a set of worker decoders, created with the configuration of the 
+     * decoder for the stream, each running on its own thread.
+     *
+     * Elements are output on the calling thread in trace order, matching the output of a 
+     * single decoder. Output for a chunk follows once it is decoded, and is complete when 
+     * EOT or RESET operations return. Data held for the current chunk is decoded after 
+     * any change to the tree interfaces.
+     *
+     * Memory reads are serialised as for setThreadedDecode(). Packet monitors, the sync 
+     * indexer, decode statistics and the decoded instruction block cache are not used for 
+     * the stream. Other trace IDs decode as normal, on separate threads if threaded decode 
+     * is also enabled.
+     *
+     * @param CSID        : Trace ID of the stream - ignored if the tree has no frame deformatter.
+     * @param enable      : true to start chunked decode, false to return to a single decoder.
+     * @param num_threads : Number of worker decoders (max 64), 0 for the number of hardware threads.
+     * @param chunk_size  : Minimum size of a chunk in bytes (1024 - 256M).
+     *
+     * @return ocsd_err_t  : Library error code or OCSD_OK if successful.
+     */
+    ocsd_err_t setChunkedDecode(const uint8_t CSID, const bool enable, const uint32_t num_threads = 0, const uint32_t chunk_size = DCD_CHUNK_DEFAULT_SIZE);
+
+    /*! @brief get the chunked decoder for a stream - 0 if not in use */
+    DecodeIDChunker *getIDChunker(const uint8_t CSID) const { return (CSID < 0x80) ? m_id_chunkers[usingFormatter() ? CSID : 0] : 0; };
+
 /** @}*/
 
 /** @name Decoder Management
@@ -263,11 +382,13 @@ public:
     /*!
      * This creates a memory mapper within the decode tree.
      *
-     * @param type : defaults to MEMACC_MAP_GLOBAL (only type available at present)
+     * @param type : defaults to MEMACC_MAP_GLOBAL_IDX - global space mapper with indexed accessor ranges.
+     *               MEMACC_MAP_GLOBAL selects the original linear search mapper.
+     *               MEMACC_MAP_CTXT selects accessors by the context ID / VMID of the reading decoder.
      *
      * @return ocsd_err_t  : Library error code or OCSD_OK if successful.
      */
-    ocsd_err_t createMemAccMapper(memacc_mapper_t type = MEMACC_MAP_GLOBAL);
+    ocsd_err_t createMemAccMapper(memacc_mapper_t type = MEMACC_MAP_GLOBAL_IDX);
 
     /*!
      * Get a pointer to the memory mapper. Allows a client to add memory accessors directly to the mapper.
@@ -298,6 +419,20 @@ public:
      */
     ocsd_err_t setMemAccCacheing(const bool enable, const uint16_t page_size, const int nr_pages);
 
+    /*! Decoded instruction block cacheing
+     *
+     *  PE decoders can cache the result of walking code blocks between waypoints, to avoid
+     *  re-reading and re-decoding opcodes each time the same block is traced. Off by default.
+     *
+     *  The cache is invalidated when memory accessors are added, updated or removed through the
+     *  decode tree. Clients that alter the memory image by other means - e.g. directly on the mapper
+     *  or by changing the data returned by a callback accessor - must call invalidateInstrBlockCache().
+     *
+     *  Error returned if number of entries outside limits (256 - 65536). Rounded up to power of 2.
+     */
+    ocsd_err_t setInstrBlockCacheing(const bool enable, const int nr_entries = INSTR_BLK_CACHE_DEFAULT_ENTRIES);
+    void invalidateInstrBlockCache();   //!< Drop all cached instruction blocks.
+
 /** @}*/
 
 /** @name Memory Accessors
@@ -325,10 +460,11 @@ public:
      * @param address : Start address for the memory block in the memory map. 
      * @param mem_space : Memory space
      * @param &filepath : Path to the binary data file
+     * @param use_mmap : Memory map the file and read directly from the mapping rather than using a file stream.
      *
      * @return ocsd_err_t  : Library error code or OCSD_OK if successful.
      */
-    ocsd_err_t addBinFileMemAcc(const ocsd_vaddr_t address, const ocsd_mem_space_acc_t mem_space, const std::string &filepath);
+    ocsd_err_t addBinFileMemAcc(const ocsd_vaddr_t address, const ocsd_mem_space_acc_t mem_space, const std::string &filepath, const bool use_mmap = false);
     
     /*!
      * Creates a memory accessor for a memory block supplied as a one or more memory regions in a binary file.
@@ -340,10 +476,11 @@ public:
      * @param num_regions : number of regions
      * @param mem_space : Memory space
      * @param &filepath : Path to the binary data file
+     * @param use_mmap : Memory map the file and read directly from the mapping rather than using a file stream.
      *
      * @return ocsd_err_t  : Library error code or OCSD_OK if successful.
      */
-    ocsd_err_t addBinFileRegionMemAcc(const ocsd_file_mem_region_t *region_array, const int num_regions, const ocsd_mem_space_acc_t mem_space, const std::string &filepath);
+    ocsd_err_t addBinFileRegionMemAcc(const ocsd_file_mem_region_t *region_array, const int num_regions, const ocsd_mem_space_acc_t mem_space, const std::string &filepath, const bool use_mmap = false);
     
 
     /*!
@@ -387,6 +524,16 @@ public:
      */
     ocsd_err_t removeMemAccByAddress(const ocsd_vaddr_t address, const ocsd_mem_space_acc_t mem_space);
 
+    /*!
+     * Set the memory context applied to memory accessors subsequently added by this decode tree.
+     * 
+     * Used with a MEMACC_MAP_CTXT mapper to add the memory images for individual processes or VMs, 
+     * which are then only used when the decoder context ID / VMID matches. Other mappers ignore the context.
+     *
+     * @param *p_ctxt : Context to apply to new accessors. 0 to add accessors valid in any context.
+     */
+    void setMemAccAddContext(const ocsd_mem_acc_ctxt_t *p_ctxt);
+
 /** @}*/
 
 /** @name CoreSight Trace Frame De-mux
@@ -410,9 +557,177 @@ public:
 
 /** @}*/
 
+/** @name Trace Sync Indexing
+@{*/
+
+    /*!
+     * Record the sync points for each trace ID as the trace is processed.
+     *
+     * Creates a sync indexer attached to the frame deformatter and the packet processors 
+     * in the tree, including any decoders created later. Packet processing alone is 
+     * sufficient to build the index, so a tree created with packet processors only can 
+     * scan a capture without a full decode.
+     *
+     * The indexer uses the packet monitor attach point - this replaces any packet monitor 
+     * printer. Disabling stops recording, but retains the index for access.
+     *
+     * Indexes must be exact, so indexing cannot be enabled with a deformatter collating 
+     * ID runs (OCSD_DFRMTR_ID_RUNS).
+     *
+     * @param enable : true to start recording sync points.
+     *
+     * @return ocsd_err_t  : Library error code or OCSD_OK if successful. OCSD_ERR_INVALID_PARAM_VAL if using ID runs.
+     */
+    ocsd_err_t setSyncIndexing(const bool enable);
+
+    /*! @brief Get the sync indexer - 0 if indexing has not been enabled */
+    TrcSyncIndexer *getSyncIndexer() const { return m_sync_indexer; };
+
+    /*!
+     * Load a sync index saved from an earlier pass over the capture, for use when seeking.
+     * Replaces any sync points already recorded. A file with an invalid trace ID or sync type 
+     * in any entry is rejected with OCSD_ERR_SYNC_IDX_FILE, leaving the index empty.
+     *
+     * @param &filename : Name of the index file.
+     *
+     * @return ocsd_err_t  : Library error code or OCSD_OK if successful. OCSD_ERR_INVALID_PARAM_VAL if using ID runs.
+     */
+    ocsd_err_t loadSyncIndex(const std::string &filename);
+
+/** @}*/
+
+/** @name Seek / Random Access Decode
+@{*/
+
+    /*!
+     * Prepare to decode from a target index in the capture.
+     *
+     * Resets the deformatter and decoders, and returns the index at which the caller must restart
+     * input data. Subsequent TraceDataIn() calls must supply data from that index.
+     *
+     * Using the sync index, the restart point is the latest sync point at or before the target for 
+     * the ID, or the earliest of the latest sync points for each ID if CSID is OCSD_BAD_CS_SRC_ID. 
+     * The deformatter is set to the ID of that sync point for data before the first ID in a frame.
+     *
+     * With no preceding sync point in the index, or no index, input restarts at the start of the 
+     * frame containing the target (indexes from a memory aligned capture start), or at the target, 
+     * and the decoders resync at the next sync point in the trace.
+     *
+     * Not available with a deformatter collating ID runs (OCSD_DFRMTR_ID_RUNS) - packet indexes 
+     * within a run are not exact.
+     *
+     * @param target_index   : Index to decode from.
+     * @param &restart_index : Returns the index at which to restart input.
+     * @param CSID           : Trace ID to seek for, or OCSD_BAD_CS_SRC_ID for all IDs.
+     *
+     * @return ocsd_err_t  : Library error code or OCSD_OK if successful. OCSD_ERR_INVALID_PARAM_VAL if using ID runs.
+     */
+    ocsd_err_t seekToIndex(const ocsd_trc_index_t target_index, ocsd_trc_index_t &restart_index, const uint8_t CSID = OCSD_BAD_CS_SRC_ID);
+
+    /*!
+     * Prepare to decode from a target timestamp, using the sync index.
+     *
+     * As seekToIndex() using the latest sync points with a timestamp at or before the target.
+     * Restarts at the start of the capture (index 0) if no sync point has an earlier timestamp.
+     *
+     * @param timestamp      : Timestamp to decode from.
+     * @param &restart_index : Returns the index at which to restart input.
+     * @param CSID           : Trace ID to seek for, or OCSD_BAD_CS_SRC_ID for all IDs.
+     *
+     * @return ocsd_err_t  : Library error code or OCSD_OK if successful. OCSD_ERR_NOT_INIT if no sync index,
+     *                       OCSD_ERR_INVALID_PARAM_VAL if using ID runs.
+     */
+    ocsd_err_t seekToTimestamp(const uint64_t timestamp, ocsd_trc_index_t &restart_index, const uint8_t CSID = OCSD_BAD_CS_SRC_ID);
+
+/** @}*/
+
+/** @name Ring Buffer Streaming Input
+@{*/
+
+    /*!
+     * Set a live ring buffer as the trace data input - e.g. a perf AUX area or ETR buffer.
+     *
+     * Head and tail are free running byte counts, as aux_head and aux_tail in the perf mmap page.
+     * Each call to processRingBuffer() decodes the data written since the last call, using the 
+     * count as the trace index. The tail is written as data is consumed.
+     *
+     * Where the producer overwrites data before it is decoded, input restarts at the oldest 
+     * data in the buffer, with a decode reset so that each decoder outputs an unsynced element.
+     * 
+     * A memory aligned formatted buffer must be a multiple of the 16 byte frame size.
+     *
+     * @param *p_buffer   : Start of the ring buffer.
+     * @param buffer_size : Size of the ring buffer in bytes.
+     * @param *p_head     : Producer position.
+     * @param *p_tail     : Consumer position - may be 0 if the producer does not use it.
+     *
+     * @return ocsd_err_t  : Library error code or OCSD_OK if successful.
+     */
+    ocsd_err_t setRingBufferInput(const uint8_t *p_buffer, const uint64_t buffer_size, const volatile uint64_t *p_head, volatile uint64_t *p_tail);
+
+    /*!
+     * Decode the ring buffer data up to the current head. On a WAIT response, call again 
+     * once the element output can accept more data.
+     *
+     * @return ocsd_datapath_resp_t  : Datapath response code (CONT/WAIT/FATAL)
+     */
+    ocsd_datapath_resp_t processRingBuffer();
+
+    /*! @brief Get the ring buffer input - 0 if not set. Use to mark lost data or read loss stats. */
+    TrcRingBufferIn *getRingBufferIn() const { return m_ring_buf_in; };
+
+/** @}*/
+
+/** @name AutoFDO Profile Aggregation
+@{*/
+
+    /*!
+     * Aggregate the decoded trace into AutoFDO range and branch counts.
+     *
+     * Creates a profile sink with a shard for each decoder in the tree, including any 
+     * decoders created later. Each shard replaces the generic element output for its ID, 
+     * and is updated from the decode thread for the ID when threaded decode is in use.
+     * Disabling restores the element outputs, but retains the counts for access.
+     *
+     * Only the element types in OCSD_GEN_TRC_ELEM_MASK_AFDO are used - set this as the element 
+     * output mask to avoid building others.
+     *
+     * @param enable : true to start aggregating the profile.
+     *
+     * @return ocsd_err_t  : Library error code or OCSD_OK if successful.
+     */
+    ocsd_err_t setAutoFdoProfiling(const bool enable);
+
+    /*!
+     * Count only the trace executed in a matching PE context. AutoFDO profiles are per binary, 
+     * so use where the trace covers several processes or VMs. Applies to trace decoded after
+     * the call.
+     *
+     * @param *p_filter : Context ID and / or VMID to match - 0 or neither valid to count all contexts.
+     *
+     * @return ocsd_err_t  : Library error code or OCSD_OK if successful. OCSD_ERR_NOT_INIT if profiling not enabled.
+     */
+    ocsd_err_t setAutoFdoContextFilter(const ocsd_mem_acc_ctxt_t *p_filter);
+
+    /*!
+     * Merge the profile counts and save in the AutoFDO text profile format. Waits for any 
+     * decode threads to complete the trace already input.
+     *
+     * @param &filename : Name of the profile file.
+     *
+     * @return ocsd_err_t  : Library error code or OCSD_OK if successful. OCSD_ERR_NOT_INIT if profiling not enabled.
+     */
+    ocsd_err_t saveAutoFdoProfile(const std::string &filename);
+
+    /*! @brief Get the profile sink - 0 if profiling has not been enabled. Read once decode is complete. */
+    TrcAfdoSink *getAutoFdoSink() const { return m_afdo_sink; };
+
+/** @}*/
+
 private:
     bool initialise(const ocsd_dcd_tree_src_t type, uint32_t formatterCfgFlags);
     const bool usingFormatter() const { return (bool)(m_dcd_tree_type ==  OCSD_TRC_SRC_FRAME_FORMATTED); };
+    const bool usingIDRuns() const;     //!< deformatter collating ID runs - packet indexes not exact.
     void setSingleRoot(TrcPktProcI *pComp);
     ocsd_err_t createDecodeElement(const uint8_t CSID);
     void destroyDecodeElement(const uint8_t CSID);
@@ -420,10 +735,31 @@ private:
     ocsd_err_t initCallbackMemAcc(const ocsd_vaddr_t st_address, const ocsd_vaddr_t en_address, 
         const ocsd_mem_space_acc_t mem_space, void *p_cb_func, bool IDfn, const void *p_context);
     TrcPktProcI *getPktProcI(const uint8_t CSID);
+    void attachInstrBlockCache(TraceComponent *pComponent);
+    void memImageChanged();     // memory accessors changed - clear cached decode and memory data.
+    const bool usingGenElemBatch() const { return (bool)(m_i_gen_elem_out == &m_gen_elem_batcher); };
+
+    // threaded decode - connect ID stream to the deformatter directly or through a decode thread.
+    ocsd_err_t attachIDStream(const uint8_t CSID);
+    void destroyIDThread(const uint8_t CSID);
+    void waitIDThreadsIdle(ocsd_datapath_resp_t *p_resp = 0);   // optionally combine decode responses into *p_resp
+    ITargetMemAccess *getDcdMemAccessI();                       // memory access interface for decoders.
+    ITrcGenElemIn *getIDGenElemOutI(const uint8_t CSID);        // element output interface for the ID.
+
+    // chunked decode - worker decoders for a single stream.
+    void destroyIDChunker(const uint8_t CSID);
+    void setIDChunkerInterfaces(const uint8_t CSID, IInstrDecode *i_instr_decode);  // 0 instruction decoder leaves current attached.
+    const bool decodeOnWorkers() const { return m_threaded_decode || (m_num_id_chunkers > 0); };  // shared interfaces used from worker threads.
+
+    // seek - reset the tree ready for input at the restart index.
+    ocsd_err_t seekRestart(const ocsd_trc_index_t index, const uint8_t restart_ID, ocsd_trc_index_t &restart_index);
 
     // keep internal list of memory accessors created by this object.
     void addMemAccessorToList(TrcMemAccessorBase* p_accessor);
 
+    // add accessor to the mapper with the current add context.
+    ocsd_err_t addAccessorToMapper(TrcMemAccessorBase* p_accessor);
+
     // destroy mem accessors in use by this object
     void destroyMemAccessors();
 
@@ -461,6 +797,39 @@ private:
 
     /**! List of accessors created by the decode tree */
     std::list<TrcMemAccessorBase*> m_mem_accessors;
+
+    /**! Memory context applied to accessors added by the decode tree */
+    ocsd_mem_acc_ctxt_t m_mem_acc_add_ctxt;
+
+    /**! Decoded instruction block cache shared by the PE decoders in this tree */
+    TrcInstrBlockCache m_instr_blk_cache;
+
+    /**! Element types output by the full decoders in this tree */
+    uint32_t m_elem_out_mask;
+
+    /**! Collects generic element output into batches when batched output in use */
+    TrcGenElemBatcher m_gen_elem_batcher;
+
+    /**! Threaded decode - per ID decode threads, element outputs and locked shared interfaces */
+    bool m_threaded_decode;
+    uint32_t m_thread_queue_size;
+    DecodeIDThread *m_id_threads[0x80];
+    ITrcGenElemIn *m_id_gen_elem_out[0x80];
+    TrcMemAccLocked m_mem_acc_locked;
+    TrcGenElemLocked m_gen_elem_locked;
+
+    /**! Chunked decode - parallel decoders for single streams */
+    DecodeIDChunker *m_id_chunkers[0x80];
+    int m_num_id_chunkers;
+
+    /**! Sync point indexer - created when indexing enabled */
+    TrcSyncIndexer *m_sync_indexer;
+
+    /**! Ring buffer streaming input - created when set */
+    TrcRingBufferIn *m_ring_buf_in;
+
+    /**! AutoFDO profile sink - created when profiling enabled */
+    TrcAfdoSink *m_afdo_sink;
 };
 
 /** @}*/
@@ -37,6 +37,7 @@
 
 #include <string>
 #include <vector>
+#include <mutex>
 //#include <fstream>
 
 #include "interfaces/trc_error_log_i.h"
@@ -81,6 +82,8 @@ private:
     bool m_created_output_logger;      // true if this class created it's own logger;
 
     std::vector<std::string> m_error_sources;
+
+    std::mutex m_log_mutex;     // serialise errors logged from threaded decode.
 };
 
 
@@ -59,7 +59,7 @@ public:
     OcsdGenElemList();
     ~OcsdGenElemList();
 
-    void initSendIf(componentAttachPt<ITrcGenElemIn> *pGenElemIf);
+    void initSendIf(componentAttachPt<ITrcGenElemIn> *pGenElemIf, const uint32_t *pElemOutMask = 0);  //!< optional element type output mask - masked types not sent.
     void initCSID(const uint8_t CSID) { m_CSID = CSID; };
 
     void reset();   //!< reset the element list.
@@ -68,6 +68,7 @@ public:
     const int getNumElem() const;                                      //!< return the total number of elements on the stack (inlcuding any pended ones).
     
     const ocsd_gen_trc_elem_t getElemType(const int entryN) const;    //!< get the type for the nth element in the stack (0 indexed)
+    OcsdTraceElement *getElem(const int entryN) const;                 //!< get the nth element in the stack (0 indexed), 0 if none.
 
     void pendLastNElem(int numPend);    //!< Last element to be pended prior to cancel/commit decision.
     void commitAllPendElem();           //!< commit all pended elements.
@@ -102,6 +103,7 @@ private:
     uint8_t m_CSID;
 
     componentAttachPt<ITrcGenElemIn> *m_sendIf; //!< element send interface.
+    const uint32_t *m_pElemOutMask;             //!< element type output mask - 0 to send all.
 };
 
 inline const int OcsdGenElemList::getAdjustedIdx(int idxIn) const
@@ -145,9 +147,10 @@ inline const bool OcsdGenElemList::elemToSend() const
     return ((getNumElem() - m_numPend) > 0);
 }
 
-inline void OcsdGenElemList::initSendIf(componentAttachPt<ITrcGenElemIn> *pGenElemIf)
+inline void OcsdGenElemList::initSendIf(componentAttachPt<ITrcGenElemIn> *pGenElemIf, const uint32_t *pElemOutMask /* = 0 */)
 {
     m_sendIf = pGenElemIf;
+    m_pElemOutMask = pElemOutMask;
 }
 
 /* End of File ocsd_gen_elem_list.h */
@@ -47,7 +47,7 @@ public:
     OcsdGenElemStack();
     ~OcsdGenElemStack();
 
-    void initSendIf(componentAttachPt<ITrcGenElemIn> *pGenElemIf);
+    void initSendIf(componentAttachPt<ITrcGenElemIn> *pGenElemIf, const uint32_t *pElemOutMask = 0);  //!< optional element type output mask - masked types not sent.
     void initCSID(const uint8_t CSID) { m_CSID = CSID; };
 
     OcsdTraceElement &getCurrElem();    //!< get the current element. 
@@ -81,6 +81,7 @@ private:
     //!< send packet info
     uint8_t m_CSID;
     componentAttachPt<ITrcGenElemIn> *m_sendIf; //!< element send interface.
+    const uint32_t *m_pElemOutMask;             //!< element type output mask - 0 to send all.
 
     bool m_is_init;
 };
@@ -90,9 +91,10 @@ inline const int OcsdGenElemStack::numElemToSend() const
     return m_elem_to_send;
 }
 
-inline void OcsdGenElemStack::initSendIf(componentAttachPt<ITrcGenElemIn> *pGenElemIf)
+inline void OcsdGenElemStack::initSendIf(componentAttachPt<ITrcGenElemIn> *pGenElemIf, const uint32_t *pElemOutMask /* = 0 */)
 {
     m_sendIf = pGenElemIf;
+    m_pElemOutMask = pElemOutMask;
 }
 
 inline void OcsdGenElemStack::setCurrElemIdx(const ocsd_trc_index_t trc_pkt_idx)
@@ -37,6 +37,7 @@
 
 #include <string>
 #include <fstream>
+#include <mutex>
 
 class ocsdMsgLogStrOutI
 {
@@ -70,7 +71,7 @@ public:
 	void setLogFileName(const char *fileName);  //!< Set the output log filename, and enable logging to file.
 	void setStrOutFn(ocsdMsgLogStrOutI *p_IstrOut); //!< Set the output log string callback and enable logging to callback.
 
-    void LogMsg(const std::string &msg); //!< Log a message to the current set output channels.
+    void LogMsg(const std::string &msg); //!< Log a message to the current set output channels. Safe to call from multiple threads.
 
     const bool isLogging() const; //!< true if logging active
 
@@ -80,6 +81,7 @@ private:
     std::string m_logFileName;
     std::fstream m_out_file;
 	ocsdMsgLogStrOutI *m_pOutStrI;
+    std::mutex m_log_mutex;     // serialise output from threaded decode.
 };
 
 #endif // ARM_OCSD_MSG_LOGGER_H_INCLUDED
@@ -0,0 +1,238 @@
+/*
+ * \file       trc_afdo_sink.h
+ * \brief      OpenCSD : Aggregate instruction ranges and branches into AutoFDO profile counts.
+ *
+ * \copyright  Copyright (c) 2026, ARM Limited. All Rights Reserved.
+ */
+
+
+/*
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 'AS IS' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef ARM_TRC_AFDO_SINK_H_INCLUDED
+#define ARM_TRC_AFDO_SINK_H_INCLUDED
+
+#include <vector>
+#include <string>
+
+#include "opencsd/ocsd_if_types.h"
+#include "opencsd/trc_gen_elem_types.h"
+#include "interfaces/trc_gen_elem_in_i.h"
+#include "common/trc_gen_elem.h"
+
+/** @addtogroup dcd_tree
+@{*/
+
+/* initial and maximum entries in a count table - power of 2 */
+#define AFDO_COUNT_TABLE_INIT_SIZE  0x1000
+#define AFDO_COUNT_TABLE_MAX_SIZE   0x10000000
+
+/* count for an address pair - range start and last instruction, or branch source and target */
+typedef struct _afdo_count {
+    ocsd_vaddr_t from;
+    ocsd_vaddr_t to;
+    uint64_t count;     // 0 for an unused table entry
+} afdo_count_t;
+
+/*!
+ * @class TrcAfdoCountTable
+ * @brief Open addressed hash table of counts for address pairs.
+ *
+ * Linear probing in a power of 2 sized table, doubled in size when 3/4 full.
+ */
+class TrcAfdoCountTable
+{
+public:
+    TrcAfdoCountTable();
+    ~TrcAfdoCountTable();
+
+    /* add to the count for a pair - OCSD_ERR_MEM if the table cannot grow */
+    ocsd_err_t add(const ocsd_vaddr_t from, const ocsd_vaddr_t to, const uint64_t count = 1);
+    ocsd_err_t merge(const TrcAfdoCountTable &table);
+    void clear();
+
+    const uint32_t numEntries() const { return m_used; };
+    const uint64_t totalCount() const;
+    void getEntries(std::vector<afdo_count_t> &entries) const;  //!< used entries sorted by address pair
+
+private:
+    const uint32_t hashIdx(const ocsd_vaddr_t from, const ocsd_vaddr_t to) const;
+    ocsd_err_t resize(const uint32_t size);
+
+    afdo_count_t *m_entries;
+    uint32_t m_size;        // number of entries - power of 2
+    uint32_t m_used;
+};
+
+/*!
+ * @class TrcAfdoIDShard
+ * @brief Profile counts for the elements from a single trace ID.
+ *
+ * Contiguous instruction ranges are joined until a taken branch, giving ranges that run
+ * from a branch target to the next taken branch, as sampled from a branch record. The
+ * taken branch is counted when the next range gives the target. Trace discontinuities,
+ * exceptions and context changes end a range without a branch.
+ *
+ * If a context filter is set, only ranges executed in a matching PE context are counted.
+ */
+class TrcAfdoIDShard : public ITrcGenElemIn
+{
+public:
+    TrcAfdoIDShard();
+    virtual ~TrcAfdoIDShard() {};
+
+    virtual ocsd_datapath_resp_t TraceElemIn(const ocsd_trc_index_t index_sop,
+                                             const uint8_t trc_chan_id,
+                                             const OcsdTraceElement &el);
+
+    /* close any open range and move the counts into the merged tables */
+    ocsd_err_t mergeInto(TrcAfdoCountTable &ranges, TrcAfdoCountTable &branches);
+    void clear();
+
+    /* count only in a matching context - neither value valid to count in all contexts */
+    ocsd_err_t setContextFilter(const ocsd_mem_acc_ctxt_t &filter);
+
+private:
+    ocsd_err_t addRange(const OcsdTraceElement &el);
+    ocsd_err_t endRange(const bool bBranchValid, const ocsd_vaddr_t br_target);
+    const bool contextChanged(const ocsd_pe_context &context);
+    const bool contextMatch() const;
+
+    TrcAfdoCountTable m_ranges;
+    TrcAfdoCountTable m_branches;
+
+    bool m_range_open;
+    ocsd_vaddr_t m_range_st;        // first instruction in the open range
+    ocsd_vaddr_t m_range_en;        // address following the open range
+    ocsd_vaddr_t m_last_instr;      // last instruction in the open range
+    bool m_br_taken;                // last instruction was a taken branch
+
+    bool m_ctxt_valid;
+    ocsd_pe_context m_context;
+
+    ocsd_mem_acc_ctxt_t m_ctxt_filter;
+    bool m_ctxt_match;              // current context passes the filter
+};
+
+/*!
+ * @class TrcAfdoSink
+ * @brief Aggregate decoded trace into the range and branch counts used for AutoFDO profiles.
+ *
+ * Each trace ID is counted in its own shard. When used by a decode tree, the shard is the
+ * element output for the ID, so is updated from the decode thread for that ID without locking
+ * when threaded decode is in use. The sink can also be attached as a generic element output,
+ * when the shard is selected by the element trace ID.
+ *
+ * Shards are merged when the profile is read, once decode is complete - after EOT.
+ * The text profile is the raw profile format read by the AutoFDO tools (create_llvm_prof /
+ * create_gcov --profiler=text): range counts, address counts (none) and branch counts,
+ * with addresses as seen in the trace.
+ *
+ * AutoFDO profiles are per binary. Where the trace covers several processes or VMs, set a
+ * context filter on the context ID and / or VMID to profile a single one.
+ */
+class TrcAfdoSink : public ITrcGenElemIn
+{
+public:
+    TrcAfdoSink();
+    virtual ~TrcAfdoSink();
+
+    /* shards for each ID - getShard returns 0 if not created */
+    ocsd_err_t addShard(const uint8_t ID);
+    TrcAfdoIDShard *getShard(const uint8_t ID) const { return (ID < 0x80) ? m_shards[ID] : 0; };
+
+    void setActive(const bool bActive) { m_active = bActive; };
+    const bool isActive() const { return m_active; };
+
+    /* count only in a matching context, for this and later shards - 0 to count in all contexts */
+    ocsd_err_t setContextFilter(const ocsd_mem_acc_ctxt_t *p_filter);
+    const ocsd_mem_acc_ctxt_t &getContextFilter() const { return m_ctxt_filter; };
+
+    /* ITrcGenElemIn - counts into the shard for the element trace ID */
+    virtual ocsd_datapath_resp_t TraceElemIn(const ocsd_trc_index_t index_sop,
+                                             const uint8_t trc_chan_id,
+                                             const OcsdTraceElement &el);
+
+    /* merge shard counts into the profile. Call once decode is complete. */
+    ocsd_err_t mergeShards();
+    const TrcAfdoCountTable &getRangeCounts() const { return m_ranges; };
+    const TrcAfdoCountTable &getBranchCounts() const { return m_branches; };
+
+    /* merge and write the text profile */
+    ocsd_err_t saveTextProfile(const std::string &filename);
+
+    /* discard all counts */
+    void clear();
+
+private:
+    TrcAfdoIDShard *m_shards[0x80];
+    TrcAfdoCountTable m_ranges;
+    TrcAfdoCountTable m_branches;
+    bool m_active;
+    ocsd_mem_acc_ctxt_t m_ctxt_filter;
+};
+
+inline const uint32_t TrcAfdoCountTable::hashIdx(const ocsd_vaddr_t from, const ocsd_vaddr_t to) const
+{
+    // multiplicative hash of both addresses - upper bits best mixed.
+    uint64_t hash = (from * 0x9E3779B97F4A7C15ULL) ^ (to * 0xC2B2AE3D27D4EB4FULL);
+    return (uint32_t)(hash >> 32) & (m_size - 1);
+}
+
+inline ocsd_err_t TrcAfdoCountTable::add(const ocsd_vaddr_t from, const ocsd_vaddr_t to, const uint64_t count /* = 1 */)
+{
+    ocsd_err_t err;
+
+    // grow before insert keeps at least 1/4 of the entries free.
+    if (((uint64_t)m_used + 1) * 4 > (uint64_t)m_size * 3)
+    {
+        if ((err = resize(m_size ? m_size * 2 : AFDO_COUNT_TABLE_INIT_SIZE)) != OCSD_OK)
+            return err;
+    }
+
+    uint32_t idx = hashIdx(from, to);
+    while (m_entries[idx].count)
+    {
+        if ((m_entries[idx].from == from) && (m_entries[idx].to == to))
+        {
+            m_entries[idx].count += count;
+            return OCSD_OK;
+        }
+        idx = (idx + 1) & (m_size - 1);
+    }
+    m_entries[idx].from = from;
+    m_entries[idx].to = to;
+    m_entries[idx].count = count;
+    m_used++;
+    return OCSD_OK;
+}
+
+/** @}*/
+
+#endif // ARM_TRC_AFDO_SINK_H_INCLUDED
+
+/* End of File trc_afdo_sink.h */
@@ -87,6 +87,7 @@ public:
     /* decode control */
     ocsd_datapath_resp_t Reset();    /* reset the decode to the start state, drop partial data - propogate to attached components */
     ocsd_datapath_resp_t Flush();    /* flush existing data if possible, retain state - propogate to attached components */
+    ocsd_err_t SetRestartID(const uint8_t ID);  /* after reset - ID for data before the first ID in the first frame (seek to a sync point) */
 
     /* demux stats */
     void SetDemuxStatsBlock(ocsd_demux_stats_t *pStatsBlock);
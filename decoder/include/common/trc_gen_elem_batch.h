@@ -0,0 +1,97 @@
+/*
+ * \file       trc_gen_elem_batch.h
+ * \brief      OpenCSD : Collect generic trace elements into batches for output.
+ * 
+ * \copyright  Copyright (c) 2026, ARM Limited. All Rights Reserved.
+ */
+
+
+/* 
+ * Redistribution and use in source and binary forms, with or without modification, 
+ * are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, 
+ * this list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright notice, 
+ * this list of conditions and the following disclaimer in the documentation 
+ * and/or other materials provided with the distribution. 
+ * 
+ * 3. Neither the name of the copyright holder nor the names of its contributors 
+ * may be used to endorse or promote products derived from this software without 
+ * specific prior written permission. 
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 'AS IS' AND 
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED 
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. 
+ * IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, 
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES 
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; 
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND 
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT 
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS 
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. 
+ */ 
+
+#ifndef ARM_TRC_GEN_ELEM_BATCH_H_INCLUDED
+#define ARM_TRC_GEN_ELEM_BATCH_H_INCLUDED
+
+#include <vector>
+
+#include "opencsd/ocsd_if_types.h"
+#include "interfaces/trc_gen_elem_in_i.h"
+#include "interfaces/trc_gen_elem_batch_in_i.h"
+
+/* batch size limits - number of elements */
+#define GEN_ELEM_BATCH_MIN_SIZE 1
+#define GEN_ELEM_BATCH_MAX_SIZE 65536
+#define GEN_ELEM_BATCH_DEFAULT_SIZE 256
+
+/*!
+ * @class TrcGenElemBatcher
+ * @brief Adapt single generic element output to a batch output interface.
+ * 
+ * Attached as the generic element output for the decoders in a decode tree. 
+ * Copies each element into the current batch, passing the batch to the 
+ * ITrcGenElemBatchIn interface when full, or when flush() is called.
+ *
+ * Elements with extended data are flushed immediately as the data pointer 
+ * is only valid during the output call.
+ */
+class TrcGenElemBatcher : public ITrcGenElemIn
+{
+public:
+    TrcGenElemBatcher();
+    virtual ~TrcGenElemBatcher() {};
+
+    /* set the output interface and batch size. 0 output interface to clear batching */
+    ocsd_err_t init(ITrcGenElemBatchIn *i_batch_out, const uint32_t batch_size);
+    ITrcGenElemBatchIn *getBatchOutI() const { return m_i_batch_out; };
+
+    virtual ocsd_datapath_resp_t TraceElemIn(const ocsd_trc_index_t index_sop,
+                                              const uint8_t trc_chan_id,
+                                              const OcsdTraceElement &elem);
+
+    ocsd_datapath_resp_t flush();   //!< output any elements in the current batch.
+
+private:
+    ITrcGenElemBatchIn *m_i_batch_out;
+    std::vector<ocsd_gen_elem_batch_entry_t> m_batch;
+    uint32_t m_num_elem;    //!< number of elements in current batch.
+};
+
+inline ocsd_datapath_resp_t TrcGenElemBatcher::flush()
+{
+    ocsd_datapath_resp_t resp = OCSD_RESP_CONT;
+
+    if (m_num_elem && m_i_batch_out)
+    {
+        resp = m_i_batch_out->TraceElemBatchIn(&m_batch[0], m_num_elem);
+        m_num_elem = 0;
+    }
+    return resp;
+}
+
+#endif // ARM_TRC_GEN_ELEM_BATCH_H_INCLUDED
+
+/* End of File trc_gen_elem_batch.h */
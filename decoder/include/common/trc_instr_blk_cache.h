@@ -0,0 +1,177 @@
+/*!
+* \file       trc_instr_blk_cache.h
+* \brief      OpenCSD : Decoded instruction block cache.
+*
+* \copyright  Copyright (c) 2026, ARM Limited. All Rights Reserved.
+*/
+
+/*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright notice,
+* this list of conditions and the following disclaimer in the documentation
+* and/or other materials provided with the distribution.
+*
+* 3. Neither the name of the copyright holder nor the names of its contributors
+* may be used to endorse or promote products derived from this software without
+* specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 'AS IS' AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+* IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef ARM_TRC_INSTR_BLK_CACHE_H_INCLUDED
+#define ARM_TRC_INSTR_BLK_CACHE_H_INCLUDED
+
+#include "opencsd/ocsd_if_types.h"
+
+#define INSTR_BLK_CACHE_DEFAULT_ENTRIES 4096
+#define INSTR_BLK_CACHE_ENTRIES_MAX 65536
+#define INSTR_BLK_CACHE_ENTRIES_MIN 256
+
+/* single cached block - start address and context as key, waypoint decode as value */
+typedef struct instr_blk_entry {
+    ocsd_vaddr_t st_addr;           // address of first instruction in block
+    uint32_t ctxt_id;               // context ID in use when block was walked
+    uint32_t vmid;                  // VMID in use when block was walked
+    ocsd_mem_space_acc_t mem_space; // memory space the opcodes were read from
+    uint32_t num_instr;             // number of instructions in block, including the waypoint
+    uint8_t trcID;                  // trace ID of the decoder that walked the block
+    uint8_t valid;                  // entry in use
+    ocsd_instr_info wp_info;        // instruction info after decode of the waypoint instruction
+} instr_blk_entry_t;
+
+/** class TrcInstrBlockCache - cache the results of walking memory images between waypoints.
+ *
+ *  The PE decoders will repeatedly walk the same code blocks from a start address to the next
+ *  waypoint instruction - reading and decoding each opcode in turn. This cache saves the result
+ *  of the walk - the number of instructions and the decoded waypoint - so that a subsequent walk
+ *  from the same address, in the same context and memory space, can skip the read / decode loop.
+ *
+ *  Direct mapped, indexed by start address. Blocks are keyed on start address, ISA, memory space,
+ *  context ID, VMID, trace ID and the instruction decode config. Any change to the memory image
+ *  must invalidate the cache - the decode tree does this when accessors are added, updated or removed.
+ *
+ *  Off by default - clients that return different memory contents from callbacks for the same
+ *  address and context must not enable this cache.
+ */
+class TrcInstrBlockCache
+{
+public:
+    TrcInstrBlockCache();
+    ~TrcInstrBlockCache();
+
+    /* cache enabling and sizing */
+    ocsd_err_t enableCaching(bool bEnable);
+    // optionally error if outside limits - otherwise set to max / min automatically. Rounded up to power of 2.
+    ocsd_err_t setNumEntries(const int nr_entries, const bool err_on_limit = false);
+
+    const bool enabled() const { return m_bCacheEnabled; };
+    const int numEntries() const { return m_num_entries; };
+
+    /* cache invalidation */
+    void invalidateAll();
+
+    /*!
+     * Look for a block starting at instr_info->instr_addr, in the current ISA and decode config.
+     * On hit instr_info is updated to the state after the waypoint instruction decode - so that
+     * instr_addr is the address following the waypoint - and num_instr set to the instructions in the block.
+     *
+     * @return bool : true if block found.
+     */
+    bool findBlock(const uint8_t trcID, const ocsd_mem_space_acc_t mem_space, const uint32_t ctxt_id, const uint32_t vmid, ocsd_instr_info *instr_info, uint32_t *num_instr);
+
+    /*!
+     * Save a block walked from st_addr, where wp_info is the instruction info after the waypoint was decoded.
+     * Replaces any existing block at the same index.
+     */
+    void addBlock(const uint8_t trcID, const ocsd_mem_space_acc_t mem_space, const uint32_t ctxt_id, const uint32_t vmid, const ocsd_vaddr_t st_addr, const ocsd_instr_info *wp_info, const uint32_t num_instr);
+
+private:
+    const uint32_t blockIdx(const ocsd_vaddr_t st_addr, const uint8_t trcID) const;
+
+    ocsd_err_t createCache();
+    void destroyCache();
+
+    instr_blk_entry_t *m_entries;
+    int m_num_entries;          // number of entries - power of 2
+    uint32_t m_idx_mask;        // mask for entry index
+
+    bool m_bCacheEnabled;
+};
+
+inline TrcInstrBlockCache::TrcInstrBlockCache() :
+    m_entries(0),
+    m_num_entries(INSTR_BLK_CACHE_DEFAULT_ENTRIES),
+    m_idx_mask(INSTR_BLK_CACHE_DEFAULT_ENTRIES - 1),
+    m_bCacheEnabled(false)
+{
+}
+
+inline TrcInstrBlockCache::~TrcInstrBlockCache()
+{
+    destroyCache();
+}
+
+inline const uint32_t TrcInstrBlockCache::blockIdx(const ocsd_vaddr_t st_addr, const uint8_t trcID) const
+{
+    // instructions at least halfword aligned - fold in upper bits and ID to spread blocks.
+    return (uint32_t)((st_addr >> 1) ^ (st_addr >> 17) ^ ((ocsd_vaddr_t)trcID << 7)) & m_idx_mask;
+}
+
+inline bool TrcInstrBlockCache::findBlock(const uint8_t trcID, const ocsd_mem_space_acc_t mem_space, const uint32_t ctxt_id, const uint32_t vmid, ocsd_instr_info *instr_info, uint32_t *num_instr)
+{
+    if (!m_bCacheEnabled)
+        return false;
+
+    const instr_blk_entry_t *entry = &m_entries[blockIdx(instr_info->instr_addr, trcID)];
+    if (!entry->valid ||
+        (entry->st_addr != instr_info->instr_addr) ||
+        (entry->trcID != trcID) ||
+        (entry->mem_space != mem_space) ||
+        (entry->ctxt_id != ctxt_id) ||
+        (entry->vmid != vmid) ||
+        (entry->wp_info.isa != instr_info->isa) ||
+        (entry->wp_info.pe_type.arch != instr_info->pe_type.arch) ||
+        (entry->wp_info.pe_type.profile != instr_info->pe_type.profile) ||
+        (entry->wp_info.dsb_dmb_waypoints != instr_info->dsb_dmb_waypoints) ||
+        (entry->wp_info.wfi_wfe_branch != instr_info->wfi_wfe_branch) ||
+        (entry->wp_info.track_it_block != instr_info->track_it_block))
+        return false;
+
+    *instr_info = entry->wp_info;
+    *num_instr = entry->num_instr;
+    return true;
+}
+
+inline void TrcInstrBlockCache::addBlock(const uint8_t trcID, const ocsd_mem_space_acc_t mem_space, const uint32_t ctxt_id, const uint32_t vmid, const ocsd_vaddr_t st_addr, const ocsd_instr_info *wp_info, const uint32_t num_instr)
+{
+    if (!m_bCacheEnabled)
+        return;
+
+    instr_blk_entry_t *entry = &m_entries[blockIdx(st_addr, trcID)];
+    entry->st_addr = st_addr;
+    entry->ctxt_id = ctxt_id;
+    entry->vmid = vmid;
+    entry->mem_space = mem_space;
+    entry->num_instr = num_instr;
+    entry->trcID = trcID;
+    entry->wp_info = *wp_info;
+    entry->valid = 1;
+}
+
+#endif // ARM_TRC_INSTR_BLK_CACHE_H_INCLUDED
+
+/* End of File trc_instr_blk_cache.h */
@@ -0,0 +1,160 @@
+/*!
+* \file       trc_mem_acc_span.h
+* \brief      OpenCSD : Decoder memory span - zero copy reads of target memory.
+*
+* \copyright  Copyright (c) 2026, ARM Limited. All Rights Reserved.
+*/
+
+/*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright notice,
+* this list of conditions and the following disclaimer in the documentation
+* and/or other materials provided with the distribution.
+*
+* 3. Neither the name of the copyright holder nor the names of its contributors
+* may be used to endorse or promote products derived from this software without
+* specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 'AS IS' AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+* IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef ARM_TRC_MEM_ACC_SPAN_H_INCLUDED
+#define ARM_TRC_MEM_ACC_SPAN_H_INCLUDED
+
+#include <cstring>
+#include "opencsd/ocsd_if_types.h"
+#include "interfaces/trc_tgt_mem_access_i.h"
+
+/*!
+ * @class TrcMemAccSpan
+ * @brief Span of target memory held by a decoder for sequential opcode reads.
+ *
+ * Obtains a pointer and contiguous length from ITargetMemAccess::ReadTargetMemoryPtr(). 
+ * Subsequent reads within the span, in the same memory space and PE context, are satisfied 
+ * from the span without further calls through the memory access interface. 
+ * 
+ * Falls back to ITargetMemAccess::ReadTargetMemoryCtxt() if no pointer is available.
+ *
+ * The span must be cleared whenever the memory image may change - the owning decoder clears 
+ * it on each new packet, on memory cache invalidation, and the decode tree clears it when 
+ * memory accessors are changed.
+ */
+class TrcMemAccSpan
+{
+public:
+    TrcMemAccSpan() { clear(); };
+    ~TrcMemAccSpan() {};
+
+    void clear() { m_p_data = 0; m_len = 0; };
+
+    ocsd_err_t readBytes(ITargetMemAccess *p_mem_acc, const ocsd_vaddr_t address, const uint8_t cs_trace_id, 
+                         const ocsd_mem_space_acc_t mem_space, const ocsd_pe_context *p_context,
+                         uint32_t *num_bytes, uint8_t *p_buffer);
+
+    /** pointer to bytes at address, num_bytes [in] minimum required, [out] available. 0 if no pointer available. */
+    const uint8_t *getBytesPtr(ITargetMemAccess *p_mem_acc, const ocsd_vaddr_t address, const uint8_t cs_trace_id, 
+                               const ocsd_mem_space_acc_t mem_space, const ocsd_pe_context *p_context,
+                               uint32_t *num_bytes);
+
+private:
+    bool inSpan(const ocsd_vaddr_t address, const uint32_t num_bytes, const ocsd_mem_space_acc_t mem_space, const ocsd_pe_context *p_context) const;
+    void setContext(const ocsd_pe_context *p_context);
+
+    const uint8_t *m_p_data;        //!< data at m_st_addr - null if no span
+    ocsd_vaddr_t m_st_addr;         //!< address of the start of the span
+    uint32_t m_len;                 //!< contiguous bytes available
+    ocsd_mem_space_acc_t m_mem_space;
+    
+    /* PE context values used for the read - context aware memory accessors may select on these */
+    bool m_has_ctxt;
+    uint32_t m_context_id;
+    uint32_t m_vmid;
+    uint8_t m_ctxt_valid;           //!< bit 0 : context ID valid, bit 1 : VMID valid
+};
+
+inline bool TrcMemAccSpan::inSpan(const ocsd_vaddr_t address, const uint32_t num_bytes, const ocsd_mem_space_acc_t mem_space, const ocsd_pe_context *p_context) const
+{
+    if (!m_p_data || (mem_space != m_mem_space) || (address < m_st_addr) || 
+        ((address - m_st_addr + num_bytes) > m_len))
+        return false;
+
+    if (!p_context)
+        return !m_has_ctxt;
+
+    return m_has_ctxt &&
+           (m_ctxt_valid == ((p_context->ctxt_id_valid ? 0x1 : 0) | (p_context->vmid_valid ? 0x2 : 0))) &&
+           (!p_context->ctxt_id_valid || (p_context->context_id == m_context_id)) &&
+           (!p_context->vmid_valid || (p_context->vmid == m_vmid));
+}
+
+inline void TrcMemAccSpan::setContext(const ocsd_pe_context *p_context)
+{
+    m_has_ctxt = (p_context != 0);
+    if (m_has_ctxt)
+    {
+        m_context_id = p_context->context_id;
+        m_vmid = p_context->vmid;
+        m_ctxt_valid = (p_context->ctxt_id_valid ? 0x1 : 0) | (p_context->vmid_valid ? 0x2 : 0);
+    }
+}
+
+inline const uint8_t *TrcMemAccSpan::getBytesPtr(ITargetMemAccess *p_mem_acc, const ocsd_vaddr_t address, const uint8_t cs_trace_id, 
+                                                  const ocsd_mem_space_acc_t mem_space, const ocsd_pe_context *p_context,
+                                                  uint32_t *num_bytes)
+{
+    uint32_t avail;
+    const uint8_t *p_data;
+    ocsd_err_t err;
+
+    if (!inSpan(address, *num_bytes, mem_space, p_context))
+    {
+        // a new span - any pointer held is invalid after the next interface call.
+        m_p_data = 0;
+        avail = *num_bytes;
+        err = p_mem_acc->ReadTargetMemoryPtr(address, cs_trace_id, mem_space, p_context, &avail, &p_data);
+        if ((err != OCSD_OK) || !p_data)
+        {
+            *num_bytes = 0;
+            return 0;
+        }
+
+        m_p_data = p_data;
+        m_st_addr = address;
+        m_len = avail;
+        m_mem_space = mem_space;
+        setContext(p_context);
+    }
+    *num_bytes = m_len - (uint32_t)(address - m_st_addr);
+    return m_p_data + (address - m_st_addr);
+}
+
+inline ocsd_err_t TrcMemAccSpan::readBytes(ITargetMemAccess *p_mem_acc, const ocsd_vaddr_t address, const uint8_t cs_trace_id, 
+                                           const ocsd_mem_space_acc_t mem_space, const ocsd_pe_context *p_context,
+                                           uint32_t *num_bytes, uint8_t *p_buffer)
+{
+    uint32_t avail = *num_bytes;
+    const uint8_t *p_data = getBytesPtr(p_mem_acc, address, cs_trace_id, mem_space, p_context, &avail);
+
+    if (!p_data)
+        return p_mem_acc->ReadTargetMemoryCtxt(address, cs_trace_id, mem_space, p_context, num_bytes, p_buffer);
+    memcpy(p_buffer, p_data, *num_bytes);
+    return OCSD_OK;
+}
+
+#endif // ARM_TRC_MEM_ACC_SPAN_H_INCLUDED
+
+/* End of File trc_mem_acc_span.h */
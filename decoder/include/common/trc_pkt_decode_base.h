@@ -42,6 +42,9 @@
 #include "interfaces/trc_gen_elem_in_i.h"
 #include "interfaces/trc_tgt_mem_access_i.h"
 #include "interfaces/trc_instr_decode_i.h"
+#include "common/trc_gen_elem.h"
+#include "common/trc_instr_blk_cache.h"
+#include "common/trc_mem_acc_span.h"
 
 /** @defgroup ocsd_pkt_decode OpenCSD Library : Packet Decoders.
 
@@ -68,6 +71,7 @@ public:
     componentAttachPt<ITrcGenElemIn> *getTraceElemOutAttachPt() { return &m_trace_elem_out; };
     componentAttachPt<ITargetMemAccess> *getMemoryAccessAttachPt() { return &m_mem_access; };
     componentAttachPt<IInstrDecode> *getInstrDecodeAttachPt() { return &m_instr_decode; };
+    componentAttachPt<TrcInstrBlockCache> *getInstrBlockCacheAttachPt() { return &m_instr_blk_cache; };
 
     void setUsesMemAccess(bool bUsesMemaccess) { m_uses_memaccess = bUsesMemaccess; };
     const bool getUsesMemAccess() const { return m_uses_memaccess; };
@@ -75,6 +79,13 @@ public:
     void setUsesIDecode(bool bUsesIDecode) { m_uses_idecode = bUsesIDecode; };
     const bool getUsesIDecode() const { return m_uses_idecode; };
 
+    /** drop any span of memory held for sequential reads - call if memory image changes */
+    void clearMemAccSpan() { m_mem_span.clear(); };
+
+    /** element types to output - OCSD_GEN_TRC_ELEM_MASK() bits. Masked out types are not built by the decoder. */
+    void setElemOutMask(const uint32_t elem_mask) { m_elem_out_mask = elem_mask; };
+    const uint32_t getElemOutMask() const { return m_elem_out_mask; };
+
 protected:
 
     /* implementation packet decoding interface */
@@ -91,19 +102,23 @@ protected:
     virtual void onFirstInitOK() {};
 
     /* data output */
+    const bool isElemOut(const ocsd_gen_trc_elem_t elem_type) const { return (m_elem_out_mask & OCSD_GEN_TRC_ELEM_MASK(elem_type)) != 0; };
     ocsd_datapath_resp_t outputTraceElement(const OcsdTraceElement &elem);    // use current index
     ocsd_datapath_resp_t outputTraceElementIdx(ocsd_trc_index_t idx, const OcsdTraceElement &elem); // use supplied index (where decoder caches elements) 
 
     /* target access */
     ocsd_err_t accessMemory(const ocsd_vaddr_t address, const ocsd_mem_space_acc_t mem_space, uint32_t *num_bytes, uint8_t *p_buffer);
+    const uint8_t *accessMemoryPtr(const ocsd_vaddr_t address, const ocsd_mem_space_acc_t mem_space, uint32_t *num_bytes); // 0 if no pointer available - use accessMemory.
     ocsd_err_t invalidateMemAccCache();
 
     /* instruction decode */
     ocsd_err_t instrDecode(ocsd_instr_info *instr_info);
+    ocsd_err_t instrDecodeBlock(ocsd_instr_info *instr_info, const uint8_t *p_opcodes, const uint32_t num_bytes, const uint32_t max_instr, uint32_t *num_instr);
 
     componentAttachPt<ITrcGenElemIn> m_trace_elem_out;
     componentAttachPt<ITargetMemAccess> m_mem_access;
     componentAttachPt<IInstrDecode> m_instr_decode;
+    componentAttachPt<TrcInstrBlockCache> m_instr_blk_cache;    //!< optional cache of decoded instruction blocks.
 
     ocsd_trc_index_t   m_index_curr_pkt;
 
@@ -115,6 +130,11 @@ protected:
     bool m_uses_memaccess;
     bool m_uses_idecode;
 
+    const ocsd_pe_context *m_p_mem_acc_ctxt;    //!< decoder current PE context passed on memory reads - 0 if not tracked.
+    TrcMemAccSpan m_mem_span;                   //!< span of memory for sequential reads without further memory access calls.
+
+    uint32_t m_elem_out_mask;   //!< element types to output.
+
 };
 
 inline TrcPktDecodeI::TrcPktDecodeI(const char *component_name) : 
@@ -123,7 +143,9 @@ inline TrcPktDecodeI::TrcPktDecodeI(const char *component_name) :
     m_decode_init_ok(false),
     m_config_init_ok(false),
     m_uses_memaccess(true),
-    m_uses_idecode(true)
+    m_uses_idecode(true),
+    m_p_mem_acc_ctxt(0),
+    m_elem_out_mask(OCSD_GEN_TRC_ELEM_MASK_ALL)
 {
 }
 
@@ -133,7 +155,9 @@ inline TrcPktDecodeI::TrcPktDecodeI(const char *component_name, int instIDNum) :
     m_decode_init_ok(false),
     m_config_init_ok(false),
     m_uses_memaccess(true),
-    m_uses_idecode(true)
+    m_uses_idecode(true),
+    m_p_mem_acc_ctxt(0),
+    m_elem_out_mask(OCSD_GEN_TRC_ELEM_MASK_ALL)
 {
 }
 
@@ -159,11 +183,15 @@ inline const bool TrcPktDecodeI::checkInit()
 
 inline ocsd_datapath_resp_t TrcPktDecodeI::outputTraceElement(const OcsdTraceElement &elem)
 {
+    if(!isElemOut(elem.getType()))
+        return OCSD_RESP_CONT;
     return m_trace_elem_out.first()->TraceElemIn(m_index_curr_pkt,getCoreSightTraceID(), elem);
 }
 
 inline ocsd_datapath_resp_t TrcPktDecodeI::outputTraceElementIdx(ocsd_trc_index_t idx, const OcsdTraceElement &elem)
 {
+    if(!isElemOut(elem.getType()))
+        return OCSD_RESP_CONT;
     return m_trace_elem_out.first()->TraceElemIn(idx, getCoreSightTraceID(), elem);
 }
 
@@ -174,17 +202,33 @@ inline ocsd_err_t TrcPktDecodeI::instrDecode(ocsd_instr_info *instr_info)
     return OCSD_ERR_DCD_INTERFACE_UNUSED;
 }
 
+inline ocsd_err_t TrcPktDecodeI::instrDecodeBlock(ocsd_instr_info *instr_info, const uint8_t *p_opcodes, const uint32_t num_bytes, const uint32_t max_instr, uint32_t *num_instr)
+{
+    if(m_uses_idecode)
+        return m_instr_decode.first()->DecodeInstructionBlock(instr_info, p_opcodes, num_bytes, max_instr, num_instr);
+    return OCSD_ERR_DCD_INTERFACE_UNUSED;
+}
+
 inline ocsd_err_t TrcPktDecodeI::accessMemory(const ocsd_vaddr_t address, const ocsd_mem_space_acc_t mem_space, uint32_t *num_bytes, uint8_t *p_buffer)
 {
     if(m_uses_memaccess)
-        return m_mem_access.first()->ReadTargetMemory(address,getCoreSightTraceID(),mem_space, num_bytes,p_buffer);
+        return m_mem_span.readBytes(m_mem_access.first(),address,getCoreSightTraceID(),mem_space,m_p_mem_acc_ctxt,num_bytes,p_buffer);
     return OCSD_ERR_DCD_INTERFACE_UNUSED;
 }
 
+inline const uint8_t *TrcPktDecodeI::accessMemoryPtr(const ocsd_vaddr_t address, const ocsd_mem_space_acc_t mem_space, uint32_t *num_bytes)
+{
+    if(m_uses_memaccess)
+        return m_mem_span.getBytesPtr(m_mem_access.first(),address,getCoreSightTraceID(),mem_space,m_p_mem_acc_ctxt,num_bytes);
+    *num_bytes = 0;
+    return 0;
+}
+
 inline ocsd_err_t TrcPktDecodeI::invalidateMemAccCache()
 {
     if (!m_uses_memaccess)
         return OCSD_ERR_DCD_INTERFACE_UNUSED;
+    m_mem_span.clear();
     m_mem_access.first()->InvalidateMemAccCache(getCoreSightTraceID());
     return OCSD_OK;
 }
@@ -246,6 +290,9 @@ template <class P, class Pc> ocsd_datapath_resp_t TrcPktDecodeBase<P, Pc>::Packe
         return OCSD_RESP_FATAL_NOT_INIT;
     }
 
+    // memory image may have changed since the last call.
+    m_mem_span.clear();
+
     switch(op)
     {
     case OCSD_OP_DATA:
@@ -197,6 +197,12 @@ protected:
     void statsAddBadHdrCount(const uint32_t count) { m_stats.bad_header_errs += count; };
     void statsInit() { m_stats_init = true; };  /* mark stats as in use */
 
+    /* bad packet errors - packet processing functions record the error and return, rather than 
+       throwing, and the processing loop logs the error before sending on the bad packet. */
+    void setPktError(const ocsd_err_t code, const ocsd_trc_index_t index, const uint8_t chan_id, const char *pszErrMsg = "");
+    const bool pktErrorSet() const { return m_pkt_err_code != OCSD_OK; };
+    const ocsd_err_t logPktError();   /* log and clear the recorded error - returns the error code */
+
  
 private:
     /* decode control */
@@ -215,13 +221,23 @@ private:
     ocsd_decode_stats_t m_stats;
     bool m_stats_init; /*< true if the specific decoder is using the stats */
 
+    /* recorded bad packet error */
+    ocsd_err_t m_pkt_err_code;
+    ocsd_trc_index_t m_pkt_err_index;
+    uint8_t m_pkt_err_chan_id;
+    const char *m_pkt_err_msg;
+
 };
 
 template<class P,class Pt, class Pc> TrcPktProcBase<P, Pt, Pc>::TrcPktProcBase(const char *component_name) : 
     TrcPktProcI(component_name),
     m_config(0),
     m_b_is_init(false),
-    m_stats_init(false)
+    m_stats_init(false),
+    m_pkt_err_code(OCSD_OK),
+    m_pkt_err_index(OCSD_BAD_TRC_INDEX),
+    m_pkt_err_chan_id(OCSD_BAD_CS_SRC_ID),
+    m_pkt_err_msg("")
 {
     resetStats();
 }
@@ -230,7 +246,11 @@ template<class P,class Pt, class Pc> TrcPktProcBase<P, Pt, Pc>::TrcPktProcBase(c
     TrcPktProcI(component_name, instIDNum),
     m_config(0),
     m_b_is_init(false),
-    m_stats_init(false)
+    m_stats_init(false),
+    m_pkt_err_code(OCSD_OK),
+    m_pkt_err_index(OCSD_BAD_TRC_INDEX),
+    m_pkt_err_chan_id(OCSD_BAD_CS_SRC_ID),
+    m_pkt_err_msg("")
 {
     resetStats();
 }
@@ -449,6 +469,22 @@ template<class P,class Pt, class Pc> void TrcPktProcBase<P, Pt, Pc>::resetStats(
     m_stats.demux.valid_id_bytes = 0;
 } 
 
+template<class P,class Pt, class Pc> void TrcPktProcBase<P, Pt, Pc>::setPktError(const ocsd_err_t code, const ocsd_trc_index_t index, const uint8_t chan_id, const char *pszErrMsg /*= ""*/)
+{
+    m_pkt_err_code = code;
+    m_pkt_err_index = index;
+    m_pkt_err_chan_id = chan_id;
+    m_pkt_err_msg = pszErrMsg;
+}
+
+template<class P,class Pt, class Pc> const ocsd_err_t TrcPktProcBase<P, Pt, Pc>::logPktError()
+{
+    ocsd_err_t err = m_pkt_err_code;
+    LogError(ocsdError(OCSD_ERR_SEV_ERROR, err, m_pkt_err_index, m_pkt_err_chan_id, m_pkt_err_msg));
+    m_pkt_err_code = OCSD_OK;
+    return err;
+}
+
 /** @}*/
 
 #endif // ARM_TRC_PKT_PROC_BASE_H_INCLUDED
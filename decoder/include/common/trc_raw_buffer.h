@@ -36,6 +36,7 @@
 #define ARM_TRC_RAW_BUFFER_H_INCLUDED
 
 #include <vector>
+#include "common/trc_sync_scan.h"
 
 class TraceRawBuffer
 {
@@ -52,6 +53,8 @@ public:
     void init(const uint32_t size, const uint8_t *rawtrace, std::vector<uint8_t> *out_packet);
     void copyByteToPkt();   // move a byte to the packet buffer     
     uint8_t peekNextByte(); // value of next byte in buffer.
+    uint32_t copyBytesToPktUntil(const uint8_t val, const uint32_t max); // move bytes to the packet buffer, up to max or the next byte of value val.
+    const uint8_t *readByteNoCopy();    // consume next byte without copy to the packet buffer - buffer must not be empty.
 
     bool empty() { return m_bufProcessed == m_bufSize; };
     // bytes processed.
@@ -84,6 +87,21 @@ inline void TraceRawBuffer::copyByteToPkt()
     }
 }
 
+inline uint32_t TraceRawBuffer::copyBytesToPktUntil(const uint8_t val, const uint32_t max)
+{
+    uint32_t avail = m_bufSize - m_bufProcessed;
+    uint32_t num_bytes = TrcSyncScan::findByte(m_pBuffer + m_bufProcessed, (avail < max) ? avail : max, val);
+
+    pkt->insert(pkt->end(), m_pBuffer + m_bufProcessed, m_pBuffer + m_bufProcessed + num_bytes);
+    m_bufProcessed += num_bytes;
+    return num_bytes;
+}
+
+inline const uint8_t *TraceRawBuffer::readByteNoCopy()
+{
+    return &m_pBuffer[m_bufProcessed++];
+}
+
 inline uint8_t TraceRawBuffer::peekNextByte()
 {
     uint8_t val = 0;
@@ -0,0 +1,151 @@
+/*
+ * \file       trc_ring_buf_in.h
+ * \brief      OpenCSD : Streaming trace data input from a live, wrapping ring buffer.
+ *
+ * \copyright  Copyright (c) 2026, ARM Limited. All Rights Reserved.
+ */
+
+
+/*
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 'AS IS' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef ARM_TRC_RING_BUF_IN_H_INCLUDED
+#define ARM_TRC_RING_BUF_IN_H_INCLUDED
+
+#include <atomic>
+
+#include "opencsd/ocsd_if_types.h"
+#include "interfaces/trc_data_raw_in_i.h"
+
+/** @addtogroup dcd_tree
+@{*/
+
+/*!
+ * @class TrcRingBufferIn
+ * @brief Decode trace data incrementally from a ring buffer written by a live producer.
+ *
+ * Consumes a memory mapped ring buffer such as a perf AUX area or ETR buffer. The producer
+ * and consumer positions are free running byte counts - as aux_head and aux_tail in the perf
+ * mmap page - with the buffer offset being the count modulo the buffer size. The count is
+ * used as the trace index for the data.
+ *
+ * Each call to processData() reads the head, and passes the data from the read position to the
+ * head into the decode input, as up to two blocks when the data wraps, without copying. The tail
+ * is written as data is consumed, releasing space to the producer.
+ *
+ * If the head is more than the buffer size ahead of the read position, the producer has
+ * overwritten unread data. Input restarts at the oldest data in the buffer, and the decode is
+ * reset, so each decoder outputs an unsynced element before decoding from the next sync point.
+ * Clients that learn of lost data by other means - e.g. a truncated perf AUX record - mark a
+ * discontinuity at the current head with setDataLost().
+ *
+ * A producer that does not observe the tail may overwrite data during decode. The head is
+ * read again after each block is decoded, and if the block has been overwritten the decode
+ * is reset in the same way, with the decoded block counted as lost.
+ */
+class TrcRingBufferIn
+{
+public:
+    TrcRingBufferIn();
+    ~TrcRingBufferIn() {};
+
+    /*!
+     * Set the ring buffer and the decode input. Read position starts at the current head.
+     *
+     * @param *pDataIn    : Decode input - decode tree or packet processor.
+     * @param *p_buffer   : Start of the ring buffer.
+     * @param buffer_size : Size in bytes, a multiple of align.
+     * @param *p_head     : Producer position - free running byte count.
+     * @param *p_tail     : Consumer position - written as data is consumed. May be 0.
+     * @param align       : Input block alignment - 16 for memory aligned formatted trace.
+     *
+     * @return ocsd_err_t : Library error code or OCSD_OK if successful.
+     */
+    ocsd_err_t init(ITrcDataIn *pDataIn, const uint8_t *p_buffer, const uint64_t buffer_size,
+                    const volatile uint64_t *p_head, volatile uint64_t *p_tail, const uint32_t align = 1);
+
+    /*!
+     * Decode the data between the read position and the current head.
+     *
+     * Returns the decode response - on WAIT the next call will flush the decoders before
+     * continuing with the input data. A FATAL response stops input until the decode is
+     * reset and the buffer set again using init().
+     */
+    ocsd_datapath_resp_t processData();
+
+    /* mark a discontinuity in the data at the current head. */
+    void setDataLost();
+
+    const uint64_t getReadPos() const { return m_pos; };                    //!< next byte to decode.
+    const uint64_t getBytesLost() const { return m_bytes_lost; };           //!< bytes skipped after overwrites.
+    const uint32_t getNumDiscontinuities() const { return m_num_discont; }; //!< decode resets for lost data.
+
+private:
+    const uint64_t readHead() const;
+    void writeTail();
+    void restartInput(const uint64_t pos);
+
+    ITrcDataIn *m_pDataIn;
+    const uint8_t *m_p_buffer;
+    uint64_t m_size;
+    const volatile uint64_t *m_p_head;
+    volatile uint64_t *m_p_tail;
+    uint64_t m_align_mask;
+
+    uint64_t m_pos;             //!< read position - free running count.
+    bool m_discont_pending;     //!< discontinuity marked by the client at m_discont_pos.
+    uint64_t m_discont_pos;
+    ocsd_datapath_resp_t m_resp;
+
+    uint64_t m_bytes_lost;
+    uint32_t m_num_discont;
+};
+
+inline const uint64_t TrcRingBufferIn::readHead() const
+{
+    uint64_t head = *m_p_head;
+
+    // data written by the producer before the head update must be visible after it.
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return head;
+}
+
+inline void TrcRingBufferIn::writeTail()
+{
+    if (m_p_tail)
+    {
+        // all reads of the consumed data complete before the space is released.
+        std::atomic_thread_fence(std::memory_order_release);
+        *m_p_tail = m_pos;
+    }
+}
+
+/** @}*/
+
+#endif // ARM_TRC_RING_BUF_IN_H_INCLUDED
+
+/* End of File trc_ring_buf_in.h */
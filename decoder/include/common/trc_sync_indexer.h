@@ -0,0 +1,150 @@
+/*
+ * \file       trc_sync_indexer.h
+ * \brief      OpenCSD : Index trace sync points for each trace ID in a capture.
+ *
+ * \copyright  Copyright (c) 2026, ARM Limited. All Rights Reserved.
+ */
+
+
+/*
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 'AS IS' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef ARM_TRC_SYNC_INDEXER_H_INCLUDED
+#define ARM_TRC_SYNC_INDEXER_H_INCLUDED
+
+#include <vector>
+#include <deque>
+#include <string>
+#include <mutex>
+#include <atomic>
+
+#include "opencsd/ocsd_if_types.h"
+#include "interfaces/trc_indexer_src_i.h"
+#include "interfaces/trc_abs_typed_base_i.h"
+
+class DecodeTree;
+class TraceFormatterFrameDecoder;
+
+/* number of frame sync points held to find the restart point for a sync packet */
+#define SYNC_IDX_FRAME_SYNC_HISTORY 0x10000
+
+/*!
+ * @class TrcSyncIndexer
+ * @brief Build an index of the sync points for each trace ID in a capture.
+ *
+ * Attached to the frame deformatter index attach point, and to the packet monitor
+ * attach point of each packet processor in a decode tree. Packet processors only
+ * are required, so the index can be built without a full decode of the capture.
+ *
+ * Records the index of ETMv4 / ETE A-sync + TraceInfo, PTM / ETMv3 A-sync + I-sync and
+ * STM / ITM ASYNC points, the index at which input must restart to decode from that
+ * point, and the nearest timestamp. The deformatter reports frame sync points, used to
+ * find the start of the frame containing the sync packet.
+ *
+ * Packet monitor calls may be made from decode threads, so index updates are locked.
+ */
+class TrcSyncIndexer : public ITrcSrcIndexCreator
+{
+public:
+    TrcSyncIndexer();
+    virtual ~TrcSyncIndexer();
+
+    /* attach to the deformatter and all packet processors in the tree. Replaces any packet monitor. */
+    ocsd_err_t attachToTree(DecodeTree *pTree);
+    /* attach to the packet processor for a single ID */
+    ocsd_err_t attachToDecoder(DecodeTree *pTree, const uint8_t CSID);
+    /* stop / start recording - packet monitors remain attached. Updates in progress complete before a stop. */
+    void setActive(const bool bActive);
+    const bool isActive() const { return m_active.load(); };
+
+    /* index access - entries sorted by packet index. */
+    void clear();
+    const std::vector<ocsd_sync_idx_entry_t> &getEntries();
+    const bool isIDPresent(const uint8_t ID) const { return (ID < 0x80) ? m_id_present[ID] : false; };
+
+    /* find the sync point to restart decode before a target index or timestamp. 
+       Latest entry at or before the target for the ID, or for each ID if CSID is OCSD_BAD_CS_SRC_ID, 
+       returning the one with the earliest restart index. false if no entry precedes the target. */
+    const bool findSeekEntry(const uint64_t target, const bool bTimestamp, const uint8_t CSID, ocsd_sync_idx_entry_t &seek_entry);
+
+    /* index files */
+    ocsd_err_t saveIndex(const std::string &filename);
+    ocsd_err_t loadIndex(const std::string &filename);
+
+    /* ITrcSrcIndexCreator - called from the frame deformatter */
+    virtual const uint32_t IndexBlockSize() const { return 256; };
+    virtual ocsd_err_t TrcIDIndex(const ocsd_trc_index_t src_idx, const uint8_t ID);
+    virtual ocsd_err_t TrcIDBlockMap(const ocsd_trc_index_t src_idx_start, const std::vector<uint8_t> IDs);
+    virtual ocsd_err_t TrcEventIndex(const ocsd_trc_index_t src_idx, const int event_type);
+    virtual void TrcSyncIndex(const ocsd_trc_index_t src_idx);
+
+    /* packet classes reported by the packet monitors */
+    typedef enum _sync_pkt_class {
+        SYNC_PKT_OTHER,     //!< not used in the index
+        SYNC_PKT_ALIGN,     //!< ETM / PTM A-sync - start of a sync sequence
+        SYNC_PKT_TINFO,     //!< ETMv4 / ETE TraceInfo
+        SYNC_PKT_ISYNC,     //!< PTM / ETMv3 I-sync
+        SYNC_PKT_ASYNC,     //!< STM / ITM ASYNC - complete sync point
+        SYNC_PKT_TS,        //!< timestamp
+    } sync_pkt_class_t;
+
+    /* called from the packet monitors */
+    void indexPacket(const uint8_t ID, const ocsd_trc_index_t index_sop, const sync_pkt_class_t pkt_class, const uint64_t ts);
+    void resetID(const uint8_t ID);
+
+private:
+    void addEntry(const uint8_t ID, const ocsd_trc_index_t pkt_index, const ocsd_sync_idx_type_t type);
+    ocsd_trc_index_t getRestartIndex(const ocsd_trc_index_t pkt_index);
+    void destroyMonitors();
+
+    /* sync sequence state for an ID */
+    typedef struct _id_state {
+        bool align_pending;             // A-sync seen, waiting for TraceInfo / I-sync
+        ocsd_trc_index_t align_index;
+        int ts_entry;                   // entry waiting for a following timestamp, -1 if none
+        bool ts_valid;                  // last timestamp for this ID
+        uint64_t ts;
+    } id_state_t;
+
+    std::vector<ocsd_sync_idx_entry_t> m_entries;   // entries in order of recording
+    std::vector<ocsd_sync_idx_entry_t> m_sorted;    // entries sorted by packet index
+    bool m_sorted_valid;
+    id_state_t m_id_state[0x80];
+    bool m_id_present[0x80];
+    ocsd_trc_index_t m_id_last_entry[0x80]; // latest sync packet indexed for each ID - re-decode after a seek does not add entries
+    ITrcTypedBase *m_id_mon[0x80];      // packet monitors attached to each ID
+
+    TraceFormatterFrameDecoder *m_deformatter;
+    std::deque<ocsd_trc_index_t> m_frame_syncs;
+
+    std::atomic<bool> m_active;     // unlocked early out in the monitors - rechecked under the lock.
+    std::mutex m_lock;
+};
+
+#endif // ARM_TRC_SYNC_INDEXER_H_INCLUDED
+
+/* End of File trc_sync_indexer.h */
@@ -0,0 +1,91 @@
+/*
+ * \file       trc_sync_scan.h
+ * \brief      OpenCSD : Fast scan of unsynchronised trace data for sync candidates.
+ * 
+ * \copyright  Copyright (c) 2026, ARM Limited. All Rights Reserved.
+ */
+
+
+/* 
+ * Redistribution and use in source and binary forms, with or without modification, 
+ * are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, 
+ * this list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright notice, 
+ * this list of conditions and the following disclaimer in the documentation 
+ * and/or other materials provided with the distribution. 
+ * 
+ * 3. Neither the name of the copyright holder nor the names of its contributors 
+ * may be used to endorse or promote products derived from this software without 
+ * specific prior written permission. 
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 'AS IS' AND 
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED 
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. 
+ * IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, 
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES 
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; 
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND 
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT 
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS 
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. 
+ */ 
+
+#ifndef ARM_TRC_SYNC_SCAN_H_INCLUDED
+#define ARM_TRC_SYNC_SCAN_H_INCLUDED
+
+#include <cstdint>
+#include <cstring>
+
+/*!
+ * @class TrcSyncScan
+ * @brief Find the next possible sync point in unsynchronised trace data.
+ *
+ * Packet processors waiting for sync look for the first byte of the protocol sync 
+ * pattern - 0x00 for the ETMv4 / ETE, PTM and ETMv3 A-sync, 0xFF for the STM ASYNC.
+ * All other bytes are unsynced data, so the scan compares a 64 bit word at a time 
+ * once aligned, and the processor state machine handles the candidate byte.
+ */
+class TrcSyncScan
+{
+public:
+    /* offset of the first byte of value val in the buffer, or size if not found */
+    static uint32_t findByte(const uint8_t *pData, const uint32_t size, const uint8_t val);
+};
+
+inline uint32_t TrcSyncScan::findByte(const uint8_t *pData, const uint32_t size, const uint8_t val)
+{
+    static const uint64_t low_bits = 0x0101010101010101ULL;
+    static const uint64_t high_bits = 0x8080808080808080ULL;
+    const uint64_t pattern = low_bits * val;
+    uint64_t word;
+    uint32_t pos = 0;
+
+    // bytes up to the first aligned word
+    while ((pos < size) && (((uintptr_t)(pData + pos)) & (sizeof(uint64_t) - 1)))
+    {
+        if (pData[pos] == val)
+            return pos;
+        pos++;
+    }
+
+    // word at a time - a zero byte after the xor is a match.
+    while ((size - pos) >= sizeof(uint64_t))
+    {
+        memcpy(&word, pData + pos, sizeof(uint64_t));
+        word ^= pattern;
+        if ((word - low_bits) & ~word & high_bits)
+            break;
+        pos += sizeof(uint64_t);
+    }
+
+    while ((pos < size) && (pData[pos] != val))
+        pos++;
+    return pos;
+}
+
+#endif // ARM_TRC_SYNC_SCAN_H_INCLUDED
+
+/* End of File trc_sync_scan.h */
@@ -49,6 +49,8 @@ public:
     virtual ~TrcIDecode() {};
 
     virtual ocsd_err_t DecodeInstruction(ocsd_instr_info* instr_info);
+    virtual ocsd_err_t DecodeInstructionBlock(ocsd_instr_info *instr_info, const uint8_t *p_opcodes, 
+                                              const uint32_t num_bytes, const uint32_t max_instr, uint32_t *num_instr);
 
     /* control AA64 checking for invalid opcode */
     void setAA64_errOnBadOpcode(bool bSet);
@@ -62,6 +64,9 @@ private:
     ocsd_err_t DecodeA64(ocsd_instr_info *instr_info, struct decode_info *info);
     ocsd_err_t DecodeT32(ocsd_instr_info *instr_info, struct decode_info *info);
 
+    ocsd_err_t DecodeA64Block(ocsd_instr_info *instr_info, const uint8_t *p_opcodes, 
+                              const uint32_t num_bytes, const uint32_t max_instr, uint32_t *num_instr);
+
     bool aa64_err_bad_opcode;   //!< error if aa64 opcode is in invalid range (top 2 bytes = 0x0000).
 
     static ITraceErrorLog* p_i_errlog;
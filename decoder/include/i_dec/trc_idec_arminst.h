@@ -124,6 +124,17 @@ int inst_Thumb_wfiwfe(uint32_t inst);
 int inst_A64_wfiwfe(uint32_t inst, struct decode_info *info);
 int inst_A64_Tstart(uint32_t inst);
 
+/*
+Test whether an A64 instruction is in the branches, exception generating and 
+system instructions encoding group (bits [28:26] == 0b101). All A64 instructions 
+that can be waypoints are in this group - others need no further decode when
+searching for a waypoint.
+*/
+inline int inst_A64_in_branch_sys_group(uint32_t inst)
+{
+    return (inst & 0x1C000000) == 0x14000000;
+}
+
 /*
 Test whether an instruction is definitely undefined, e.g. because
 allocated to a "permanently UNDEFINED" space (UDF mnemonic).
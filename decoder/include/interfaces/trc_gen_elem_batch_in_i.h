@@ -0,0 +1,77 @@
+/*
+ * \file       trc_gen_elem_batch_in_i.h
+ * \brief      OpenCSD : Generic Trace Element batch output interface.
+ * 
+ * \copyright  Copyright (c) 2026, ARM Limited. All Rights Reserved.
+ */
+
+
+/* 
+ * Redistribution and use in source and binary forms, with or without modification, 
+ * are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, 
+ * this list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright notice, 
+ * this list of conditions and the following disclaimer in the documentation 
+ * and/or other materials provided with the distribution. 
+ * 
+ * 3. Neither the name of the copyright holder nor the names of its contributors 
+ * may be used to endorse or promote products derived from this software without 
+ * specific prior written permission. 
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 'AS IS' AND 
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED 
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. 
+ * IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, 
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES 
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; 
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND 
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT 
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS 
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. 
+ */ 
+
+#ifndef ARM_TRC_GEN_ELEM_BATCH_IN_I_H_INCLUDED
+#define ARM_TRC_GEN_ELEM_BATCH_IN_I_H_INCLUDED
+
+#include "opencsd/trc_gen_elem_types.h"
+
+/*!
+ * @class ITrcGenElemBatchIn
+  
+ * @brief Interface for the input of batches of generic trace elements. 
+ *
+ * @ingroup ocsd_interfaces
+ *
+ * Optional alternative to ITrcGenElemIn as the output attachment for a decode tree.
+ * Elements are copied into a contiguous array, which is passed to the client when full, 
+ * at the end of each block of trace data passed into the decode tree, or when an element
+ * references extended data that is only valid for the duration of the output call.
+ * 
+ */
+class ITrcGenElemBatchIn
+{
+public:
+    ITrcGenElemBatchIn() {};  /**< Default constructor. */
+    virtual ~ITrcGenElemBatchIn() {}; /**< Default destructor. */
+
+    /*!
+     * Input a batch of generic trace elements, in decode order.
+     *
+     * All elements in the batch are consumed by the call. A WAIT response 
+     * will pause the decode after this batch.
+     *
+     * @param *p_elems : Array of elements with source index and trace ID.
+     * @param num_elem : Number of elements in the array.
+     *
+     * @return ocsd_datapath_resp_t  : Standard data path response.
+     */
+    virtual ocsd_datapath_resp_t TraceElemBatchIn(const ocsd_gen_elem_batch_entry_t *p_elems,
+                                                   const uint32_t num_elem) = 0;
+};
+
+#endif // ARM_TRC_GEN_ELEM_BATCH_IN_I_H_INCLUDED
+
+/* End of File trc_gen_elem_batch_in_i.h */
@@ -69,7 +69,7 @@ public:
      * 
      * @return uint32_t : Size of indexing block.
      */
-    virtual const uint32_t IndexBlockSize() const;
+    virtual const uint32_t IndexBlockSize() const { return 256; };
 
     /*!
      * Index a single ID
@@ -115,7 +115,7 @@ public:
      *
      * @param src_idx : trace index of sync point.
      */
-    virtual void TrcSyncIndex(const ocsd_trc_index_t src_idx);
+    virtual void TrcSyncIndex(const ocsd_trc_index_t /* src_idx */) {};
 
 };
 
@@ -35,6 +35,9 @@
 #ifndef ARM_TRC_INSTR_DECODE_I_H_INCLUDED
 #define ARM_TRC_INSTR_DECODE_I_H_INCLUDED
 
+#include <cstring>
+#include "opencsd/ocsd_if_types.h"
+
 /*!
  * @class IInstrDecode   
  * @ingroup ocsd_interfaces
@@ -59,6 +62,50 @@ public:
      * @return ocsd_err_t  : OCSD_OK if successful.
      */
     virtual ocsd_err_t DecodeInstruction(ocsd_instr_info *instr_info) = 0;
+
+    /*!
+     * Decode a block of sequential opcodes, stopping after the first waypoint instruction - 
+     * any instruction with a type other than OCSD_INSTR_OTHER.
+     *
+     * Decode also stops when fewer than 4 bytes remain in the block, as for a single instruction 
+     * the caller would read 4 bytes, or when the maximum number of instructions is reached.
+     *
+     * On return instr_info contains the decode of the last instruction decoded, with instr_addr 
+     * set to the address of that instruction. If no instructions are decoded instr_info is unchanged.
+     * On error, instr_info contains the instruction that failed to decode.
+     *
+     * Default implementation calls DecodeInstruction() for each opcode.
+     *
+     * @param *instr_info : [in] Address, ISA and decode options for the first instruction. [out] Decode of the last instruction.
+     * @param *p_opcodes : Opcode bytes, in memory order, starting at instr_info->instr_addr.
+     * @param num_bytes : Number of bytes available at p_opcodes.
+     * @param max_instr : Maximum number of instructions to decode. 0 for no limit.
+     * @param *num_instr : [out] Number of instructions decoded, including any waypoint.
+     *
+     * @return ocsd_err_t  : OCSD_OK if successful. On error, num_instr excludes the failed instruction.
+     */
+    virtual ocsd_err_t DecodeInstructionBlock(ocsd_instr_info *instr_info, const uint8_t *p_opcodes, 
+                                              const uint32_t num_bytes, const uint32_t max_instr, uint32_t *num_instr)
+    {
+        ocsd_err_t err = OCSD_OK;
+        uint32_t offset = 0, count = 0;
+
+        while (((offset + 4) <= num_bytes) && (!max_instr || (count < max_instr)))
+        {
+            if (count)
+                instr_info->instr_addr += instr_info->instr_size;
+            memcpy(&instr_info->opcode, p_opcodes + offset, 4);
+            err = DecodeInstruction(instr_info);
+            if (err != OCSD_OK)
+                break;
+            offset += instr_info->instr_size;
+            count++;
+            if (instr_info->type != OCSD_INSTR_OTHER)
+                break;
+        }
+        *num_instr = count;
+        return err;
+    };
 };
 
 #endif // ARM_TRC_INSTR_DECODE_I_H_INCLUDED
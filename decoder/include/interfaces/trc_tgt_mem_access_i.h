@@ -84,6 +84,63 @@ public:
                                             uint32_t *num_bytes, 
                                             uint8_t *p_buffer) = 0;
 
+    /*!
+     * Read a block of target memory, supplying the current PE context of the reading decoder.
+     *
+     * Context aware implementations use the context ID and VMID to select the memory image for 
+     * the read. Default implementation ignores the context and calls ReadTargetMemory().
+     *
+     * @param address : Address to access.
+     * @param cs_trace_id : protocol source trace ID.
+     * @param mem_space : Memory space to access, (secure, non-secure, optionally with EL, or any).
+     * @param *p_context : current PE context for the trace source - may be 0 if unknown.
+     * @param num_bytes : [in] Number of bytes required. [out] Number of bytes actually read.
+     * @param *p_buffer : Buffer to fill with the bytes.
+     *
+     * @return ocsd_err_t : OCSD_OK on successful access (including memory not available)
+     */
+    virtual ocsd_err_t ReadTargetMemoryCtxt(const ocsd_vaddr_t address, 
+                                            const uint8_t cs_trace_id, 
+                                            const ocsd_mem_space_acc_t mem_space, 
+                                            const ocsd_pe_context * /*p_context*/,
+                                            uint32_t *num_bytes, 
+                                            uint8_t *p_buffer)
+    {
+        return ReadTargetMemory(address, cs_trace_id, mem_space, num_bytes, p_buffer);
+    };
+
+    /*!
+     * Get a pointer to target memory, without copying into a caller buffer.
+     *
+     * Implementations that hold the memory image in memory - e.g. in cache pages, or buffer / mapped 
+     * file accessors - return a pointer to the data at the address, and the number of contiguous bytes 
+     * available from that pointer. Allows the caller to read sequential locations without further calls.
+     *
+     * The pointer is valid until the next call to this interface, or until the memory accessors are 
+     * changed. A null pointer indicates the required bytes are not available by pointer - the caller
+     * should use ReadTargetMemoryCtxt(). The default implementation always returns a null pointer.
+     *
+     * @param address : Address to access.
+     * @param cs_trace_id : protocol source trace ID.
+     * @param mem_space : Memory space to access, (secure, non-secure, optionally with EL, or any).
+     * @param *p_context : current PE context for the trace source - may be 0 if unknown.
+     * @param num_bytes : [in] Minimum number of bytes required. [out] Number of contiguous bytes available, 0 if none.
+     * @param **pp_data : [out] Pointer to the data at address, 0 if none.
+     *
+     * @return ocsd_err_t : OCSD_OK on successful access (including memory not available)
+     */
+    virtual ocsd_err_t ReadTargetMemoryPtr(const ocsd_vaddr_t /*address*/, 
+                                           const uint8_t /*cs_trace_id*/, 
+                                           const ocsd_mem_space_acc_t /*mem_space*/, 
+                                           const ocsd_pe_context * /*p_context*/,
+                                           uint32_t *num_bytes, 
+                                           const uint8_t **pp_data)
+    {
+        *num_bytes = 0;
+        *pp_data = 0;
+        return OCSD_OK;
+    };
+
     /*! 
      * Invalidate any caching that the memory accessor functions are using.
      * Generally called when a memory context changes in the trace.
@@ -37,6 +37,14 @@
 
 #include "opencsd/ocsd_if_types.h"
 #include <string>
+#include <vector>
+#include <atomic>
+
+/** inclusive start and end addresses of a single region covered by an accessor */
+typedef struct _memacc_range {
+    ocsd_vaddr_t st_addr;
+    ocsd_vaddr_t en_addr;
+} memacc_range_t;
 
 /*!
  * @class TrcMemAccessorBase
@@ -131,6 +139,23 @@ public:
      */
     virtual const uint32_t readBytes(const ocsd_vaddr_t s_address, const ocsd_mem_space_acc_t memSpace, const uint8_t trcID, const uint32_t reqBytes, uint8_t *byteBuffer) = 0;
 
+    /*!
+     * Get a pointer to the bytes at an address, where the accessor holds the memory image in memory.
+     * Default returns no data - accessors that must copy or call out for data do not override.
+     *
+     * @param s_address : Start address of the read.
+     * @param memSpace  : memory space for this access. 
+     * @param trcID     : Trace ID of trace source.
+     * @param *numBytes : [out] Number of contiguous bytes available from the returned pointer.
+     *
+     * @return const uint8_t * : Pointer to data at s_address, 0 if out of range or not supported.
+     */
+    virtual const uint8_t *getBytesPtr(const ocsd_vaddr_t /*s_address*/, const ocsd_mem_space_acc_t /*memSpace*/, const uint8_t /*trcID*/, uint32_t *numBytes) 
+    { 
+        *numBytes = 0;
+        return 0;
+    };
+
     /*!
      * Validate the address range - ensure addresses aligned, different, st < en etc.
      *
@@ -145,6 +170,26 @@ public:
     void setMemSpace(ocsd_mem_space_acc_t memSpace) { m_mem_space = memSpace; };
     const ocsd_mem_space_acc_t getMemSpace() const { return m_mem_space; };
     const bool inMemSpace(const ocsd_mem_space_acc_t mem_space) const { return (bool)(((uint8_t)m_mem_space & (uint8_t)mem_space) != 0); }; 
+
+    /* handle memory context - context ID / VMID this accessor is valid for. Used by context aware mappers. */
+    void setMemContext(const ocsd_mem_acc_ctxt_t &mem_ctxt) { m_mem_ctxt = mem_ctxt; };
+    const ocsd_mem_acc_ctxt_t &getMemContext() const { return m_mem_ctxt; };
+    const bool hasMemContext() const { return (bool)(m_mem_ctxt.ctxt_id_valid || m_mem_ctxt.vmid_valid); };
+
+    /*!
+     * Append the address ranges covered by this accessor to the supplied vector.
+     * Accessors with multiple discontiguous regions override to add each region.
+     *
+     * @param &ranges : vector to append ranges to.
+     */
+    virtual void getRanges(std::vector<memacc_range_t> &ranges) const;
+
+    /*!
+     * Sequence number incremented whenever an accessor that may already be in use 
+     * has its ranges changed. Allows mappers that index ranges to detect stale indexes.
+     * Atomic - read by decode threads while ranges may be updated on another thread.
+     */
+    static const uint32_t getRangeUpdateSeq() { return s_range_update_seq.load(); };
     
     /* memory access info logging */
     virtual void getMemAccString(std::string &accStr) const;
@@ -156,6 +201,12 @@ protected:
     ocsd_vaddr_t m_endAddress;     /**< accessible range end address */
     const MemAccTypes m_type;       /**< memory accessor type */
     ocsd_mem_space_acc_t m_mem_space; /**< Matching memory space of this acessor */
+    ocsd_mem_acc_ctxt_t m_mem_ctxt;   /**< Matching memory context of this accessor - none valid for any context */
+
+    static void rangeUpdated() { s_range_update_seq++; };  /**< call if ranges change after accessor creation */
+
+private:
+    static std::atomic<uint32_t> s_range_update_seq;
 };
 
 inline TrcMemAccessorBase::TrcMemAccessorBase(MemAccTypes accType, ocsd_vaddr_t startAddr, ocsd_vaddr_t endAddr) :
@@ -164,6 +215,8 @@ inline TrcMemAccessorBase::TrcMemAccessorBase(MemAccTypes accType, ocsd_vaddr_t
      m_type(accType),
      m_mem_space(OCSD_MEM_SPACE_ANY)
 {
+    m_mem_ctxt.context_id = m_mem_ctxt.vmid = 0;
+    m_mem_ctxt.ctxt_id_valid = m_mem_ctxt.vmid_valid = 0;
 }
 
 inline TrcMemAccessorBase::TrcMemAccessorBase(MemAccTypes accType) :
@@ -172,6 +225,8 @@ inline TrcMemAccessorBase::TrcMemAccessorBase(MemAccTypes accType) :
      m_type(accType),
      m_mem_space(OCSD_MEM_SPACE_ANY)
 {
+    m_mem_ctxt.context_id = m_mem_ctxt.vmid = 0;
+    m_mem_ctxt.ctxt_id_valid = m_mem_ctxt.vmid_valid = 0;
 }
 
 inline void TrcMemAccessorBase::setRange(ocsd_vaddr_t startAddr, ocsd_vaddr_t endAddr)
@@ -213,6 +268,14 @@ inline const bool TrcMemAccessorBase::overLapRange(const TrcMemAccessorBase *p_t
     return false;
 }
 
+inline void TrcMemAccessorBase::getRanges(std::vector<memacc_range_t> &ranges) const
+{
+    memacc_range_t range;
+    range.st_addr = m_startAddress;
+    range.en_addr = m_endAddress;
+    ranges.push_back(range);
+}
+
 inline const bool TrcMemAccessorBase::validateRange()
 {
     if(m_startAddress & 0x1) // at least hword aligned for thumb
@@ -232,7 +295,7 @@ class TrcMemAccFactory
 public:
     /** Accessor Creation */
     static ocsd_err_t CreateBufferAccessor(TrcMemAccessorBase **pAccessor, const ocsd_vaddr_t s_address, const uint8_t *p_buffer, const uint32_t size);
-    static ocsd_err_t CreateFileAccessor(TrcMemAccessorBase **pAccessor, const std::string &pathToFile, ocsd_vaddr_t startAddr, size_t offset = 0, size_t size = 0);
+    static ocsd_err_t CreateFileAccessor(TrcMemAccessorBase **pAccessor, const std::string &pathToFile, ocsd_vaddr_t startAddr, size_t offset = 0, size_t size = 0, const bool use_mmap = false, const ocsd_mem_acc_ctxt_t *p_mem_ctxt = 0);
     static ocsd_err_t CreateCBAccessor(TrcMemAccessorBase **pAccessor, const ocsd_vaddr_t s_address, const ocsd_vaddr_t e_address, const ocsd_mem_space_acc_t mem_space);
     
     /** Accessor Destruction */
@@ -83,6 +83,9 @@ public:
     /** Memory access override - allow decoder to read bytes from the buffer. */
     virtual const uint32_t readBytes(const ocsd_vaddr_t address, const ocsd_mem_space_acc_t memSpace, const uint8_t trcID, const uint32_t reqBytes, uint8_t *byteBuffer);
 
+    /** Direct pointer override - return pointer into the buffer. */
+    virtual const uint8_t *getBytesPtr(const ocsd_vaddr_t address, const ocsd_mem_space_acc_t memSpace, const uint8_t trcID, uint32_t *numBytes);
+
 private:
     const uint8_t *m_p_buffer;  /**< pointer to the memory buffer  */
 };
@@ -58,7 +58,12 @@ typedef struct cache_block {
     uint32_t valid_len;
     uint8_t* data;
     uint8_t trcID;          // trace ID associated with the page
-    uint32_t use_sequence; // number representing the sequence of allocation to evict oldest page.
+    const TrcMemAccessorBase *p_acc;    // accessor the page was loaded from
+    ocsd_mem_space_acc_t mem_space;     // memory space used when loading the page
+    int hash_prev;          // previous / next page in the same hash bucket, -1 if none
+    int hash_next;
+    int lru_prev;           // previous (more recently used) / next (less recently used) page in LRU list, -1 if none
+    int lru_next;
 } cache_block_t;
 
 // enable define to collect stats for debugging / cache performance tests
@@ -69,11 +74,15 @@ typedef struct cache_block {
  * 
  * Reduce the need to read files / make callbacks into clients when walking memory images.
  * 
+ * Valid pages are indexed in a hash table by page aligned start address, so lookup cost does not
+ * depend on the number of pages. Pages are kept in a least recently used list - the LRU page, or
+ * a clean page, is evicted when a new page is needed.
+ * 
  * Caching is done on a per Core/Trace ID basis - all caches from that ID are invalidated when a context
- * switch appears on the core. This means that we do not account for memory spaces in the cache pages as
- * these only change via a context switch.
+ * switch appears on the core. 
  * 
- * Memory space is used on cache miss if reading data from the underlying accessor (file / callback).
+ * Pages are also tagged with the accessor and memory space used to load them. This allows context aware
+ * mappers, which select a different accessor per context, to keep pages across context switches.
  */
 class TrcMemAccCache
 {
@@ -95,11 +104,16 @@ public:
     /* cache invalidation */
     void invalidateAll();
     void invalidateByTraceID(int8_t trcID);
+    void invalidateCtxtPagesByTraceID(int8_t trcID);    // pages loaded from accessors with a memory context only
     void clearPage(cache_block_t* page);
 
     /** read bytes from cache if possible - load new page if needed from underlying accessor, bail out if data not available */
     ocsd_err_t readBytesFromCache(TrcMemAccessorBase *p_accessor, const ocsd_vaddr_t address, const ocsd_mem_space_acc_t mem_space, const uint8_t trcID, uint32_t *numBytes, uint8_t *byteBuffer);
 
+    /** as readBytesFromCache, but return pointer to data in the cache page, and the bytes available in the page from address. 
+        Pointer valid until the next cache operation. */
+    ocsd_err_t readPtrFromCache(TrcMemAccessorBase *p_accessor, const ocsd_vaddr_t address, const ocsd_mem_space_acc_t mem_space, const uint8_t trcID, uint32_t *numBytes, const uint8_t **pp_data);
+
     void setErrorLog(ITraceErrorLog *log);
     void logAndClearCounts();
 
@@ -107,12 +121,23 @@ public:
     static void getenvMemaccCacheSizes(bool& enable, int& page_size, int& num_pages);
 
 private:
-    bool blockInCache(const ocsd_vaddr_t address, const uint32_t reqBytes, const uint8_t trcID); // run through each page to look for data.
-    bool blockInPage(const ocsd_vaddr_t address, const uint32_t reqBytes, const uint8_t trcID);    
+    bool blockInCache(const ocsd_vaddr_t address, const uint32_t reqBytes, const uint8_t trcID, const TrcMemAccessorBase *p_acc, const ocsd_mem_space_acc_t mem_space); // look up hash index for page containing data.
+    bool blockInPage(const int idx, const ocsd_vaddr_t address, const uint32_t reqBytes, const uint8_t trcID, const TrcMemAccessorBase *p_acc, const ocsd_mem_space_acc_t mem_space);    
 
     void logMsg(const std::string &szMsg, ocsd_err_t err = OCSD_OK);
     int findNewPage();
-    void incSequence(); // increment sequence on current block
+    void resetPages();      // clear all pages, hash index and LRU list
+
+    /* hash index of valid pages */
+    uint32_t hashBucket(const ocsd_vaddr_t blk_num) const;
+    void hashInsert(const int idx);
+    void hashRemove(const int idx);
+
+    /* LRU list of pages */
+    void lruUnlink(const int idx);
+    void lruPushHead(const int idx);
+    void lruPushTail(const int idx);
+    void lruMoveToHead(const int idx);
 
     ocsd_err_t createCaches();     // create caches according to current sizes 
     void destroyCaches();   // destroy the cache blocks
@@ -121,7 +146,12 @@ private:
     int m_mru_idx = 0;          // in use index - most recently used page   
     uint16_t m_mru_page_size;   // page size
     int m_mru_num_pages;        // number of pages  
-    uint32_t m_mru_sequence;    // allocation & use sequence number
+
+    int *m_hash_tbl;            // hash buckets - index of first page in bucket, -1 if empty
+    uint32_t m_hash_mask;       // number of buckets - 1
+    int m_blk_shift;            // log2 of hash block size - smallest power of 2 >= page size
+    int m_lru_head;             // most recently used page
+    int m_lru_tail;             // least recently used page
 
     bool m_bCacheEnabled = false;
 
@@ -137,7 +167,7 @@ private:
 };
 
 inline TrcMemAccCache::TrcMemAccCache() :
-    m_mru(0), m_mru_sequence(1)
+    m_mru(0), m_hash_tbl(0), m_hash_mask(0), m_blk_shift(0), m_lru_head(-1), m_lru_tail(-1)
 {
     /* set default cache sizes */
     m_mru_page_size = MEM_ACC_CACHE_DEFAULT_PAGE_SIZE;
@@ -150,51 +180,63 @@ inline TrcMemAccCache::~TrcMemAccCache()
 }
 
 
-inline bool TrcMemAccCache::blockInPage(const ocsd_vaddr_t address, const uint32_t reqBytes, const uint8_t trcID)
+inline bool TrcMemAccCache::blockInPage(const int idx, const ocsd_vaddr_t address, const uint32_t reqBytes, const uint8_t trcID, const TrcMemAccessorBase *p_acc, const ocsd_mem_space_acc_t mem_space)
 {
-    /* check has data, trcID and mem space */
-    if ((m_mru[m_mru_idx].trcID != trcID) ||
-        (m_mru[m_mru_idx].valid_len == 0)
+    /* check has data, trcID, accessor and mem space */
+    if ((m_mru[idx].trcID != trcID) ||
+        (m_mru[idx].valid_len == 0) ||
+        (m_mru[idx].p_acc != p_acc) ||
+        (m_mru[idx].mem_space != mem_space)
         )
         return false;
 
     /* check block is in this page */
-    if ((m_mru[m_mru_idx].st_addr <= address) &&
-        m_mru[m_mru_idx].st_addr + m_mru[m_mru_idx].valid_len >= (address + reqBytes))
+    if ((m_mru[idx].st_addr <= address) &&
+        m_mru[idx].st_addr + m_mru[idx].valid_len >= (address + reqBytes))
         return true;
     return false;
 }
 
-inline bool TrcMemAccCache::blockInCache(const ocsd_vaddr_t address, const uint32_t reqBytes, const uint8_t trcID)
+inline uint32_t TrcMemAccCache::hashBucket(const ocsd_vaddr_t blk_num) const
+{
+    return (uint32_t)((blk_num * 0x9E3779B97F4A7C15ULL) >> 32) & m_hash_mask;
+}
+
+inline bool TrcMemAccCache::blockInCache(const ocsd_vaddr_t address, const uint32_t reqBytes, const uint8_t trcID, const TrcMemAccessorBase *p_acc, const ocsd_mem_space_acc_t mem_space)
 {
-    int tests = m_mru_num_pages;
-    while (tests)
-    {        
-        if (blockInPage(address, reqBytes, trcID))
-            return true; // found address in page
+    ocsd_vaddr_t blk_num;
+    int idx;
+
+    /* most recently used page first */
+    if (blockInPage(m_mru_idx, address, reqBytes, trcID, p_acc, mem_space))
+        return true;
 #ifdef LOG_CACHE_STATS    
-        // miss counts of current page only - to determine if we hit other page
-        if (tests == m_mru_num_pages)
-            m_misses++;
+    // miss counts of current page only - to determine if we hit other page
+    m_misses++;
 #endif
 
-        tests--;
-        m_mru_idx++;
-        if (m_mru_idx == m_mru_num_pages)
-            m_mru_idx = 0;
+    /* Pages are loaded from the requested address and are no larger than the hash block size,
+       so a page containing the request must start in the same block as address, or the one before. */
+    blk_num = address >> m_blk_shift;
+    for (int i = 0; i < 2; i++)
+    {
+        idx = m_hash_tbl[hashBucket(blk_num)];
+        while (idx != -1)
+        {
+            if (blockInPage(idx, address, reqBytes, trcID, p_acc, mem_space))
+            {
+                m_mru_idx = idx;
+                return true;
+            }
+            idx = m_mru[idx].hash_next;
+        }
+        if (blk_num == 0)
+            break;
+        blk_num--;
     }
     return false;
 }
 
-// zero out page parameters rendering it empty
-inline void TrcMemAccCache::clearPage(cache_block_t* page)
-{
-    page->use_sequence = 0;
-    page->st_addr = 0;
-    page->valid_len = 0;
-    page->trcID = OCSD_BAD_CS_SRC_ID;
-}
-
 #endif // ARM_TRC_MEM_ACC_CACHE_H_INCLUDED
 
 /* End of File trc_mem_acc_cache.h */
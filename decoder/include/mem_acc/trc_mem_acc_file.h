@@ -59,6 +59,7 @@ public:
     virtual const uint32_t readBytes(const ocsd_vaddr_t s_address, const ocsd_mem_space_acc_t memSpace, const uint8_t trcID, const uint32_t reqBytes, uint8_t *byteBuffer) { return 0; };
 
     const ocsd_vaddr_t regionStartAddress() const { return m_startAddress; };
+    const ocsd_vaddr_t regionEndAddress() const { return m_endAddress; };
 
 private:
     size_t m_file_offset;
@@ -79,6 +80,9 @@ public:
     /** read bytes override - reads from file */
     virtual const uint32_t readBytes(const ocsd_vaddr_t address, const ocsd_mem_space_acc_t memSpace, const uint8_t trcID, const uint32_t reqBytes, uint8_t *byteBuffer);
 
+    /** direct pointer override - available if file mapped into memory */
+    virtual const uint8_t *getBytesPtr(const ocsd_vaddr_t address, const ocsd_mem_space_acc_t memSpace, const uint8_t trcID, uint32_t *numBytes);
+
 protected:
     TrcMemAccessorFile();   /**< protected default constructor */
     virtual ~ TrcMemAccessorFile(); /**< protected default destructor */
@@ -98,10 +102,21 @@ protected:
      *
      * @param &pathToFile : Binary file path and name
      * @param startAddr : system memory address associated with start of binary datain file.
+     * @param use_mmap : map the file into memory rather than reading through a file stream.
      *
      * @return bool  : true if set up successfully, false if file could not be opened.
      */
-    ocsd_err_t initAccessor(const std::string &pathToFile, ocsd_vaddr_t startAddr, size_t offset, size_t size);
+    ocsd_err_t initAccessor(const std::string &pathToFile, ocsd_vaddr_t startAddr, size_t offset, size_t size, const bool use_mmap);
+
+    /** map / unmap the whole file read only - sets m_p_mapped and m_mapped_size */
+    bool mapFile(const std::string &pathToFile);
+    void unmapFile();
+
+    /** read from the mapped file, base range or regions */
+    const uint32_t readBytesMapped(const ocsd_vaddr_t address, const uint32_t reqBytes, uint8_t *byteBuffer);
+
+    /** pointer into the mapped file for address, with bytes available up to reqBytes */
+    const uint8_t *getMappedPtr(const ocsd_vaddr_t address, const uint32_t reqBytes, uint32_t *numBytes);
 
     /** get the file path */
     const std::string &getFilePath() const { return m_file_path; };
@@ -164,9 +179,15 @@ public:
      */
     virtual const bool overLapRange(const TrcMemAccessorBase *p_test_acc) const;
 
+    /*! Override to add the base range and each offset region. */
+    virtual void getRanges(std::vector<memacc_range_t> &ranges) const;
+
     /*! Override to handle ranges and offset accessors plus add in file name. */
     virtual void getMemAccString(std::string &accStr) const;
 
+    /*! true if the file is memory mapped rather than read through a file stream */
+    const bool isMapped() const { return (bool)(m_p_mapped != 0); };
+
 
     /*!
      * Create a file accessor based on the supplied path and address.
@@ -174,15 +195,20 @@ public:
      *
      * File will be checked to ensure valid accessor can be created.
      *
-     * If an accessor using the supplied file is currently in use then a reference to that
-     * accessor will be returned and the accessor reference counter updated.
+     * If an accessor using the supplied file in the same memory context is currently in use then 
+     * a reference to that accessor will be returned and the accessor reference counter updated.
+     * The same file in a different memory context gets a separate accessor, so one image
+     * can be mapped into several processes.
      *
      * @param &pathToFile : Path to binary file
      * @param startAddr : Start address of data represented by file.
+     * @param use_mmap : Memory map the file rather than use a file stream. Ignored if the file 
+     *                   is already in use by an existing accessor.
+     * @param *p_mem_ctxt : Memory context for the accessor. 0 for an accessor valid in all contexts.
      *
      * @return TrcMemAccessorFile * : pointer to accessor if successful, 0 if it could not be created.
      */
-    static ocsd_err_t createFileAccessor(TrcMemAccessorFile **p_acc, const std::string &pathToFile, ocsd_vaddr_t startAddr, size_t offset = 0, size_t size = 0);
+    static ocsd_err_t createFileAccessor(TrcMemAccessorFile **p_acc, const std::string &pathToFile, ocsd_vaddr_t startAddr, size_t offset = 0, size_t size = 0, const bool use_mmap = false, const ocsd_mem_acc_ctxt_t *p_mem_ctxt = 0);
 
     /*!
      * Destroy supplied accessor. 
@@ -194,33 +220,41 @@ public:
     static void destroyFileAccessor(TrcMemAccessorFile *p_accessor);
 
     /*!
-     * Test if any accessor is currently using the supplied file path
+     * Test if any accessor is currently using the supplied file path in the memory context
      *
      * @param &pathToFile : Path to test.
+     * @param *p_mem_ctxt : Memory context to test. 0 for no context.
      *
      * @return bool : true if an accessor exists with this file path.
      */
-    static const bool isExistingFileAccessor(const std::string &pathToFile);
+    static const bool isExistingFileAccessor(const std::string &pathToFile, const ocsd_mem_acc_ctxt_t *p_mem_ctxt = 0);
 
     /*!
-     * Get the accessor using the supplied file path
+     * Get the accessor using the supplied file path in the memory context
      * Use after createFileAccessor if additional memory ranges need
      * adding to an exiting file accessor.
      *
      * @param &pathToFile : Path to test.
+     * @param *p_mem_ctxt : Memory context to test. 0 for no context.
      *
      * @return TrcMemAccessorFile * : none 0 if an accessor exists with this file path.
      */
-    static TrcMemAccessorFile * getExistingFileAccessor(const std::string &pathToFile);
+    static TrcMemAccessorFile * getExistingFileAccessor(const std::string &pathToFile, const ocsd_mem_acc_ctxt_t *p_mem_ctxt = 0);
 
 
 
 
 private:
-    static std::map<std::string, TrcMemAccessorFile *> s_FileAccessorMap;   /**< map of file accessors in use. */
+    // key : file path, memory context (valid flags, VMID << 32 | context ID - invalid values set to 0)
+    typedef std::pair<std::string, std::pair<uint8_t, uint64_t> > file_acc_key_t;
+    static file_acc_key_t makeFileKey(const std::string &pathToFile, const ocsd_mem_acc_ctxt_t *p_mem_ctxt);
+
+    static std::map<file_acc_key_t, TrcMemAccessorFile *> s_FileAccessorMap;   /**< map of file accessors in use. */
 
 private:
     std::ifstream m_mem_file;   /**< input binary file stream */
+    const uint8_t *m_p_mapped;  /**< start of memory mapped file if using mmap */
+    size_t m_mapped_size;       /**< size of the mapping */
     ocsd_vaddr_t m_file_size;  /**< size of the file */
     int m_ref_count;            /**< accessor reference count */
     std::string m_file_path;    /**< path to input file */
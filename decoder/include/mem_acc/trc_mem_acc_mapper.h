@@ -36,6 +36,7 @@
 #define ARM_TRC_MEM_ACC_MAPPER_H_INCLUDED
 
 #include <vector>
+#include <map>
 
 #include "opencsd/ocsd_if_types.h"
 #include "interfaces/trc_tgt_mem_access_i.h"
@@ -45,6 +46,8 @@
 
 typedef enum _memacc_mapper_t {
     MEMACC_MAP_GLOBAL,
+    MEMACC_MAP_GLOBAL_IDX,
+    MEMACC_MAP_CTXT,
 } memacc_mapper_t;
 
 class TrcMemAccMapper : public ITargetMemAccess
@@ -61,6 +64,14 @@ public:
                                             uint32_t *num_bytes, 
                                             uint8_t *p_buffer);
 
+    // pointer direct to buffer / mapped file accessor data, or into cache page.
+    virtual ocsd_err_t ReadTargetMemoryPtr(const ocsd_vaddr_t address, 
+                                           const uint8_t cs_trace_id, 
+                                           const ocsd_mem_space_acc_t mem_space, 
+                                           const ocsd_pe_context *p_context,
+                                           uint32_t *num_bytes, 
+                                           const uint8_t **pp_data);
+
     virtual void InvalidateMemAccCache(const uint8_t cs_trace_id);
 
 // mapper memory area configuration interface
@@ -91,6 +102,10 @@ public:
     // optionally error if outside limits - otherwise set to max / min automatically
     ocsd_err_t setCacheSizes(uint16_t page_size, int num_pages, const bool err_on_limit = false);
 
+    // allow pointer reads to return cache pages - disable if reads are shared between threads, 
+    // as a page may be reloaded while a pointer is in use.
+    void setCachePtrReads(const bool enable) { m_cache_ptr_reads = enable; };
+
 protected:
     virtual bool findAccessor(const ocsd_vaddr_t address, const ocsd_mem_space_acc_t mem_space, const uint8_t cs_trace_id) = 0;     // set m_acc_curr if found valid range, leave unchanged if not.
     virtual bool readFromCurrent(const ocsd_vaddr_t address, const ocsd_mem_space_acc_t mem_space, const uint8_t cs_trace_id) = 0;
@@ -98,6 +113,8 @@ protected:
     virtual TrcMemAccessorBase *getNextAccessor() = 0;
     virtual void clearAccessorList() = 0;
 
+    bool selectAccessor(const ocsd_vaddr_t address, const ocsd_mem_space_acc_t mem_space, const uint8_t cs_trace_id); // set m_acc_curr for the read, true if found.
+
     void LogMessage(const std::string &msg);
     void LogWarn(const ocsd_err_t err, const std::string &msg);
 
@@ -106,6 +123,8 @@ protected:
     const bool m_using_trace_id;        // true if we are using separate memory spaces by TraceID.
     ITraceErrorLog *m_err_log;          // error log to print out mappings on request.
     TrcMemAccCache m_cache;             // memory accessor caching.
+    bool m_keep_cache_on_acc_change;    // cache pages remain valid when a different accessor is selected.
+    bool m_cache_ptr_reads;             // pointer reads may return a cache page.
 };
 
 
@@ -135,6 +154,118 @@ protected:
     std::vector<TrcMemAccessorBase *>::iterator m_acc_it;
 };
 
+// index of accessor ranges, one per memory space - ranges within a single space do not overlap.
+class TrcMemAccRangeIdx
+{
+public:
+    TrcMemAccRangeIdx() {};
+    ~TrcMemAccRangeIdx() {};
+
+    void indexAccessor(TrcMemAccessorBase *p_accessor, const uint32_t add_order);
+    bool overlapsIndex(const TrcMemAccessorBase *p_accessor);
+    TrcMemAccessorBase *findInIndex(const ocsd_vaddr_t address, const ocsd_mem_space_acc_t mem_space) const;
+    void clear();
+
+private:
+    // single range for an accessor in a memory space index.
+    typedef struct _acc_idx_entry {
+        ocsd_vaddr_t en_addr;           // inclusive end address - start address is the map key
+        TrcMemAccessorBase *p_acc;      // accessor for the range
+        uint32_t add_order;             // order accessor added - first added wins where request covers multiple spaces
+    } acc_idx_entry_t;
+
+    typedef std::map<ocsd_vaddr_t, acc_idx_entry_t> acc_idx_t;
+
+    const acc_idx_entry_t *findInSpaceIndex(const int space_idx, const ocsd_vaddr_t address) const;
+
+    static const int NUM_SPACE_IDX = 8;     // one index per memory space bit in ocsd_mem_space_acc_t
+    acc_idx_t m_acc_idx[NUM_SPACE_IDX];
+    std::vector<memacc_range_t> m_ranges;   // working list of ranges for an accessor
+};
+
+// global address space as above, with accessor ranges indexed per memory space.
+// O(log n) add and find for use where large numbers of accessors are mapped.
+class TrcMemAccMapGlobalSpaceIdx : public TrcMemAccMapGlobalSpace
+{
+public:
+    TrcMemAccMapGlobalSpaceIdx();
+    virtual ~TrcMemAccMapGlobalSpaceIdx();
+
+    // mapper creation interface - prevent overlaps
+    virtual ocsd_err_t AddAccessor(TrcMemAccessorBase *p_accessor, const uint8_t cs_trace_id);
+
+protected:
+    virtual bool findAccessor(const ocsd_vaddr_t address, const ocsd_mem_space_acc_t mem_space, const uint8_t cs_trace_id); 
+    virtual void clearAccessorList();
+    virtual ocsd_err_t RemoveAccessor(const TrcMemAccessorBase *p_accessor);
+
+private:
+    void rebuildIndex();
+
+    TrcMemAccRangeIdx m_acc_idx;
+    uint32_t m_range_seq;                   // accessor range update sequence when index built
+};
+
+// context aware address space - accessors indexed by memory context (context ID / VMID) 
+// and memory space. Reads with a PE context use accessors for the matching context, falling 
+// back to accessors with no memory context set, so multiple process images can share VAs.
+// Cache pages are tagged by accessor, so context changes do not invalidate the cache.
+// Reads without a context, and removal by address, use accessors with no memory context only.
+class TrcMemAccMapCtxtSpace : public TrcMemAccMapGlobalSpace
+{
+public:
+    TrcMemAccMapCtxtSpace();
+    virtual ~TrcMemAccMapCtxtSpace();
+
+    virtual ocsd_err_t ReadTargetMemory(   const ocsd_vaddr_t address, 
+                                            const uint8_t cs_trace_id, 
+                                            const ocsd_mem_space_acc_t mem_space, 
+                                            uint32_t *num_bytes, 
+                                            uint8_t *p_buffer);
+
+    virtual ocsd_err_t ReadTargetMemoryCtxt(const ocsd_vaddr_t address, 
+                                            const uint8_t cs_trace_id, 
+                                            const ocsd_mem_space_acc_t mem_space, 
+                                            const ocsd_pe_context *p_context,
+                                            uint32_t *num_bytes, 
+                                            uint8_t *p_buffer);
+
+    virtual ocsd_err_t ReadTargetMemoryPtr(const ocsd_vaddr_t address, 
+                                           const uint8_t cs_trace_id, 
+                                           const ocsd_mem_space_acc_t mem_space, 
+                                           const ocsd_pe_context *p_context,
+                                           uint32_t *num_bytes, 
+                                           const uint8_t **pp_data);
+
+    // context change - invalidate pages from context specific accessors only.
+    virtual void InvalidateMemAccCache(const uint8_t cs_trace_id);
+
+    // mapper creation interface - prevent overlaps within the same memory context
+    virtual ocsd_err_t AddAccessor(TrcMemAccessorBase *p_accessor, const uint8_t cs_trace_id);
+
+protected:
+    virtual bool findAccessor(const ocsd_vaddr_t address, const ocsd_mem_space_acc_t mem_space, const uint8_t cs_trace_id); 
+    virtual bool readFromCurrent(const ocsd_vaddr_t address,const ocsd_mem_space_acc_t mem_space,  const uint8_t cs_trace_id);    
+    virtual void clearAccessorList();
+    virtual ocsd_err_t RemoveAccessor(const TrcMemAccessorBase *p_accessor);
+
+private:
+    // key : valid flags, VMID << 32 | context ID - invalid values set to 0.
+    typedef std::pair<uint8_t, uint64_t> ctxt_key_t;
+    static const uint8_t KEY_CTXT_ID = 0x1;
+    static const uint8_t KEY_VMID = 0x2;
+
+    static ctxt_key_t makeKey(const uint8_t flags, const uint32_t ctxt_id, const uint32_t vmid);
+    static ctxt_key_t accessorKey(const TrcMemAccessorBase *p_accessor);
+    void setReadKey(const ocsd_pe_context *p_context);
+    void rebuildIndex();
+
+    std::map<ctxt_key_t, TrcMemAccRangeIdx> m_ctxt_idx;
+    uint32_t m_range_seq;           // accessor range update sequence when index built
+    ctxt_key_t m_read_key;          // memory context of the current read
+    ctxt_key_t m_acc_curr_key;      // memory context of the read that selected m_acc_curr
+};
+
 #endif // ARM_TRC_MEM_ACC_MAPPER_H_INCLUDED
 
 /* End of File trc_mem_acc_mapper.h */
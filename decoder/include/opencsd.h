@@ -45,6 +45,7 @@
 #include "interfaces/trc_data_rawframe_in_i.h"
 #include "interfaces/trc_error_log_i.h"
 #include "interfaces/trc_gen_elem_in_i.h"
+#include "interfaces/trc_gen_elem_batch_in_i.h"
 #include "interfaces/trc_instr_decode_i.h"
 #include "interfaces/trc_pkt_in_i.h"
 #include "interfaces/trc_pkt_raw_in_i.h"
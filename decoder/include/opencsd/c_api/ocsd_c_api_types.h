@@ -77,6 +77,11 @@ typedef ocsd_datapath_resp_t (* FnTraceElemIn)( const void *p_context,
                                                 const uint8_t trc_chan_id, 
                                                 const ocsd_generic_trace_elem *elem); 
 
+/** function pointer type for batched decoder outputs. all protocols, array of generic data elements */
+typedef ocsd_datapath_resp_t (* FnTraceElemBatchIn)( const void *p_context, 
+                                                     const ocsd_gen_elem_batch_entry_t *p_elems, 
+                                                     const uint32_t num_elem); 
+
 /** function pointer type for packet processor packet output sink, packet analyser/decoder input - generic declaration */
 typedef ocsd_datapath_resp_t (* FnDefPktDataIn)(const void *p_context, 
                                                 const ocsd_datapath_op_t op, 
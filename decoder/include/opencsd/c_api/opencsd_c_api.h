@@ -155,6 +155,234 @@ OCSD_C_API ocsd_datapath_resp_t ocsd_dt_process_data(const dcd_tree_handle_t han
  */
 OCSD_C_API ocsd_err_t ocsd_dt_set_gen_elem_outfn(const dcd_tree_handle_t handle, FnTraceElemIn pFn, const void *p_context);
 
+/*!
+ * Set a batched trace element output callback function. Alternative to ocsd_dt_set_gen_elem_outfn().
+ *
+ * Decoded elements are copied into an array, which is passed to the callback function 
+ * at the end of each block of data passed to ocsd_dt_process_data(), when the array is full,
+ * or when an element has extended data. 
+ *
+ * A single function is used for all trace source IDs in the decode tree. Replaces any 
+ * callback set by ocsd_dt_set_gen_elem_outfn().
+ *
+ * @param handle : Handle to decode tree.
+ * @param pFn : Pointer to the callback function.
+ * @param p_context : opaque context pointer value used in callback function.
+ * @param batch_size : Maximum number of elements in a batch (1 - 65536).
+ *
+ * @return  ocsd_err_t  : Library error code -  OCSD_OK if successful.
+ */
+OCSD_C_API ocsd_err_t ocsd_dt_set_gen_elem_batch_outfn(const dcd_tree_handle_t handle, FnTraceElemBatchIn pFn, const void *p_context, const uint32_t batch_size);
+
+/*!
+ * Set the trace element types output by the decoders in the decode tree.
+ *
+ * One bit per ocsd_gen_trc_elem_t value - use OCSD_GEN_TRC_ELEM_MASK(). Decoders do not
+ * build masked out element types. Default is OCSD_GEN_TRC_ELEM_MASK_ALL.
+ *
+ * @param handle : Handle to decode tree.
+ * @param elem_mask : element types to output.
+ *
+ * @return  ocsd_err_t  : Library error code -  OCSD_OK if successful.
+ */
+OCSD_C_API ocsd_err_t ocsd_dt_set_gen_elem_out_mask(const dcd_tree_handle_t handle, const uint32_t elem_mask);
+
+/*!
+ * Decode each trace source ID in a frame formatted decode tree on a separate thread.
+ *
+ * ocsd_dt_process_data() returns once data is queued for the decode threads. EOT and 
+ * RESET operations return once all queued data is decoded. 
+ * 
+ * Output callbacks are called from the decode threads, one at a time. Elements for a 
+ * single trace ID are output in order, elements for different IDs are interleaved.
+ * Memory access callbacks are called from the decode threads, one at a time.
+ *
+ * @param handle     : Handle to decode tree.
+ * @param enable     : 0 to decode on the calling thread.
+ * @param queue_size : Size in bytes of the data queue for each ID (power of 2, 4096 - 16M). 
+ *
+ * @return  ocsd_err_t  : Library error code -  OCSD_OK if successful.
+ */
+OCSD_C_API ocsd_err_t ocsd_dt_set_threaded_decode(const dcd_tree_handle_t handle, const int enable, const uint32_t queue_size);
+
+/*!
+ * Decode a single ETMv4 / ETE trace source in parallel, splitting the trace data into
+ * chunks at A-sync + TraceInfo sync points, each decoded by one of a set of worker threads.
+ *
+ * Elements are output on the calling thread, in trace order. Output for a chunk follows 
+ * once the chunk is decoded, all output is complete when EOT or RESET operations return.
+ * Memory access callbacks are called from the decode threads, one at a time.
+ *
+ * @param handle      : Handle to decode tree.
+ * @param CSID        : Trace source ID - ignored for a tree with no frame formatter.
+ * @param enable      : 0 to decode the source with a single decoder on the calling thread.
+ * @param num_threads : Number of decode threads (max 64), 0 for the number of hardware threads.
+ * @param chunk_size  : Minimum size in bytes of trace data in a chunk (1024 - 256M).
+ *
+ * @return  ocsd_err_t  : Library error code -  OCSD_OK if successful.
+ */
+OCSD_C_API ocsd_err_t ocsd_dt_set_chunked_decode(const dcd_tree_handle_t handle, const unsigned char CSID, const int enable, const uint32_t num_threads, const uint32_t chunk_size);
+
+/*!
+ * Record the sync points for each trace ID as trace data is processed by the decode tree.
+ * Decoders created with packet processing only are sufficient to build the index.
+ *
+ * Uses the packet monitor attach point of each decoder, replacing any packet monitor
+ * callback or printer. Disabling stops recording, retaining the index.
+ *
+ * @param handle : Handle to decode tree.
+ * @param enable : 0 to stop recording sync points.
+ *
+ * @return  ocsd_err_t  : Library error code -  OCSD_OK if successful.
+ */
+OCSD_C_API ocsd_err_t ocsd_dt_set_sync_indexing(const dcd_tree_handle_t handle, const int enable);
+
+/*!
+ * Get the sync points recorded by the decode tree, sorted by trace index.
+ * Array remains valid until the next call into the decode tree.
+ *
+ * @param handle : Handle to decode tree.
+ * @param **p_entries : returns a pointer to the array of index entries.
+ * @param *num_entries : returns the number of entries.
+ *
+ * @return  ocsd_err_t  : Library error code -  OCSD_OK if successful, OCSD_ERR_NOT_INIT if indexing not enabled.
+ */
+OCSD_C_API ocsd_err_t ocsd_dt_get_sync_index(const dcd_tree_handle_t handle, const ocsd_sync_idx_entry_t **p_entries, uint64_t *num_entries);
+
+/*!
+ * Save the sync points recorded by the decode tree to an index file.
+ *
+ * @param handle : Handle to decode tree.
+ * @param *filename : Name of the index file.
+ *
+ * @return  ocsd_err_t  : Library error code -  OCSD_OK if successful.
+ */
+OCSD_C_API ocsd_err_t ocsd_dt_save_sync_index(const dcd_tree_handle_t handle, const char *filename);
+
+/*!
+ * Load a sync index saved from an earlier pass over the capture, for use when seeking.
+ *
+ * @param handle : Handle to decode tree.
+ * @param *filename : Name of the index file.
+ *
+ * @return  ocsd_err_t  : Library error code -  OCSD_OK if successful, OCSD_ERR_SYNC_IDX_FILE if the file is invalid.
+ */
+OCSD_C_API ocsd_err_t ocsd_dt_load_sync_index(const dcd_tree_handle_t handle, const char *filename);
+
+/*!
+ * Reset the decode tree to decode from a target trace index. Returns the index from which 
+ * the caller must restart input to ocsd_dt_process_data() - the nearest preceding sync point 
+ * in the sync index, or the frame containing the target if none, with decoders resyncing 
+ * at the next sync point in the trace.
+ *
+ * @param handle : Handle to decode tree.
+ * @param target_index : Index to decode from.
+ * @param cs_id : Trace ID to seek for, or OCSD_BAD_CS_SRC_ID for all IDs.
+ * @param *restart_index : Returns the index at which to restart input.
+ *
+ * @return  ocsd_err_t  : Library error code -  OCSD_OK if successful.
+ */
+OCSD_C_API ocsd_err_t ocsd_dt_seek_index(const dcd_tree_handle_t handle, const ocsd_trc_index_t target_index, const uint8_t cs_id, ocsd_trc_index_t *restart_index);
+
+/*!
+ * Reset the decode tree to decode from a target timestamp, using the sync index. Returns the 
+ * index from which the caller must restart input to ocsd_dt_process_data().
+ *
+ * @param handle : Handle to decode tree.
+ * @param timestamp : Timestamp to decode from.
+ * @param cs_id : Trace ID to seek for, or OCSD_BAD_CS_SRC_ID for all IDs.
+ * @param *restart_index : Returns the index at which to restart input.
+ *
+ * @return  ocsd_err_t  : Library error code -  OCSD_OK if successful, OCSD_ERR_NOT_INIT if no sync index.
+ */
+OCSD_C_API ocsd_err_t ocsd_dt_seek_timestamp(const dcd_tree_handle_t handle, const uint64_t timestamp, const uint8_t cs_id, ocsd_trc_index_t *restart_index);
+
+/*!
+ * Set a live ring buffer as the trace data input for the decode tree - e.g. a perf AUX area or ETR buffer.
+ * Alternative to passing linear buffers to ocsd_dt_process_data().
+ *
+ * Head and tail are free running byte counts, as aux_head and aux_tail in the perf mmap page. 
+ * The count is used as the trace index. Data overwritten before it is decoded causes a decode 
+ * reset, with each decoder outputting an unsynced element before resyncing.
+ *
+ * @param handle : Handle to decode tree.
+ * @param *p_buffer : Start of the ring buffer.
+ * @param buffer_size : Size of the ring buffer in bytes - multiple of 16 for memory aligned frame formatted trace.
+ * @param *p_head : Producer position.
+ * @param *p_tail : Consumer position, written as data is decoded - may be NULL.
+ *
+ * @return  ocsd_err_t  : Library error code -  OCSD_OK if successful.
+ */
+OCSD_C_API ocsd_err_t ocsd_dt_set_ring_buf_input(const dcd_tree_handle_t handle, const uint8_t *p_buffer, const uint64_t buffer_size, const volatile uint64_t *p_head, volatile uint64_t *p_tail);
+
+/*!
+ * Decode the ring buffer data written since the last call, up to the current head.
+ * On a WAIT response, call again once the element output can accept more data.
+ *
+ * @param handle : Handle to decode tree.
+ *
+ * @return ocsd_datapath_resp_t  : Datapath response code (CONT/WAIT/FATAL)
+ */
+OCSD_C_API ocsd_datapath_resp_t ocsd_dt_process_ring_buf(const dcd_tree_handle_t handle);
+
+/*!
+ * Mark a discontinuity in the ring buffer data at the current head - e.g. on a truncated perf AUX record.
+ * Data up to the head is decoded, then the decode is reset before the following data.
+ *
+ * @param handle : Handle to decode tree.
+ *
+ * @return  ocsd_err_t  : Library error code -  OCSD_OK if successful, OCSD_ERR_NOT_INIT if no ring buffer set.
+ */
+OCSD_C_API ocsd_err_t ocsd_dt_ring_buf_data_lost(const dcd_tree_handle_t handle);
+
+/*!
+ * Get the ring buffer read position and lost data counts. 
+ *
+ * @param handle : Handle to decode tree.
+ * @param *read_pos : Returns the position of the next byte to decode.
+ * @param *bytes_lost : Returns the number of bytes overwritten before decode.
+ * @param *num_discont : Returns the number of decode resets for lost data.
+ *
+ * @return  ocsd_err_t  : Library error code -  OCSD_OK if successful, OCSD_ERR_NOT_INIT if no ring buffer set.
+ */
+OCSD_C_API ocsd_err_t ocsd_dt_get_ring_buf_stats(const dcd_tree_handle_t handle, uint64_t *read_pos, uint64_t *bytes_lost, uint32_t *num_discont);
+
+/*!
+ * Aggregate the decoded trace into AutoFDO instruction range and branch counts.
+ *
+ * Element output for each trace ID is counted instead of passed to the output callbacks.
+ * Set OCSD_GEN_TRC_ELEM_MASK_AFDO with ocsd_dt_set_gen_elem_out_mask() to skip building unused elements.
+ * Disabling restores the output callbacks, retaining the counts.
+ *
+ * @param handle : Handle to decode tree.
+ * @param enable : 0 to stop aggregating the profile.
+ *
+ * @return  ocsd_err_t  : Library error code -  OCSD_OK if successful.
+ */
+OCSD_C_API ocsd_err_t ocsd_dt_set_afdo_profiling(const dcd_tree_handle_t handle, const int enable);
+
+/*!
+ * Count only the trace executed in a matching PE context, once profiling is enabled.
+ * AutoFDO profiles are per binary - use where the trace covers several processes or VMs.
+ *
+ * @param handle : Handle to decode tree.
+ * @param *p_filter : Context ID and / or VMID to match. NULL or neither valid to count all contexts.
+ *
+ * @return  ocsd_err_t  : Library error code -  OCSD_OK if successful, OCSD_ERR_NOT_INIT if profiling not enabled.
+ */
+OCSD_C_API ocsd_err_t ocsd_dt_set_afdo_ctxt_filter(const dcd_tree_handle_t handle, const ocsd_mem_acc_ctxt_t *p_filter);
+
+/*!
+ * Save the profile counts in the AutoFDO text profile format, once decode is complete.
+ * Waits for any decode threads to complete the trace already input.
+ *
+ * @param handle : Handle to decode tree.
+ * @param *filename : Name of the profile file.
+ *
+ * @return  ocsd_err_t  : Library error code -  OCSD_OK if successful, OCSD_ERR_NOT_INIT if profiling not enabled.
+ */
+OCSD_C_API ocsd_err_t ocsd_dt_save_afdo_profile(const dcd_tree_handle_t handle, const char *filename);
+
 /*---------------------- Trace Decoders ----------------------------------------------------------------------------------*/
 /*!
 * Creates a decoder that is registered with the library under the supplied name.
@@ -283,6 +511,37 @@ OCSD_C_API ocsd_err_t ocsd_dt_add_binfile_mem_acc(const dcd_tree_handle_t handle
  */
 OCSD_C_API ocsd_err_t ocsd_dt_add_binfile_region_mem_acc(const dcd_tree_handle_t handle, const ocsd_file_mem_region_t *region_array, const int num_regions, const ocsd_mem_space_acc_t mem_space, const char *filepath); 
 
+/*!
+ * Add a memory mapped binary file based memory range accessor to the decode tree.
+ *
+ * As ocsd_dt_add_binfile_mem_acc(), but the file is mapped into memory and 
+ * reads are served directly from the mapping rather than a file stream.
+ *
+ * @param handle : Handle to decode tree.
+ * @param address : Start address of memory area.
+ * @param mem_space : Associated memory space.
+ * @param *filepath : Path to binary data file.
+ *
+ * @return ocsd_err_t  : Library error code -  RCDTL_OK if successful.
+ */
+OCSD_C_API ocsd_err_t ocsd_dt_add_binfile_mmap_mem_acc(const dcd_tree_handle_t handle, const ocsd_vaddr_t address, const ocsd_mem_space_acc_t mem_space, const char *filepath);
+
+/*!
+ * Add a memory mapped binary file based memory range accessor to the decode tree.
+ *
+ * As ocsd_dt_add_binfile_region_mem_acc(), but the file is mapped into memory and 
+ * reads for each region are served directly from the mapping.
+ *
+ * @param handle : Handle to decode tree.
+ * @param region_list : Array of memory regions in the file.
+ * @param num_regions : Size of region array
+ * @param mem_space : Associated memory space.
+ * @param *filepath : Path to binary data file.
+ *
+ * @return ocsd_err_t  : Library error code -  RCDTL_OK if successful.
+ */
+OCSD_C_API ocsd_err_t ocsd_dt_add_binfile_region_mmap_mem_acc(const dcd_tree_handle_t handle, const ocsd_file_mem_region_t *region_array, const int num_regions, const ocsd_mem_space_acc_t mem_space, const char *filepath);
+
 /*!
  * Add a memory buffer based memory range accessor to the decode tree.
  *
@@ -340,6 +599,32 @@ OCSD_C_API ocsd_err_t ocsd_dt_add_callback_trcid_mem_acc(const dcd_tree_handle_t
  */
 OCSD_C_API ocsd_err_t ocsd_dt_remove_mem_acc(const dcd_tree_handle_t handle, const ocsd_vaddr_t st_address, const ocsd_mem_space_acc_t mem_space);
 
+/*!
+ * Create a context aware memory accessor mapper for the decode tree.
+ *
+ * Accessors are selected by the context ID / VMID of the reading decoder as well as address and 
+ * memory space, allowing images for multiple processes to be mapped at the same addresses.
+ * Replaces any existing mapper - call before adding memory accessors.
+ *
+ * @param handle : Handle to decode tree.
+ *
+ * @return ocsd_err_t  : Library error code -  OCSD_OK if successful.
+ */
+OCSD_C_API ocsd_err_t ocsd_dt_create_ctxt_mem_acc_mapper(const dcd_tree_handle_t handle);
+
+/*!
+ * Set the memory context applied to memory accessors subsequently added to the decode tree.
+ *
+ * Used with a context aware mapper. Accessors added with a context ID and / or VMID are only used 
+ * when the decoder context matches. Accessors added with no context are used in all contexts.
+ *
+ * @param handle : Handle to decode tree.
+ * @param *p_ctxt : Context for new accessors. NULL to add accessors valid in any context.
+ *
+ * @return ocsd_err_t  : Library error code -  OCSD_OK if successful.
+ */
+OCSD_C_API ocsd_err_t ocsd_dt_set_mem_acc_add_ctxt(const dcd_tree_handle_t handle, const ocsd_mem_acc_ctxt_t *p_ctxt);
+
 /*
  *  Print the mapped memory accessor ranges to the configured logger.
  *
@@ -361,6 +646,29 @@ OCSD_C_API void ocsd_tl_log_mapped_mem_ranges(const dcd_tree_handle_t handle);
  */
 OCSD_C_API ocsd_err_t ocsd_dt_set_mem_acc_cacheing(const dcd_tree_handle_t handle, const int enable, const uint16_t page_size, const int nr_pages);
 
+/*
+ * Set cacheing for decoded instruction blocks - reduce memory reads and opcode decode 
+ * when PE decoders repeatedly trace the same code.
+ * 
+ * System defaults to caching disabled. Do not enable if memory callbacks may return 
+ * different data for the same address and context, unless ocsd_dt_invalidate_instr_blk_cache()
+ * is called when the data changes.
+ * 
+ * @param handle     : Handle to decode tree.
+ * @param enable     : 0 to disable caching.
+ * @param nr_entries : Number of cache entries to use (256 - 65536).
+ * 
+ * @return ocsd_err_t  : Library error code -  OCSD_OK if successful.
+ */
+OCSD_C_API ocsd_err_t ocsd_dt_set_instr_blk_cacheing(const dcd_tree_handle_t handle, const int enable, const int nr_entries);
+
+/*
+ * Drop all cached decoded instruction blocks.
+ * 
+ * @param handle     : Handle to decode tree.
+ */
+OCSD_C_API void ocsd_dt_invalidate_instr_blk_cache(const dcd_tree_handle_t handle);
+
 /** @}*/  
 
 /** @name Library Default Error Log Object API
@@ -61,6 +61,7 @@ public:
     const bool hasAtomCC() const;   //!< cycle count for current atom?
     const uint32_t getAtomCC() const;   //!< cycle count for current atom
     const uint32_t getRemainCC() const; //!< get residual cycle count for remaining atoms
+    const ocsd_pkt_atom &getRemainAtoms() const; //!< current and remaining atoms
 
     void clearAtom();   //!< clear the current atom, set the next.
     void clearAll();    //!< clear all    
@@ -108,6 +109,11 @@ inline const int Etmv3Atoms::numAtoms() const
     return m_atom.num;
 }
 
+inline const ocsd_pkt_atom &Etmv3Atoms::getRemainAtoms() const
+{
+    return m_atom;
+}
+
 inline const ocsd_trc_index_t Etmv3Atoms::pktIndex() const
 {
     return  m_root_index;
@@ -229,6 +235,8 @@ protected:
     ocsd_datapath_resp_t processISync(const bool withCC, const bool firstSync = false);
     ocsd_datapath_resp_t processBranchAddr();
     ocsd_datapath_resp_t processPHdr();
+    void coalesceAtoms(Etmv3Atoms &atoms, ocsd_isa &isa, ocsd_datapath_resp_t &resp);
+    OcsdTraceElement *getOpenRange(const ocsd_isa isa);
     
     ocsd_datapath_resp_t sendUnsyncPacket();    //!< send an initial unsync packet when decoder starts
 
@@ -238,6 +246,7 @@ private:
     void setNeedAddr(bool bNeedAddr);
     void pendExceptionReturn();
     bool preISyncValid(ocsd_etmv3_pkt_type pkt_type);
+    const bool outputCC() const;    //!< cycle counts in trace and output
 //** intra packet state;
 
     OcsdCodeFollower m_code_follower;   //!< code follower for instruction trace
@@ -251,6 +260,11 @@ private:
 
     OcsdGenElemList m_outputElemList;   //!< list of output elements
 
+    OcsdTraceElement *m_pOpenRange;     //!< last range output if not ended on a waypoint - extended when coalescing atoms.
+    ocsd_generic_trace_elem m_cancel_range; //!< range before extension with the final atom of a packet - restored on cancel.
+    OcsdTraceElement *m_pCancelRangeElem;   //!< range element the cancel state applies to.
+    bool m_bCancelRangeValid;
+
 
 //** Other packet decoder state;
 
@@ -269,6 +283,11 @@ private:
     uint8_t m_CSID; //!< Coresight trace ID for this decoder.
 };
 
+inline const bool TrcPktDecodeEtmV3::outputCC() const
+{
+    return m_config->isCycleAcc() && isElemOut(OCSD_GEN_TRC_ELEM_CYCLE_COUNT);
+}
+
 
 #endif // ARM_TRC_PKT_DECODE_ETMV3_H_INCLUDED
 
@@ -73,6 +73,7 @@ protected:
 
 
 #define ETMV3_OPFLG_UNFORMATTED_SOURCE  0x00010000 /**< Single ETM source from bypassed formatter - need to check for EOT markers */
+#define ETMV3_OPFLG_PKTDEC_COALESCE_RANGES  0x00040000 /**< Decoder: Output one range for consecutive atoms to a waypoint */
 
 /** @}*/
 
@@ -36,7 +36,7 @@
 #include "opencsd/etmv4/trc_pkt_types_etmv4.h"
 #include "opencsd/trc_gen_elem_types.h"
 
-#include <deque>
+#include <cstddef>
 #include <vector>
 
 /* ETMv4 I trace stack elements  
@@ -74,12 +74,15 @@ typedef enum _p0_elem_t
 
 /************************************************************/
 /***Trace stack element base class - 
-    record originating packet type and index in buffer*/ 
+    record originating packet type and index in buffer.
+    
+    The P0 type is the tag for the element class - elements are not polymorphic, 
+    and are cast to the derived class according to the P0 type (see p0ElemCast()).
+*/ 
 
 class TrcStackElem {
 public:
      TrcStackElem(const p0_elem_t p0_type, const bool isP0, const ocsd_etmv4_i_pkt_type root_pkt, const ocsd_trc_index_t root_index);
-     virtual ~TrcStackElem() {};
 
      const p0_elem_t getP0Type() const { return m_P0_type; };
      const ocsd_etmv4_i_pkt_type getRootPkt() const { return m_root_pkt; };
@@ -87,8 +90,8 @@ public:
      const bool isP0() const { return m_is_P0; };
 
 private:
-     ocsd_etmv4_i_pkt_type m_root_pkt;
      ocsd_trc_index_t m_root_idx;
+     ocsd_etmv4_i_pkt_type m_root_pkt;
      p0_elem_t m_P0_type;
 
 protected:
@@ -97,13 +100,19 @@ protected:
 };
 
 inline TrcStackElem::TrcStackElem(p0_elem_t p0_type, const bool isP0, ocsd_etmv4_i_pkt_type root_pkt, ocsd_trc_index_t root_index) :
-    m_root_pkt(root_pkt),
     m_root_idx(root_index),
+    m_root_pkt(root_pkt),
     m_P0_type(p0_type),
     m_is_P0(isP0)
 {
 }
 
+/* cast an element to the derived class T, using the P0 type. 0 if the element is not of class T */
+template<class T> inline T *p0ElemCast(TrcStackElem *pElem)
+{
+    return (pElem && T::isElemType(pElem->getP0Type())) ? static_cast<T *>(pElem) : 0;
+}
+
 /************************************************************/
 /** Address element */
 
@@ -112,11 +121,12 @@ class TrcStackElemAddr : public TrcStackElem
 protected:
     TrcStackElemAddr(const ocsd_etmv4_i_pkt_type root_pkt, const ocsd_trc_index_t root_index);
     TrcStackElemAddr(const ocsd_etmv4_i_pkt_type root_pkt, const ocsd_trc_index_t root_index, const bool src_addr);
-    virtual ~TrcStackElemAddr() {};
 
     friend class EtmV4P0Stack;
 
 public:
+    static const bool isElemType(const p0_elem_t p0_type) { return (p0_type == P0_ADDR) || (p0_type == P0_SRC_ADDR); };
+
     void setAddr(const etmv4_addr_val_t &addr_val) { m_addr_val = addr_val; };
     const etmv4_addr_val_t &getAddr() const { return m_addr_val; };
 
@@ -145,11 +155,12 @@ class TrcStackQElem : public TrcStackElem
 {
 protected:
     TrcStackQElem(const ocsd_etmv4_i_pkt_type root_pkt, const ocsd_trc_index_t root_index);
-    virtual ~TrcStackQElem() {};
 
     friend class EtmV4P0Stack;
 
 public:
+    static const bool isElemType(const p0_elem_t p0_type) { return p0_type == P0_Q; };
+
     void setInstrCount(const int instr_count) { m_instr_count = instr_count; };
     const int getInstrCount() const { return m_instr_count;  }
 
@@ -184,11 +195,12 @@ class TrcStackElemCtxt : public TrcStackElem
 {
 protected:
     TrcStackElemCtxt(const ocsd_etmv4_i_pkt_type root_pkt, const ocsd_trc_index_t root_index);
-    virtual ~TrcStackElemCtxt() {};
 
     friend class EtmV4P0Stack;
 
 public:
+    static const bool isElemType(const p0_elem_t p0_type) { return p0_type == P0_CTXT; };
+
     void setContext(const  etmv4_context_t &ctxt) { m_context = ctxt; };
     const  etmv4_context_t &getContext() const  { return m_context; }; 
     void setIS(const uint8_t IS) { m_IS = IS; };
@@ -211,11 +223,12 @@ class TrcStackElemExcept : public TrcStackElem
 {
 protected:
     TrcStackElemExcept(const ocsd_etmv4_i_pkt_type root_pkt, const ocsd_trc_index_t root_index);
-    virtual ~TrcStackElemExcept() {};
 
     friend class EtmV4P0Stack;
 
 public:
+    static const bool isElemType(const p0_elem_t p0_type) { return p0_type == P0_EXCEP; };
+
     void setPrevSame(bool bSame) { m_prev_addr_same = bSame; };
     const bool getPrevSame() const { return m_prev_addr_same; };
 
@@ -240,11 +253,12 @@ class TrcStackElemAtom : public TrcStackElem
 {
 protected:
     TrcStackElemAtom(const ocsd_etmv4_i_pkt_type root_pkt, const ocsd_trc_index_t root_index);
-    virtual ~TrcStackElemAtom() {};
 
     friend class EtmV4P0Stack;
 
 public:
+    static const bool isElemType(const p0_elem_t p0_type) { return p0_type == P0_ATOM; };
+
     void setAtom(const ocsd_pkt_atom &atom) { m_atom = atom; };
 
     const ocsd_atm_val commitOldest();
@@ -296,11 +310,12 @@ class TrcStackElemParam : public TrcStackElem
 {
 protected:
     TrcStackElemParam(const p0_elem_t p0_type, const bool isP0, const ocsd_etmv4_i_pkt_type root_pkt, const ocsd_trc_index_t root_index);
-    virtual ~TrcStackElemParam() {};
 
     friend class EtmV4P0Stack;
 
 public:
+    static const bool isElemType(const p0_elem_t p0_type) { return (p0_type == P0_EVENT) || (p0_type == P0_TS) || (p0_type == P0_CC) || (p0_type == P0_TS_CC); };
+
     void setParam(const uint32_t param, const int nParamNum) { m_param[(nParamNum & 0x3)] = param; };
     const uint32_t &getParam(const int nParamNum) const { return m_param[(nParamNum & 0x3)]; };
 
@@ -320,11 +335,12 @@ class TrcStackElemMarker : public TrcStackElem
 {
 protected:
     TrcStackElemMarker(const ocsd_etmv4_i_pkt_type root_pkt, const ocsd_trc_index_t root_index);
-    virtual ~TrcStackElemMarker() {};
 
     friend class EtmV4P0Stack;
 
 public:
+    static const bool isElemType(const p0_elem_t p0_type) { return p0_type == P0_MARKER; };
+
     void setMarker(const trace_marker_payload_t &marker) { m_marker = marker; };
     const trace_marker_payload_t &getMarker() const { return m_marker; };
 
@@ -345,11 +361,12 @@ class TrcStackElemITE : public TrcStackElem
 {
 protected:
     TrcStackElemITE(const ocsd_etmv4_i_pkt_type root_pkt, const ocsd_trc_index_t root_index);
-    virtual ~TrcStackElemITE() {};
 
     friend class EtmV4P0Stack;
 
 public:
+    static const bool isElemType(const p0_elem_t p0_type) { return p0_type == P0_ITE; };
+
     void setITE(const trace_sw_ite_t &ite) { m_ite = ite; };
     const trace_sw_ite_t &getITE() { return m_ite; };
 
@@ -364,11 +381,15 @@ inline TrcStackElemITE::TrcStackElemITE(const ocsd_etmv4_i_pkt_type root_pkt, co
 
 /************************************************************/
 /* P0 element stack that allows push of elements, and deletion of elements when done.
+
+   Elements are held in a ring buffer, initially sized from the speculation depth, which 
+   grows if required. Element storage is taken from a pool owned by the stack - deleted 
+   elements are returned to the pool for re-use rather than freed.
 */
 class EtmV4P0Stack
 {
 public:
-    EtmV4P0Stack() {};
+    EtmV4P0Stack();
     ~EtmV4P0Stack();
 
     void push_front(TrcStackElem *pElem);
@@ -389,6 +410,9 @@ public:
     void delete_front();
     void delete_popped();
 
+    /* set initial ring buffer size - e.g. from max speculation depth. */
+    void reserve(const size_t num_elem);
+
     // creation functions - create and push if successful.
     TrcStackElemParam *createParamElem(const p0_elem_t p0_type, const bool isP0, const ocsd_etmv4_i_pkt_type root_pkt, const ocsd_trc_index_t root_index, const std::vector<uint32_t> &params);
     TrcStackElem *createParamElemNoParam(const p0_elem_t p0_type, const bool isP0, const ocsd_etmv4_i_pkt_type root_pkt, const ocsd_trc_index_t root_index, bool back = false);
@@ -405,85 +429,146 @@ public:
     int createUnseenUncommitedP0Elem(const int n_unseen, const ocsd_etmv4_i_pkt_type root_pkt, const ocsd_trc_index_t root_index);
 
 private:
-    std::deque<TrcStackElem *> m_P0_stack;  //!< P0 decode element stack
+    /* storage for any one of the element types */
+    typedef union _elem_mem_t {
+        char base[sizeof(TrcStackElem)];
+        char addr[sizeof(TrcStackElemAddr)];
+        char q[sizeof(TrcStackQElem)];
+        char ctxt[sizeof(TrcStackElemCtxt)];
+        char except[sizeof(TrcStackElemExcept)];
+        char atom[sizeof(TrcStackElemAtom)];
+        char param[sizeof(TrcStackElemParam)];
+        char marker[sizeof(TrcStackElemMarker)];
+        char ite[sizeof(TrcStackElemITE)];
+        std::max_align_t align;
+    } elem_mem_t;
+
+    /* pool slot - element storage when allocated, free list link when not */
+    typedef union _elem_slot_t {
+        union _elem_slot_t *next;
+        elem_mem_t mem;
+    } elem_slot_t;
+
+    static const int POOL_CHUNK_SLOTS = 64;    //!< slots added to pool when free list empty.
+    static const size_t MIN_RING_SIZE = 16;
+
+    void *allocElemMem();                   //!< get storage from pool - 0 if out of memory
+    void releaseElem(TrcStackElem *pElem);  //!< destroy element and return storage to pool
+    bool growPool();
+    void growRing();
+    TrcStackElem *&at(const size_t idx);    //!< element at position from front
+
+    std::vector<TrcStackElem *> m_ring;     //!< P0 decode element stack - ring buffer, power of 2 size.
+    size_t m_ring_mask;
+    size_t m_front;                         //!< ring index of front element.
+    size_t m_count;                         //!< number of elements on the stack.
+    size_t m_iter;                          //!< iterate across the list w/o removing stuff - position from front.
+
     std::vector<TrcStackElem *> m_popped_elem;  //!< save list of popped but not deleted elements.
-    std::deque<TrcStackElem *>::iterator m_iter;    //!< iterate across the list w/o removing stuff
+
+    elem_slot_t *m_free_slots;                  //!< pool free list.
+    std::vector<elem_slot_t *> m_pool_chunks;   //!< allocated pool memory.
 };
 
-inline EtmV4P0Stack::~EtmV4P0Stack()
+inline TrcStackElem *&EtmV4P0Stack::at(const size_t idx)
 {
-    delete_all();
-    delete_popped();
+    return m_ring[(m_front + idx) & m_ring_mask];
+}
+
+inline void *EtmV4P0Stack::allocElemMem()
+{
+    elem_slot_t *pSlot;
+
+    if (!m_free_slots && !growPool())
+        return 0;
+    pSlot = m_free_slots;
+    m_free_slots = pSlot->next;
+    return pSlot;
+}
+
+inline void EtmV4P0Stack::releaseElem(TrcStackElem *pElem)
+{
+    // single inheritance from TrcStackElem - element is at the start of the slot.
+    elem_slot_t *pSlot = reinterpret_cast<elem_slot_t *>(pElem);
+
+    pElem->~TrcStackElem();
+    pSlot->next = m_free_slots;
+    m_free_slots = pSlot;
 }
 
 // put an element on the front of the stack
 inline void EtmV4P0Stack::push_front(TrcStackElem *pElem)
 {
-    m_P0_stack.push_front(pElem);
+    if (m_count == m_ring.size())
+        growRing();
+    m_front = (m_front - 1) & m_ring_mask;
+    m_ring[m_front] = pElem;
+    m_count++;
 }
 
 // put an element on the back of the stack
 inline void EtmV4P0Stack::push_back(TrcStackElem *pElem)
 {
-    m_P0_stack.push_back(pElem);
+    if (m_count == m_ring.size())
+        growRing();
+    at(m_count) = pElem;
+    m_count++;
 }
 
 // pop last element pointer off the stack and stash it for later deletion
 inline void EtmV4P0Stack::pop_back(bool pend_delete /* = true */)
 {
     if (pend_delete)
-        m_popped_elem.push_back(m_P0_stack.back());
-    m_P0_stack.pop_back();
+        m_popped_elem.push_back(back());
+    m_count--;
 }
 
 inline void EtmV4P0Stack::pop_front(bool pend_delete /* = true */)
 {
     if (pend_delete)
-        m_popped_elem.push_back(m_P0_stack.front());
-    m_P0_stack.pop_front();
+        m_popped_elem.push_back(front());
+    m_front = (m_front + 1) & m_ring_mask;
+    m_count--;
 }
 
 // pop last element pointer off the stack and delete immediately
 inline void EtmV4P0Stack::delete_back()
 {
-    if (m_P0_stack.size() > 0)
+    if (m_count > 0)
     {
-        TrcStackElem* pElem = m_P0_stack.back();
-        delete pElem;
-        m_P0_stack.pop_back();
+        releaseElem(back());
+        m_count--;
     }
 }
 
 // pop first element pointer off the stack and delete immediately
 inline void EtmV4P0Stack::delete_front()
 {
-    if (m_P0_stack.size() > 0)
+    if (m_count > 0)
     {
-        TrcStackElem* pElem = m_P0_stack.front();
-        delete pElem;
-        m_P0_stack.pop_front();
+        releaseElem(front());
+        m_front = (m_front + 1) & m_ring_mask;
+        m_count--;
     }
 }
 
-
-
 // get a pointer to the last element on the stack
 inline TrcStackElem *EtmV4P0Stack::back()
 {
-    return m_P0_stack.back();
+    return at(m_count - 1);
 }
 
 inline TrcStackElem *EtmV4P0Stack::front()
 {
-    return m_P0_stack.front();
+    return m_ring[m_front];
 }
 
 // remove and delete all the elements left on the stack
 inline void EtmV4P0Stack::delete_all()
 {
-    while (m_P0_stack.size() > 0)
+    while (m_count > 0)
         delete_back();
-    m_P0_stack.clear();
+    m_front = 0;
 }
 
 // delete list of popped elements.
@@ -491,16 +576,15 @@ inline void EtmV4P0Stack::delete_popped()
 {
     while (m_popped_elem.size() > 0)
     {
-        delete m_popped_elem.back();
+        releaseElem(m_popped_elem.back());
         m_popped_elem.pop_back();
     }
-    m_popped_elem.clear();
 }
 
 // get current number of elements on the stack
 inline size_t EtmV4P0Stack::size()
 {
-    return m_P0_stack.size();
+    return m_count;
 }
 
 #endif // ARM_TRC_ETMV4_STACK_ELEM_H_INCLUDED
@@ -166,6 +166,9 @@ private:
 
     ocsd_mem_space_acc_t getCurrMemSpace();
 
+    // context updated - invalidate memory access caching if the memory access context changed.
+    void updateMemAccContext();
+
 //** intra packet state (see ETMv4 spec 6.2.1);
 
     // timestamping
@@ -177,6 +180,7 @@ private:
     uint32_t m_vmid_id;                 // most recent VMID
     bool m_is_secure;                   // true if Secure
     bool m_is_64bit;                    // true if 64 bit
+    ocsd_pe_context m_pe_context;       // current context - supplied on memory accesses
     uint8_t m_last_IS;                  // last instruction set value from address packet.
 
     // cycle counts 
@@ -294,6 +298,11 @@ private:
     bool m_range_cont_chk;
     bool m_br_check_no_thumb;
 
+    // strobed trace - the context is repeated at the start of each trace window.
+    bool m_strobed_trace;
+    bool m_mem_acc_ctxt_valid;          // context in use since last memory access cache invalidate.
+    ocsd_pe_context m_mem_acc_ctxt;     // kept over decoder reset for strobed trace window restarts.
+
 //** output element handling
     OcsdGenElemStack m_out_elem;  //!< output element stack.
     OcsdTraceElement &outElem() { return m_out_elem.getCurrElem(); };   //!< current  out element
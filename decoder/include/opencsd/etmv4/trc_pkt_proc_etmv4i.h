@@ -79,6 +79,7 @@ protected:
     process_state m_process_state;
 
     void InitPacketState();      // clear current packet state.
+    ocsd_datapath_resp_t outputAtomRun();   // output single byte atom packets directly from the input.
     void InitProcessorState();   // clear all previous process state
 
     /** packet processor configuration **/
@@ -162,6 +163,7 @@ private:
     ocsd_datapath_resp_t outputUnsyncedRawPacket(); 
 
     void iNotSync(const uint8_t lastByte);      // not synced yet
+    void iNotSyncScan();                        // move unsynced data up to the next possible A-sync
     void iPktNoPayload(const uint8_t lastByte); // process a single byte packet
     void iPktReserved(const uint8_t lastByte);  // deal with reserved header value
     void iPktExtension(const uint8_t lastByte);
@@ -201,7 +203,10 @@ private:
 
     void BuildIPacketTable();
 
-    void throwBadSequenceError(const char *pszExtMsg);
+    /* bad packet errors - set the error packet type, record the error and move to PROC_ERR */
+    void setBadSequenceError(const char *pszExtMsg);
+    void setBadHeaderError();
+    ocsd_datapath_resp_t processPktError();   // log the recorded error and send the bad packet.
 };
 
 
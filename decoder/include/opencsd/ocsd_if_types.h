@@ -136,6 +136,10 @@ typedef enum _ocsd_err_t {
     OCSD_ERR_INVALID_OPCODE,            /**< 44 Opcode found while decoding program memory is illegal */
     OCSD_ERR_I_RANGE_LIMIT_OVERRUN,     /**< 45 An optional limit on consecutive instructions in range during decode has been exceeded. */
     OCSD_ERR_BAD_DECODE_IMAGE,          /**< 46 Inconsistencies detected between trace and decode image (e.g. not taken unconditional instructions) */
+    /* trace indexing */
+    OCSD_ERR_SYNC_IDX_FILE,             /**< 47 Sync index file could not be opened, or is not a valid sync index */
+    /* profile output */
+    OCSD_ERR_PROFILE_FILE,              /**< 48 Profile output file could not be opened or written */
     /* end marker*/
     OCSD_ERR_LAST
 } ocsd_err_t;
@@ -242,7 +246,8 @@ typedef enum _ocsd_dcd_tree_src_t {
 #define OCSD_DFRMTR_PACKED_RAW_OUT     0x08 /**< Deformatter Config : output raw packed frame data if raw monitor attached. */
 #define OCSD_DFRMTR_UNPACKED_RAW_OUT   0x10 /**< Deformatter Config : output raw unpacked frame data if raw monitor attached. */
 #define OCSD_DFRMTR_RESET_ON_4X_FSYNC  0x20 /**< Deformatter Config : reset downstream decoders if frame aligned 4x consecutive fsyncs spotted. (perf workaround) */
-#define OCSD_DFRMTR_VALID_MASK         0x3F /**< Deformatter Config : valid mask for deformatter configuration */
+#define OCSD_DFRMTR_ID_RUNS            0x40 /**< Deformatter Config : memory aligned frames - collate data for an ID across frames and output as a single run. Packet indexes within a run are approximate - sync indexing and seek are not available. */
+#define OCSD_DFRMTR_VALID_MASK         0x7F /**< Deformatter Config : valid mask for deformatter configuration */
 
 #define OCSD_DFRMTR_FRAME_SIZE         0x10 /**< CoreSight frame formatter frame size constant in bytes. */
 
@@ -443,6 +448,18 @@ typedef enum _ocsd_mem_space_acc_t {
     OCSD_MEM_SPACE_ANY  = 0xFF, /**< Any sec level / EL - live system use current EL + sec state */
 } ocsd_mem_space_acc_t;
 
+/** Memory context for a memory accessor, used by context aware memory mappers.
+ 
+    Accessors with a valid context ID and / or VMID are only used when the current PE context of 
+    the reading decoder matches. Accessors with neither value valid are used in all contexts.
+*/
+typedef struct _ocsd_mem_acc_ctxt {
+    uint32_t context_id;    /**< context ID to match */
+    uint32_t vmid;          /**< VMID to match */
+    uint8_t ctxt_id_valid;  /**< 1 if context ID is matched */
+    uint8_t vmid_valid;     /**< 1 if VMID is matched */
+} ocsd_mem_acc_ctxt_t;
+
 /**
  * Callback function definition for callback function memory accessor type.
  *
@@ -699,6 +716,34 @@ typedef struct _ocsd_decode_stats {
 
 /** @}*/
 
+/** @name Trace Sync Index
+
+    Sync index entries record the points in a trace capture where decode of a trace ID can be
+    restarted, with the nearest timestamp for that ID.
+
+@{*/
+
+/** Type of sync point recorded in the sync index */
+typedef enum _ocsd_sync_idx_type_t {
+    OCSD_SYNC_IDX_ASYNC,    /**< STM / ITM ASYNC packet. */
+    OCSD_SYNC_IDX_TINFO,    /**< ETMv4 / ETE A-sync followed by TraceInfo. */
+    OCSD_SYNC_IDX_ISYNC,    /**< PTM / ETMv3 A-sync followed by I-sync. */
+} ocsd_sync_idx_type_t;
+
+#define OCSD_SYNC_IDX_FLG_TS_VALID 0x01 /**< Sync index entry : timestamp value is valid. */
+
+typedef struct _ocsd_sync_idx_entry_t {
+    uint64_t pkt_index;     /**< trace index of the sync packet - the A-sync for ETM / PTM protocols */
+    uint64_t restart_index; /**< trace index to restart input data - start of the frame containing the sync packet */
+    uint64_t timestamp;     /**< nearest timestamp - first after the sync point, or last before if none follow */
+    uint8_t trc_id;         /**< CoreSight trace ID */
+    uint8_t type;           /**< sync point type - ocsd_sync_idx_type_t */
+    uint8_t flags;          /**< OCSD_SYNC_IDX_FLG_ flags */
+    uint8_t reserved;
+} ocsd_sync_idx_entry_t;
+
+/** @}*/
+
 
 /** @}*/
 #endif // ARM_OCSD_IF_TYPES_H_INCLUDED
@@ -168,9 +168,10 @@ protected:
     ocsd_isa m_addrPktIsa; //!< ISA of the branch address packet
     int m_excepAltISA;      //!< Alt ISA bit iff exception bytes
 
-    // bad packets 
-    void throwMalformedPacketErr(const char *pszErrMsg);
-    void throwPacketHeaderErr(const char *pszErrMsg);
+    // bad packets - set the error packet type and record the error for the processing loop.
+    void setMalformedPacketErr(const char *pszErrMsg);
+    void setPacketHeaderErr(const char *pszErrMsg);
+    ocsd_datapath_resp_t processPktError();   // log the recorded error and send the bad packet.
 
 
     // packet processing function table
@@ -191,15 +192,15 @@ inline const bool TrcPktProcPtm::isSync() const
     return (bool)(m_curr_packet.getType() == PTM_PKT_NOTSYNC);
 }
 
-inline void TrcPktProcPtm::throwMalformedPacketErr(const char *pszErrMsg)
+inline void TrcPktProcPtm::setMalformedPacketErr(const char *pszErrMsg)
 {
     m_curr_packet.SetErrType(PTM_PKT_BAD_SEQUENCE);
-    throw ocsdError(OCSD_ERR_SEV_ERROR,OCSD_ERR_BAD_PACKET_SEQ,m_curr_pkt_index,m_chanIDCopy,pszErrMsg);
+    setPktError(OCSD_ERR_BAD_PACKET_SEQ,m_curr_pkt_index,m_chanIDCopy,pszErrMsg);
 }
 
-inline void TrcPktProcPtm::throwPacketHeaderErr(const char *pszErrMsg)
+inline void TrcPktProcPtm::setPacketHeaderErr(const char *pszErrMsg)
 {
-    throw ocsdError(OCSD_ERR_SEV_ERROR,OCSD_ERR_INVALID_PCKT_HDR,m_curr_pkt_index,m_chanIDCopy,pszErrMsg);
+    setPktError(OCSD_ERR_INVALID_PCKT_HDR,m_curr_pkt_index,m_chanIDCopy,pszErrMsg);
 }
 
 inline const bool TrcPktProcPtm::readByte()
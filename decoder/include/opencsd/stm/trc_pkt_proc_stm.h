@@ -84,8 +84,9 @@ private:
     ocsd_datapath_resp_t outputPacket();   //!< send packet on output 
     void sendPacket();                      //!< mark packet for send.
     void setProcUnsynced();                 //!< set processor state to unsynced
-    void throwBadSequenceError(const char *pszMessage = "");
-    void throwReservedHdrError(const char *pszMessage = "");
+    void setBadSequenceError(const char *pszMessage = "");  //!< mark bad packet and record error for the processing loop
+    void setReservedHdrError(const char *pszMessage = "");
+    ocsd_datapath_resp_t processPktError(); //!< log the recorded error and handle the bad packet.
 
     // packet processing routines
     // 1 nibble opcodes
@@ -156,6 +157,7 @@ private:
     // read a nibble from the input data - may read a byte and set spare or return spare.
     // handles setting up packet data block and end of input 
     bool readNibble();
+    void skipNotSyncBytes();
 
     const bool dataToProcess() const;       //!< true if data to process, or packet to send
 
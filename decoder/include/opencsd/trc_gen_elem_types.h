@@ -68,6 +68,22 @@ typedef enum _ocsd_gen_trc_elem_t
     OCSD_GEN_TRC_ELEM_CUSTOM,          /*!< Fully custom packet type - used by none-ARM architecture decoders */
 } ocsd_gen_trc_elem_t;
 
+/** Element type output mask - one bit per ocsd_gen_trc_elem_t value. Decoders do not build masked out element types. */
+#define OCSD_GEN_TRC_ELEM_MASK(elem_type) (((uint32_t)1) << (elem_type))
+#define OCSD_GEN_TRC_ELEM_MASK_ALL 0xFFFFFFFF  /**< default - output all element types */
+
+/** element types used by AutoFDO profile aggregation */
+#define OCSD_GEN_TRC_ELEM_MASK_AFDO (OCSD_GEN_TRC_ELEM_MASK(OCSD_GEN_TRC_ELEM_NO_SYNC) | \
+                                     OCSD_GEN_TRC_ELEM_MASK(OCSD_GEN_TRC_ELEM_TRACE_ON) | \
+                                     OCSD_GEN_TRC_ELEM_MASK(OCSD_GEN_TRC_ELEM_EO_TRACE) | \
+                                     OCSD_GEN_TRC_ELEM_MASK(OCSD_GEN_TRC_ELEM_PE_CONTEXT) | \
+                                     OCSD_GEN_TRC_ELEM_MASK(OCSD_GEN_TRC_ELEM_INSTR_RANGE) | \
+                                     OCSD_GEN_TRC_ELEM_MASK(OCSD_GEN_TRC_ELEM_I_RANGE_NOPATH) | \
+                                     OCSD_GEN_TRC_ELEM_MASK(OCSD_GEN_TRC_ELEM_ADDR_NACC) | \
+                                     OCSD_GEN_TRC_ELEM_MASK(OCSD_GEN_TRC_ELEM_ADDR_UNKNOWN) | \
+                                     OCSD_GEN_TRC_ELEM_MASK(OCSD_GEN_TRC_ELEM_EXCEPTION) | \
+                                     OCSD_GEN_TRC_ELEM_MASK(OCSD_GEN_TRC_ELEM_EXCEPTION_RET))
+
 
 typedef enum _trace_on_reason_t {
     TRACE_ON_NORMAL = 0,    /**< Trace on at start of trace or filtering discontinuity */
@@ -177,6 +193,13 @@ typedef struct _ocsd_generic_trace_elem {
 
 } ocsd_generic_trace_elem;
 
+/** Generic element batch entry - element with source index and trace ID, as delivered by batch output. */
+typedef struct _ocsd_gen_elem_batch_entry {
+    ocsd_trc_index_t index_sop;     /**< Trace index for start of packet generating this element. */
+    uint8_t trc_chan_id;            /**< CoreSight Trace ID for this source. */
+    ocsd_generic_trace_elem elem;   /**< Copy of the generic element */
+} ocsd_gen_elem_batch_entry_t;
+
 
 typedef enum _event_t {
     EVENT_UNKNOWN = 0,
@@ -113,8 +113,11 @@ OCSD_C_API void ocsd_destroy_dcd_tree(const dcd_tree_handle_t handle)
 {
     if(handle != C_API_INVALID_TREE_HANDLE)
     {
+        GenTraceElemBatchCBObj * pBatchIf = (GenTraceElemBatchCBObj *)(((DecodeTree *)handle)->getGenTraceElemBatchOutI());
         GenTraceElemCBObj * pIf = (GenTraceElemCBObj *)(((DecodeTree *)handle)->getGenTraceElemOutI());
-        if(pIf != 0)
+        if(pBatchIf != 0)
+            delete pBatchIf;
+        else if(pIf != 0)
             delete pIf;
 
         /* need to clear any associated callback data. */
@@ -257,12 +260,19 @@ OCSD_C_API ocsd_err_t ocsd_dt_set_gen_elem_outfn(const dcd_tree_handle_t handle,
 
     GenTraceElemCBObj * pCBObj = new (std::nothrow)GenTraceElemCBObj(pFn, p_context);
     ITrcGenElemIn* pCurrIF;
+    ITrcGenElemBatchIn* pCurrBatchIF;
 
     if(pCBObj)
     {
         /* delete any previous element we might have set */
+        pCurrBatchIF = ((DecodeTree*)handle)->getGenTraceElemBatchOutI();
         pCurrIF = ((DecodeTree*)handle)->getGenTraceElemOutI();
-        if (pCurrIF)
+        if (pCurrBatchIF)
+        {
+            ((DecodeTree*)handle)->setGenTraceElemBatchOutI(0);
+            delete static_cast<GenTraceElemBatchCBObj*>(pCurrBatchIF);
+        }
+        else if (pCurrIF)
             delete static_cast<GenTraceElemCBObj*>(pCurrIF);
 
         /* set the new one */
@@ -272,6 +282,174 @@ OCSD_C_API ocsd_err_t ocsd_dt_set_gen_elem_outfn(const dcd_tree_handle_t handle,
     return OCSD_ERR_MEM;
 }
 
+OCSD_C_API ocsd_err_t ocsd_dt_set_gen_elem_batch_outfn(const dcd_tree_handle_t handle, FnTraceElemBatchIn pFn, const void *p_context, const uint32_t batch_size)
+{
+    GenTraceElemBatchCBObj* pCBObj;
+    ITrcGenElemIn* pCurrIF;
+    ITrcGenElemBatchIn* pCurrBatchIF;
+    ocsd_err_t err;
+
+    if ((handle == C_API_INVALID_TREE_HANDLE) || !pFn)
+        return OCSD_ERR_INVALID_PARAM_VAL;
+
+    pCBObj = new (std::nothrow) GenTraceElemBatchCBObj(pFn, p_context);
+    if (!pCBObj)
+        return OCSD_ERR_MEM;
+
+    /* note any previous element we might have set */
+    pCurrBatchIF = ((DecodeTree*)handle)->getGenTraceElemBatchOutI();
+    pCurrIF = ((DecodeTree*)handle)->getGenTraceElemOutI();
+
+    /* set the new one */
+    err = ((DecodeTree*)handle)->setGenTraceElemBatchOutI(pCBObj, batch_size);
+    if (err != OCSD_OK)
+    {
+        delete pCBObj;
+        return err;
+    }
+
+    /* delete the previous element */
+    if (pCurrBatchIF)
+        delete static_cast<GenTraceElemBatchCBObj*>(pCurrBatchIF);
+    else if (pCurrIF)
+        delete static_cast<GenTraceElemCBObj*>(pCurrIF);
+    return OCSD_OK;
+}
+
+OCSD_C_API ocsd_err_t ocsd_dt_set_gen_elem_out_mask(const dcd_tree_handle_t handle, const uint32_t elem_mask)
+{
+    if (handle == C_API_INVALID_TREE_HANDLE)
+        return OCSD_ERR_INVALID_PARAM_VAL;
+    static_cast<DecodeTree*>(handle)->setGenElemOutMask(elem_mask);
+    return OCSD_OK;
+}
+
+OCSD_C_API ocsd_err_t ocsd_dt_set_threaded_decode(const dcd_tree_handle_t handle, const int enable, const uint32_t queue_size)
+{
+    if (handle == C_API_INVALID_TREE_HANDLE)
+        return OCSD_ERR_INVALID_PARAM_VAL;
+    return static_cast<DecodeTree*>(handle)->setThreadedDecode(enable == 0 ? false : true, queue_size);
+}
+
+OCSD_C_API ocsd_err_t ocsd_dt_set_chunked_decode(const dcd_tree_handle_t handle, const unsigned char CSID, const int enable, const uint32_t num_threads, const uint32_t chunk_size)
+{
+    if (handle == C_API_INVALID_TREE_HANDLE)
+        return OCSD_ERR_INVALID_PARAM_VAL;
+    return static_cast<DecodeTree*>(handle)->setChunkedDecode(CSID, enable == 0 ? false : true, num_threads, chunk_size);
+}
+
+OCSD_C_API ocsd_err_t ocsd_dt_set_sync_indexing(const dcd_tree_handle_t handle, const int enable)
+{
+    if (handle == C_API_INVALID_TREE_HANDLE)
+        return OCSD_ERR_INVALID_PARAM_VAL;
+    return static_cast<DecodeTree*>(handle)->setSyncIndexing(enable == 0 ? false : true);
+}
+
+OCSD_C_API ocsd_err_t ocsd_dt_get_sync_index(const dcd_tree_handle_t handle, const ocsd_sync_idx_entry_t **p_entries, uint64_t *num_entries)
+{
+    if ((handle == C_API_INVALID_TREE_HANDLE) || !p_entries || !num_entries)
+        return OCSD_ERR_INVALID_PARAM_VAL;
+
+    TrcSyncIndexer *pIndexer = static_cast<DecodeTree*>(handle)->getSyncIndexer();
+    if (!pIndexer)
+        return OCSD_ERR_NOT_INIT;
+
+    const std::vector<ocsd_sync_idx_entry_t> &entries = pIndexer->getEntries();
+    *p_entries = entries.size() ? &entries[0] : 0;
+    *num_entries = entries.size();
+    return OCSD_OK;
+}
+
+OCSD_C_API ocsd_err_t ocsd_dt_save_sync_index(const dcd_tree_handle_t handle, const char *filename)
+{
+    if ((handle == C_API_INVALID_TREE_HANDLE) || !filename)
+        return OCSD_ERR_INVALID_PARAM_VAL;
+
+    TrcSyncIndexer *pIndexer = static_cast<DecodeTree*>(handle)->getSyncIndexer();
+    if (!pIndexer)
+        return OCSD_ERR_NOT_INIT;
+    return pIndexer->saveIndex(filename);
+}
+
+OCSD_C_API ocsd_err_t ocsd_dt_load_sync_index(const dcd_tree_handle_t handle, const char *filename)
+{
+    if ((handle == C_API_INVALID_TREE_HANDLE) || !filename)
+        return OCSD_ERR_INVALID_PARAM_VAL;
+    return static_cast<DecodeTree*>(handle)->loadSyncIndex(filename);
+}
+
+OCSD_C_API ocsd_err_t ocsd_dt_seek_index(const dcd_tree_handle_t handle, const ocsd_trc_index_t target_index, const uint8_t cs_id, ocsd_trc_index_t *restart_index)
+{
+    if ((handle == C_API_INVALID_TREE_HANDLE) || !restart_index)
+        return OCSD_ERR_INVALID_PARAM_VAL;
+    return static_cast<DecodeTree*>(handle)->seekToIndex(target_index, *restart_index, cs_id);
+}
+
+OCSD_C_API ocsd_err_t ocsd_dt_seek_timestamp(const dcd_tree_handle_t handle, const uint64_t timestamp, const uint8_t cs_id, ocsd_trc_index_t *restart_index)
+{
+    if ((handle == C_API_INVALID_TREE_HANDLE) || !restart_index)
+        return OCSD_ERR_INVALID_PARAM_VAL;
+    return static_cast<DecodeTree*>(handle)->seekToTimestamp(timestamp, *restart_index, cs_id);
+}
+
+OCSD_C_API ocsd_err_t ocsd_dt_set_ring_buf_input(const dcd_tree_handle_t handle, const uint8_t *p_buffer, const uint64_t buffer_size, const volatile uint64_t *p_head, volatile uint64_t *p_tail)
+{
+    if (handle == C_API_INVALID_TREE_HANDLE)
+        return OCSD_ERR_INVALID_PARAM_VAL;
+    return static_cast<DecodeTree*>(handle)->setRingBufferInput(p_buffer, buffer_size, p_head, p_tail);
+}
+
+OCSD_C_API ocsd_datapath_resp_t ocsd_dt_process_ring_buf(const dcd_tree_handle_t handle)
+{
+    if (handle == C_API_INVALID_TREE_HANDLE)
+        return OCSD_RESP_FATAL_NOT_INIT;
+    return static_cast<DecodeTree*>(handle)->processRingBuffer();
+}
+
+OCSD_C_API ocsd_err_t ocsd_dt_ring_buf_data_lost(const dcd_tree_handle_t handle)
+{
+    if (handle == C_API_INVALID_TREE_HANDLE)
+        return OCSD_ERR_INVALID_PARAM_VAL;
+    TrcRingBufferIn *pRingBuf = static_cast<DecodeTree*>(handle)->getRingBufferIn();
+    if (!pRingBuf)
+        return OCSD_ERR_NOT_INIT;
+    pRingBuf->setDataLost();
+    return OCSD_OK;
+}
+
+OCSD_C_API ocsd_err_t ocsd_dt_get_ring_buf_stats(const dcd_tree_handle_t handle, uint64_t *read_pos, uint64_t *bytes_lost, uint32_t *num_discont)
+{
+    if ((handle == C_API_INVALID_TREE_HANDLE) || !read_pos || !bytes_lost || !num_discont)
+        return OCSD_ERR_INVALID_PARAM_VAL;
+    TrcRingBufferIn *pRingBuf = static_cast<DecodeTree*>(handle)->getRingBufferIn();
+    if (!pRingBuf)
+        return OCSD_ERR_NOT_INIT;
+    *read_pos = pRingBuf->getReadPos();
+    *bytes_lost = pRingBuf->getBytesLost();
+    *num_discont = pRingBuf->getNumDiscontinuities();
+    return OCSD_OK;
+}
+
+OCSD_C_API ocsd_err_t ocsd_dt_set_afdo_profiling(const dcd_tree_handle_t handle, const int enable)
+{
+    if (handle == C_API_INVALID_TREE_HANDLE)
+        return OCSD_ERR_INVALID_PARAM_VAL;
+    return static_cast<DecodeTree*>(handle)->setAutoFdoProfiling(enable == 0 ? false : true);
+}
+
+OCSD_C_API ocsd_err_t ocsd_dt_save_afdo_profile(const dcd_tree_handle_t handle, const char *filename)
+{
+    if ((handle == C_API_INVALID_TREE_HANDLE) || !filename)
+        return OCSD_ERR_INVALID_PARAM_VAL;
+    return static_cast<DecodeTree*>(handle)->saveAutoFdoProfile(filename);
+}
+
+OCSD_C_API ocsd_err_t ocsd_dt_set_afdo_ctxt_filter(const dcd_tree_handle_t handle, const ocsd_mem_acc_ctxt_t *p_filter)
+{
+    if (handle == C_API_INVALID_TREE_HANDLE)
+        return OCSD_ERR_INVALID_PARAM_VAL;
+    return static_cast<DecodeTree*>(handle)->setAutoFdoContextFilter(p_filter);
+}
 
 /*** Default error logging */
 
@@ -413,6 +591,26 @@ OCSD_C_API ocsd_err_t ocsd_dt_add_binfile_region_mem_acc(const dcd_tree_handle_t
     return err;
 }
 
+OCSD_C_API ocsd_err_t ocsd_dt_add_binfile_mmap_mem_acc(const dcd_tree_handle_t handle, const ocsd_vaddr_t address, const ocsd_mem_space_acc_t mem_space, const char *filepath)
+{
+    ocsd_err_t err = OCSD_OK;
+    DecodeTree *pDT;
+    err = ocsd_check_and_add_mem_acc_mapper(handle,&pDT);
+    if(err == OCSD_OK)
+        err = pDT->addBinFileMemAcc(address,mem_space,filepath,true);
+    return err;
+}
+
+OCSD_C_API ocsd_err_t ocsd_dt_add_binfile_region_mmap_mem_acc(const dcd_tree_handle_t handle, const ocsd_file_mem_region_t *region_array, const int num_regions, const ocsd_mem_space_acc_t mem_space, const char *filepath)
+{
+    ocsd_err_t err = OCSD_OK;
+    DecodeTree *pDT;
+    err = ocsd_check_and_add_mem_acc_mapper(handle,&pDT);
+    if(err == OCSD_OK)
+        err = pDT->addBinFileRegionMemAcc(region_array,num_regions,mem_space,filepath,true);
+    return err;
+}
+
 OCSD_C_API ocsd_err_t ocsd_dt_add_buffer_mem_acc(const dcd_tree_handle_t handle, const ocsd_vaddr_t address, const ocsd_mem_space_acc_t mem_space, const uint8_t *p_mem_buffer, const uint32_t mem_length)
 {
     ocsd_err_t err = OCSD_OK;
@@ -458,6 +656,34 @@ OCSD_C_API ocsd_err_t ocsd_dt_remove_mem_acc(const dcd_tree_handle_t handle, con
     return err;
 }
 
+OCSD_C_API ocsd_err_t ocsd_dt_create_ctxt_mem_acc_mapper(const dcd_tree_handle_t handle)
+{
+    ocsd_err_t err = OCSD_OK;
+
+    if(handle != C_API_INVALID_TREE_HANDLE)
+    {
+        DecodeTree *pDT = static_cast<DecodeTree *>(handle);
+        err = pDT->createMemAccMapper(MEMACC_MAP_CTXT);
+    }
+    else
+        err = OCSD_ERR_INVALID_PARAM_VAL;
+    return err;
+}
+
+OCSD_C_API ocsd_err_t ocsd_dt_set_mem_acc_add_ctxt(const dcd_tree_handle_t handle, const ocsd_mem_acc_ctxt_t *p_ctxt)
+{
+    ocsd_err_t err = OCSD_OK;
+
+    if(handle != C_API_INVALID_TREE_HANDLE)
+    {
+        DecodeTree *pDT = static_cast<DecodeTree *>(handle);
+        pDT->setMemAccAddContext(p_ctxt);
+    }
+    else
+        err = OCSD_ERR_INVALID_PARAM_VAL;
+    return err;
+}
+
 OCSD_C_API void ocsd_tl_log_mapped_mem_ranges(const dcd_tree_handle_t handle)
 {
     if(handle != C_API_INVALID_TREE_HANDLE)
@@ -482,6 +708,27 @@ OCSD_C_API ocsd_err_t ocsd_dt_set_mem_acc_cacheing(const dcd_tree_handle_t handl
     return err;
 }
 
+OCSD_C_API ocsd_err_t ocsd_dt_set_instr_blk_cacheing(const dcd_tree_handle_t handle, const int enable, const int nr_entries)
+{
+    ocsd_err_t err = OCSD_OK;
+
+    if (handle != C_API_INVALID_TREE_HANDLE)
+    {
+        DecodeTree* pDT = static_cast<DecodeTree*>(handle);
+        err = pDT->setInstrBlockCacheing(enable == 0 ? false : true, nr_entries);
+    }
+    else
+        err = OCSD_ERR_INVALID_PARAM_VAL;
+
+    return err;
+}
+
+OCSD_C_API void ocsd_dt_invalidate_instr_blk_cache(const dcd_tree_handle_t handle)
+{
+    if (handle != C_API_INVALID_TREE_HANDLE)
+        static_cast<DecodeTree*>(handle)->invalidateInstrBlockCache();
+}
+
 OCSD_C_API void ocsd_gen_elem_init(ocsd_generic_trace_elem *p_pkt, const ocsd_gen_trc_elem_t elem_type)
 {
     p_pkt->elem_type = elem_type;
@@ -667,4 +914,16 @@ ocsd_datapath_resp_t GenTraceElemCBObj::TraceElemIn(const ocsd_trc_index_t index
     return m_c_api_cb_fn(m_p_cb_context, index_sop, trc_chan_id, &elem);
 }
 
+GenTraceElemBatchCBObj::GenTraceElemBatchCBObj(FnTraceElemBatchIn pCBFn, const void *p_context) :
+    m_c_api_cb_fn(pCBFn),
+    m_p_cb_context(p_context)
+{
+}
+
+ocsd_datapath_resp_t GenTraceElemBatchCBObj::TraceElemBatchIn(const ocsd_gen_elem_batch_entry_t *p_elems,
+                                                              const uint32_t num_elem)
+{
+    return m_c_api_cb_fn(m_p_cb_context, p_elems, num_elem);
+}
+
 /* End of File ocsd_c_api.cpp */
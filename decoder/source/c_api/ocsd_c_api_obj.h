@@ -34,6 +34,20 @@ private:
     const void *m_p_cb_context;
 };
 
+class GenTraceElemBatchCBObj : public ITrcGenElemBatchIn
+{
+public:
+    GenTraceElemBatchCBObj(FnTraceElemBatchIn pCBFn, const void *p_context);
+    virtual ~GenTraceElemBatchCBObj() {};
+
+    virtual ocsd_datapath_resp_t TraceElemBatchIn(const ocsd_gen_elem_batch_entry_t *p_elems,
+                                                   const uint32_t num_elem);
+
+private:
+    FnTraceElemBatchIn m_c_api_cb_fn;
+    const void *m_p_cb_context;
+};
+
 
 
 template<class TrcPkt>
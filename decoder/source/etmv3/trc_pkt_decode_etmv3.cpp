@@ -33,6 +33,7 @@
  */ 
 
 #include "opencsd/etmv3/trc_pkt_decode_etmv3.h"
+#include "opencsd/etmv3/trc_pkt_proc_etmv3.h"
 
 #define DCD_NAME "DCD_ETMV3"
 
@@ -95,6 +96,9 @@ ocsd_datapath_resp_t TrcPktDecodeEtmV3::processPacket()
             {
                 // decode anything that might be valid - send will be set automatically 
                 resp = decodePacket(bPktDone);
+                // no elements to send if element types masked out - still waiting for ISync
+                if(m_curr_state == DECODE_PKTS)
+                    m_curr_state = WAIT_ISYNC;
             }
             else
                 bPktDone = true; 
@@ -199,11 +203,16 @@ ocsd_err_t TrcPktDecodeEtmV3::onProtocolConfig()
 // initialise on creation
 void TrcPktDecodeEtmV3::initDecoder()
 {
+    // set the operational modes supported.
+    m_supported_op_flags = ETMV3_OPFLG_PKTDEC_COALESCE_RANGES;
+
     m_CSID = 0;
     resetDecoder();
     m_unsync_info = UNSYNC_INIT_DECODER;
     m_code_follower.initInterfaces(getMemoryAccessAttachPt(),getInstrDecodeAttachPt());
-    m_outputElemList.initSendIf(getTraceElemOutAttachPt());
+    m_code_follower.setMemAccContext(&((const ocsd_pe_context &)m_PeContext));
+    m_code_follower.setMemAccSpan(&m_mem_span);
+    m_outputElemList.initSendIf(getTraceElemOutAttachPt(), &m_elem_out_mask);
 }
 
 // reset for first use / re-use.
@@ -213,6 +222,9 @@ void TrcPktDecodeEtmV3::resetDecoder()
     m_bNeedAddr = true;
     m_bSentUnknown = false;
     m_bWaitISync = false;
+    m_pOpenRange = 0;
+    m_pCancelRangeElem = 0;
+    m_bCancelRangeValid = false;
     m_outputElemList.reset();
 }
 
@@ -251,7 +263,14 @@ ocsd_datapath_resp_t TrcPktDecodeEtmV3::decodePacket(bool &pktDone)
     // only the branch address with exception and cancel element can cancel
     // if not one of those, commit immediately, otherwise defer to branch address handler.
     if(m_curr_packet_in->getType() != ETM3_PKT_BRANCH_ADDRESS)
+    {
         m_outputElemList.commitAllPendElem();
+        m_bCancelRangeValid = false;
+    }
+
+    // only consecutive atom packets extend a range.
+    if(m_curr_packet_in->getType() != ETM3_PKT_P_HDR)
+        m_pOpenRange = 0;
 
     try {
 
@@ -271,12 +290,16 @@ ocsd_datapath_resp_t TrcPktDecodeEtmV3::decodePacket(bool &pktDone)
 
     // markers for valid packets
         case ETM3_PKT_CYCLE_COUNT:
+            if(!isElemOut(OCSD_GEN_TRC_ELEM_CYCLE_COUNT))
+                break;
             pElem = GetNextOpElem(resp);
             pElem->setType(OCSD_GEN_TRC_ELEM_CYCLE_COUNT);
             pElem->setCycleCount(m_curr_packet_in->getCycleCount());
             break;
 
         case ETM3_PKT_TRIGGER:
+            if(!isElemOut(OCSD_GEN_TRC_ELEM_EVENT))
+                break;
             pElem = GetNextOpElem(resp);
             pElem->setType(OCSD_GEN_TRC_ELEM_EVENT);
             pElem->setEvent(EVENT_TRIGGER,0);
@@ -323,6 +346,8 @@ ocsd_datapath_resp_t TrcPktDecodeEtmV3::decodePacket(bool &pktDone)
             break;
         
         case ETM3_PKT_TIMESTAMP:
+            if(!isElemOut(OCSD_GEN_TRC_ELEM_TIMESTAMP))
+                break;
             pElem = GetNextOpElem(resp);
             pElem->setType(OCSD_GEN_TRC_ELEM_TIMESTAMP);
             pElem->setTS(m_curr_packet_in->getTS());
@@ -443,7 +468,7 @@ ocsd_datapath_resp_t TrcPktDecodeEtmV3::processISync(const bool withCC, const bo
             pElem->setISA(m_curr_packet_in->ISA());
 
             // with cycle count...
-            if(m_curr_packet_in->getISyncHasCC())
+            if(m_curr_packet_in->getISyncHasCC() && isElemOut(OCSD_GEN_TRC_ELEM_CYCLE_COUNT))
                 pElem->setCycleCount(m_curr_packet_in->getCycleCount());
 
         }
@@ -485,9 +510,20 @@ ocsd_datapath_resp_t TrcPktDecodeEtmV3::processBranchAddr()
 
     // might need to cancel something ... if the last output was an instruction range or excep return
     if(m_curr_packet_in->isExcepCancel())
-        m_outputElemList.cancelPendElem();
+    {
+        // a coalesced range drops only the last instruction.
+        if(m_bCancelRangeValid && m_outputElemList.numPendElem() && 
+           (m_outputElemList.getElem(m_outputElemList.getNumElem() - 1) == m_pCancelRangeElem))
+        {
+            *((ocsd_generic_trace_elem *)m_pCancelRangeElem) = m_cancel_range;
+            m_outputElemList.commitAllPendElem();
+        }
+        else
+            m_outputElemList.cancelPendElem();
+    }
     else         
         m_outputElemList.commitAllPendElem(); // otherwise commit any pending elements.
+    m_bCancelRangeValid = false;
 
     // record the address
     m_IAddr = m_curr_packet_in->getAddr();
@@ -552,11 +588,12 @@ ocsd_datapath_resp_t TrcPktDecodeEtmV3::processPHdr()
     ocsd_datapath_resp_t resp = OCSD_RESP_CONT;
     OcsdTraceElement *pElem = 0;
     ocsd_isa isa;
-    Etmv3Atoms atoms(m_config->isCycleAcc());
+    Etmv3Atoms atoms(outputCC());   // no cycle count accumulation if not output
 
     atoms.initAtomPkt(m_curr_packet_in,m_index_curr_pkt);
     isa = m_curr_packet_in->ISA();
     m_code_follower.setMemSpaceAccess((m_PeContext.getSecLevel() ==  ocsd_sec_secure) ? OCSD_MEM_SPACE_S : OCSD_MEM_SPACE_N);
+    m_bCancelRangeValid = false;
 
     try
     {
@@ -569,18 +606,24 @@ ocsd_datapath_resp_t TrcPktDecodeEtmV3::processPHdr()
                 // output unknown address packet or a cycle count packet
                 if(!m_bSentUnknown || m_config->isCycleAcc())
                 {
-                    pElem = GetNextOpElem(resp);
-                    if(m_bSentUnknown || !atoms.numAtoms())
-                        pElem->setType(OCSD_GEN_TRC_ELEM_CYCLE_COUNT);
-                    else
-                        pElem->setType(OCSD_GEN_TRC_ELEM_ADDR_UNKNOWN);
-                    if(m_config->isCycleAcc())
-                        pElem->setCycleCount(atoms.getRemainCC());
+                    bool bUnknown = !m_bSentUnknown && atoms.numAtoms();
+                    if(bUnknown || isElemOut(OCSD_GEN_TRC_ELEM_CYCLE_COUNT))
+                    {
+                        pElem = GetNextOpElem(resp);
+                        pElem->setType(bUnknown ? OCSD_GEN_TRC_ELEM_ADDR_UNKNOWN : OCSD_GEN_TRC_ELEM_CYCLE_COUNT);
+                        if(outputCC())
+                            pElem->setCycleCount(atoms.getRemainCC());
+                    }
                     m_bSentUnknown = true;
                 }
                 atoms.clearAll();   // skip remaining atoms
             }
-            else    // have an address, can process atoms
+            else if((getComponentOpMode() & ETMV3_OPFLG_PKTDEC_COALESCE_RANGES) && 
+                    (atoms.numAtoms() || (outputCC() && getOpenRange(isa))))
+            {
+                coalesceAtoms(atoms, isa, resp);
+            }
+            else if(atoms.numAtoms() || isElemOut(OCSD_GEN_TRC_ELEM_CYCLE_COUNT))  // have an address, can process atoms
             {
                 pElem = GetNextOpElem(resp);
                 pElem->setType(OCSD_GEN_TRC_ELEM_INSTR_RANGE);
@@ -592,7 +635,8 @@ ocsd_datapath_resp_t TrcPktDecodeEtmV3::processPHdr()
                     if(!atoms.numAtoms())   // override type if CC only
                          pElem->setType(OCSD_GEN_TRC_ELEM_CYCLE_COUNT);
                     // set cycle count
-                    pElem->setCycleCount(atoms.getAtomCC());
+                    if(outputCC())
+                        pElem->setCycleCount(atoms.getAtomCC());
                 }
 
                 // now process the atom 
@@ -663,6 +707,106 @@ ocsd_datapath_resp_t TrcPktDecodeEtmV3::processPHdr()
     return resp;
 }
 
+// last range output if not ended on a waypoint and still waiting to be sent.
+OcsdTraceElement *TrcPktDecodeEtmV3::getOpenRange(const ocsd_isa isa)
+{
+    int numElem = m_outputElemList.getNumElem();
+    if(m_pOpenRange && numElem && (m_outputElemList.getElem(numElem - 1) == m_pOpenRange) &&
+       (m_pOpenRange->en_addr == m_IAddr) && (m_pOpenRange->isa == isa))
+        return m_pOpenRange;
+    return 0;
+}
+
+// follow atoms to the next waypoint. The range extends the last range output if that 
+// did not end on a waypoint, otherwise starts a new range.
+void TrcPktDecodeEtmV3::coalesceAtoms(Etmv3Atoms &atoms, ocsd_isa &isa, ocsd_datapath_resp_t &resp)
+{
+    OcsdTraceElement *pElem = getOpenRange(isa);
+    ocsd_pkt_atom follow_atoms = atoms.getRemainAtoms();
+    ocsd_atm_val atom = ATOM_E;
+    uint32_t cycleCount = 0;
+    uint32_t numInstr;
+    bool bFinalAtom = (follow_atoms.num == 1);
+
+    // cycle count only - wait cycles are added to the open range the next atom will extend.
+    if(!follow_atoms.num)
+    {
+        pElem->setCycleCount(pElem->cycle_count + atoms.getAtomCC());
+        if(m_bCancelRangeValid)
+            m_cancel_range.cycle_count += atoms.getAtomCC();
+        return;
+    }
+
+    // the final atom in the packet is followed alone - an exception may cancel the last instruction.
+    if(!bFinalAtom)
+        follow_atoms.num--;
+
+    m_code_follower.setISA(isa);
+    m_code_follower.followNInstructions(m_IAddr, follow_atoms);
+
+    // use the atoms for the instructions followed - one if nacc on the first instruction.
+    numInstr = m_code_follower.getNumInstr() ? m_code_follower.getNumInstr() : 1;
+    for(uint32_t i = 0; i < numInstr; i++)
+    {
+        cycleCount += atoms.getAtomCC();
+        atom = atoms.getCurrAtomVal();
+        atoms.clearAtom();
+    }
+
+    if(m_code_follower.hasRange())
+    {
+        // extend the open range if it is still waiting to be sent.
+        if(pElem)
+        {
+            if(bFinalAtom)
+            {
+                m_cancel_range = *((ocsd_generic_trace_elem *)pElem);
+                m_pCancelRangeElem = pElem;
+                m_bCancelRangeValid = true;
+            }
+            pElem->setAddrRange(pElem->st_addr, m_code_follower.getRangeEn(), pElem->num_instr_range + m_code_follower.getNumInstr());
+            cycleCount += pElem->cycle_count;
+        }
+        else
+        {
+            pElem = GetNextOpElem(resp);
+            pElem->setType(OCSD_GEN_TRC_ELEM_INSTR_RANGE);
+            pElem->setAddrRange(m_IAddr, m_code_follower.getRangeEn(), m_code_follower.getNumInstr());
+            pElem->setISA(isa);
+        }
+        if(outputCC())
+            pElem->setCycleCount(cycleCount);
+        pElem->setLastInstrInfo(atom == ATOM_E, 
+                    m_code_follower.getInstrType(),
+                    m_code_follower.getInstrSubType(),m_code_follower.getInstrSize());
+        pElem->setLastInstrCond(m_code_follower.isCondInstr());
+
+        m_pOpenRange = m_code_follower.isWPFound() ? 0 : pElem;
+        if(m_code_follower.hasNextAddr())
+            m_IAddr = m_code_follower.getNextAddr();
+        else
+            setNeedAddr(true);
+    }
+
+    // next address has new ISA?
+    if(m_code_follower.ISAChanged())
+        isa = m_code_follower.nextISA();
+
+    // there is a nacc
+    if(m_code_follower.isNacc())
+    {
+        pElem = GetNextOpElem(resp);
+        pElem->setType(OCSD_GEN_TRC_ELEM_ADDR_NACC);
+        if(!m_code_follower.hasRange() && outputCC())
+            pElem->setCycleCount(cycleCount);
+        pElem->setAddrStart(m_code_follower.getNaccAddr());
+        pElem->setExceptionNum((uint32_t)m_code_follower.getMemSpaceAccess());
+        setNeedAddr(true);
+        m_code_follower.clearNacc(); // we have generated some code for the nacc.
+        m_pOpenRange = 0;
+    }
+}
+
 // if v7M -> pend only ERET, if V7A/R pend ERET and prev instr.
 void TrcPktDecodeEtmV3::pendExceptionReturn()
 {
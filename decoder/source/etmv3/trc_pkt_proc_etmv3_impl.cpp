@@ -33,6 +33,7 @@
  */ 
 
 #include "trc_pkt_proc_etmv3_impl.h"
+#include "common/trc_sync_scan.h"
 
 EtmV3PktProcImpl::EtmV3PktProcImpl() :
     m_isInit(false),
@@ -85,11 +86,13 @@ ocsd_datapath_resp_t EtmV3PktProcImpl::processData(const ocsd_trc_index_t index,
 
             case PROC_HDR:
                 m_packet_index = index +  m_bytesProcessed;
-                processHeaderByte(pDataBlock[m_bytesProcessed++]);
+                if(processHeaderByte(pDataBlock[m_bytesProcessed++]) != OCSD_OK)
+                    resp = processPktError();
                 break;
 
             case PROC_DATA:
-                processPayloadByte(pDataBlock [m_bytesProcessed++]);
+                if(processPayloadByte(pDataBlock [m_bytesProcessed++]) != OCSD_OK)
+                    resp = processPktError();
                 break;
 
             case SEND_PKT:
@@ -97,21 +100,6 @@ ocsd_datapath_resp_t EtmV3PktProcImpl::processData(const ocsd_trc_index_t index,
                 break;
             }
         }
-        catch(ocsdError &err)
-        {
-            m_interface->LogError(err);
-            if( (err.getErrorCode() == OCSD_ERR_BAD_PACKET_SEQ) ||
-                (err.getErrorCode() == OCSD_ERR_INVALID_PCKT_HDR))
-            {
-                // send invalid packets up the pipe to let the next stage decide what to do.
-                m_process_state = SEND_PKT; 
-            }
-            else
-            {
-                // bail out on any other error.
-                resp = OCSD_RESP_FATAL_INVALID_DATA;
-            }
-        }
         catch(...)
         {
             /// vv bad at this point.
@@ -126,6 +114,20 @@ ocsd_datapath_resp_t EtmV3PktProcImpl::processData(const ocsd_trc_index_t index,
     return resp;
 }
 
+ocsd_datapath_resp_t EtmV3PktProcImpl::processPktError()
+{
+    ocsd_err_t err = m_interface->logPktError();
+    if( (err == OCSD_ERR_BAD_PACKET_SEQ) ||
+        (err == OCSD_ERR_INVALID_PCKT_HDR))
+    {
+        // send invalid packets up the pipe to let the next stage decide what to do.
+        m_process_state = SEND_PKT; 
+        return OCSD_RESP_CONT;
+    }
+    // bail out on any other error.
+    return OCSD_RESP_FATAL_INVALID_DATA;
+}
+
 ocsd_datapath_resp_t EtmV3PktProcImpl::onEOT()
 {
     ocsd_datapath_resp_t resp = OCSD_RESP_CONT;
@@ -274,6 +276,18 @@ uint32_t EtmV3PktProcImpl::waitForSync(const uint32_t dataBlockSize, const uint8
         }
         else    // not seen a start of sync candidate yet
         {
+            // move bytes that cannot start an a-sync in one go, up to the unsynced packet size.
+            if((currByte != 0x00) && (m_currPacketData.size() < 15))
+            {
+                uint32_t scan_max = dataBlockSize - bytesProcessed;
+                if(scan_max > (uint32_t)(15 - m_currPacketData.size()))
+                    scan_max = (uint32_t)(15 - m_currPacketData.size());
+                uint32_t skip_bytes = TrcSyncScan::findByte(pDataBlock + bytesProcessed, scan_max, 0x00);
+                m_currPacketData.insert(m_currPacketData.end(), pDataBlock + bytesProcessed - 1, pDataBlock + bytesProcessed + skip_bytes - 1);
+                bytesProcessed += skip_bytes;
+                currByte = pDataBlock[bytesProcessed - 1];
+            }
+
             if(currByte == 0x00)  // could be the start of a-sync
             {
                 if(m_currPacketData.size() == 0)
@@ -325,13 +339,15 @@ ocsd_err_t EtmV3PktProcImpl::processHeaderByte(uint8_t by)
             if((by == 0x01) && (m_interface->getComponentOpMode() & ETMV3_OPFLG_UNFORMATTED_SOURCE))
 			{
                 // TBD: need to fix up for handling bypassed ETM stream at some point.
-                throwUnsupportedErr("Bypassed ETM stream not supported in this version of the decoder.");
+                return setUnsupportedErr("Bypassed ETM stream not supported in this version of the decoder.");
                 // could be EOTrace marker from bypassed formatter
 				m_curr_packet.SetType(ETM3_PKT_BRANCH_OR_BYPASS_EOT);
 			}
 			else
             {
                 OnBranchAddress();
+                if(pktErrorSet())
+                    return OCSD_ERR_BAD_PACKET_SEQ;
 				SendPacket();  // mark ready to send.
             }
 		}
@@ -342,7 +358,7 @@ ocsd_err_t EtmV3PktProcImpl::processHeaderByte(uint8_t by)
         if(m_curr_packet.UpdateAtomFromPHdr(by,m_config.isCycleAcc()))
 		    SendPacket();
         else
-            throwPacketHeaderErr("Invalid P-Header.");
+            return setPacketHeaderErr("Invalid P-Header.");
 	}
 	// check 0b0000xx00 group
 	else if((by & 0xF3) == 0x00) {
@@ -374,7 +390,7 @@ ocsd_err_t EtmV3PktProcImpl::processHeaderByte(uint8_t by)
 		if((by & 0x93 )== 0x00) {
             if(!m_config.isDataValTrace()) {
                 m_curr_packet.SetErrType(ETM3_PKT_BAD_TRACEMODE);
-                throwPacketHeaderErr("Invalid data trace header (out of order data) - not tracing data values.");
+                return setPacketHeaderErr("Invalid data trace header (out of order data) - not tracing data values.");
 			}
 			m_curr_packet.SetType(ETM3_PKT_OOO_DATA);
 			uint8_t size = ((by & 0x0C) >> 2);
@@ -400,7 +416,7 @@ ocsd_err_t EtmV3PktProcImpl::processHeaderByte(uint8_t by)
             if(!m_config.isDataValTrace())
             {
                 m_curr_packet.SetErrType(ETM3_PKT_BAD_TRACEMODE);
-                throwPacketHeaderErr("Invalid data trace header (store failed) - not tracing data values.");
+                return setPacketHeaderErr("Invalid data trace header (store failed) - not tracing data values.");
             }
             m_curr_packet.SetType(ETM3_PKT_STORE_FAIL);
             SendPacket();
@@ -411,7 +427,7 @@ ocsd_err_t EtmV3PktProcImpl::processHeaderByte(uint8_t by)
             if(!m_config.isDataTrace())
             {
                 m_curr_packet.SetErrType(ETM3_PKT_BAD_TRACEMODE);
-                throwPacketHeaderErr("Invalid data trace header (out of order placeholder) - not tracing data.");
+                return setPacketHeaderErr("Invalid data trace header (out of order placeholder) - not tracing data.");
             }
             // expecting data address if flagged and address tracing enabled (flag can be set even if address tracing disabled)
 			m_bExpectingDataAddress = ((by & DATA_ADDR_EXPECTED_FLAG) == DATA_ADDR_EXPECTED_FLAG) && m_config.isDataAddrTrace();
@@ -428,7 +444,7 @@ ocsd_err_t EtmV3PktProcImpl::processHeaderByte(uint8_t by)
 		else
 		{
 			m_curr_packet.SetErrType(ETM3_PKT_RESERVED);
-            throwPacketHeaderErr("Packet header reserved encoding");
+            return setPacketHeaderErr("Packet header reserved encoding");
 		}
 	}
 	// normal data 0b00x0xx10
@@ -436,7 +452,7 @@ ocsd_err_t EtmV3PktProcImpl::processHeaderByte(uint8_t by)
 		uint8_t size = ((by & 0x0C) >> 2);
 		if(!m_config.isDataTrace()) {
             m_curr_packet.SetErrType(ETM3_PKT_BAD_TRACEMODE);
-            throwPacketHeaderErr("Invalid data trace header (normal data) - not tracing data.");
+            return setPacketHeaderErr("Invalid data trace header (normal data) - not tracing data.");
 		}
 		m_curr_packet.SetType(ETM3_PKT_NORM_DATA);
 		m_bExpectingDataAddress = ((by & DATA_ADDR_EXPECTED_FLAG) == DATA_ADDR_EXPECTED_FLAG) && m_config.isDataAddrTrace();
@@ -456,7 +472,7 @@ ocsd_err_t EtmV3PktProcImpl::processHeaderByte(uint8_t by)
 		if(!m_config.isDataTrace())
         {
             m_curr_packet.SetErrType(ETM3_PKT_BAD_TRACEMODE);
-            throwPacketHeaderErr("Invalid data trace header (data suppressed) - not tracing data.");
+            return setPacketHeaderErr("Invalid data trace header (data suppressed) - not tracing data.");
         }
         m_curr_packet.SetType(ETM3_PKT_DATA_SUPPRESSED);
         SendPacket();
@@ -465,7 +481,7 @@ ocsd_err_t EtmV3PktProcImpl::processHeaderByte(uint8_t by)
 	else if((by & 0xEF )== 0x6A) {
 		if(!m_config.isDataTrace()) {
             m_curr_packet.SetErrType(ETM3_PKT_BAD_TRACEMODE);
-            throwPacketHeaderErr("Invalid data trace header (value not traced) - not tracing data.");
+            return setPacketHeaderErr("Invalid data trace header (value not traced) - not tracing data.");
 		}
 		m_curr_packet.SetType(ETM3_PKT_VAL_NOT_TRACED);
 		m_bExpectingDataAddress = ((by & DATA_ADDR_EXPECTED_FLAG) == DATA_ADDR_EXPECTED_FLAG) && m_config.isDataAddrTrace();
@@ -502,7 +518,7 @@ ocsd_err_t EtmV3PktProcImpl::processHeaderByte(uint8_t by)
 	else
 	{
 		m_curr_packet.SetErrType(ETM3_PKT_RESERVED);
-        throwPacketHeaderErr("Packet header reserved encoding.");
+        return setPacketHeaderErr("Packet header reserved encoding.");
 	}
     return OCSD_OK;
 }
@@ -517,8 +533,8 @@ ocsd_err_t EtmV3PktProcImpl::processPayloadByte(uint8_t by)
 				
     switch(m_curr_packet.getType()) {
 	default:
-        throw ocsdError(OCSD_ERR_SEV_ERROR,OCSD_ERR_PKT_INTERP_FAIL,m_packet_index,m_chanIDCopy,"Interpreter failed - cannot process payload for unexpected or unsupported packet.");
-		break;
+        m_interface->setPktError(OCSD_ERR_PKT_INTERP_FAIL,m_packet_index,m_chanIDCopy,"Interpreter failed - cannot process payload for unexpected or unsupported packet.");
+        return OCSD_ERR_PKT_INTERP_FAIL;
      	
 	case ETM3_PKT_BRANCH_ADDRESS:
 		bTopBitSet = (bool)((by & 0x80) == 0x80);
@@ -563,6 +579,8 @@ ocsd_err_t EtmV3PktProcImpl::processPayloadByte(uint8_t by)
         if(packetDone)
         {
             OnBranchAddress();
+            if(pktErrorSet())
+                return OCSD_ERR_BAD_PACKET_SEQ;
 			SendPacket();
         }
 		break;
@@ -624,7 +642,7 @@ ocsd_err_t EtmV3PktProcImpl::processPayloadByte(uint8_t by)
                 m_curr_packet.SetErrType(ETM3_PKT_BAD_SEQUENCE);
                 // mark extra 0 for sending, retain remaining, restart in A-SYNC processing mode.
                 setBytesPartPkt(1,PROC_DATA,ETM3_PKT_A_SYNC);   
-                throwMalformedPacketErr("A-Sync ?: Extra 0x00 in sequence");
+                return setMalformedPacketErr("A-Sync ?: Extra 0x00 in sequence");
 			}
 		}
 		else if((by == 0x80) && ( m_currPacketData.size() == 6)) {
@@ -636,7 +654,7 @@ ocsd_err_t EtmV3PktProcImpl::processPayloadByte(uint8_t by)
             m_curr_packet.SetErrType(ETM3_PKT_BAD_SEQUENCE);
             m_bytesProcessed--; // remove the last byte from the number processed to re-try
             m_currPacketData.pop_back();  // remove the last byte processed from the packet
-            throwMalformedPacketErr("A-Sync ? : Unexpected byte in sequence");
+            return setMalformedPacketErr("A-Sync ? : Unexpected byte in sequence");
 		}
 		break;			
 			
@@ -644,7 +662,10 @@ ocsd_err_t EtmV3PktProcImpl::processPayloadByte(uint8_t by)
 		bTopBitSet = ((by & 0x80) == 0x80);
         if(!bTopBitSet || ( m_currPacketData.size() >= 6)) {
             m_currPktIdx = 1;
-            m_curr_packet.SetCycleCount(extractCycleCount());
+            uint32_t cycleCount = extractCycleCount();
+            if(pktErrorSet())
+                return OCSD_ERR_BAD_PACKET_SEQ;
+            m_curr_packet.SetCycleCount(cycleCount);
 			SendPacket();
 		}
 		break;
@@ -685,6 +706,8 @@ ocsd_err_t EtmV3PktProcImpl::processPayloadByte(uint8_t by)
 				// otherwise, output now
                 OnISyncPacket();
 			}
+            if(pktErrorSet())
+                return OCSD_ERR_BAD_PACKET_SEQ;
 		}
 		break;
 			
@@ -707,11 +730,16 @@ ocsd_err_t EtmV3PktProcImpl::processPayloadByte(uint8_t by)
                 uint8_t bits = 0, beVal = 0;
                 bool updateBE = false;
                 uint32_t dataAddress = extractDataAddress(bits,updateBE,beVal);
+                if(pktErrorSet())
+                    return OCSD_ERR_BAD_PACKET_SEQ;
                 m_curr_packet.UpdateDataAddress(dataAddress, bits);
                 if(updateBE)
                     m_curr_packet.UpdateDataEndian(beVal);
             }
-            m_curr_packet.SetDataValue(extractDataValue((m_currPacketData[0] >> 2) & 0x3));
+            uint32_t dataValue = extractDataValue((m_currPacketData[0] >> 2) & 0x3);
+            if(pktErrorSet())
+                return OCSD_ERR_BAD_PACKET_SEQ;
+            m_curr_packet.SetDataValue(dataValue);
 			SendPacket();
 		}
 		break;
@@ -720,12 +748,15 @@ ocsd_err_t EtmV3PktProcImpl::processPayloadByte(uint8_t by)
 		if(m_bytesExpectedThisPkt ==  m_currPacketData.size())
         {
             m_currPktIdx = 1;
-            m_curr_packet.SetDataValue(extractDataValue((m_currPacketData[0] >> 2) & 0x3));
+            uint32_t dataValue = extractDataValue((m_currPacketData[0] >> 2) & 0x3);
+            if(pktErrorSet())
+                return OCSD_ERR_BAD_PACKET_SEQ;
+            m_curr_packet.SetDataValue(dataValue);
             m_curr_packet.SetDataOOOTag((m_currPacketData[0] >> 5) & 0x3);
 			SendPacket();
         }
 		if(m_bytesExpectedThisPkt <  m_currPacketData.size())
-			throwMalformedPacketErr("Malformed out of order data packet.");
+			return setMalformedPacketErr("Malformed out of order data packet.");
 		break;
 			
         // both these expect an address only.
@@ -738,6 +769,8 @@ ocsd_err_t EtmV3PktProcImpl::processPayloadByte(uint8_t by)
                 bool updateBE = false;
                 m_currPktIdx = 1;
                 uint32_t dataAddress = extractDataAddress(bits,updateBE,beVal);
+                if(pktErrorSet())
+                    return OCSD_ERR_BAD_PACKET_SEQ;
                 m_curr_packet.UpdateDataAddress(dataAddress, bits);
                 if(updateBE)
                     m_curr_packet.UpdateDataEndian(beVal);
@@ -749,11 +782,14 @@ ocsd_err_t EtmV3PktProcImpl::processPayloadByte(uint8_t by)
 	case ETM3_PKT_CONTEXT_ID:
 		if(m_bytesExpectedThisPkt == m_currPacketData.size()) {
             m_currPktIdx = 1;
-            m_curr_packet.UpdateContextID(extractCtxtID());
+            uint32_t ctxtID = extractCtxtID();
+            if(pktErrorSet())
+                return OCSD_ERR_BAD_PACKET_SEQ;
+            m_curr_packet.UpdateContextID(ctxtID);
 			SendPacket();
 		}
 		if(m_bytesExpectedThisPkt < m_currPacketData.size())
-			throwMalformedPacketErr("Malformed context id packet.");
+			return setMalformedPacketErr("Malformed context id packet.");
 		break;
 			
 	case ETM3_PKT_TIMESTAMP:
@@ -761,6 +797,8 @@ ocsd_err_t EtmV3PktProcImpl::processPayloadByte(uint8_t by)
             uint8_t tsBits = 0;
             m_currPktIdx = 1;
             uint64_t tsVal = extractTimestamp(tsBits);
+            if(pktErrorSet())
+                return OCSD_ERR_BAD_PACKET_SEQ;
             m_curr_packet.UpdateTimestamp(tsVal,tsBits);
 			SendPacket();
 		}
@@ -783,7 +821,8 @@ void EtmV3PktProcImpl::OnBranchAddress()
     ocsd_vaddr_t partAddr = 0;
   
     partAddr = extractBrAddrPkt(validBits);
-    m_curr_packet.UpdateAddress(partAddr,validBits);
+    if(!pktErrorSet())
+        m_curr_packet.UpdateAddress(partAddr,validBits);
 }
 
 uint32_t EtmV3PktProcImpl::extractBrAddrPkt(int &nBitsOut)
@@ -831,7 +870,8 @@ uint32_t EtmV3PktProcImpl::extractBrAddrPkt(int &nBitsOut)
 
     while(CBit && bytecount < 4)
     {
-        checkPktLimits();
+        if(!checkPktLimits())
+            return 0;
         addrbyte = m_currPacketData[m_currPktIdx++];
         CBit = (bool)((addrbyte & 0x80) != 0);
         shift = bitcount;
@@ -848,7 +888,11 @@ uint32_t EtmV3PktProcImpl::extractBrAddrPkt(int &nBitsOut)
             {
                 // last compressed address byte with exception
                 if((addrbyte & 0x40) == 0x40)
+                {
                     extractExceptionData();
+                    if(pktErrorSet())
+                        return 0;
+                }
                 addrbyte &= 0x3F;
                 bitcount+=6;       
             }
@@ -865,7 +909,8 @@ uint32_t EtmV3PktProcImpl::extractBrAddrPkt(int &nBitsOut)
     // byte 5 - indicates following exception bytes (or not!)
     if(CBit)
     {
-        checkPktLimits();
+        if(!checkPktLimits())
+            return 0;
         addrbyte = m_currPacketData[m_currPktIdx++];
         
         // deprecated original byte 5 encoding - ARM state exception only
@@ -880,7 +925,11 @@ uint32_t EtmV3PktProcImpl::extractBrAddrPkt(int &nBitsOut)
         {
             // go grab the exception bits to correctly interpret the ISA state
             if((addrbyte & 0x40) == 0x40)
+            {
                 extractExceptionData();     
+                if(pktErrorSet())
+                    return 0;
+            }
 
             if((addrbyte & 0xB8) == 0x08)
                 m_curr_packet.UpdateISA(ocsd_isa_arm);
@@ -889,7 +938,10 @@ uint32_t EtmV3PktProcImpl::extractBrAddrPkt(int &nBitsOut)
             else if ((addrbyte & 0xA0) == 0x20)
                 m_curr_packet.UpdateISA(ocsd_isa_jazelle);
             else
-                throwMalformedPacketErr("Malformed Packet - Unknown ISA.");
+            {
+                setMalformedPacketErr("Malformed Packet - Unknown ISA.");
+                return 0;
+            }
         }
 
         byte5AddrUpdate = true; // need to update the address value from byte 5
@@ -945,7 +997,8 @@ void EtmV3PktProcImpl::extractExceptionData()
     bool cancel_prev_instr = 0;
     bool Byte2 = false;
 
-    checkPktLimits();
+    if(!checkPktLimits())
+        return;
 
     //**** exception info Byte 0
     uint8_t dataByte =  m_currPacketData[m_currPktIdx++];   
@@ -958,7 +1011,8 @@ void EtmV3PktProcImpl::extractExceptionData()
     //** another byte?
     if(dataByte & 0x80)
     {
-        checkPktLimits();
+        if(!checkPktLimits())
+            return;
         dataByte = m_currPacketData[m_currPktIdx++];
 
         if(dataByte & 0x40)
@@ -974,7 +1028,8 @@ void EtmV3PktProcImpl::extractExceptionData()
 
             if(dataByte & 0x80)
             {
-                checkPktLimits();
+                if(!checkPktLimits())
+                    return;
                 dataByte = m_currPacketData[m_currPktIdx++];
                 Byte2 = true;
             }
@@ -1013,11 +1068,15 @@ void EtmV3PktProcImpl::extractExceptionData()
     m_curr_packet.SetException(excep_type, exceptionNum, cancel_prev_instr,m_config.isV7MArch(), irq_n,resume);
 }
 
-void EtmV3PktProcImpl::checkPktLimits()
+const bool EtmV3PktProcImpl::checkPktLimits()
 {
     // index running off the end of the packet means a malformed packet.
     if(m_currPktIdx >= m_currPacketData.size())
-        throwMalformedPacketErr("Malformed Packet - oversized packet.");
+    {
+        setMalformedPacketErr("Malformed Packet - oversized packet.");
+        return false;
+    }
+    return true;
 }
 
 uint32_t EtmV3PktProcImpl::extractCtxtID()
@@ -1027,7 +1086,10 @@ uint32_t EtmV3PktProcImpl::extractCtxtID()
 
     // check we have enough data
     if((m_currPktIdx + size) > m_currPacketData.size())
-        throwMalformedPacketErr("Too few bytes to extract context ID.");
+    {
+        setMalformedPacketErr("Too few bytes to extract context ID.");
+        return 0;
+    }
 
     switch(size)
     {
@@ -1069,7 +1131,10 @@ uint64_t EtmV3PktProcImpl::extractTimestamp(uint8_t &tsBits)
     while((tsCurrBytes < tsMaxBytes) && bCont)
     {
         if(m_currPacketData.size() < (m_currPktIdx + tsCurrBytes + 1))
-            throwMalformedPacketErr("Insufficient bytes to extract timestamp.");
+        {
+            setMalformedPacketErr("Insufficient bytes to extract timestamp.");
+            return 0;
+        }
 
         currByte = m_currPacketData[m_currPktIdx+tsCurrBytes];
         ts |= ((uint64_t)(currByte & mask)) << (7 * tsCurrBytes);
@@ -1099,7 +1164,8 @@ uint32_t EtmV3PktProcImpl::extractDataAddress(uint8_t &bits, bool &updateBE, uin
 
     while(bCont)
     {
-        checkPktLimits();
+        if(!checkPktLimits())
+            return 0;
         currByte = m_currPacketData[m_currPktIdx++] & ((bytesIdx == 4) ? 0x0F : 0x7F);
         dataAddr |= (((uint32_t)currByte)  << (bytesIdx * 7));
         bCont = ((currByte & 0x80) == 0x80);
@@ -1126,7 +1192,8 @@ uint32_t EtmV3PktProcImpl::extractDataValue(const int dataByteSize)
     int bytesReq = bytesReqTable[dataByteSize & 0x3]; 
     while(bytesUsed < bytesReq)
     {
-        checkPktLimits();
+        if(!checkPktLimits())
+            return 0;
         dataVal |= (((uint32_t)m_currPacketData[m_currPktIdx++])  << (bytesUsed * 8));
         bytesUsed++;
     }
@@ -1144,7 +1211,8 @@ uint32_t EtmV3PktProcImpl::extractCycleCount()
 
     while(bCond)
     {
-        checkPktLimits();
+        if(!checkPktLimits())
+            return 0;
         currByte = m_currPacketData[m_currPktIdx++];
         cycleCount |= ((uint32_t)(currByte & mask)) << (7 * byteIdx);
         bCond = ((currByte & 0x80) == 0x80);
@@ -1169,13 +1237,19 @@ void EtmV3PktProcImpl::OnISyncPacket()
     m_currPktIdx = 1;
     if(m_bIsync_got_cycle_cnt)
     {
-        m_curr_packet.SetCycleCount(extractCycleCount());
+        uint32_t cycleCount = extractCycleCount();
+        if(pktErrorSet())
+            return;
+        m_curr_packet.SetCycleCount(cycleCount);
         m_curr_packet.SetISyncHasCC();
     }
 
     if(m_config.CtxtIDBytes() != 0)
     {
-        m_curr_packet.UpdateContextID(extractCtxtID());
+        uint32_t ctxtID = extractCtxtID();
+        if(pktErrorSet())
+            return;
+        m_curr_packet.UpdateContextID(ctxtID);
     }
 
     // extract context info 
@@ -1209,6 +1283,8 @@ void EtmV3PktProcImpl::OnISyncPacket()
         if(m_bIsync_get_LSiP_addr)
         {
             LSiPAddr = extractBrAddrPkt(LSiPBits);
+            if(pktErrorSet())
+                return;
             // follow up address value is compressed relative to the main value
             // we store this in the data address value temporarily.
             m_curr_packet.UpdateDataAddress(instrAddr,32);
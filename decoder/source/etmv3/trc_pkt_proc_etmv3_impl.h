@@ -96,17 +96,19 @@ protected:
     // packet handling - helper routines
     uint32_t extractBrAddrPkt(int &nBitsOut);
     void extractExceptionData();
-    void checkPktLimits();
+    const bool checkPktLimits();    // false if malformed - error recorded.
     void setBytesPartPkt(const int numBytes, const process_state nextState, const ocsd_etmv3_pkt_type nextType); // set first n bytes from current packet to be sent via alt packet.
 
     // packet output
     void SendPacket();  // mark state for packet output
     ocsd_datapath_resp_t outputPacket();   // output a packet
 
-    // bad packets 
-    void throwMalformedPacketErr(const char *pszErrMsg);
-    void throwPacketHeaderErr(const char *pszErrMsg);
-    void throwUnsupportedErr(const char *pszErrMsg);
+    // bad packets - record the error for the processing loop, returning the error code.
+    ocsd_err_t setMalformedPacketErr(const char *pszErrMsg);
+    ocsd_err_t setPacketHeaderErr(const char *pszErrMsg);
+    ocsd_err_t setUnsupportedErr(const char *pszErrMsg);
+    const bool pktErrorSet() const;
+    ocsd_datapath_resp_t processPktError();   // log the recorded error and send the bad packet.
 
     uint32_t m_bytesProcessed; // bytes processed by the process data routine (index into input buffer)
     std::vector<uint8_t> m_currPacketData;  // raw data
@@ -148,19 +150,27 @@ inline void EtmV3PktProcImpl::SendPacket()
     m_process_state = SEND_PKT;
 }
 
-inline void EtmV3PktProcImpl::throwMalformedPacketErr(const char *pszErrMsg)
+inline ocsd_err_t EtmV3PktProcImpl::setMalformedPacketErr(const char *pszErrMsg)
 {
-    throw ocsdError(OCSD_ERR_SEV_ERROR,OCSD_ERR_BAD_PACKET_SEQ,m_packet_index,m_chanIDCopy,pszErrMsg);
+    m_interface->setPktError(OCSD_ERR_BAD_PACKET_SEQ,m_packet_index,m_chanIDCopy,pszErrMsg);
+    return OCSD_ERR_BAD_PACKET_SEQ;
 }
 
-inline void EtmV3PktProcImpl::throwPacketHeaderErr(const char *pszErrMsg)
+inline ocsd_err_t EtmV3PktProcImpl::setPacketHeaderErr(const char *pszErrMsg)
 {
-    throw ocsdError(OCSD_ERR_SEV_ERROR,OCSD_ERR_INVALID_PCKT_HDR,m_packet_index,m_chanIDCopy,pszErrMsg);
+    m_interface->setPktError(OCSD_ERR_INVALID_PCKT_HDR,m_packet_index,m_chanIDCopy,pszErrMsg);
+    return OCSD_ERR_INVALID_PCKT_HDR;
 }
 
-inline void EtmV3PktProcImpl::throwUnsupportedErr(const char *pszErrMsg)
+inline ocsd_err_t EtmV3PktProcImpl::setUnsupportedErr(const char *pszErrMsg)
 {
-    throw ocsdError(OCSD_ERR_SEV_ERROR,OCSD_ERR_HW_CFG_UNSUPP,m_packet_index,m_chanIDCopy,pszErrMsg);
+    m_interface->setPktError(OCSD_ERR_HW_CFG_UNSUPP,m_packet_index,m_chanIDCopy,pszErrMsg);
+    return OCSD_ERR_HW_CFG_UNSUPP;
+}
+
+inline const bool EtmV3PktProcImpl::pktErrorSet() const
+{
+    return m_interface->pktErrorSet();
 }
 
 
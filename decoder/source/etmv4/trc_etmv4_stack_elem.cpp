@@ -35,10 +35,67 @@
 
 #include "opencsd/etmv4/trc_etmv4_stack_elem.h"
 
+#include <new>
+
 /* implementation of P0 element stack in ETM v4 trace*/
+EtmV4P0Stack::EtmV4P0Stack() :
+    m_ring_mask(0),
+    m_front(0),
+    m_count(0),
+    m_iter(0),
+    m_free_slots(0)
+{
+}
+
+EtmV4P0Stack::~EtmV4P0Stack()
+{
+    delete_all();
+    delete_popped();
+    while (m_pool_chunks.size() > 0)
+    {
+        delete [] m_pool_chunks.back();
+        m_pool_chunks.pop_back();
+    }
+}
+
+void EtmV4P0Stack::reserve(const size_t num_elem)
+{
+    while (m_ring.size() < num_elem)
+        growRing();
+}
+
+// add a chunk of slots to the element pool free list.
+bool EtmV4P0Stack::growPool()
+{
+    elem_slot_t *pChunk = new (std::nothrow) elem_slot_t[POOL_CHUNK_SLOTS];
+    if (!pChunk)
+        return false;
+    m_pool_chunks.push_back(pChunk);
+    for (int i = 0; i < POOL_CHUNK_SLOTS; i++)
+    {
+        pChunk[i].next = m_free_slots;
+        m_free_slots = &pChunk[i];
+    }
+    return true;
+}
+
+// double the ring buffer size, unwrapping the current elements to start at index 0.
+void EtmV4P0Stack::growRing()
+{
+    size_t new_size = m_ring.size() ? m_ring.size() * 2 : MIN_RING_SIZE;
+    std::vector<TrcStackElem *> new_ring(new_size, (TrcStackElem *)0);
+
+    for (size_t i = 0; i < m_count; i++)
+        new_ring[i] = at(i);
+    m_ring.swap(new_ring);
+    m_ring_mask = new_size - 1;
+    m_front = 0;
+}
+
 TrcStackElem *EtmV4P0Stack::createParamElemNoParam(const p0_elem_t p0_type, const bool isP0, const ocsd_etmv4_i_pkt_type root_pkt, const ocsd_trc_index_t root_index, bool back /*= false*/)
 {
-    TrcStackElem *pElem = new (std::nothrow) TrcStackElem(p0_type, isP0, root_pkt, root_index);
+    void *pMem = allocElemMem();
+    TrcStackElem *pElem = pMem ? new (pMem) TrcStackElem(p0_type, isP0, root_pkt, root_index) : 0;
     if (pElem)
     {
         if (back)
@@ -51,7 +108,8 @@ TrcStackElem *EtmV4P0Stack::createParamElemNoParam(const p0_elem_t p0_type, cons
 
 TrcStackElemParam *EtmV4P0Stack::createParamElem(const p0_elem_t p0_type, const bool isP0, const ocsd_etmv4_i_pkt_type root_pkt, const ocsd_trc_index_t root_index, const std::vector<uint32_t> &params)
 {
-    TrcStackElemParam *pElem = new (std::nothrow) TrcStackElemParam(p0_type, isP0, root_pkt, root_index);
+    void *pMem = allocElemMem();
+    TrcStackElemParam *pElem = pMem ? new (pMem) TrcStackElemParam(p0_type, isP0, root_pkt, root_index) : 0;
     if (pElem)
     {
         int param_idx = 0;
@@ -69,7 +127,8 @@ TrcStackElemParam *EtmV4P0Stack::createParamElem(const p0_elem_t p0_type, const
 
 TrcStackElemAtom *EtmV4P0Stack::createAtomElem(const ocsd_etmv4_i_pkt_type root_pkt, const ocsd_trc_index_t root_index, const ocsd_pkt_atom &atom)
 {
-    TrcStackElemAtom *pElem = new (std::nothrow) TrcStackElemAtom(root_pkt, root_index);
+    void *pMem = allocElemMem();
+    TrcStackElemAtom *pElem = pMem ? new (pMem) TrcStackElemAtom(root_pkt, root_index) : 0;
     if (pElem)
     {
         pElem->setAtom(atom);
@@ -80,7 +139,8 @@ TrcStackElemAtom *EtmV4P0Stack::createAtomElem(const ocsd_etmv4_i_pkt_type root_
 
 TrcStackElemExcept *EtmV4P0Stack::createExceptElem(const ocsd_etmv4_i_pkt_type root_pkt, const ocsd_trc_index_t root_index, const bool bSame, const uint16_t excepNum)
 {
-    TrcStackElemExcept *pElem = new (std::nothrow) TrcStackElemExcept(root_pkt, root_index);
+    void *pMem = allocElemMem();
+    TrcStackElemExcept *pElem = pMem ? new (pMem) TrcStackElemExcept(root_pkt, root_index) : 0;
     if (pElem)
     {
         pElem->setExcepNum(excepNum);
@@ -92,7 +152,8 @@ TrcStackElemExcept *EtmV4P0Stack::createExceptElem(const ocsd_etmv4_i_pkt_type r
 
 TrcStackElemCtxt *EtmV4P0Stack::createContextElem(const ocsd_etmv4_i_pkt_type root_pkt, const ocsd_trc_index_t root_index, const etmv4_context_t &context, const uint8_t IS, const bool back /*= false*/)
 {
-    TrcStackElemCtxt *pElem = new (std::nothrow) TrcStackElemCtxt(root_pkt, root_index);
+    void *pMem = allocElemMem();
+    TrcStackElemCtxt *pElem = pMem ? new (pMem) TrcStackElemCtxt(root_pkt, root_index) : 0;
     if (pElem)
     {
         pElem->setContext(context);
@@ -108,7 +169,8 @@ TrcStackElemCtxt *EtmV4P0Stack::createContextElem(const ocsd_etmv4_i_pkt_type ro
 
 TrcStackElemAddr *EtmV4P0Stack::createAddrElem(const ocsd_etmv4_i_pkt_type root_pkt, const ocsd_trc_index_t root_index, const etmv4_addr_val_t &addr_val)
 {
-    TrcStackElemAddr *pElem = new (std::nothrow) TrcStackElemAddr(root_pkt, root_index);
+    void *pMem = allocElemMem();
+    TrcStackElemAddr *pElem = pMem ? new (pMem) TrcStackElemAddr(root_pkt, root_index) : 0;
     if (pElem)
     {
         pElem->setAddr(addr_val);
@@ -119,7 +181,8 @@ TrcStackElemAddr *EtmV4P0Stack::createAddrElem(const ocsd_etmv4_i_pkt_type root_
 
 TrcStackQElem *EtmV4P0Stack::createQElem(const ocsd_etmv4_i_pkt_type root_pkt, const ocsd_trc_index_t root_index, const int count)
 {
-    TrcStackQElem *pElem = new (std::nothrow) TrcStackQElem(root_pkt, root_index);
+    void *pMem = allocElemMem();
+    TrcStackQElem *pElem = pMem ? new (pMem) TrcStackQElem(root_pkt, root_index) : 0;
     if (pElem)
     {
         pElem->setInstrCount(count);
@@ -130,7 +193,8 @@ TrcStackQElem *EtmV4P0Stack::createQElem(const ocsd_etmv4_i_pkt_type root_pkt, c
 
 TrcStackElemMarker *EtmV4P0Stack::createMarkerElem(const ocsd_etmv4_i_pkt_type root_pkt, const ocsd_trc_index_t root_index, const trace_marker_payload_t &marker)
 {
-    TrcStackElemMarker *pElem = new (std::nothrow) TrcStackElemMarker(root_pkt, root_index);
+    void *pMem = allocElemMem();
+    TrcStackElemMarker *pElem = pMem ? new (pMem) TrcStackElemMarker(root_pkt, root_index) : 0;
     if (pElem)
     {
         pElem->setMarker(marker);
@@ -141,7 +205,8 @@ TrcStackElemMarker *EtmV4P0Stack::createMarkerElem(const ocsd_etmv4_i_pkt_type r
 
 TrcStackElemAddr *EtmV4P0Stack::createSrcAddrElem(const ocsd_etmv4_i_pkt_type root_pkt, const ocsd_trc_index_t root_index, const etmv4_addr_val_t &addr_val)
 {
-    TrcStackElemAddr *pElem = new (std::nothrow) TrcStackElemAddr(root_pkt, root_index, true);
+    void *pMem = allocElemMem();
+    TrcStackElemAddr *pElem = pMem ? new (pMem) TrcStackElemAddr(root_pkt, root_index, true) : 0;
     if (pElem)
     {
         pElem->setAddr(addr_val);
@@ -152,7 +217,8 @@ TrcStackElemAddr *EtmV4P0Stack::createSrcAddrElem(const ocsd_etmv4_i_pkt_type ro
 
 TrcStackElemITE *EtmV4P0Stack::createITEElem(const ocsd_etmv4_i_pkt_type root_pkt, const ocsd_trc_index_t root_index, const trace_sw_ite_t &ite)
 {
-    TrcStackElemITE *pElem = new (std::nothrow) TrcStackElemITE(root_pkt, root_index);
+    void *pMem = allocElemMem();
+    TrcStackElemITE *pElem = pMem ? new (pMem) TrcStackElemITE(root_pkt, root_index) : 0;
     if (pElem)
     {
         pElem->setITE(ite);
@@ -184,34 +250,34 @@ int EtmV4P0Stack::createUnseenUncommitedP0Elem(const int n_unseen, const ocsd_et
 // iteration functions
 void EtmV4P0Stack::from_front_init()
 {
-    m_iter = m_P0_stack.begin();
+    m_iter = 0;
 }
 
 TrcStackElem *EtmV4P0Stack::from_front_next()
 {
     TrcStackElem *pElem = 0;
-    if (m_iter != m_P0_stack.end())
+    if (m_iter < m_count)
     {
-        pElem = *m_iter++;
+        pElem = at(m_iter++);
     }
     return pElem;
 }
 
 void EtmV4P0Stack::erase_curr_from_front()
 {
-    std::deque<TrcStackElem *>::iterator erase_iter;
-    
-    erase_iter = m_iter;
-    erase_iter--;
-    TrcStackElem* pElem = *erase_iter;
+    size_t erase_idx = m_iter - 1;
+    TrcStackElem* pElem = at(erase_idx);
 
-    // prevent overrun if we are erasing the last element
-    // - end() returned if no elements after the erased one.
-    m_iter = m_P0_stack.erase(erase_iter);
+    // close the gap - shift the older elements towards the front.
+    // iterator then refers to the element after the erased one.
+    for (size_t i = erase_idx; i < (m_count - 1); i++)
+        at(i) = at(i + 1);
+    m_count--;
+    m_iter = erase_idx;
 
     // explicitly delete the item here as the caller can no longer reference it.
     // fixes memory leak from github issue #52
-    delete pElem;
+    releaseElem(pElem);
 }
 
 
@@ -194,6 +194,7 @@ ocsd_err_t TrcPktDecodeEtmV4I::onProtocolConfig()
     // set some static config elements
     m_CSID = m_config->getTraceID();
     m_max_spec_depth = m_config->MaxSpecDepth();
+    m_P0_stack.reserve(m_max_spec_depth);
 
     // elements associated with data trace
 #ifdef DATA_TRACE_SUPPORTED
@@ -246,6 +247,7 @@ ocsd_err_t TrcPktDecodeEtmV4I::onProtocolConfig()
     m_strict_br_chk = (bool)(getComponentOpMode() & OCSD_OPFLG_STRICT_N_UNCOND_BR_CHK);
     m_range_cont_chk = (bool)(getComponentOpMode() & OCSD_OPFLG_CHK_RANGE_CONTINUE);
     m_br_check_no_thumb = (bool)(getComponentOpMode() & OCSD_OPFLG_N_UNCOND_CHK_NO_THUMB);
+    m_strobed_trace = (bool)(getComponentOpMode() & ETM4_OPFLG_PKTDEC_STROBED_TRACE);
 
     return err;
 }
@@ -283,6 +285,9 @@ void TrcPktDecodeEtmV4I::initDecoder()
 
     // reset decoder state to unsynced
     m_unsync_eot_info = UNSYNC_INIT_DECODER;
+    m_p_mem_acc_ctxt = &m_pe_context;
+    m_strobed_trace = false;
+    m_mem_acc_ctxt_valid = false;
     resetDecoder();
 }
 
@@ -294,6 +299,14 @@ void TrcPktDecodeEtmV4I::resetDecoder()
     m_vmid_id = 0;                 
     m_is_secure = true;
     m_is_64bit = false;
+    m_pe_context.context_id = 0;
+    m_pe_context.vmid = 0;
+    m_pe_context.ctxt_id_valid = 0;
+    m_pe_context.vmid_valid = 0;
+    m_pe_context.bits64 = 0;
+    m_pe_context.el_valid = 0;
+    m_pe_context.exception_level = ocsd_EL_unknown;
+    m_pe_context.security_level = ocsd_sec_secure;
     m_cc_threshold = 0;
     m_curr_spec_depth = 0;
     m_need_ctxt = true;
@@ -318,7 +331,7 @@ void TrcPktDecodeEtmV4I::resetDecoder()
 void TrcPktDecodeEtmV4I::onFirstInitOK()
 {
     // once init, set the output element interface to the out elem list.
-    m_out_elem.initSendIf(this->getTraceElemOutAttachPt());
+    m_out_elem.initSendIf(this->getTraceElemOutAttachPt(), &m_elem_out_mask);
 }
 
 // Changes a packet into stack of trace elements - these will be resolved and output later
@@ -467,6 +480,7 @@ ocsd_err_t TrcPktDecodeEtmV4I::decodePacket()
 
     // event trace
     case ETM4_PKT_I_EVENT:
+        if (isElemOut(OCSD_GEN_TRC_ELEM_EVENT))
         {
             std::vector<uint32_t> params = { 0 };
             params[0] = (uint32_t)m_curr_packet_in->event_val;
@@ -481,10 +495,13 @@ ocsd_err_t TrcPktDecodeEtmV4I::decodePacket()
     case ETM4_PKT_I_CCNT_F2:
     case ETM4_PKT_I_CCNT_F3:
         {
-            std::vector<uint32_t> params = { 0 };
-            params[0] = m_curr_packet_in->getCC();
-            if (m_P0_stack.createParamElem(P0_CC, false, m_curr_packet_in->getType(), m_index_curr_pkt, params) == 0)
-                bAllocErr = true;
+            if (isElemOut(OCSD_GEN_TRC_ELEM_CYCLE_COUNT))
+            {
+                std::vector<uint32_t> params = { 0 };
+                params[0] = m_curr_packet_in->getCC();
+                if (m_P0_stack.createParamElem(P0_CC, false, m_curr_packet_in->getType(), m_index_curr_pkt, params) == 0)
+                    bAllocErr = true;
+            }
             m_elem_res.P0_commit = m_curr_packet_in->getCommitElem();
 
         }
@@ -492,8 +509,9 @@ ocsd_err_t TrcPktDecodeEtmV4I::decodePacket()
 
     // timestamp
     case ETM4_PKT_I_TIMESTAMP:
+        if (isElemOut(OCSD_GEN_TRC_ELEM_TIMESTAMP))
         {
-            bool bTSwithCC = m_config->enabledCCI();
+            bool bTSwithCC = m_config->enabledCCI() && isElemOut(OCSD_GEN_TRC_ELEM_CYCLE_COUNT);
             uint64_t ts = m_curr_packet_in->getTS();
             std::vector<uint32_t> params = { 0, 0, 0 };
             params[0] = (uint32_t)(ts & 0xFFFFFFFF);
@@ -606,6 +624,7 @@ ocsd_err_t TrcPktDecodeEtmV4I::decodePacket()
 
         /* PE Instrumentation packet */
     case ETE_PKT_I_ITE:
+        if (isElemOut(OCSD_GEN_TRC_ELEM_INSTRUMENTATION))
         {
             trace_sw_ite_t ite_pkt;
 
@@ -788,7 +807,7 @@ ocsd_err_t TrcPktDecodeEtmV4I::commitElements()
 
             case P0_ADDR:
                 {
-                TrcStackElemAddr *pAddrElem = dynamic_cast<TrcStackElemAddr *>(pElem);
+                TrcStackElemAddr *pAddrElem = p0ElemCast<TrcStackElemAddr>(pElem);
                 m_return_stack.clear_pop_pending(); // address removes the need to pop the indirect address target from the stack
                 if (m_return_stack.is_t_info_wait_addr())
                     m_return_stack.clear_t_info_wait_addr(); // also may clear wait for address after TINFO
@@ -802,7 +821,7 @@ ocsd_err_t TrcPktDecodeEtmV4I::commitElements()
 
             case P0_CTXT:
                 {
-                TrcStackElemCtxt *pCtxtElem = dynamic_cast<TrcStackElemCtxt *>(pElem);
+                TrcStackElemCtxt *pCtxtElem = p0ElemCast<TrcStackElemCtxt>(pElem);
                 if (pCtxtElem)
                 {
                     etmv4_context_t ctxt = pCtxtElem->getContext();
@@ -819,7 +838,7 @@ ocsd_err_t TrcPktDecodeEtmV4I::commitElements()
                             
                             // invalidate memory accessor cacheing - force next memory access out to client to 
                             // ensure that the correct memory context is in play when decoding subsequent atoms.
-                            invalidateMemAccCache();
+                            updateMemAccContext();
                         }
                     }
                 }
@@ -839,7 +858,7 @@ ocsd_err_t TrcPktDecodeEtmV4I::commitElements()
 
             case P0_ATOM:
                 {
-                TrcStackElemAtom *pAtomElem = dynamic_cast<TrcStackElemAtom *>(pElem);
+                TrcStackElemAtom *pAtomElem = p0ElemCast<TrcStackElemAtom>(pElem);
 
                 if (pAtomElem)
                 {
@@ -1150,7 +1169,7 @@ ocsd_err_t TrcPktDecodeEtmV4I::mispredictAtom()
         {
             if (pElem->getP0Type() == P0_ATOM)
             {
-                TrcStackElemAtom* pAtomElem = dynamic_cast<TrcStackElemAtom*>(pElem);
+                TrcStackElemAtom* pAtomElem = p0ElemCast<TrcStackElemAtom>(pElem);
                 if (pAtomElem)
                 {
                     pAtomElem->mispredictNewest();
@@ -1228,7 +1247,7 @@ ocsd_err_t TrcPktDecodeEtmV4I::processTS_CC_EventElem(TrcStackElem *pElem)
     {
         case P0_EVENT:
         {
-            TrcStackElemParam *pParamElem = dynamic_cast<TrcStackElemParam *>(pElem);
+            TrcStackElemParam *pParamElem = p0ElemCast<TrcStackElemParam>(pElem);
             if (pParamElem)
                 err = addElemEvent(pParamElem);
         }
@@ -1236,7 +1255,7 @@ ocsd_err_t TrcPktDecodeEtmV4I::processTS_CC_EventElem(TrcStackElem *pElem)
 
         case P0_TS:
         {
-            TrcStackElemParam *pParamElem = dynamic_cast<TrcStackElemParam *>(pElem);
+            TrcStackElemParam *pParamElem = p0ElemCast<TrcStackElemParam>(pElem);
             if (pParamElem && bPermitTS)
                 err = addElemTS(pParamElem, false);
         }
@@ -1244,7 +1263,7 @@ ocsd_err_t TrcPktDecodeEtmV4I::processTS_CC_EventElem(TrcStackElem *pElem)
 
         case P0_CC:
         {
-            TrcStackElemParam *pParamElem = dynamic_cast<TrcStackElemParam *>(pElem);
+            TrcStackElemParam *pParamElem = p0ElemCast<TrcStackElemParam>(pElem);
             if (pParamElem)
                 err = addElemCC(pParamElem);
         }
@@ -1252,7 +1271,7 @@ ocsd_err_t TrcPktDecodeEtmV4I::processTS_CC_EventElem(TrcStackElem *pElem)
 
         case P0_TS_CC:
         {
-            TrcStackElemParam *pParamElem = dynamic_cast<TrcStackElemParam *>(pElem);
+            TrcStackElemParam *pParamElem = p0ElemCast<TrcStackElemParam>(pElem);
             if (pParamElem && bPermitTS)
                 err = addElemTS(pParamElem, true);
         }
@@ -1265,12 +1284,12 @@ ocsd_err_t TrcPktDecodeEtmV4I::processTS_CC_EventElem(TrcStackElem *pElem)
 ocsd_err_t TrcPktDecodeEtmV4I::processMarkerElem(TrcStackElem *pElem)
 {
     ocsd_err_t err = OCSD_OK;
-    TrcStackElemMarker *pMarkerElem = dynamic_cast<TrcStackElemMarker *>(pElem);
+    TrcStackElemMarker *pMarkerElem = p0ElemCast<TrcStackElemMarker>(pElem);
 
     if (m_config->eteHasTSMarker() && (pMarkerElem->getMarker().type == ELEM_MARKER_TS))
         m_ete_first_ts_marker = true;
 
-    if (!err)
+    if (!err && isElemOut(OCSD_GEN_TRC_ELEM_SYNC_MARKER))
     {
         err = m_out_elem.addElemType(pElem->getRootIndex(), OCSD_GEN_TRC_ELEM_SYNC_MARKER);
         if (!err)
@@ -1281,7 +1300,12 @@ ocsd_err_t TrcPktDecodeEtmV4I::processMarkerElem(TrcStackElem *pElem)
 
 ocsd_err_t TrcPktDecodeEtmV4I::processTransElem(TrcStackElem *pElem)
 {
-    ocsd_err_t err = m_out_elem.addElemType(pElem->getRootIndex(), OCSD_GEN_TRC_ELEM_MEMTRANS);
+    ocsd_err_t err = OCSD_OK;
+
+    if (!isElemOut(OCSD_GEN_TRC_ELEM_MEMTRANS))
+        return err;
+
+    err = m_out_elem.addElemType(pElem->getRootIndex(), OCSD_GEN_TRC_ELEM_MEMTRANS);
     if (!err)
     {
         outElem().setTransactionType((trace_memtrans_t)((int)OCSD_MEM_TRANS_FAIL -
@@ -1293,7 +1317,7 @@ ocsd_err_t TrcPktDecodeEtmV4I::processTransElem(TrcStackElem *pElem)
 ocsd_err_t TrcPktDecodeEtmV4I::processITEElem(TrcStackElem *pElem)
 {
     ocsd_err_t err = OCSD_OK;
-    TrcStackElemITE *pITEElem = dynamic_cast<TrcStackElemITE *>(pElem);
+    TrcStackElemITE *pITEElem = p0ElemCast<TrcStackElemITE>(pElem);
 
     err = m_out_elem.addElemType(pElem->getRootIndex(), OCSD_GEN_TRC_ELEM_INSTRUMENTATION);
     if (!err) {
@@ -1519,7 +1543,7 @@ ocsd_err_t TrcPktDecodeEtmV4I::processException()
     bool bMTailChain = false;
 
     // grab the exception element off the stack
-    pExceptElem = dynamic_cast<TrcStackElemExcept *>(m_P0_stack.back());  // get the exception element
+    pExceptElem = p0ElemCast<TrcStackElemExcept>(m_P0_stack.back());  // get the exception element
     excep_pkt_index = pExceptElem->getRootIndex();
     branch_target = pExceptElem->getPrevSame();
     if (pExceptElem->getRootPkt() == ETE_PKT_I_PE_RESET)
@@ -1532,7 +1556,7 @@ ocsd_err_t TrcPktDecodeEtmV4I::processException()
         pElem = m_P0_stack.back();  // look at next element.
         if (pElem->getP0Type() == P0_CTXT)
         {
-            pCtxtElem = dynamic_cast<TrcStackElemCtxt *>(pElem);
+            pCtxtElem = p0ElemCast<TrcStackElemCtxt>(pElem);
             m_P0_stack.pop_back(); // remove the context element
             pElem = m_P0_stack.back();  // next one should be an address element
         }
@@ -1685,7 +1709,7 @@ ocsd_err_t TrcPktDecodeEtmV4I::processQElement()
     etmv4_addr_val_t QAddr; // address where trace restarts 
     int iCount = 0;
 
-    pQElem = dynamic_cast<TrcStackQElem *>(m_P0_stack.back());  // get the exception element
+    pQElem = p0ElemCast<TrcStackQElem>(m_P0_stack.back());  // get the exception element
     m_P0_stack.pop_back(); // remove the Q element.
 
     if (!pQElem->hasAddr())  // no address - it must be next on the stack....
@@ -1697,7 +1721,7 @@ ocsd_err_t TrcPktDecodeEtmV4I::processQElement()
         pElem = m_P0_stack.back();  // look at next element.
         if (pElem->getP0Type() == P0_CTXT)
         {
-            pCtxtElem = dynamic_cast<TrcStackElemCtxt *>(pElem);
+            pCtxtElem = p0ElemCast<TrcStackElemCtxt>(pElem);
             m_P0_stack.pop_back(); // remove the context element
             pElem = m_P0_stack.back();  // next one should be an address element
         }
@@ -1710,7 +1734,7 @@ ocsd_err_t TrcPktDecodeEtmV4I::processQElement()
             m_P0_stack.delete_popped();
             return err;
         }
-        pAddressElem = dynamic_cast<TrcStackElemAddr *>(pElem);
+        pAddressElem = p0ElemCast<TrcStackElemAddr>(pElem);
         QAddr = pAddressElem->getAddr();
         m_P0_stack.pop_back();  // remove the address element
         m_P0_stack.delete_popped(); // clear used elements
@@ -1738,12 +1762,41 @@ ocsd_err_t TrcPktDecodeEtmV4I::processQElement()
     addr_range.st_addr = addr_range.en_addr = m_instr_info.instr_addr;
     addr_range.num_instr = 0;
 
+    // blocks walked to a waypoint are shared with the instruction block cache.
+    TrcInstrBlockCache *pBlkCache = m_instr_blk_cache.first();
+    ocsd_vaddr_t blkStAddr = m_instr_info.instr_addr;
+    bool blkCacheable = (m_instr_info.thumb_it_conditions == 0);
+    uint32_t blkNumInstr = 0;
+
     // walk iCount instructions
-    for (int i = 0; i < iCount; i++)
+    while (addr_range.num_instr < (uint32_t)iCount)
     {
         uint32_t opcode;
         uint32_t bytesReq = 4;
 
+        // at a block start - use a cached block if it ends within the instruction count.
+        if (pBlkCache && !blkNumInstr && blkCacheable)
+        {
+            ocsd_instr_info blkInfo = m_instr_info;
+            uint32_t numInstr = 0;
+
+            if (pBlkCache->findBlock(m_CSID, getCurrMemSpace(), m_context_id, m_vmid_id, &blkInfo, &numInstr) &&
+                (numInstr <= ((uint32_t)iCount - addr_range.num_instr)))
+            {
+                m_instr_info = blkInfo;
+                addr_range.num_instr += numInstr;
+
+                isBranch = (m_instr_info.type == OCSD_INSTR_BR) ||
+                    (m_instr_info.type == OCSD_INSTR_BR_INDIRECT);
+                if (isBranch)
+                    break;
+
+                blkStAddr = m_instr_info.instr_addr;
+                blkCacheable = (m_instr_info.thumb_it_conditions == 0);
+                continue;
+            }
+        }
+
         err = accessMemory(m_instr_info.instr_addr, getCurrMemSpace(), &bytesReq, (uint8_t *)&opcode);
         if (err != OCSD_OK) break;
 
@@ -1756,6 +1809,17 @@ ocsd_err_t TrcPktDecodeEtmV4I::processQElement()
             // increment address - may be adjusted by direct branch value later
             m_instr_info.instr_addr += m_instr_info.instr_size;
             addr_range.num_instr++;
+            blkNumInstr++;
+
+            // walked to a waypoint - save the block and start the next one.
+            if (m_instr_info.type != OCSD_INSTR_OTHER)
+            {
+                if (pBlkCache && blkCacheable)
+                    pBlkCache->addBlock(m_CSID, getCurrMemSpace(), m_context_id, m_vmid_id, blkStAddr, &m_instr_info, blkNumInstr);
+                blkStAddr = m_instr_info.instr_addr;
+                blkCacheable = (m_instr_info.thumb_it_conditions == 0);
+                blkNumInstr = 0;
+            }
 
             isBranch = (m_instr_info.type == OCSD_INSTR_BR) ||
                 (m_instr_info.type == OCSD_INSTR_BR_INDIRECT);
@@ -1812,7 +1876,7 @@ ocsd_err_t TrcPktDecodeEtmV4I::processQElement()
 ocsd_err_t TrcPktDecodeEtmV4I::processSourceAddress()
 {
     ocsd_err_t err = OCSD_OK;
-    TrcStackElemAddr *pElem = dynamic_cast<TrcStackElemAddr *>(m_P0_stack.back());  // get the address element
+    TrcStackElemAddr *pElem = p0ElemCast<TrcStackElemAddr>(m_P0_stack.back());  // get the address element
     etmv4_addr_val_t srcAddr = pElem->getAddr();
     uint32_t opcode, bytesReq = 4;
     ocsd_vaddr_t currAddr = m_instr_info.instr_addr;    // get the latest decoded address.
@@ -1875,16 +1939,54 @@ ocsd_err_t TrcPktDecodeEtmV4I::processSourceAddress()
             // need to count T32 - 2 or 4 byte instructions or we are spotting N atoms
             ocsd_instr_info instr; // going back to start of range so make a copy of info.
             bool bMemAccErr = false;
+            TrcInstrBlockCache *pBlkCache = m_instr_blk_cache.first();
+            ocsd_vaddr_t blkStAddr = out_range.st_addr;
+            bool blkCacheable = true;
+            uint32_t blkNumInstr = 0;
 
             instr.instr_addr = out_range.st_addr;
             instr.isa = m_instr_info.isa;
             instr.pe_type = m_instr_info.pe_type;
             instr.dsb_dmb_waypoints = m_instr_info.dsb_dmb_waypoints;
             instr.wfi_wfe_branch = m_instr_info.wfi_wfe_branch;
+            instr.track_it_block = m_instr_info.track_it_block;
+            instr.thumb_it_conditions = 0;
             out_range.num_instr = 0;
 
             while ((instr.instr_addr < out_range.en_addr) && !bMemAccErr)
             {
+                // at a block start - use a cached block if the waypoint is within the range.
+                if (pBlkCache && !blkNumInstr && blkCacheable)
+                {
+                    ocsd_instr_info blkInfo = instr;
+                    uint32_t numInstr = 0;
+
+                    if (pBlkCache->findBlock(m_CSID, getCurrMemSpace(), m_context_id, m_vmid_id, &blkInfo, &numInstr) &&
+                        (blkInfo.instr_addr <= out_range.en_addr))
+                    {
+                        instr = blkInfo;
+                        out_range.num_instr += numInstr;
+                        blkStAddr = instr.instr_addr;
+                        blkCacheable = (instr.thumb_it_conditions == 0);
+
+                        // waypoint before the source address is an N atom
+                        if (bSplitRangeOnN && (instr.instr_addr < out_range.en_addr))
+                        {
+                            instr_range_t mid_range = out_range;
+                            mid_range.en_addr = instr.instr_addr;
+
+                            err = m_out_elem.addElem(pElem->getRootIndex());
+                            if (err)
+                                return err;
+                            setElemTraceRangeInstr(outElem(), mid_range, false, pElem->getRootIndex(), instr);
+
+                            out_range.st_addr = mid_range.en_addr;
+                            out_range.num_instr = 0;
+                        }
+                        continue;
+                    }
+                }
+
                 bytesReq = 4;
                 err = accessMemory(instr.instr_addr, getCurrMemSpace(), &bytesReq, (uint8_t *)&opcode);
                 if (err != OCSD_OK)
@@ -1905,6 +2007,17 @@ ocsd_err_t TrcPktDecodeEtmV4I::processSourceAddress()
 
                     instr.instr_addr += instr.instr_size;
                     out_range.num_instr++;
+                    blkNumInstr++;
+
+                    // walked to a waypoint - save the block and start the next one.
+                    if (instr.type != OCSD_INSTR_OTHER)
+                    {
+                        if (pBlkCache && blkCacheable)
+                            pBlkCache->addBlock(m_CSID, getCurrMemSpace(), m_context_id, m_vmid_id, blkStAddr, &instr, blkNumInstr);
+                        blkStAddr = instr.instr_addr;
+                        blkCacheable = (instr.thumb_it_conditions == 0);
+                        blkNumInstr = 0;
+                    }
 
                     /* if we are doing N atom ranges ...*/
                     if (bSplitRangeOnN && (instr.instr_addr < out_range.en_addr))
@@ -1981,16 +2094,65 @@ ocsd_err_t TrcPktDecodeEtmV4I::traceInstrToWP(instr_range_t &range, WP_res_t &WP
     uint32_t bytesReq;
     ocsd_err_t err = OCSD_OK;
 
+    TrcInstrBlockCache *pBlkCache = 0;
+    const ocsd_mem_space_acc_t mem_space = getCurrMemSpace();
+
     range.st_addr = range.en_addr = m_instr_info.instr_addr;
     range.num_instr = 0;
 
     WPRes = WP_NOT_FOUND;
 
+    // cached blocks are only valid when walking to the next waypoint from outside an IT block.
+    if (!traceToAddrNext && !m_num_instr_range_limit && (m_instr_info.thumb_it_conditions == 0))
+    {
+        pBlkCache = m_instr_blk_cache.first();
+        if (pBlkCache && pBlkCache->findBlock(m_CSID, mem_space, m_context_id, m_vmid_id, &m_instr_info, &range.num_instr))
+        {
+            WPRes = WP_FOUND;
+            range.en_addr = m_instr_info.instr_addr;
+            return OCSD_OK;
+        }
+    }
+
     while(WPRes == WP_NOT_FOUND)
     {
+        // walking to a waypoint - decode a block of opcodes in place if memory is directly accessible.
+        if (!traceToAddrNext && (!m_num_instr_range_limit || (range.num_instr <= (uint32_t)m_num_instr_range_limit)))
+        {
+            const uint8_t *p_opcodes;
+            uint32_t num_blk_instr = 0;
+            uint32_t max_instr = 0xFFFFFFFF;
+
+            bytesReq = 4;
+            p_opcodes = accessMemoryPtr(m_instr_info.instr_addr, mem_space, &bytesReq);
+            if (p_opcodes)
+            {
+                if (m_num_instr_range_limit)
+                    max_instr = (uint32_t)m_num_instr_range_limit + 1 - range.num_instr;
+                err = instrDecodeBlock(&m_instr_info, p_opcodes, bytesReq, max_instr, &num_blk_instr);
+                range.num_instr += num_blk_instr;
+                if (err != OCSD_OK) break;
+            }
+
+            if (num_blk_instr)
+            {
+                // block decode leaves last instruction address - increment as single decode.
+                m_instr_info.instr_addr += m_instr_info.instr_size;
+                if (m_instr_info.type != OCSD_INSTR_OTHER)
+                    WPRes = WP_FOUND;
+
+                if (m_num_instr_range_limit && (range.num_instr > (uint32_t)m_num_instr_range_limit))
+                {
+                    err = OCSD_ERR_I_RANGE_LIMIT_OVERRUN;
+                    LogError(ocsdError(OCSD_ERR_SEV_ERROR, err, "Decode Instruction Range Limit Overrun"));
+                }
+                continue;
+            }
+        }
+
         // start off by reading next opcode;
         bytesReq = 4;
-        err = accessMemory(m_instr_info.instr_addr, getCurrMemSpace(),&bytesReq,(uint8_t *)&opcode);
+        err = accessMemory(m_instr_info.instr_addr, mem_space, &bytesReq,(uint8_t *)&opcode);
         if(err != OCSD_OK) break;
 
         if(bytesReq == 4) // got data back
@@ -2029,6 +2191,9 @@ ocsd_err_t TrcPktDecodeEtmV4I::traceInstrToWP(instr_range_t &range, WP_res_t &WP
     }
     // update the range decoded address in the output packet.
     range.en_addr = m_instr_info.instr_addr;
+
+    if (pBlkCache && (err == OCSD_OK) && (WPRes == WP_FOUND))
+        pBlkCache->addBlock(m_CSID, mem_space, m_context_id, m_vmid_id, range.st_addr, &m_instr_info, range.num_instr);
     return err;
 }
 
@@ -2052,18 +2217,46 @@ void TrcPktDecodeEtmV4I::updateContext(TrcStackElemCtxt *pCtxtElem, OcsdTraceEle
     {
         elem.context.ctxt_id_valid = 1;
         m_context_id = elem.context.context_id = ctxt.ctxtID;
+        m_pe_context.context_id = ctxt.ctxtID;
+        m_pe_context.ctxt_id_valid = 1;
     }
     if(ctxt.updated_v)
     {
         elem.context.vmid_valid = 1;
         m_vmid_id = elem.context.vmid = ctxt.VMID;
+        m_pe_context.vmid = ctxt.VMID;
+        m_pe_context.vmid_valid = 1;
     }
+    m_pe_context.bits64 = elem.context.bits64;
+    m_pe_context.security_level = elem.context.security_level;
+    m_pe_context.exception_level = elem.context.exception_level;
+    m_pe_context.el_valid = 1;
 
     // need to update ISA in case context follows address.
     elem.isa = m_instr_info.isa = calcISA(m_is_64bit, pCtxtElem->getIS());
     m_need_ctxt = false;
 }
 
+void TrcPktDecodeEtmV4I::updateMemAccContext()
+{
+    // Strobed trace restarts at each trace window with the context repeated in a
+    // context packet - cached memory remains valid if the context is unchanged.
+    if (m_strobed_trace && m_mem_acc_ctxt_valid &&
+        (m_pe_context.security_level == m_mem_acc_ctxt.security_level) &&
+        (m_pe_context.exception_level == m_mem_acc_ctxt.exception_level) &&
+        (m_pe_context.el_valid == m_mem_acc_ctxt.el_valid) &&
+        (m_pe_context.bits64 == m_mem_acc_ctxt.bits64) &&
+        (m_pe_context.ctxt_id_valid == m_mem_acc_ctxt.ctxt_id_valid) &&
+        (m_pe_context.context_id == m_mem_acc_ctxt.context_id) &&
+        (m_pe_context.vmid_valid == m_mem_acc_ctxt.vmid_valid) &&
+        (m_pe_context.vmid == m_mem_acc_ctxt.vmid))
+        return;
+
+    invalidateMemAccCache();
+    m_mem_acc_ctxt = m_pe_context;
+    m_mem_acc_ctxt_valid = true;
+}
+
 ocsd_err_t TrcPktDecodeEtmV4I::handleBadPacket(const char *reason, ocsd_trc_index_t index /* = OCSD_BAD_TRC_INDEX */)
 {
     ocsd_err_severity_t sev = OCSD_ERR_SEV_WARN;
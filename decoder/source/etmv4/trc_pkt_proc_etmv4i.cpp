@@ -91,94 +91,82 @@ ocsd_datapath_resp_t TrcPktProcEtmV4I::processData(  const ocsd_trc_index_t inde
 
     m_trcIn.init(dataBlockSize, pDataBlock, &m_currPacketData);
     m_blockIndex = index;
-    bool done = false;
     uint8_t nextByte;
 
-    do
+    try 
     {
-        try 
+        while ( (!m_trcIn.empty() || (m_process_state == SEND_PKT)) &&
+                OCSD_DATA_RESP_IS_CONT(resp)
+            )
         {
-            while ( (!m_trcIn.empty() || (m_process_state == SEND_PKT)) &&
-                    OCSD_DATA_RESP_IS_CONT(resp)
-                )
+            switch (m_process_state)
             {
-                switch (m_process_state)
+            case PROC_HDR:
+                m_packet_index = m_blockIndex + m_trcIn.processed();
+                if (m_is_sync)
                 {
-                case PROC_HDR:
-                    m_packet_index = m_blockIndex + m_trcIn.processed();
-                    if (m_is_sync)
+                    nextByte = m_trcIn.peekNextByte();
+                    if (m_i_table[nextByte].pptkFn == &TrcPktProcEtmV4I::iAtom)
                     {
-                        nextByte = m_trcIn.peekNextByte();
-                        m_pIPktFn = m_i_table[nextByte].pptkFn;
-                        m_curr_packet.type = m_i_table[nextByte].pkt_type;
+                        resp = outputAtomRun();
+                        break;
                     }
-                    else
-                    {
-                        // unsynced - process data until we see a sync point
-                        m_pIPktFn = &TrcPktProcEtmV4I::iNotSync;
-                        m_curr_packet.type = ETM4_PKT_I_NOTSYNC;
-                    }
-                    m_process_state = PROC_DATA;
-
-                case PROC_DATA:
-                    // loop till full packet or no more data...
-                    while (!m_trcIn.empty() && (m_process_state == PROC_DATA))
-                    {
-                        nextByte = m_trcIn.peekNextByte();
-                        m_trcIn.copyByteToPkt();  // move next byte into the packet
-                        (this->*m_pIPktFn)(nextByte);
-                    }
-                    break;
+                    m_pIPktFn = m_i_table[nextByte].pptkFn;
+                    m_curr_packet.type = m_i_table[nextByte].pkt_type;
+                }
+                else
+                {
+                    // unsynced - process data until we see a sync point
+                    m_pIPktFn = &TrcPktProcEtmV4I::iNotSync;
+                    m_curr_packet.type = ETM4_PKT_I_NOTSYNC;
+                }
+                m_process_state = PROC_DATA;
 
-                case SEND_PKT:
-                    resp = outputPacket();
-                    InitPacketState();
-                    m_process_state = PROC_HDR;
-                    break;
+            case PROC_DATA:
+                // skip unsynced data in bulk before the per byte processing.
+                if (m_pIPktFn == &TrcPktProcEtmV4I::iNotSync)
+                    iNotSyncScan();
 
-                case SEND_UNSYNCED:
-                    resp = outputUnsyncedRawPacket();
-                    if (m_update_on_unsync_packet_index != 0)
-                    {
-                        m_packet_index = m_update_on_unsync_packet_index;
-                        m_update_on_unsync_packet_index = 0;
-                    }
-                    m_process_state = PROC_DATA;        // after dumping unsynced data, still in data mode.
-                    break;
+                // loop till full packet, bad packet error or no more data...
+                while (!m_trcIn.empty() && (m_process_state == PROC_DATA))
+                {
+                    nextByte = m_trcIn.peekNextByte();
+                    m_trcIn.copyByteToPkt();  // move next byte into the packet
+                    (this->*m_pIPktFn)(nextByte);
                 }
+                if (m_process_state == PROC_ERR)
+                    resp = processPktError();
+                break;
+
+            case SEND_PKT:
+                resp = outputPacket();
+                InitPacketState();
+                m_process_state = PROC_HDR;
+                break;
+
+            case SEND_UNSYNCED:
+                resp = outputUnsyncedRawPacket();
+                if (m_update_on_unsync_packet_index != 0)
+                {
+                    m_packet_index = m_update_on_unsync_packet_index;
+                    m_update_on_unsync_packet_index = 0;
+                }
+                m_process_state = PROC_DATA;        // after dumping unsynced data, still in data mode.
+                break;
+
+            case PROC_ERR:
+                resp = processPktError();
+                break;
             }
-            done = true;
-        }
-        catch(ocsdError &err)
-        {
-            done = true;
-            LogError(err);
-            if( (err.getErrorCode() == OCSD_ERR_BAD_PACKET_SEQ) ||
-                (err.getErrorCode() == OCSD_ERR_INVALID_PCKT_HDR))
-            {
-                // send invalid packets up the pipe to let the next stage decide what to do.
-                if (err.getErrorCode() == OCSD_ERR_INVALID_PCKT_HDR)
-                    statsAddBadHdrCount(1);
-                else
-                    statsAddBadSeqCount(1);
-                m_process_state = SEND_PKT; 
-                done = false;
-            }
-            else
-            {
-                // bail out on any other error.
-                resp = OCSD_RESP_FATAL_INVALID_DATA;
-            }
-        }
-        catch(...)
-        {
-            done = true;
-            /// vv bad at this point.
-            resp = OCSD_RESP_FATAL_SYS_ERR;
-            const ocsdError &fatal = ocsdError(OCSD_ERR_SEV_ERROR,OCSD_ERR_FAIL,m_packet_index,m_config.getTraceID(),"Unknown System Error decoding trace.");
-           LogError(fatal);
         }
-    } while (!done);
+    }
+    catch(...)
+    {
+        /// vv bad at this point.
+        resp = OCSD_RESP_FATAL_SYS_ERR;
+        const ocsdError &fatal = ocsdError(OCSD_ERR_SEV_ERROR,OCSD_ERR_FAIL,m_packet_index,m_config.getTraceID(),"Unknown System Error decoding trace.");
+        LogError(fatal);
+    }
 
     statsAddTotalCount(m_trcIn.processed());
     *numBytesProcessed = m_trcIn.processed();
@@ -247,6 +235,29 @@ ocsd_datapath_resp_t TrcPktProcEtmV4I::outputPacket()
     return resp;
 }
 
+// Atom packets are complete in the header byte - output a run of them without collecting 
+// the data into the packet buffer.
+ocsd_datapath_resp_t TrcPktProcEtmV4I::outputAtomRun()
+{
+    ocsd_datapath_resp_t resp = OCSD_RESP_CONT;
+    uint8_t nextByte;
+
+    while (!m_trcIn.empty() && OCSD_DATA_RESP_IS_CONT(resp))
+    {
+        nextByte = m_trcIn.peekNextByte();
+        if (m_i_table[nextByte].pptkFn != &TrcPktProcEtmV4I::iAtom)
+            break;
+
+        m_packet_index = m_blockIndex + m_trcIn.processed();
+        m_curr_packet.type = m_i_table[nextByte].pkt_type;
+        iAtom(nextByte);
+        resp = outputOnAllInterfaces(m_packet_index, &m_curr_packet, &m_curr_packet.type, m_trcIn.readByteNoCopy(), 1);
+        m_curr_packet.initNextPacket();
+    }
+    m_process_state = PROC_HDR;
+    return resp;
+}
+
 ocsd_datapath_resp_t TrcPktProcEtmV4I::outputUnsyncedRawPacket()
 {
     ocsd_datapath_resp_t resp = OCSD_RESP_CONT;
@@ -294,6 +305,24 @@ void TrcPktProcEtmV4I::iNotSync(const uint8_t lastByte)
     }
 }
 
+// unsynced bytes are sent in blocks of 8 if there is a raw packet monitor to show them,
+// otherwise all bytes before the next 0x00 are sent together.
+void TrcPktProcEtmV4I::iNotSyncScan()
+{
+    const uint32_t dump_size = 8;
+    uint32_t max_bytes = m_trcIn.size();
+
+    if (hasRawMon())
+        max_bytes = (m_currPacketData.size() < dump_size) ? dump_size - m_currPacketData.size() : 0;
+
+    if (m_trcIn.copyBytesToPktUntil(0x00, max_bytes) && (m_currPacketData.size() >= dump_size))
+    {
+        m_dump_unsynced_bytes = m_currPacketData.size();
+        m_process_state = SEND_UNSYNCED;
+        m_update_on_unsync_packet_index = m_blockIndex + m_trcIn.processed();
+    }
+}
+
 void TrcPktProcEtmV4I::iPktNoPayload(const uint8_t lastByte)
 {
     // some expansion may be required...
@@ -329,13 +358,13 @@ void TrcPktProcEtmV4I::iPktNoPayload(const uint8_t lastByte)
 void TrcPktProcEtmV4I::iPktReserved(const uint8_t lastByte)
 {
     m_curr_packet.updateErrType(ETM4_PKT_I_RESERVED, lastByte);   // swap type for err type
-    throw ocsdError(OCSD_ERR_SEV_ERROR, OCSD_ERR_INVALID_PCKT_HDR,m_packet_index,m_config.getTraceID());
+    setBadHeaderError();
 }
 
 void TrcPktProcEtmV4I::iPktInvalidCfg(const uint8_t lastByte)
 {
     m_curr_packet.updateErrType(ETM4_PKT_I_RESERVED_CFG, lastByte);   // swap type for err type
-    throw ocsdError(OCSD_ERR_SEV_ERROR, OCSD_ERR_INVALID_PCKT_HDR, m_packet_index, m_config.getTraceID());
+    setBadHeaderError();
 }
 
 void TrcPktProcEtmV4I::iPktExtension(const uint8_t lastByte)
@@ -467,27 +496,37 @@ void TrcPktProcEtmV4I::iPktTraceInfo(const uint8_t lastByte)
         if((presSect & TINFO_INFO_SECT) && (idx < m_currPacketData.size()))
         {
             idx += extractContField(m_currPacketData,idx,fieldVal);
+            if (pktErrorSet())
+                return;
             m_curr_packet.setTraceInfo(fieldVal);
         }
         if((presSect & TINFO_KEY_SECT) && (idx < m_currPacketData.size()))
         {
             idx += extractContField(m_currPacketData,idx,fieldVal);
+            if (pktErrorSet())
+                return;
             m_curr_packet.setTraceInfoKey(fieldVal);
         }
         if((presSect & TINFO_SPEC_SECT) && (idx < m_currPacketData.size()))
         {
             idx += extractContField(m_currPacketData,idx,fieldVal);
+            if (pktErrorSet())
+                return;
             m_curr_packet.setTraceInfoSpec(fieldVal);
             m_curr_packet.trace_info.bits.spec_field_present = 1;
         }
         if((presSect & TINFO_CYCT_SECT) && (idx < m_currPacketData.size()))
         {
             idx += extractContField(m_currPacketData,idx,fieldVal);
+            if (pktErrorSet())
+                return;
             m_curr_packet.setTraceInfoCyct(fieldVal);
         }
         if ((presSect & TINFO_WNDW_SECT) && (idx < m_currPacketData.size()))
         {
             idx += extractContField(m_currPacketData, idx, fieldVal);
+            if (pktErrorSet())
+                return;
             /* Trace commit window unsupported in current ETE versions */
         }
         m_process_state = SEND_PKT;
@@ -531,6 +570,8 @@ void TrcPktProcEtmV4I::iPktTimestamp(const uint8_t lastByte)
         int idx = 1;
         uint64_t tsVal;
         int ts_bytes = extractTSField64(m_currPacketData, idx, tsVal);
+        if (pktErrorSet())
+            return;
         int ts_bits;
         
         // if ts_bytes 8 or less, then cont bits on each byte, otherwise full 64 bit value for 9 bytes
@@ -547,6 +588,8 @@ void TrcPktProcEtmV4I::iPktTimestamp(const uint8_t lastByte)
             
             idx += ts_bytes;           
             extractContField(m_currPacketData, idx, countVal, 3);    // only 3 possible count bytes.
+            if (pktErrorSet())
+                return;
             countMask = (((uint32_t)1UL << m_config.ccSize()) - 1); // mask of the CC size
             countVal &= countMask;
             m_curr_packet.setCycleCount(countVal);
@@ -676,11 +719,15 @@ void TrcPktProcEtmV4I::iPktCycleCntF123(const uint8_t lastByte)
         if(!m_config.commitOpt1())
         {
             idx += extractContField(m_currPacketData,idx,field_value);
+            if (pktErrorSet())
+                return;
             m_curr_packet.setCommitElements(field_value);
         }
 		if (m_has_count)
 		{
 			extractContField(m_currPacketData, idx, field_value, 3);
+			if (pktErrorSet())
+				return;
 			m_curr_packet.setCycleCount(field_value + m_curr_packet.getCCThreshold());
 		}
 		else
@@ -724,6 +771,8 @@ void TrcPktProcEtmV4I::iPktSpeclRes(const uint8_t lastByte)
         {
             uint32_t field_val = 0;
             extractContField(m_currPacketData,1,field_val);
+            if (pktErrorSet())
+                return;
             if(m_curr_packet.getType() == ETM4_PKT_I_COMMIT)
                 m_curr_packet.setCommitElements(field_val);
             else
@@ -769,6 +818,8 @@ void TrcPktProcEtmV4I::iPktCondInstr(const uint8_t lastByte)
     {
         uint32_t cond_key = 0;
         extractContField(m_currPacketData, 1, cond_key);       
+        if (pktErrorSet())
+            return;
         m_process_state = SEND_PKT;        
     }
 }
@@ -831,10 +882,14 @@ void TrcPktProcEtmV4I::iPktCondResult(const uint8_t lastByte)
             uint8_t CI[2];
 
             st_idx+= extractCondResult(m_currPacketData,st_idx,key[0],result[0]);
+            if (pktErrorSet())
+                return;
             CI[0] = m_currPacketData[0] & 0x1;
             if(m_F1has_P2) // 2nd payload?
             {
                 extractCondResult(m_currPacketData,st_idx,key[1],result[1]);
+                if (pktErrorSet())
+                    return;
                 CI[1] = (m_currPacketData[0] >> 1) & 0x1;
             }
             m_curr_packet.setCondRF1(key,result,CI,m_F1has_P2);
@@ -1183,6 +1238,8 @@ void TrcPktProcEtmV4I::iPktQ(const uint8_t lastByte)
         if(m_Q_type != 0xF)
         {
             extractContField(m_currPacketData,idx,q_count);
+            if (pktErrorSet())
+                return;
             m_curr_packet.setQType(true,q_count,m_has_addr,m_addr_match,m_Q_type);
         }
         else
@@ -1690,7 +1747,8 @@ void TrcPktProcEtmV4I::BuildIPacketTable()
         }
         else
         {
-            throwBadSequenceError("Invalid 32 bit continuation fields in packet");
+            setBadSequenceError("Invalid 32 bit continuation fields in packet");
+            break;
         }
     }
     return idx;
@@ -1727,7 +1785,8 @@ unsigned TrcPktProcEtmV4I::extractTSField64(const std::vector<uint8_t> &buffer,
         }
         else
         {
-            throwBadSequenceError("Invalid 64 bit continuation fields in packet");
+            setBadSequenceError("Invalid 64 bit continuation fields in packet");
+            break;
         }
     }
     // index is the count of bytes used here.
@@ -1762,7 +1821,8 @@ unsigned TrcPktProcEtmV4I::extractTSField64(const std::vector<uint8_t> &buffer,
         }
         else
         {
-            throwBadSequenceError("Invalid continuation fields in packet");
+            setBadSequenceError("Invalid continuation fields in packet");
+            break;
         }
     }    
     return idx;
@@ -1808,10 +1868,31 @@ int TrcPktProcEtmV4I::extract32BitLongAddr(const std::vector<uint8_t> &buffer, c
     return 4;
 }
 
-void TrcPktProcEtmV4I::throwBadSequenceError(const char *pszExtMsg)
+void TrcPktProcEtmV4I::setBadSequenceError(const char *pszExtMsg)
 {
     m_curr_packet.updateErrType(ETM4_PKT_I_BAD_SEQUENCE);   // swap type for err type
-    throw ocsdError(OCSD_ERR_SEV_ERROR, OCSD_ERR_BAD_PACKET_SEQ,m_packet_index,m_config.getTraceID(),pszExtMsg);
+    setPktError(OCSD_ERR_BAD_PACKET_SEQ, m_packet_index, m_config.getTraceID(), pszExtMsg);
+    m_process_state = PROC_ERR;
+}
+
+void TrcPktProcEtmV4I::setBadHeaderError()
+{
+    setPktError(OCSD_ERR_INVALID_PCKT_HDR, m_packet_index, m_config.getTraceID());
+    m_process_state = PROC_ERR;
+}
+
+ocsd_datapath_resp_t TrcPktProcEtmV4I::processPktError()
+{
+    // send invalid packets up the pipe to let the next stage decide what to do.
+    ocsd_err_t err = logPktError();
+    if (err == OCSD_ERR_INVALID_PCKT_HDR)
+        statsAddBadHdrCount(1);
+    else if (err == OCSD_ERR_BAD_PACKET_SEQ)
+        statsAddBadSeqCount(1);
+    else
+        return OCSD_RESP_FATAL_INVALID_DATA;    // bail out on any other error.
+    m_process_state = SEND_PKT;
+    return OCSD_RESP_CONT;
 }
 
 
@@ -37,6 +37,7 @@
 #include "i_dec/trc_idec_arminst.h"
 
 #include <cstdlib>
+#include <cstring>
 
 ITraceErrorLog* TrcIDecode::p_i_errlog = 0;
 
@@ -87,6 +88,52 @@ ocsd_err_t TrcIDecode::DecodeInstruction(ocsd_instr_info *instr_info)
     return err;
 }
 
+ocsd_err_t TrcIDecode::DecodeInstructionBlock(ocsd_instr_info *instr_info, const uint8_t *p_opcodes, 
+                                              const uint32_t num_bytes, const uint32_t max_instr, uint32_t *num_instr)
+{
+    if (instr_info->isa == ocsd_isa_aarch64)
+        return DecodeA64Block(instr_info, p_opcodes, num_bytes, max_instr, num_instr);
+    return IInstrDecode::DecodeInstructionBlock(instr_info, p_opcodes, num_bytes, max_instr, num_instr);
+}
+
+/* A64 instructions are fixed size - only opcodes in the branch / system encoding group, 
+   and the last in the block, need a full decode. 
+ */
+ocsd_err_t TrcIDecode::DecodeA64Block(ocsd_instr_info *instr_info, const uint8_t *p_opcodes, 
+                                      const uint32_t num_bytes, const uint32_t max_instr, uint32_t *num_instr)
+{
+    ocsd_err_t err = OCSD_OK;
+    const ocsd_vaddr_t st_addr = instr_info->instr_addr;
+    uint32_t total = num_bytes / 4, idx = 0, opcode;
+
+    if (max_instr && (max_instr < total))
+        total = max_instr;
+
+    while (idx < total)
+    {
+        // skip opcodes that cannot be waypoints - or fail the bad opcode check.
+        while (idx < (total - 1))
+        {
+            memcpy(&opcode, p_opcodes + (idx * 4), 4);
+            if (inst_A64_in_branch_sys_group(opcode) || 
+                (aa64_err_bad_opcode && !(opcode & 0xFFFF0000)))
+                break;
+            idx++;
+        }
+
+        instr_info->instr_addr = st_addr + (idx * 4);
+        memcpy(&instr_info->opcode, p_opcodes + (idx * 4), 4);
+        err = TrcIDecode::DecodeInstruction(instr_info);
+        if (err != OCSD_OK)
+            break;
+        idx++;
+        if (instr_info->type != OCSD_INSTR_OTHER)
+            break;
+    }
+    *num_instr = idx;
+    return err;
+}
+
 ocsd_err_t TrcIDecode::DecodeA32(ocsd_instr_info *instr_info, struct decode_info *info)
 {
     uint32_t branchAddr = 0;
@@ -254,7 +254,7 @@ ocsd_datapath_resp_t TrcPktDecodeItm::decodePacket()
 
     }
 
-    if (bSendPacket)
+    if (bSendPacket && isElemOut(OCSD_GEN_TRC_ELEM_ITMTRACE))
     {
         if (m_b_prevOverflow) 
         {
@@ -41,6 +41,8 @@
 #include <sstream>
 #include <iomanip>
 
+std::atomic<uint32_t> TrcMemAccessorBase::s_range_update_seq(0);
+
  /** Accessor Creation */
 ocsd_err_t TrcMemAccFactory::CreateBufferAccessor(TrcMemAccessorBase **pAccessor, const ocsd_vaddr_t s_address, const uint8_t *p_buffer, const uint32_t size)
 {
@@ -53,11 +55,11 @@ ocsd_err_t TrcMemAccFactory::CreateBufferAccessor(TrcMemAccessorBase **pAccessor
     return err;
 }
 
-ocsd_err_t TrcMemAccFactory::CreateFileAccessor(TrcMemAccessorBase **pAccessor, const std::string &pathToFile, ocsd_vaddr_t startAddr, size_t offset /*= 0*/, size_t size /*= 0*/)
+ocsd_err_t TrcMemAccFactory::CreateFileAccessor(TrcMemAccessorBase **pAccessor, const std::string &pathToFile, ocsd_vaddr_t startAddr, size_t offset /*= 0*/, size_t size /*= 0*/, const bool use_mmap /*= false*/, const ocsd_mem_acc_ctxt_t *p_mem_ctxt /*= 0*/)
 {
     ocsd_err_t err = OCSD_OK;
     TrcMemAccessorFile *pFileAccessor = 0;
-    err = TrcMemAccessorFile::createFileAccessor(&pFileAccessor, pathToFile, startAddr, offset,size);
+    err = TrcMemAccessorFile::createFileAccessor(&pFileAccessor, pathToFile, startAddr, offset, size, use_mmap, p_mem_ctxt);
     *pAccessor = pFileAccessor;
     return err;
 }
@@ -121,6 +123,10 @@ void TrcMemAccessorBase::getMemAccString(std::string& accStr) const
     oss << "; Mem Space::";
     getMemAccSpaceString(spaceStr, m_mem_space);
     oss << spaceStr;
+    if (m_mem_ctxt.ctxt_id_valid)
+        oss << "; CtxtID::0x" << std::hex << m_mem_ctxt.context_id;
+    if (m_mem_ctxt.vmid_valid)
+        oss << "; VMID::0x" << std::hex << m_mem_ctxt.vmid;
 
     accStr = oss.str();
 }
@@ -65,4 +65,15 @@ const uint32_t TrcMemAccBufPtr::readBytes(const ocsd_vaddr_t address, const ocsd
     return bytesRead;
 }
 
+const uint8_t *TrcMemAccBufPtr::getBytesPtr(const ocsd_vaddr_t address, const ocsd_mem_space_acc_t mem_space, const uint8_t trcID, uint32_t *numBytes)
+{
+    *numBytes = 0;
+    if (!m_p_buffer)
+        return 0;
+
+    // mapper will filter memory spaces.
+    *numBytes = bytesInRange(address, 0xFFFFFFFF);
+    return *numBytes ? m_p_buffer + address - m_startAddress : 0;
+}
+
 /* End of File trc_mem_acc_bufptr.cpp */
@@ -65,6 +65,8 @@
 
 ocsd_err_t TrcMemAccCache::createCaches()
 {
+    int num_buckets;
+
     if (m_mru)
         destroyCaches();
     m_mru = (cache_block_t*) new (std::nothrow) cache_block_t[m_mru_num_pages];
@@ -74,8 +76,23 @@ ocsd_err_t TrcMemAccCache::createCaches()
         m_mru[i].data = new (std::nothrow) uint8_t[m_mru_page_size];
         if (!m_mru[i].data)
             return OCSD_ERR_MEM;
-        clearPage(&m_mru[i]);
     }
+
+    /* hash block size is the smallest power of 2 that will hold a page */
+    m_blk_shift = 0;
+    while ((1U << m_blk_shift) < m_mru_page_size)
+        m_blk_shift++;
+
+    /* at least 2 buckets per page, power of 2 */
+    num_buckets = 1;
+    while (num_buckets < (m_mru_num_pages * 2))
+        num_buckets <<= 1;
+    m_hash_mask = (uint32_t)(num_buckets - 1);
+    m_hash_tbl = new (std::nothrow) int[num_buckets];
+    if (!m_hash_tbl)
+        return OCSD_ERR_MEM;
+
+    resetPages();
 #ifdef LOG_CACHE_STATS
     m_hit_rl = (uint32_t *) new (std::nothrow) uint32_t[m_mru_num_pages];
     m_hit_rl_max = (uint32_t*) new (std::nothrow) uint32_t[m_mru_num_pages];
@@ -102,6 +119,12 @@ void TrcMemAccCache::destroyCaches()
         delete[] m_mru;
         m_mru = 0;
     }
+    if (m_hash_tbl) {
+        delete[] m_hash_tbl;
+        m_hash_tbl = 0;
+    }
+    m_mru_idx = 0;
+    m_lru_head = m_lru_tail = -1;
 #ifdef LOG_CACHE_STATS
     if (m_hit_rl)
         delete[] m_hit_rl;
@@ -242,70 +265,153 @@ ocsd_err_t TrcMemAccCache::setCacheSizes(const uint16_t page_size, const int nr_
     return createCaches();
 }
 
-/* return index of unused page, or oldest used page by sequence number */
+/* return index of page at the tail of the LRU list - clean pages are always placed at the tail. */
 int TrcMemAccCache::findNewPage()
 {
-    uint32_t oldest_seq;
-    int current_idx, oldest_idx;
+    int idx = m_lru_tail;
 #ifdef LOG_CACHE_OPS
     std::ostringstream oss;
 #endif
 
-    /* set up search indexes and check the current search index has not wrapped. */
-    current_idx = m_mru_idx + 1;
-    oldest_idx = m_mru_idx;
-    oldest_seq = 0;
-    if (current_idx >= m_mru_num_pages)
-        current_idx = 0;
+    if (m_mru[idx].valid_len == 0) {
+#ifdef LOG_CACHE_OPS
+        oss << "TrcMemAccCache:: ALI-allocate clean page:  [page: " << std::dec << idx << "]\n";
+        logMsg(oss.str());
+#endif
+        return idx;
+    }
 
-    /* search forwards from m_mru_idx + 1 until we wrap and hit the index again */
-    while (current_idx != m_mru_idx) {
-        if (m_mru[current_idx].use_sequence == 0) {
 #ifdef LOG_CACHE_OPS
-            oss << "TrcMemAccCache:: ALI-allocate clean page:  [page: " << std::dec << current_idx << "]\n";
-            logMsg(oss.str());
+    oss << "TrcMemAccCache:: ALI-evict and allocate old page:  [page: " << std::dec << idx << "]\n";
+    logMsg(oss.str());
 #endif
-            return current_idx;
-        }
+    clearPage(&m_mru[idx]);
+    return idx;
+}
 
-        // if we find a page with a lower use sequence, that is older.
-        if ((oldest_seq == 0) || (oldest_seq > m_mru[current_idx].use_sequence)) {
-            oldest_seq = m_mru[current_idx].use_sequence;
-            oldest_idx = current_idx;
-        }
+// zero out page parameters rendering it empty, remove from index and move to LRU tail for re-use.
+void TrcMemAccCache::clearPage(cache_block_t* page)
+{
+    int idx = (int)(page - m_mru);
+
+    if (page->valid_len)
+        hashRemove(idx);
+    page->st_addr = 0;
+    page->valid_len = 0;
+    page->trcID = OCSD_BAD_CS_SRC_ID;
+    page->p_acc = 0;
+    page->mem_space = OCSD_MEM_SPACE_NONE;
+    if (m_lru_tail != idx) {
+        lruUnlink(idx);
+        lruPushTail(idx);
+    }
+}
 
-        current_idx++;
+void TrcMemAccCache::resetPages()
+{
+    for (uint32_t i = 0; i <= m_hash_mask; i++)
+        m_hash_tbl[i] = -1;
 
-        // wrap around?
-        if (current_idx >= m_mru_num_pages)
-            current_idx = 0;
+    m_lru_head = m_lru_tail = -1;
+    for (int i = 0; i < m_mru_num_pages; i++) {
+        m_mru[i].st_addr = 0;
+        m_mru[i].valid_len = 0;
+        m_mru[i].trcID = OCSD_BAD_CS_SRC_ID;
+        m_mru[i].p_acc = 0;
+        m_mru[i].mem_space = OCSD_MEM_SPACE_NONE;
+        m_mru[i].hash_prev = m_mru[i].hash_next = -1;
+        lruPushTail(i);
     }
-#ifdef LOG_CACHE_OPS
-    oss << "TrcMemAccCache:: ALI-evict and allocate old page:  [page: " << std::dec << oldest_idx << "]\n";
-    logMsg(oss.str());
-#endif
-    return oldest_idx;
+    m_mru_idx = 0;
 }
 
-void TrcMemAccCache::incSequence()
+void TrcMemAccCache::hashInsert(const int idx)
 {
-    m_mru[m_mru_idx].use_sequence = m_mru_sequence++;
-    if (m_mru_sequence == 0) {
-        // wrapped which throws out the oldest algorithm - oldest will now appear newer - so not evicted.
-        // arbitrarily re-sequence all in use..
-        m_mru_sequence = 1;
-        for (int i = 0; i < m_mru_num_pages; i++)
-            if (m_mru[i].use_sequence != 0)
-                m_mru[i].use_sequence = m_mru_sequence++;
+    uint32_t bucket = hashBucket(m_mru[idx].st_addr >> m_blk_shift);
+
+    m_mru[idx].hash_prev = -1;
+    m_mru[idx].hash_next = m_hash_tbl[bucket];
+    if (m_hash_tbl[bucket] != -1)
+        m_mru[m_hash_tbl[bucket]].hash_prev = idx;
+    m_hash_tbl[bucket] = idx;
+}
 
-        // ensure newest still newest...
-        m_mru[m_mru_idx].use_sequence = m_mru_sequence++;
+void TrcMemAccCache::hashRemove(const int idx)
+{
+    cache_block_t *page = &m_mru[idx];
+
+    if (page->hash_prev != -1)
+        m_mru[page->hash_prev].hash_next = page->hash_next;
+    else
+        m_hash_tbl[hashBucket(page->st_addr >> m_blk_shift)] = page->hash_next;
+    if (page->hash_next != -1)
+        m_mru[page->hash_next].hash_prev = page->hash_prev;
+    page->hash_prev = page->hash_next = -1;
+}
+
+void TrcMemAccCache::lruUnlink(const int idx)
+{
+    cache_block_t *page = &m_mru[idx];
+
+    if (page->lru_prev != -1)
+        m_mru[page->lru_prev].lru_next = page->lru_next;
+    else
+        m_lru_head = page->lru_next;
+    if (page->lru_next != -1)
+        m_mru[page->lru_next].lru_prev = page->lru_prev;
+    else
+        m_lru_tail = page->lru_prev;
+    page->lru_prev = page->lru_next = -1;
+}
+
+void TrcMemAccCache::lruPushHead(const int idx)
+{
+    m_mru[idx].lru_prev = -1;
+    m_mru[idx].lru_next = m_lru_head;
+    if (m_lru_head != -1)
+        m_mru[m_lru_head].lru_prev = idx;
+    else
+        m_lru_tail = idx;
+    m_lru_head = idx;
+}
+
+void TrcMemAccCache::lruPushTail(const int idx)
+{
+    m_mru[idx].lru_next = -1;
+    m_mru[idx].lru_prev = m_lru_tail;
+    if (m_lru_tail != -1)
+        m_mru[m_lru_tail].lru_next = idx;
+    else
+        m_lru_head = idx;
+    m_lru_tail = idx;
+}
+
+void TrcMemAccCache::lruMoveToHead(const int idx)
+{
+    if (m_lru_head != idx) {
+        lruUnlink(idx);
+        lruPushHead(idx);
     }
 }
 
 ocsd_err_t TrcMemAccCache::readBytesFromCache(TrcMemAccessorBase *p_accessor, const ocsd_vaddr_t address, const ocsd_mem_space_acc_t mem_space, const uint8_t trcID, uint32_t *numBytes, uint8_t *byteBuffer)
 {
-    uint32_t bytesRead = 0, reqBytes = *numBytes;
+    uint32_t bytesAvail = *numBytes;
+    const uint8_t *p_data = 0;
+    ocsd_err_t err;
+
+    err = readPtrFromCache(p_accessor, address, mem_space, trcID, &bytesAvail, &p_data);
+    if (p_data)
+        memcpy(byteBuffer, p_data, *numBytes);
+    else
+        *numBytes = 0;
+    return err;
+}
+
+ocsd_err_t TrcMemAccCache::readPtrFromCache(TrcMemAccessorBase *p_accessor, const ocsd_vaddr_t address, const ocsd_mem_space_acc_t mem_space, const uint8_t trcID, uint32_t *numBytes, const uint8_t **pp_data)
+{
+    uint32_t reqBytes = *numBytes;
+    bool bInPage = false;
     ocsd_err_t err = OCSD_OK;
     
 
@@ -316,13 +422,12 @@ ocsd_err_t TrcMemAccCache::readBytesFromCache(TrcMemAccessorBase *p_accessor, co
 
     if (m_bCacheEnabled)
     {
-        if (blockInCache(address, reqBytes, trcID))
+        if (blockInCache(address, reqBytes, trcID, p_accessor, mem_space))
         {
-            bytesRead = reqBytes;
-            memcpy(byteBuffer, &m_mru[m_mru_idx].data[address - m_mru[m_mru_idx].st_addr], reqBytes);
-            incSequence();
+            bInPage = true;
+            lruMoveToHead(m_mru_idx);
 #ifdef LOG_CACHE_OPS
-            oss << "TrcMemAccCache:: hit {page: " << std::dec << m_mru_idx << "; seq: " << m_mru[m_mru_idx].use_sequence << " CSID: " << std::hex << (int)m_mru[m_mru_idx].trcID;
+            oss << "TrcMemAccCache:: hit {page: " << std::dec << m_mru_idx << "; CSID: " << std::hex << (int)m_mru[m_mru_idx].trcID;
             oss << "} [addr:0x" << std::hex << address << ", bytes: " << std::dec << reqBytes << "]\n";
             logMsg(oss.str());
 #endif
@@ -350,7 +455,10 @@ ocsd_err_t TrcMemAccCache::readBytesFromCache(TrcMemAccessorBase *p_accessor, co
                 // got some data - so save the details                
                 m_mru[m_mru_idx].st_addr = address;
                 m_mru[m_mru_idx].trcID = trcID;
-                incSequence();
+                m_mru[m_mru_idx].p_acc = p_accessor;
+                m_mru[m_mru_idx].mem_space = mem_space;
+                hashInsert(m_mru_idx);
+                lruMoveToHead(m_mru_idx);
 
                 // log the run length hit counts
                 SET_MAX_RL(m_mru_idx);
@@ -358,16 +466,15 @@ ocsd_err_t TrcMemAccCache::readBytesFromCache(TrcMemAccessorBase *p_accessor, co
 #ifdef LOG_CACHE_OPS
                 TrcMemAccessorBase::getMemAccSpaceString(memSpaceStr, mem_space);
                 oss.str("");
-                oss << "TrcMemAccCache:: ALI-load {page: " << std::dec << m_mru_idx << "; seq: " << m_mru[m_mru_idx].use_sequence << " CSID: " << std::hex << (int)m_mru[m_mru_idx].trcID;
+                oss << "TrcMemAccCache:: ALI-load {page: " << std::dec << m_mru_idx << "; CSID: " << std::hex << (int)m_mru[m_mru_idx].trcID;
                 oss << "} [mem space: " << memSpaceStr << ", addr:0x" << std::hex << address << ", bytes: " << std::dec << m_mru[m_mru_idx].valid_len << "]\n";
                 logMsg(oss.str());
 #endif
                 INC_PAGES();              
 
-                if (blockInPage(address, reqBytes, trcID)) /* check we got the data we needed */
+                if (blockInPage(m_mru_idx, address, reqBytes, trcID, p_accessor, mem_space)) /* check we got the data we needed */
                 {
-                    bytesRead = reqBytes;
-                    memcpy(byteBuffer, &m_mru[m_mru_idx].data[address - m_mru[m_mru_idx].st_addr], reqBytes);
+                    bInPage = true;
                     INC_RL(m_mru_idx);
                 }
                 else
@@ -382,7 +489,17 @@ ocsd_err_t TrcMemAccCache::readBytesFromCache(TrcMemAccessorBase *p_accessor, co
             }
         }
     }
-    *numBytes = bytesRead;
+
+    if (bInPage)
+    {
+        *pp_data = &m_mru[m_mru_idx].data[address - m_mru[m_mru_idx].st_addr];
+        *numBytes = (uint32_t)(m_mru[m_mru_idx].st_addr + m_mru[m_mru_idx].valid_len - address);
+    }
+    else
+    {
+        *pp_data = 0;
+        *numBytes = 0;
+    }
     return err;
 }
 
@@ -394,9 +511,8 @@ void TrcMemAccCache::invalidateAll()
     logMsg(oss.str());
 #endif
 
-    for (int i = 0; i < m_mru_num_pages; i++)
-        clearPage(&m_mru[i]);
-    m_mru_idx = 0;
+    if (m_mru)
+        resetPages();
 }
 
 void TrcMemAccCache::invalidateByTraceID(int8_t trcID)
@@ -413,7 +529,7 @@ void TrcMemAccCache::invalidateByTraceID(int8_t trcID)
         {
 #ifdef LOG_CACHE_OPS
             oss.str("");
-            oss << "TrcMemAccCache:: ALI-invalidate page {page: " << std::dec << i << "; seq: " << m_mru[i].use_sequence << " CSID: " << std::hex << (int)m_mru[i].trcID;
+            oss << "TrcMemAccCache:: ALI-invalidate page {page: " << std::dec << i << "; CSID: " << std::hex << (int)m_mru[i].trcID;
             oss << "} [addr:0x" << std::hex << m_mru[i].st_addr << ", bytes: " << std::dec << m_mru[i].valid_len << "]\n";
             logMsg(oss.str());
 #endif
@@ -422,6 +538,15 @@ void TrcMemAccCache::invalidateByTraceID(int8_t trcID)
     }
 }
 
+void TrcMemAccCache::invalidateCtxtPagesByTraceID(int8_t trcID)
+{
+    for (int i = 0; i < m_mru_num_pages; i++)
+    {
+        if ((m_mru[i].trcID == trcID) && m_mru[i].p_acc && m_mru[i].p_acc->hasMemContext())
+            clearPage(&m_mru[i]);
+    }
+}
+
 void TrcMemAccCache::logMsg(const std::string &szMsg, ocsd_err_t err /*= OCSD_OK */ )
 {
     if (m_err_log)
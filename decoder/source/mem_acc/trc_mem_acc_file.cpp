@@ -35,6 +35,17 @@
 
 #include <sstream>
 #include <iomanip>
+#include <cstring>
+
+#ifdef WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 /***************************************************/
 /* protected construction and reference counting   */
@@ -46,12 +57,15 @@ TrcMemAccessorFile::TrcMemAccessorFile() : TrcMemAccessorBase(MEMACC_FILE)
     m_base_range_set = false;
     m_has_access_regions = false;
     m_file_size = 0;
+    m_p_mapped = 0;
+    m_mapped_size = 0;
 }
 
 TrcMemAccessorFile::~TrcMemAccessorFile()
 {
     if(m_mem_file.is_open())
         m_mem_file.close();
+    unmapFile();
     if(m_access_regions.size())
     {
         std::list<FileRegionMemAccessor *>::iterator it;
@@ -65,16 +79,29 @@ TrcMemAccessorFile::~TrcMemAccessorFile()
     }
 }
 
-ocsd_err_t TrcMemAccessorFile::initAccessor(const std::string &pathToFile, ocsd_vaddr_t startAddr, size_t offset, size_t size)
+ocsd_err_t TrcMemAccessorFile::initAccessor(const std::string &pathToFile, ocsd_vaddr_t startAddr, size_t offset, size_t size, const bool use_mmap)
 {
     ocsd_err_t err = OCSD_OK;
     bool init = false;
+    bool opened = false;
 
-    m_mem_file.open(pathToFile.c_str(), std::ifstream::binary | std::ifstream::ate);
-    if(m_mem_file.is_open())
+    if(use_mmap)
+    {
+        if((opened = mapFile(pathToFile)) == true)
+            m_file_size = (ocsd_vaddr_t)m_mapped_size & ((ocsd_vaddr_t)~0x1);
+    }
+    else
+    {
+        m_mem_file.open(pathToFile.c_str(), std::ifstream::binary | std::ifstream::ate);
+        if((opened = m_mem_file.is_open()) == true)
+        {
+            m_file_size = (ocsd_vaddr_t)m_mem_file.tellg() & ((ocsd_vaddr_t)~0x1);
+            m_mem_file.seekg(0, m_mem_file.beg);
+        }
+    }
+
+    if(opened)
     {
-        m_file_size = (ocsd_vaddr_t)m_mem_file.tellg() & ((ocsd_vaddr_t)~0x1);
-        m_mem_file.seekg(0, m_mem_file.beg);
         // adding an offset of 0, sets the base range.
         if((offset == 0) && (size == 0))
         {
@@ -95,6 +122,62 @@ ocsd_err_t TrcMemAccessorFile::initAccessor(const std::string &pathToFile, ocsd_
 }
 
 
+bool TrcMemAccessorFile::mapFile(const std::string &pathToFile)
+{
+#ifdef WIN32
+    LARGE_INTEGER file_size;
+    HANDLE h_file, h_map;
+    void *p_view = 0;
+
+    h_file = CreateFileA(pathToFile.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if(h_file == INVALID_HANDLE_VALUE)
+        return false;
+    if(GetFileSizeEx(h_file, &file_size) && (file_size.QuadPart > 0))
+    {
+        h_map = CreateFileMappingA(h_file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if(h_map != NULL)
+        {
+            // view holds a reference to the mapping - handles can be closed.
+            p_view = MapViewOfFile(h_map, FILE_MAP_READ, 0, 0, 0);
+            CloseHandle(h_map);
+        }
+    }
+    CloseHandle(h_file);
+    if(p_view == 0)
+        return false;
+    m_mapped_size = (size_t)file_size.QuadPart;
+#else
+    struct stat file_stat;
+    void *p_view = MAP_FAILED;
+
+    int fd = open(pathToFile.c_str(), O_RDONLY);
+    if(fd < 0)
+        return false;
+    if((fstat(fd, &file_stat) == 0) && (file_stat.st_size > 0))
+        p_view = mmap(0, (size_t)file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);   // mapping remains valid after close.
+    if(p_view == MAP_FAILED)
+        return false;
+    m_mapped_size = (size_t)file_stat.st_size;
+#endif
+    m_p_mapped = (const uint8_t *)p_view;
+    return true;
+}
+
+void TrcMemAccessorFile::unmapFile()
+{
+    if(m_p_mapped)
+    {
+#ifdef WIN32
+        UnmapViewOfFile((LPCVOID)m_p_mapped);
+#else
+        munmap((void *)m_p_mapped, m_mapped_size);
+#endif
+        m_p_mapped = 0;
+        m_mapped_size = 0;
+    }
+}
+
 FileRegionMemAccessor *TrcMemAccessorFile::getRegionForAddress(const ocsd_vaddr_t startAddr) const
 {
     FileRegionMemAccessor *p_region = 0;
@@ -117,14 +200,35 @@ FileRegionMemAccessor *TrcMemAccessorFile::getRegionForAddress(const ocsd_vaddr_
 /* static object creation                          */
 /***************************************************/
 
-std::map<std::string, TrcMemAccessorFile *> TrcMemAccessorFile::s_FileAccessorMap;
+std::map<TrcMemAccessorFile::file_acc_key_t, TrcMemAccessorFile *> TrcMemAccessorFile::s_FileAccessorMap;
+
+TrcMemAccessorFile::file_acc_key_t TrcMemAccessorFile::makeFileKey(const std::string &pathToFile, const ocsd_mem_acc_ctxt_t *p_mem_ctxt)
+{
+    uint8_t flags = 0;
+    uint64_t val = 0;
+    if (p_mem_ctxt)
+    {
+        if (p_mem_ctxt->ctxt_id_valid)
+        {
+            flags |= 0x1;
+            val |= (uint64_t)p_mem_ctxt->context_id;
+        }
+        if (p_mem_ctxt->vmid_valid)
+        {
+            flags |= 0x2;
+            val |= ((uint64_t)p_mem_ctxt->vmid) << 32;
+        }
+    }
+    return file_acc_key_t(pathToFile, std::pair<uint8_t, uint64_t>(flags, val));
+}
 
 // return existing or create new accessor
-ocsd_err_t TrcMemAccessorFile::createFileAccessor(TrcMemAccessorFile **p_acc, const std::string &pathToFile, ocsd_vaddr_t startAddr, size_t offset /*= 0*/, size_t size /*= 0*/)
+ocsd_err_t TrcMemAccessorFile::createFileAccessor(TrcMemAccessorFile **p_acc, const std::string &pathToFile, ocsd_vaddr_t startAddr, size_t offset /*= 0*/, size_t size /*= 0*/, const bool use_mmap /*= false*/, const ocsd_mem_acc_ctxt_t *p_mem_ctxt /*= 0*/)
 {
     ocsd_err_t err = OCSD_OK;
     TrcMemAccessorFile * acc = 0;
-    std::map<std::string, TrcMemAccessorFile *>::iterator it = s_FileAccessorMap.find(pathToFile);
+    const file_acc_key_t key = makeFileKey(pathToFile, p_mem_ctxt);
+    std::map<file_acc_key_t, TrcMemAccessorFile *>::iterator it = s_FileAccessorMap.find(key);
     if(it != s_FileAccessorMap.end())
     {
         acc = it->second;
@@ -141,10 +245,12 @@ ocsd_err_t TrcMemAccessorFile::createFileAccessor(TrcMemAccessorFile **p_acc, co
         acc = new (std::nothrow) TrcMemAccessorFile();
         if(acc != 0)
         {
-            if((err = acc->initAccessor(pathToFile,startAddr, offset,size)) == OCSD_OK)
+            if((err = acc->initAccessor(pathToFile,startAddr, offset,size, use_mmap)) == OCSD_OK)
             {
+                if (p_mem_ctxt)
+                    acc->setMemContext(*p_mem_ctxt);
                 acc->IncRefCount();
-                s_FileAccessorMap.insert(std::pair<std::string, TrcMemAccessorFile *>(pathToFile,acc));
+                s_FileAccessorMap.insert(std::pair<file_acc_key_t, TrcMemAccessorFile *>(key,acc));
             }
             else
             {
@@ -166,8 +272,8 @@ void TrcMemAccessorFile::destroyFileAccessor(TrcMemAccessorFile *p_accessor)
         p_accessor->DecRefCount();
         if(p_accessor->getRefCount() == 0)
         {
-            std::map<std::string, TrcMemAccessorFile *>::iterator it = s_FileAccessorMap.find(p_accessor->getFilePath());
-            if(it != s_FileAccessorMap.end())
+            std::map<file_acc_key_t, TrcMemAccessorFile *>::iterator it = s_FileAccessorMap.find(makeFileKey(p_accessor->getFilePath(), &p_accessor->getMemContext()));
+            if((it != s_FileAccessorMap.end()) && (it->second == p_accessor))
             {
                 s_FileAccessorMap.erase(it);
             }
@@ -176,19 +282,19 @@ void TrcMemAccessorFile::destroyFileAccessor(TrcMemAccessorFile *p_accessor)
     }
 }
 
-const bool TrcMemAccessorFile::isExistingFileAccessor(const std::string &pathToFile)
+const bool TrcMemAccessorFile::isExistingFileAccessor(const std::string &pathToFile, const ocsd_mem_acc_ctxt_t *p_mem_ctxt /*= 0*/)
 {
     bool bExists = false;
-    std::map<std::string, TrcMemAccessorFile *>::const_iterator it = s_FileAccessorMap.find(pathToFile);
+    std::map<file_acc_key_t, TrcMemAccessorFile *>::const_iterator it = s_FileAccessorMap.find(makeFileKey(pathToFile, p_mem_ctxt));
     if(it != s_FileAccessorMap.end())
         bExists = true;
     return bExists;
 }
 
-TrcMemAccessorFile * TrcMemAccessorFile::getExistingFileAccessor(const std::string &pathToFile)
+TrcMemAccessorFile * TrcMemAccessorFile::getExistingFileAccessor(const std::string &pathToFile, const ocsd_mem_acc_ctxt_t *p_mem_ctxt /*= 0*/)
 {
     TrcMemAccessorFile * p_acc = 0;
-    std::map<std::string, TrcMemAccessorFile *>::iterator it = s_FileAccessorMap.find(pathToFile);
+    std::map<file_acc_key_t, TrcMemAccessorFile *>::iterator it = s_FileAccessorMap.find(makeFileKey(pathToFile, p_mem_ctxt));
     if(it != s_FileAccessorMap.end())
         p_acc = it->second;
     return p_acc;
@@ -201,6 +307,9 @@ TrcMemAccessorFile * TrcMemAccessorFile::getExistingFileAccessor(const std::stri
 /***************************************************/
 const uint32_t TrcMemAccessorFile::readBytes(const ocsd_vaddr_t address, const ocsd_mem_space_acc_t mem_space, const uint8_t trcID, const uint32_t reqBytes, uint8_t *byteBuffer)
 {
+    if(m_p_mapped)
+        return readBytesMapped(address, reqBytes, byteBuffer);
+
     if(!m_mem_file.is_open())
         return 0;
     uint32_t bytesRead = 0;
@@ -232,6 +341,55 @@ const uint32_t TrcMemAccessorFile::readBytes(const ocsd_vaddr_t address, const o
     return bytesRead;
 }
 
+// read direct from the mapped file - no shared stream position to manage.
+const uint32_t TrcMemAccessorFile::readBytesMapped(const ocsd_vaddr_t address, const uint32_t reqBytes, uint8_t *byteBuffer)
+{
+    uint32_t bytesRead = 0;
+    const uint8_t *p_data = getMappedPtr(address, reqBytes, &bytesRead);
+
+    if(p_data)
+        memcpy(byteBuffer, p_data, bytesRead);
+    return bytesRead;
+}
+
+const uint8_t *TrcMemAccessorFile::getBytesPtr(const ocsd_vaddr_t address, const ocsd_mem_space_acc_t memSpace, const uint8_t trcID, uint32_t *numBytes)
+{
+    if(!m_p_mapped)
+        return TrcMemAccessorBase::getBytesPtr(address, memSpace, trcID, numBytes);
+    return getMappedPtr(address, 0xFFFFFFFF, numBytes);
+}
+
+const uint8_t *TrcMemAccessorFile::getMappedPtr(const ocsd_vaddr_t address, const uint32_t reqBytes, uint32_t *numBytes)
+{
+    uint32_t bytesRead = 0;
+    ocsd_vaddr_t file_offset = 0;
+    const uint8_t *p_data = 0;
+
+    if(m_base_range_set)
+    {
+        bytesRead = TrcMemAccessorBase::bytesInRange(address,reqBytes);
+        file_offset = address - m_startAddress;
+    }
+
+    if((bytesRead == 0) && m_has_access_regions)
+    {
+        FileRegionMemAccessor *p_region = getRegionForAddress(address);
+        if(p_region)
+        {
+            bytesRead = p_region->bytesInRange(address,reqBytes);
+            file_offset = address - p_region->regionStartAddress() + p_region->getOffset();
+        }
+    }
+
+    // ranges validated against file size when added - but guard the mapping.
+    if(bytesRead && ((file_offset + bytesRead) <= m_mapped_size))
+        p_data = m_p_mapped + file_offset;
+    else
+        bytesRead = 0;
+    *numBytes = bytesRead;
+    return p_data;
+}
+
 bool TrcMemAccessorFile::AddOffsetRange(const ocsd_vaddr_t startAddr, const size_t size, const size_t offset)
 {
     bool addOK = false;
@@ -275,6 +433,10 @@ bool TrcMemAccessorFile::AddOffsetRange(const ocsd_vaddr_t startAddr, const size
             }        
         }
     }
+
+    // accessor already created may be in use by mappers.
+    if(addOK && (m_ref_count > 0))
+        rangeUpdated();
     return addOK;
 }
 
@@ -361,6 +523,24 @@ const bool TrcMemAccessorFile::overLapRange(const TrcMemAccessorBase *p_test_acc
     return bOverLapRange;
 }
 
+void TrcMemAccessorFile::getRanges(std::vector<memacc_range_t> &ranges) const
+{
+    if(m_base_range_set)
+        TrcMemAccessorBase::getRanges(ranges);
+
+    if(m_has_access_regions)
+    {
+        memacc_range_t range;
+        std::list<FileRegionMemAccessor *>::const_iterator it;
+        for(it = m_access_regions.begin(); it != m_access_regions.end(); it++)
+        {
+            range.st_addr = (*it)->regionStartAddress();
+            range.en_addr = (*it)->regionEndAddress();
+            ranges.push_back(range);
+        }
+    }
+}
+
     /*! Override to handle ranges and offset accessors plus add in file name. */
 void TrcMemAccessorFile::getMemAccString(std::string &accStr) const
 {
@@ -386,6 +566,8 @@ void TrcMemAccessorFile::getMemAccString(std::string &accStr) const
         }
     }
     accStr += (std::string)"\nFilename=" + m_file_path;
+    if(m_p_mapped)
+        accStr += " (mmap)";
 }
 
 /* End of File trc_mem_acc_file.cpp */
@@ -44,7 +44,9 @@ TrcMemAccMapper::TrcMemAccMapper() :
     m_acc_curr(0),
     m_trace_id_curr(0),
     m_using_trace_id(false),
-    m_err_log(0)
+    m_err_log(0),
+    m_keep_cache_on_acc_change(false),
+    m_cache_ptr_reads(true)
 {
 }
 
@@ -52,7 +54,9 @@ TrcMemAccMapper::TrcMemAccMapper(bool using_trace_id) :
     m_acc_curr(0),
     m_trace_id_curr(0),
     m_using_trace_id(using_trace_id),
-    m_err_log(0)
+    m_err_log(0),
+    m_keep_cache_on_acc_change(false),
+    m_cache_ptr_reads(true)
 {
 }
 
@@ -77,12 +81,9 @@ ocsd_err_t TrcMemAccMapper::setCacheSizes(uint16_t page_size, int num_pages, con
     return m_cache.setCacheSizes(page_size, num_pages, err_on_limit);
 }
 
-// memory access interface
-ocsd_err_t TrcMemAccMapper::ReadTargetMemory(const ocsd_vaddr_t address, const uint8_t cs_trace_id, const ocsd_mem_space_acc_t mem_space, uint32_t *num_bytes, uint8_t *p_buffer)
+bool TrcMemAccMapper::selectAccessor(const ocsd_vaddr_t address, const ocsd_mem_space_acc_t mem_space, const uint8_t cs_trace_id)
 {
     bool bReadFromCurr = true;
-    uint32_t readBytes = 0;
-    ocsd_err_t err = OCSD_OK;
 
     /* see if the address is in any range we know */
     if (!readFromCurrent(address, mem_space, cs_trace_id))
@@ -90,12 +91,20 @@ ocsd_err_t TrcMemAccMapper::ReadTargetMemory(const ocsd_vaddr_t address, const u
         bReadFromCurr = findAccessor(address, mem_space, cs_trace_id);
 
         // found a new accessor - invalidate any cache entries used by the previous one.
-        if (m_cache.enabled() && bReadFromCurr)
+        if (m_cache.enabled() && bReadFromCurr && !m_keep_cache_on_acc_change)
             m_cache.invalidateByTraceID(cs_trace_id); 
     }
+    return bReadFromCurr;
+}
+
+// memory access interface
+ocsd_err_t TrcMemAccMapper::ReadTargetMemory(const ocsd_vaddr_t address, const uint8_t cs_trace_id, const ocsd_mem_space_acc_t mem_space, uint32_t *num_bytes, uint8_t *p_buffer)
+{
+    uint32_t readBytes = 0;
+    ocsd_err_t err = OCSD_OK;
 
-    /* if bReadFromCurr then we know m_acc_curr is set */
-    if (bReadFromCurr)
+    /* if accessor selected then we know m_acc_curr is set */
+    if (selectAccessor(address, mem_space, cs_trace_id))
     {
         // use cache if enabled and the amount fits into a cache page
         if (m_cache.enabled_for_size(*num_bytes))
@@ -122,6 +131,36 @@ ocsd_err_t TrcMemAccMapper::ReadTargetMemory(const ocsd_vaddr_t address, const u
     return err;
 }
 
+ocsd_err_t TrcMemAccMapper::ReadTargetMemoryPtr(const ocsd_vaddr_t address, const uint8_t cs_trace_id, const ocsd_mem_space_acc_t mem_space, const ocsd_pe_context * /*p_context*/, uint32_t *num_bytes, const uint8_t **pp_data)
+{
+    uint32_t reqBytes = *num_bytes, availBytes = 0;
+    const uint8_t *p_data = 0;
+    ocsd_err_t err = OCSD_OK;
+
+    if (selectAccessor(address, mem_space, cs_trace_id))
+    {
+        // accessors holding the image in memory supply a pointer directly - otherwise use a cache page.
+        p_data = m_acc_curr->getBytesPtr(address, mem_space, cs_trace_id, &availBytes);
+        if ((!p_data || (availBytes < reqBytes)) && m_cache_ptr_reads && m_cache.enabled_for_size(reqBytes))
+        {
+            availBytes = reqBytes;
+            err = m_cache.readPtrFromCache(m_acc_curr, address, mem_space, cs_trace_id, &availBytes, &p_data);
+            if (err != OCSD_OK)
+                LogWarn(err, "Mem Acc: Cache access error");
+        }
+    }
+
+    // only return a pointer if all the required bytes are available.
+    if (!p_data || (availBytes < reqBytes))
+    {
+        p_data = 0;
+        availBytes = 0;
+    }
+    *pp_data = p_data;
+    *num_bytes = availBytes;
+    return err;
+}
+
 void TrcMemAccMapper::InvalidateMemAccCache(const uint8_t cs_trace_id)
 {    
     if (m_cache.enabled())
@@ -305,5 +344,296 @@ void TrcMemAccMapGlobalSpace::logMappedRanges()
     }
     LogMessage("========================\n");
 }
+/************************************************************************************/
+/* accessor range index - per memory space                                          */
+/************************************************************************************/
+void TrcMemAccRangeIdx::indexAccessor(TrcMemAccessorBase *p_accessor, const uint32_t add_order)
+{
+    acc_idx_entry_t entry;
+    std::vector<memacc_range_t>::const_iterator it;
+
+    entry.p_acc = p_accessor;
+    entry.add_order = add_order;
+
+    m_ranges.clear();
+    p_accessor->getRanges(m_ranges);
+    for(int i = 0; i < NUM_SPACE_IDX; i++)
+    {
+        if(p_accessor->inMemSpace((ocsd_mem_space_acc_t)(1 << i)))
+        {
+            for(it = m_ranges.begin(); it != m_ranges.end(); it++)
+            {
+                entry.en_addr = it->en_addr;
+                m_acc_idx[i][it->st_addr] = entry;
+            }
+        }
+    }
+}
+
+bool TrcMemAccRangeIdx::overlapsIndex(const TrcMemAccessorBase *p_accessor)
+{
+    std::vector<memacc_range_t>::const_iterator it;
+    acc_idx_t::const_iterator idx_it;
+
+    m_ranges.clear();
+    p_accessor->getRanges(m_ranges);
+    for(int i = 0; i < NUM_SPACE_IDX; i++)
+    {
+        if(!p_accessor->inMemSpace((ocsd_mem_space_acc_t)(1 << i)))
+            continue;
+
+        for(it = m_ranges.begin(); it != m_ranges.end(); it++)
+        {
+            // last indexed range starting at or before the end of the new range 
+            // is the only one that can overlap it.
+            idx_it = m_acc_idx[i].upper_bound(it->en_addr);
+            if(idx_it != m_acc_idx[i].begin())
+            {
+                idx_it--;
+                if(idx_it->second.en_addr >= it->st_addr)
+                    return true;
+            }
+        }
+    }
+    return false;
+}
+
+TrcMemAccessorBase *TrcMemAccRangeIdx::findInIndex(const ocsd_vaddr_t address, const ocsd_mem_space_acc_t mem_space) const
+{
+    const acc_idx_entry_t *p_found = 0, *p_entry;
+
+    // check the index for each space in the request - usually a single space.
+    for(int i = 0; i < NUM_SPACE_IDX; i++)
+    {
+        if(((uint8_t)mem_space & (1 << i)) && ((p_entry = findInSpaceIndex(i, address)) != 0))
+        {
+            if(!p_found || (p_entry->add_order < p_found->add_order))
+                p_found = p_entry;
+        }
+    }
+    return p_found ? p_found->p_acc : 0;
+}
+
+void TrcMemAccRangeIdx::clear()
+{
+    for(int i = 0; i < NUM_SPACE_IDX; i++)
+        m_acc_idx[i].clear();
+}
+
+const TrcMemAccRangeIdx::acc_idx_entry_t *TrcMemAccRangeIdx::findInSpaceIndex(const int space_idx, const ocsd_vaddr_t address) const
+{
+    // ranges in a single space do not overlap - only the range starting at or
+    // immediately below the address can contain it.
+    acc_idx_t::const_iterator it = m_acc_idx[space_idx].upper_bound(address);
+    if(it == m_acc_idx[space_idx].begin())
+        return 0;
+    it--;
+    return (it->second.en_addr >= address) ? &(it->second) : 0;
+}
+
+/************************************************************************************/
+/* global address space mapper with per memory space range index                   */
+/************************************************************************************/
+TrcMemAccMapGlobalSpaceIdx::TrcMemAccMapGlobalSpaceIdx() : TrcMemAccMapGlobalSpace()
+{
+    m_range_seq = TrcMemAccessorBase::getRangeUpdateSeq();
+}
+
+TrcMemAccMapGlobalSpaceIdx::~TrcMemAccMapGlobalSpaceIdx()
+{
+}
+
+ocsd_err_t TrcMemAccMapGlobalSpaceIdx::AddAccessor(TrcMemAccessorBase *p_accessor, const uint8_t /*cs_trace_id*/)
+{
+    if(!p_accessor->validateRange())
+        return OCSD_ERR_MEM_ACC_RANGE_INVALID;
+
+    if(m_range_seq != TrcMemAccessorBase::getRangeUpdateSeq())
+        rebuildIndex();
+
+    if(m_acc_idx.overlapsIndex(p_accessor))
+        return OCSD_ERR_MEM_ACC_OVERLAP;
+
+    m_acc_idx.indexAccessor(p_accessor, (uint32_t)m_acc_global.size());
+    m_acc_global.push_back(p_accessor);
+    return OCSD_OK;
+}
+
+bool TrcMemAccMapGlobalSpaceIdx::findAccessor(const ocsd_vaddr_t address, const ocsd_mem_space_acc_t mem_space, const uint8_t /*cs_trace_id*/)
+{
+    TrcMemAccessorBase *p_found;
+
+    // accessor ranges changed since index built
+    if(m_range_seq != TrcMemAccessorBase::getRangeUpdateSeq())
+        rebuildIndex();
+
+    p_found = m_acc_idx.findInIndex(address, mem_space);
+    if(p_found)
+        m_acc_curr = p_found;
+    return (bool)(p_found != 0);
+}
+
+void TrcMemAccMapGlobalSpaceIdx::clearAccessorList()
+{
+    TrcMemAccMapGlobalSpace::clearAccessorList();
+    m_acc_idx.clear();
+}
+
+ocsd_err_t TrcMemAccMapGlobalSpaceIdx::RemoveAccessor(const TrcMemAccessorBase *p_accessor)
+{
+    ocsd_err_t err = TrcMemAccMapGlobalSpace::RemoveAccessor(p_accessor);
+    // add order of following accessors changed - re-index
+    if(err == OCSD_OK)
+        rebuildIndex();
+    return err;
+}
+
+void TrcMemAccMapGlobalSpaceIdx::rebuildIndex()
+{
+    m_acc_idx.clear();
+    for(uint32_t order = 0; order < (uint32_t)m_acc_global.size(); order++)
+        m_acc_idx.indexAccessor(m_acc_global[order], order);
+    m_range_seq = TrcMemAccessorBase::getRangeUpdateSeq();
+}
+
+/************************************************************************************/
+/* context aware address space mapper - range index per memory context             */
+/************************************************************************************/
+TrcMemAccMapCtxtSpace::TrcMemAccMapCtxtSpace() : TrcMemAccMapGlobalSpace()
+{
+    m_range_seq = TrcMemAccessorBase::getRangeUpdateSeq();
+    m_read_key = m_acc_curr_key = makeKey(0, 0, 0);
+    m_keep_cache_on_acc_change = true;
+}
+
+TrcMemAccMapCtxtSpace::~TrcMemAccMapCtxtSpace()
+{
+}
+
+ocsd_err_t TrcMemAccMapCtxtSpace::ReadTargetMemory(const ocsd_vaddr_t address, const uint8_t cs_trace_id, const ocsd_mem_space_acc_t mem_space, uint32_t *num_bytes, uint8_t *p_buffer)
+{
+    setReadKey(0);
+    return TrcMemAccMapper::ReadTargetMemory(address, cs_trace_id, mem_space, num_bytes, p_buffer);
+}
+
+ocsd_err_t TrcMemAccMapCtxtSpace::ReadTargetMemoryCtxt(const ocsd_vaddr_t address, const uint8_t cs_trace_id, const ocsd_mem_space_acc_t mem_space, const ocsd_pe_context *p_context, uint32_t *num_bytes, uint8_t *p_buffer)
+{
+    setReadKey(p_context);
+    return TrcMemAccMapper::ReadTargetMemory(address, cs_trace_id, mem_space, num_bytes, p_buffer);
+}
+
+ocsd_err_t TrcMemAccMapCtxtSpace::ReadTargetMemoryPtr(const ocsd_vaddr_t address, const uint8_t cs_trace_id, const ocsd_mem_space_acc_t mem_space, const ocsd_pe_context *p_context, uint32_t *num_bytes, const uint8_t **pp_data)
+{
+    setReadKey(p_context);
+    return TrcMemAccMapper::ReadTargetMemoryPtr(address, cs_trace_id, mem_space, p_context, num_bytes, pp_data);
+}
+
+void TrcMemAccMapCtxtSpace::InvalidateMemAccCache(const uint8_t cs_trace_id)
+{
+    // drop pages from context specific accessors so a process image changed by the client 
+    // is re-read - pages from accessors valid in all contexts are kept over a context change.
+    if (m_cache.enabled())
+        m_cache.invalidateCtxtPagesByTraceID(cs_trace_id);
+}
+
+ocsd_err_t TrcMemAccMapCtxtSpace::AddAccessor(TrcMemAccessorBase *p_accessor, const uint8_t /*cs_trace_id*/)
+{
+    if(!p_accessor->validateRange())
+        return OCSD_ERR_MEM_ACC_RANGE_INVALID;
+
+    if(m_range_seq != TrcMemAccessorBase::getRangeUpdateSeq())
+        rebuildIndex();
+
+    TrcMemAccRangeIdx &acc_idx = m_ctxt_idx[accessorKey(p_accessor)];
+    if(acc_idx.overlapsIndex(p_accessor))
+        return OCSD_ERR_MEM_ACC_OVERLAP;
+
+    acc_idx.indexAccessor(p_accessor, (uint32_t)m_acc_global.size());
+    m_acc_global.push_back(p_accessor);
+    return OCSD_OK;
+}
+
+bool TrcMemAccMapCtxtSpace::findAccessor(const ocsd_vaddr_t address, const ocsd_mem_space_acc_t mem_space, const uint8_t /*cs_trace_id*/)
+{
+    std::map<ctxt_key_t, TrcMemAccRangeIdx>::const_iterator it;
+    TrcMemAccessorBase *p_found = 0;
+    const uint8_t read_flags = m_read_key.first;
+
+    if(m_range_seq != TrcMemAccessorBase::getRangeUpdateSeq())
+        rebuildIndex();
+
+    // most specific context first - context ID + VMID, context ID, VMID, then no context.
+    for(int flags = (KEY_CTXT_ID | KEY_VMID); (flags >= 0) && !p_found; flags--)
+    {
+        if((flags & read_flags) != flags)
+            continue;
+        it = m_ctxt_idx.find(makeKey((uint8_t)flags, (uint32_t)m_read_key.second, (uint32_t)(m_read_key.second >> 32)));
+        if(it != m_ctxt_idx.end())
+            p_found = it->second.findInIndex(address, mem_space);
+    }
+
+    if(p_found)
+    {
+        m_acc_curr = p_found;
+        m_acc_curr_key = m_read_key;
+    }
+    return (bool)(p_found != 0);
+}
+
+bool TrcMemAccMapCtxtSpace::readFromCurrent(const ocsd_vaddr_t address, const ocsd_mem_space_acc_t mem_space, const uint8_t cs_trace_id)
+{
+    // current accessor only valid for the context that selected it.
+    if(m_acc_curr_key != m_read_key)
+        return false;
+    return TrcMemAccMapGlobalSpace::readFromCurrent(address, mem_space, cs_trace_id);
+}
+
+void TrcMemAccMapCtxtSpace::clearAccessorList()
+{
+    TrcMemAccMapGlobalSpace::clearAccessorList();
+    m_ctxt_idx.clear();
+}
+
+ocsd_err_t TrcMemAccMapCtxtSpace::RemoveAccessor(const TrcMemAccessorBase *p_accessor)
+{
+    ocsd_err_t err = TrcMemAccMapGlobalSpace::RemoveAccessor(p_accessor);
+    if(err == OCSD_OK)
+        rebuildIndex();
+    return err;
+}
+
+TrcMemAccMapCtxtSpace::ctxt_key_t TrcMemAccMapCtxtSpace::makeKey(const uint8_t flags, const uint32_t ctxt_id, const uint32_t vmid)
+{
+    uint64_t val = 0;
+    if(flags & KEY_CTXT_ID)
+        val |= (uint64_t)ctxt_id;
+    if(flags & KEY_VMID)
+        val |= ((uint64_t)vmid) << 32;
+    return ctxt_key_t(flags, val);
+}
+
+TrcMemAccMapCtxtSpace::ctxt_key_t TrcMemAccMapCtxtSpace::accessorKey(const TrcMemAccessorBase *p_accessor)
+{
+    const ocsd_mem_acc_ctxt_t &mem_ctxt = p_accessor->getMemContext();
+    return makeKey((mem_ctxt.ctxt_id_valid ? KEY_CTXT_ID : 0) | (mem_ctxt.vmid_valid ? KEY_VMID : 0),
+                   mem_ctxt.context_id, mem_ctxt.vmid);
+}
+
+void TrcMemAccMapCtxtSpace::setReadKey(const ocsd_pe_context *p_context)
+{
+    if(p_context)
+        m_read_key = makeKey((p_context->ctxt_id_valid ? KEY_CTXT_ID : 0) | (p_context->vmid_valid ? KEY_VMID : 0),
+                             p_context->context_id, p_context->vmid);
+    else
+        m_read_key = makeKey(0, 0, 0);
+}
+
+void TrcMemAccMapCtxtSpace::rebuildIndex()
+{
+    m_ctxt_idx.clear();
+    for(uint32_t order = 0; order < (uint32_t)m_acc_global.size(); order++)
+        m_ctxt_idx[accessorKey(m_acc_global[order])].indexAccessor(m_acc_global[order], order);
+    m_range_seq = TrcMemAccessorBase::getRangeUpdateSeq();
+}
 
 /* End of File trc_mem_acc_mapper.cpp */
@@ -49,8 +49,12 @@ OcsdCodeFollower::OcsdCodeFollower()
     m_pMemAccess = 0;
     m_pIDecode = 0;
     m_mem_space_csid = 0;
+    m_p_mem_acc_ctxt = 0;
+    m_p_mem_span = 0;
     m_st_range_addr =  m_en_range_addr = m_next_addr = 0;
     m_b_next_valid = false;
+    m_num_instr = 0;
+    m_b_wp_found = false;
     m_b_nacc_err = false;
 }
 
@@ -71,6 +75,8 @@ bool OcsdCodeFollower::initFollowerState()
     // reset per follow flags
     m_b_next_valid = false;
     m_b_nacc_err = false;
+    m_num_instr = 0;
+    m_b_wp_found = false;
 
     // set range addresses
     m_en_range_addr = m_next_addr = m_st_range_addr;
@@ -112,25 +118,131 @@ ocsd_err_t OcsdCodeFollower::followSingleAtom(const ocsd_vaddr_t addrStart, cons
 
     // set end range - always after the instruction executed.
     m_en_range_addr = m_instr_info.instr_addr + m_instr_info.instr_size;
-                    
+    m_num_instr = 1;
+    m_b_wp_found = (m_instr_info.type != OCSD_INSTR_OTHER);
+    setNextAddr(A);
+    return err;
+}
+
+/*!
+ * Decodes instructions from the start address to the first waypoint, calculates 
+ * the next address if possible according to the waypoint type and atom.
+ *
+ * @param addrStart : Address of the first instruction
+ * @param A :  Atom value for the waypoint - E or N
+ *
+ * @return ocsd_err_t : OCSD_OK - decode correct, check flags for next address
+ *                    : OCSD_ERR_MEM_NACC - unable to access memory area @ address - range valid up to nacc address.
+ *                    : OCSD_ERR_NOT_INIT - not initialised - fatal.
+ *                    : OCSD_<other>  - other error occured - fatal.
+ */
+ocsd_err_t OcsdCodeFollower::followToAtomWP(const ocsd_vaddr_t addrStart, const ocsd_atm_val A)
+{
+    m_st_range_addr = addrStart;
+    if(!initFollowerState())
+        return OCSD_ERR_NOT_INIT;
+
+    ocsd_err_t err = followRange(0, false, 0);
+    if(err == OCSD_OK)
+        setNextAddr(A);
+    return err;
+}
+
+/*!
+ * Decodes instructions from the start address until the next instruction is at
+ * the match address, or to the first waypoint if that is reached before the match.
+ * The atom value is applied to a waypoint ending the range.
+ *
+ * @param addrStart : Address of the first instruction
+ * @param A : Atom value for a waypoint - E or N
+ * @param addrMatch : Address ending the range - exclusive.
+ *
+ * @return ocsd_err_t : as followToAtomWP()
+ */
+ocsd_err_t OcsdCodeFollower::followToAddress(const ocsd_vaddr_t addrStart, const ocsd_atm_val A, const ocsd_vaddr_t addrMatch)
+{
+    m_st_range_addr = addrStart;
+    if(!initFollowerState())
+        return OCSD_ERR_NOT_INIT;
+
+    ocsd_err_t err = followRange(0, true, addrMatch);
+    if(err == OCSD_OK)
+        setNextAddr(A);
+    return err;
+}
+
+/*!
+ * Decodes up to atoms.num instructions from the start address, one atom per
+ * instruction as ETMv3, stopping after the first waypoint. Atoms on non-waypoint
+ * instructions do not change the program flow, so the range covers them all.
+ * getNumInstr() gives the number of atoms used, the last being applied to a waypoint
+ * ending the range.
+ *
+ * @param addrStart : Address of the first instruction
+ * @param &atoms : Atom pattern - ls bit for the first instruction.
+ *
+ * @return ocsd_err_t : as followToAtomWP()
+ */
+ocsd_err_t OcsdCodeFollower::followNInstructions(const ocsd_vaddr_t addrStart, const ocsd_pkt_atom &atoms)
+{
+    m_st_range_addr = addrStart;
+    if(!initFollowerState())
+        return OCSD_ERR_NOT_INIT;
+
+    if(!atoms.num)
+        return OCSD_OK;
+
+    ocsd_err_t err = followRange(atoms.num, false, 0);
+    if(err == OCSD_OK)
+        setNextAddr((atoms.En_bits >> (m_num_instr - 1)) & 0x1 ? ATOM_E : ATOM_N);
+    return err;
+}
+
+ocsd_err_t OcsdCodeFollower::followRange(const uint32_t maxInstr, const bool bMatchAddr, const ocsd_vaddr_t addrMatch)
+{
+    ocsd_err_t err = OCSD_OK;
+
+    m_instr_info.instr_addr = m_st_range_addr;
+    while(!m_b_wp_found && (!maxInstr || (m_num_instr < maxInstr)))
+    {
+        if(bMatchAddr && (m_instr_info.instr_addr == addrMatch))
+            break;
+
+        // on nacc, range is valid to the failed address and next address is needed from the trace.
+        err = decodeSingleOpCode();
+        if(err != OCSD_OK)
+            break;
+
+        m_num_instr++;
+        m_en_range_addr = m_instr_info.instr_addr + m_instr_info.instr_size;
+        m_b_wp_found = (m_instr_info.type != OCSD_INSTR_OTHER);
+        m_instr_info.instr_addr = m_en_range_addr;
+    }
+    return err;
+}
+
+void OcsdCodeFollower::setNextAddr(const ocsd_atm_val A)
+{
     // assume next addr is the instruction after
     m_next_addr = m_en_range_addr;
     m_b_next_valid = true;
 
     // case when next address is different
-    switch(m_instr_info.type)                        
+    if(m_b_wp_found)
     {
-    case OCSD_INSTR_BR:
-        if(A == ATOM_E) // executed the direct branch
-            m_next_addr = m_instr_info.branch_addr;
-        break;
-
-    case OCSD_INSTR_BR_INDIRECT:
-        if(A == ATOM_E) // executed indirect branch
-            m_b_next_valid = false;
-        break;
+        switch(m_instr_info.type)
+        {
+        case OCSD_INSTR_BR:
+            if(A == ATOM_E) // executed the direct branch
+                m_next_addr = m_instr_info.branch_addr;
+            break;
+
+        case OCSD_INSTR_BR_INDIRECT:
+            if(A == ATOM_E) // executed indirect branch
+                m_b_next_valid = false;
+            break;
+        }
     }
-    return err;
 }
 
 ocsd_err_t OcsdCodeFollower::decodeSingleOpCode()
@@ -141,7 +253,10 @@ ocsd_err_t OcsdCodeFollower::decodeSingleOpCode()
     uint32_t opcode;    // buffer for opcode
 
     // read memory location for opcode 
-    err = m_pMemAccess->first()->ReadTargetMemory(m_instr_info.instr_addr,m_mem_space_csid,m_mem_acc_rule,&bytesReq,(uint8_t *)&opcode);
+    if(m_p_mem_span)
+        err = m_p_mem_span->readBytes(m_pMemAccess->first(),m_instr_info.instr_addr,m_mem_space_csid,m_mem_acc_rule,m_p_mem_acc_ctxt,&bytesReq,(uint8_t *)&opcode);
+    else
+        err = m_pMemAccess->first()->ReadTargetMemoryCtxt(m_instr_info.instr_addr,m_mem_space_csid,m_mem_acc_rule,m_p_mem_acc_ctxt,&bytesReq,(uint8_t *)&opcode);
 
     // operational error (not access problem - that is indicated by 0 bytes returned)
     if(err != OCSD_OK)
@@ -0,0 +1,890 @@
+/*
+ * \file       ocsd_dcd_chunk.cpp
+ * \brief      OpenCSD : Parallel decode of a single trace ID stream split at sync points.
+ * 
+ * \copyright  Copyright (c) 2026, ARM Limited. All Rights Reserved.
+ */
+
+
+/* 
+ * Redistribution and use in source and binary forms, with or without modification, 
+ * are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, 
+ * this list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright notice, 
+ * this list of conditions and the following disclaimer in the documentation 
+ * and/or other materials provided with the distribution. 
+ * 
+ * 3. Neither the name of the copyright holder nor the names of its contributors 
+ * may be used to endorse or promote products derived from this software without 
+ * specific prior written permission. 
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 'AS IS' AND 
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED 
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. 
+ * IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, 
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES 
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; 
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND 
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT 
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS 
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. 
+ */ 
+
+#include "common/ocsd_dcd_chunk.h"
+#include "common/ocsd_dcd_mngr_i.h"
+#include "common/trc_pkt_decode_base.h"
+#include "opencsd/etmv4/trc_cmp_cfg_etmv4.h"
+
+/* ETMv4 / ETE A-sync - 11 zero bytes then 0x80 - and TraceInfo packet fields */
+#define ASYNC_ZERO_BYTES    11
+#define ASYNC_SIZE          12
+#define TINFO_HDR           0x01
+#define TINFO_INFO_SECT     0x01
+#define TINFO_KEY_SECT      0x02
+#define TINFO_SPEC_SECT     0x04
+#define TINFO_ALL_SECT      0x1F
+#define CONT_FIELD_MAX      5   // max bytes in a 32 bit continuation field
+
+/***************************************************************/
+/* worker decoder - collect elements for the current chunk */
+
+DecodeChunkWorker::DecodeChunkWorker() :
+    m_pDecoder(0),
+    m_pDataIn(0),
+    m_used(false),
+    m_pChunk(0),
+    m_num_elem(0),
+    m_pErrLog(0),
+    m_cid_en(false),
+    m_vmid_en(false)
+{
+    initHandover(m_start_handover, 0);
+    initHandover(m_end_handover, 0);
+}
+
+ocsd_datapath_resp_t DecodeChunkWorker::TraceElemIn(const ocsd_trc_index_t index_sop,
+                                                    const uint8_t trc_chan_id,
+                                                    const OcsdTraceElement &elem)
+{
+    bool bKeep = true;
+
+    // remove the artefacts of starting and ending decode at the split points, and overlap output.
+    if (elem.getType() == OCSD_GEN_TRC_ELEM_EO_TRACE)
+        bKeep = m_pChunk->end_eot;
+    else if (!keepIndex(index_sop, false))
+        bKeep = false;
+    else if ((elem.getType() == OCSD_GEN_TRC_ELEM_NO_SYNC) && !m_pChunk->split_start)
+        bKeep = (m_num_elem > 0) || m_pChunk->stream_start;
+    m_num_elem++;
+
+    if (bKeep)
+    {
+        ocsd_gen_elem_batch_entry_t entry;
+        entry.index_sop = index_sop;
+        entry.trc_chan_id = trc_chan_id;
+        entry.elem = elem;
+        m_pChunk->elems.push_back(entry);
+    }
+    return OCSD_RESP_CONT;
+}
+
+const ocsd_hndl_err_log_t DecodeChunkWorker::RegisterErrorSource(const std::string &component_name)
+{
+    return m_pErrLog ? m_pErrLog->RegisterErrorSource(component_name) : OCSD_INVALID_HANDLE;
+}
+
+const ocsd_err_severity_t DecodeChunkWorker::GetErrorLogVerbosity() const
+{
+    return m_pErrLog ? m_pErrLog->GetErrorLogVerbosity() : OCSD_ERR_SEV_NONE;
+}
+
+void DecodeChunkWorker::LogError(const ocsd_hndl_err_log_t handle, const ocsdError *Error)
+{
+    if (!m_pChunk)
+    {
+        if (m_pErrLog)
+            m_pErrLog->LogError(handle, Error);
+        return;
+    }
+
+    // errors either side of the handover are logged by the decode of the other chunk.
+    if (!keepIndex(Error->getErrorIndex(), Error->getErrorIndex() == OCSD_BAD_TRC_INDEX))
+        return;
+
+    dcd_chunk_err_t chunk_err = { m_pChunk->elems.size(), handle, ocsdError(Error) };
+    m_pChunk->errs.push_back(chunk_err);
+}
+
+void DecodeChunkWorker::LogMessage(const ocsd_hndl_err_log_t handle, const ocsd_err_severity_t filter_level, const std::string &msg)
+{
+    if (m_pErrLog)
+        m_pErrLog->LogMessage(handle, filter_level, msg);
+}
+
+ocsdError *DecodeChunkWorker::GetLastError()
+{
+    return m_pErrLog ? m_pErrLog->GetLastError() : 0;
+}
+
+ocsdError *DecodeChunkWorker::GetLastIDError(const uint8_t chan_id)
+{
+    return m_pErrLog ? m_pErrLog->GetLastIDError(chan_id) : 0;
+}
+
+ocsdMsgLogger *DecodeChunkWorker::getOutputLogger()
+{
+    return m_pErrLog ? m_pErrLog->getOutputLogger() : 0;
+}
+
+void DecodeChunkWorker::setOutputLogger(ocsdMsgLogger *pLogger)
+{
+    if (m_pErrLog)
+        m_pErrLog->setOutputLogger(pLogger);
+}
+
+void DecodeChunkWorker::RawPacketDataMon(const ocsd_datapath_op_t op,
+                                         const ocsd_trc_index_t index_sop,
+                                         const EtmV4ITrcPacket *pkt,
+                                         const uint32_t size,
+                                         const uint8_t *p_data)
+{
+    if (!m_pChunk || (op != OCSD_OP_DATA) || !pkt)
+        return;
+
+    if (m_pChunk->split_start)
+        checkHandover(m_start_handover, index_sop, size, pkt);
+    if (m_pChunk->split_end)
+        checkHandover(m_end_handover, index_sop, size, pkt);
+}
+
+void DecodeChunkWorker::initHandover(dcd_chunk_handover_t &handover, const ocsd_trc_index_t split_index)
+{
+    handover.split_index = split_index;
+    handover.use_limit = false;
+    handover.limit = 0;
+    handover.tinfo = false;
+    handover.ctxt = false;
+    handover.cid = false;
+    handover.vmid = false;
+    handover.found = false;
+    handover.index = 0;
+}
+
+/* The TraceInfo resets the packet address state, so packets after it are the same in the decode 
+   of either chunk. The decoder state is not reset - the handover is at the first address 
+   packet once the context is known, from where the decode of the next chunk matches. */
+void DecodeChunkWorker::checkHandover(dcd_chunk_handover_t &handover, const ocsd_trc_index_t index_sop, const uint32_t size, const EtmV4ITrcPacket *pkt)
+{
+    bool bAddr = false;
+
+    if (handover.found)
+        return;
+
+    // packet not completely within the overlap decoded by the previous chunk.
+    if (handover.use_limit && ((index_sop + size) > handover.limit))
+    {
+        handover.found = true;
+        handover.index = index_sop;
+        return;
+    }
+
+    if (!handover.tinfo)
+    {
+        handover.tinfo = (pkt->getType() == ETM4_PKT_I_TRACE_INFO) && (index_sop >= handover.split_index);
+        return;
+    }
+
+    switch (pkt->getType())
+    {
+    case ETM4_PKT_I_ADDR_CTXT_L_32IS0:
+    case ETM4_PKT_I_ADDR_CTXT_L_32IS1:
+    case ETM4_PKT_I_ADDR_CTXT_L_64IS0:
+    case ETM4_PKT_I_ADDR_CTXT_L_64IS1:
+    case ETM4_PKT_I_ADDR_MATCH:
+    case ETM4_PKT_I_ADDR_S_IS0:
+    case ETM4_PKT_I_ADDR_S_IS1:
+    case ETM4_PKT_I_ADDR_L_32IS0:
+    case ETM4_PKT_I_ADDR_L_32IS1:
+    case ETM4_PKT_I_ADDR_L_64IS0:
+    case ETM4_PKT_I_ADDR_L_64IS1:
+    case ETE_PKT_I_SRC_ADDR_MATCH:
+    case ETE_PKT_I_SRC_ADDR_S_IS0:
+    case ETE_PKT_I_SRC_ADDR_S_IS1:
+    case ETE_PKT_I_SRC_ADDR_L_32IS0:
+    case ETE_PKT_I_SRC_ADDR_L_32IS1:
+    case ETE_PKT_I_SRC_ADDR_L_64IS0:
+    case ETE_PKT_I_SRC_ADDR_L_64IS1:
+        bAddr = true;
+        break;
+
+    default:
+        break;
+    }
+
+    const etmv4_context_t &ctxt = pkt->getContext();
+    if (ctxt.updated)
+        handover.ctxt = true;
+    if (ctxt.updated_c)
+        handover.cid = true;
+    if (ctxt.updated_v)
+        handover.vmid = true;
+
+    if (bAddr && handover.ctxt && (handover.cid || !m_cid_en) && (handover.vmid || !m_vmid_en))
+    {
+        handover.found = true;
+        handover.index = index_sop;
+    }
+}
+
+/* element or error at index output by this chunk */
+const bool DecodeChunkWorker::keepIndex(const ocsd_trc_index_t index, const bool bNoIndex) const
+{
+    // unindexed errors kept by the chunk decoding at the time.
+    if (bNoIndex)
+        return (!m_pChunk->split_start || m_start_handover.found) &&
+               (!m_pChunk->split_end || !m_end_handover.found);
+
+    if (m_pChunk->split_start && (!m_start_handover.found || (index < m_start_handover.index)))
+        return false;
+    if (m_pChunk->split_end && m_end_handover.found && (index >= m_end_handover.index))
+        return false;
+    return true;
+}
+
+/***************************************************************/
+/* chunked decode of a single stream */
+
+DecodeIDChunker::DecodeIDChunker(const uint8_t CSID) :
+    m_CSID(CSID),
+    m_chunk_size(DCD_CHUNK_DEFAULT_SIZE),
+    m_pDcdMngr(0),
+    m_i_gen_elem_out(0),
+    m_i_err_log(0),
+    m_pCurrChunk(0),
+    m_pSplitChunk(0),
+    m_scan_pos(0),
+    m_zero_run(0),
+    m_tinfo_pos(0),
+    m_next_start(true),
+    m_next_reset(false),
+    m_flush_all(false),
+    m_num_chunks(0),
+    m_max_chunks(0),
+    m_resp(OCSD_RESP_CONT),
+    m_stop(false)
+{
+}
+
+DecodeIDChunker::~DecodeIDChunker()
+{
+    destroyWorkers();
+}
+
+ocsd_err_t DecodeIDChunker::init(IDecoderMngr *pDcdMngr, TraceComponent *pDecoder, const bool bUseInstID, const uint32_t num_threads, const uint32_t chunk_size)
+{
+    ocsd_err_t err = OCSD_OK;
+    DecodeChunkWorker *pWorker;
+    uint32_t threads = num_threads;
+    int create_flags;
+
+    if (!pDcdMngr || !pDecoder || !m_workers.empty() || (num_threads > DCD_CHUNK_MAX_THREADS) ||
+        (chunk_size < DCD_CHUNK_MIN_SIZE) || (chunk_size > DCD_CHUNK_MAX_SIZE))
+        return OCSD_ERR_INVALID_PARAM_VAL;
+
+    // workers are configured as the decoder for the stream - TraceInfo split points are ETMv4 / ETE only.
+    TrcPktDecodeBase<EtmV4ITrcPacket, EtmV4Config> *pBase = dynamic_cast<TrcPktDecodeBase<EtmV4ITrcPacket, EtmV4Config> *>(pDecoder);
+    if (!pBase || !pBase->getProtocolConfig())
+        return OCSD_ERR_INVALID_PARAM_TYPE;
+
+    create_flags = OCSD_CREATE_FLG_FULL_DECODER | (int)pDecoder->getComponentOpMode();
+    if (pDecoder->getAssocComponent())
+        create_flags |= (int)pDecoder->getAssocComponent()->getComponentOpMode();
+    if (bUseInstID)
+        create_flags |= OCSD_CREATE_FLG_INST_ID;
+
+    if (!threads)
+        threads = std::thread::hardware_concurrency();
+    if (!threads)
+        threads = 1;
+    if (threads > DCD_CHUNK_MAX_THREADS)
+        threads = DCD_CHUNK_MAX_THREADS;
+
+    const EtmV4Config *pConfig = pBase->getProtocolConfig();
+
+    m_pDcdMngr = pDcdMngr;
+    m_chunk_size = chunk_size;
+    m_max_chunks = 2 * threads;
+    m_stop = false;
+
+    m_pCurrChunk = newChunk();
+    if (!m_pCurrChunk)
+        err = OCSD_ERR_MEM;
+
+    for (uint32_t i = 0; (i < threads) && (err == OCSD_OK); i++)
+    {
+        pWorker = new (std::nothrow) DecodeChunkWorker();
+        if (!pWorker)
+        {
+            err = OCSD_ERR_MEM;
+            break;
+        }
+        m_workers.push_back(pWorker);
+        pWorker->m_cid_en = pConfig->enabledCID();
+        pWorker->m_vmid_en = pConfig->enabledVMID();
+
+        err = m_pDcdMngr->createDecoder(create_flags, (int)m_CSID, pBase->getProtocolConfig(), &pWorker->m_pDecoder);
+        if (err == OCSD_OK)
+        {
+            TrcPktDecodeI *pDcdI = dynamic_cast<TrcPktDecodeI *>(pWorker->m_pDecoder);
+            if (pDcdI)
+                pDcdI->setElemOutMask(pBase->getElemOutMask());
+            err = m_pDcdMngr->attachOutputSink(pWorker->m_pDecoder, pWorker);
+        }
+        if (err == OCSD_OK)
+            err = m_pDcdMngr->attachPktMonitor(pWorker->m_pDecoder, static_cast<IPktRawDataMon<EtmV4ITrcPacket> *>(pWorker));
+        if (err == OCSD_OK)
+            err = m_pDcdMngr->getDataInputI(pWorker->m_pDecoder, &pWorker->m_pDataIn);
+        if (err == OCSD_OK)
+        {
+            try {
+                pWorker->m_thread = std::thread(&DecodeIDChunker::workerFn, this, pWorker);
+            }
+            catch (...) {
+                err = OCSD_ERR_FAIL;
+            }
+        }
+    }
+
+    if (err != OCSD_OK)
+        destroyWorkers();
+    return err;
+}
+
+void DecodeIDChunker::destroyWorkers()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_stop = true;
+    }
+    m_decode_cv.notify_all();
+
+    for (size_t i = 0; i < m_workers.size(); i++)
+    {
+        if (m_workers[i]->m_thread.joinable())
+            m_workers[i]->m_thread.join();
+        if (m_workers[i]->m_pDecoder)
+            m_pDcdMngr->destroyDecoder(m_workers[i]->m_pDecoder);
+        delete m_workers[i];
+    }
+    m_workers.clear();
+
+    // decode queue holds chunks also in the output queue.
+    while (!m_output_queue.empty())
+    {
+        delete m_output_queue.front();
+        m_output_queue.pop_front();
+    }
+    m_decode_queue.clear();
+    if (m_pCurrChunk)
+        delete m_pCurrChunk;
+    m_pCurrChunk = 0;
+    if (m_pSplitChunk)
+        delete m_pSplitChunk;
+    m_pSplitChunk = 0;
+}
+
+void DecodeIDChunker::setInterfaces(IInstrDecode *i_instr_decode, ITargetMemAccess *i_mem_access, ITraceErrorLog *i_err_log, ITrcGenElemIn *i_gen_elem_out)
+{
+    for (size_t i = 0; i < m_workers.size(); i++)
+    {
+        // errors only where a decoder does not use the interface.
+        m_workers[i]->m_pErrLog = i_err_log;
+        m_pDcdMngr->attachErrorLogger(m_workers[i]->m_pDecoder, i_err_log ? m_workers[i] : 0);
+        if (i_instr_decode)
+            m_pDcdMngr->attachInstrDecoder(m_workers[i]->m_pDecoder, i_instr_decode);
+        m_pDcdMngr->attachMemAccessor(m_workers[i]->m_pDecoder, i_mem_access);
+    }
+    m_i_gen_elem_out = i_gen_elem_out;
+    m_i_err_log = i_err_log;
+}
+
+void DecodeIDChunker::setElemOutMask(const uint32_t elem_mask)
+{
+    for (size_t i = 0; i < m_workers.size(); i++)
+    {
+        TrcPktDecodeI *pDcdI = dynamic_cast<TrcPktDecodeI *>(m_workers[i]->m_pDecoder);
+        if (pDcdI)
+            pDcdI->setElemOutMask(elem_mask);
+    }
+}
+
+void DecodeIDChunker::waitIdle()
+{
+    {
+        std::unique_lock<std::mutex> lock(m_lock);
+        for (size_t i = 0; i < m_output_queue.size(); i++)
+        {
+            while (!m_output_queue[i]->done)
+                m_done_cv.wait(lock);
+        }
+    }
+    outputChunks(true);
+}
+
+void DecodeIDChunker::flushInput()
+{
+    // input stopped - decode the data collected so far, as a single decoder already has.
+    if (OCSD_DATA_RESP_IS_FATAL(m_resp))
+        return;
+    endChunk(false, false);
+    m_flush_all = true;
+    outputChunks(true);
+}
+
+ocsd_datapath_resp_t DecodeIDChunker::TraceDataIn(const ocsd_datapath_op_t op,
+                                                  const ocsd_trc_index_t index,
+                                                  const uint32_t dataBlockSize,
+                                                  const uint8_t *pDataBlock,
+                                                  uint32_t *numBytesProcessed)
+{
+    ocsd_datapath_resp_t resp = OCSD_RESP_CONT;
+
+    if (numBytesProcessed)
+        *numBytesProcessed = 0;
+
+    if (m_workers.empty())
+        return OCSD_RESP_FATAL_NOT_INIT;
+
+    // after a fatal error only a reset will restart decode.
+    if (OCSD_DATA_RESP_IS_FATAL(m_resp) && (op != OCSD_OP_RESET))
+        return m_resp;
+
+    switch (op)
+    {
+    case OCSD_OP_DATA:
+        if (!dataBlockSize || !pDataBlock)
+            return OCSD_RESP_FATAL_INVALID_PARAM;
+        addData(index, dataBlockSize, pDataBlock);
+        if (numBytesProcessed)
+            *numBytesProcessed = dataBlockSize;
+        resp = outputChunks(m_flush_all);
+        break;
+
+    case OCSD_OP_FLUSH:
+        resp = outputChunks(m_flush_all);
+        break;
+
+    case OCSD_OP_EOT:
+        endChunk(true, false);
+        m_flush_all = true;
+        resp = outputChunks(true);
+        break;
+
+    case OCSD_OP_RESET:
+        endChunk(false, true);
+        m_flush_all = true;
+        resp = outputChunks(true);
+        m_resp = OCSD_RESP_CONT;
+        if (OCSD_DATA_RESP_IS_FATAL(resp))
+            resp = OCSD_RESP_CONT;
+        break;
+
+    default:
+        resp = OCSD_RESP_FATAL_INVALID_OP;
+        break;
+    }
+    return resp;
+}
+
+dcd_chunk_t *DecodeIDChunker::newChunk()
+{
+    dcd_chunk_t *pChunk = new (std::nothrow) dcd_chunk_t;
+    if (pChunk)
+    {
+        pChunk->stream_start = m_next_start;
+        pChunk->after_reset = m_next_reset;
+        pChunk->end_eot = false;
+        pChunk->split_start = false;
+        pChunk->split_end = false;
+        pChunk->split_index = 0;
+        pChunk->overlap_limit = false;
+        pChunk->overlap_end = 0;
+        pChunk->out_pos = 0;
+        pChunk->err_pos = 0;
+        pChunk->resp = OCSD_RESP_CONT;
+        pChunk->done = false;
+        m_next_start = false;
+        m_next_reset = false;
+    }
+    m_scan_pos = 0;
+    m_zero_run = 0;
+    m_tinfo_pos = 0;
+    return pChunk;
+}
+
+void DecodeIDChunker::addData(const ocsd_trc_index_t index, const uint32_t size, const uint8_t *pData)
+{
+    dcd_chunk_block_t block;
+    int tinfo_check;
+
+    block.index = index;
+    block.offset = (uint32_t)m_pCurrChunk->data.size();
+    block.size = size;
+    m_pCurrChunk->blocks.push_back(block);
+    m_pCurrChunk->data.insert(m_pCurrChunk->data.end(), pData, pData + size);
+
+    if (m_pSplitChunk && (m_pCurrChunk->data.size() >= DCD_CHUNK_OVERLAP))
+        queueSplitChunk();
+
+    // look for a split point once the chunk is large enough.
+    while (m_pCurrChunk->data.size() > m_chunk_size)
+    {
+        const std::vector<uint8_t> &data = m_pCurrChunk->data;
+
+        if (m_scan_pos < m_chunk_size)
+        {
+            m_scan_pos = m_chunk_size;
+            m_zero_run = 0;
+        }
+
+        if (m_tinfo_pos)
+        {
+            tinfo_check = checkTraceInfo(data.data() + m_tinfo_pos, data.size() - m_tinfo_pos);
+            if (tinfo_check < 0)
+                break;  // need more data.
+            if (tinfo_check > 0)
+            {
+                if (!splitChunk(m_tinfo_pos - ASYNC_SIZE))
+                    break;
+                continue;
+            }
+            m_tinfo_pos = 0;
+        }
+
+        while (m_scan_pos < data.size())
+        {
+            uint8_t byte = data[m_scan_pos++];
+            if (byte == 0)
+                m_zero_run++;
+            else
+            {
+                if ((byte == 0x80) && (m_zero_run >= ASYNC_ZERO_BYTES))
+                    m_tinfo_pos = m_scan_pos;
+                m_zero_run = 0;
+                if (m_tinfo_pos)
+                    break;
+            }
+        }
+        if (!m_tinfo_pos)
+            break;
+    }
+}
+
+/* check for a TraceInfo packet with zero speculation depth.
+   1 if found, 0 if not, -1 if more data is needed */
+int DecodeIDChunker::checkTraceInfo(const uint8_t *pData, const size_t avail)
+{
+    size_t idx = 0;
+    uint8_t sections;
+    uint32_t spec_depth = 0;
+    int field_bytes;
+
+    if (!avail)
+        return -1;
+    if (pData[idx++] != TINFO_HDR)
+        return 0;
+
+    // control bytes
+    if (idx >= avail)
+        return -1;
+    sections = pData[idx] & TINFO_ALL_SECT;
+    while (pData[idx++] & 0x80)
+    {
+        if (idx >= avail)
+            return -1;
+    }
+
+    // skip info and key fields to the speculation depth.
+    for (uint8_t sect = TINFO_INFO_SECT; sect <= TINFO_SPEC_SECT; sect <<= 1)
+    {
+        if (!(sections & sect))
+            continue;
+
+        field_bytes = 0;
+        do {
+            if (idx >= avail)
+                return -1;
+            if (++field_bytes > CONT_FIELD_MAX)
+                return 0;
+            if (sect == TINFO_SPEC_SECT)
+                spec_depth |= ((uint32_t)(pData[idx] & 0x7F)) << (7 * (field_bytes - 1));
+        } while (pData[idx++] & 0x80);
+    }
+    return (spec_depth == 0) ? 1 : 0;
+}
+
+bool DecodeIDChunker::splitChunk(const size_t split_pos)
+{
+    dcd_chunk_t *pPrev = m_pCurrChunk;
+    dcd_chunk_t *pNext = newChunk();
+    size_t num_blocks = 0;
+
+    if (!pNext)
+        return false; // continue with current chunk.
+
+    // any earlier split chunk takes its overlap from the chunk being split.
+    if (m_pSplitChunk)
+        queueSplitChunk();
+
+    pNext->data.assign(pPrev->data.begin() + split_pos, pPrev->data.end());
+    for (size_t i = 0; i < pPrev->blocks.size(); i++)
+    {
+        dcd_chunk_block_t &block = pPrev->blocks[i];
+        if ((block.offset + block.size) <= split_pos)
+            num_blocks++;
+        else if (block.offset < split_pos)
+        {
+            // block index + offset is the index of the split byte.
+            dcd_chunk_block_t split_block;
+            split_block.index = block.index + (ocsd_trc_index_t)(split_pos - block.offset);
+            split_block.offset = 0;
+            split_block.size = block.offset + block.size - (uint32_t)split_pos;
+            pNext->blocks.push_back(split_block);
+            block.size = (uint32_t)split_pos - block.offset;
+            num_blocks++;
+        }
+        else
+        {
+            pNext->blocks.push_back(block);
+            pNext->blocks.back().offset -= (uint32_t)split_pos;
+        }
+    }
+    pPrev->blocks.resize(num_blocks);
+    pPrev->data.resize(split_pos);
+    pPrev->split_end = true;
+    pPrev->split_index = pNext->blocks[0].index;
+    pNext->split_start = true;
+
+    // queued once the overlap data is available.
+    m_pSplitChunk = pPrev;
+    m_pCurrChunk = pNext;
+    return true;
+}
+
+void DecodeIDChunker::queueSplitChunk()
+{
+    dcd_chunk_t *pNext = m_pCurrChunk;
+    size_t overlap = pNext->data.size();
+    uint32_t base_offset = (uint32_t)m_pSplitChunk->data.size();
+
+    if (overlap > DCD_CHUNK_OVERLAP)
+        overlap = DCD_CHUNK_OVERLAP;
+
+    m_pSplitChunk->data.insert(m_pSplitChunk->data.end(), pNext->data.begin(), pNext->data.begin() + overlap);
+    for (size_t i = 0; (i < pNext->blocks.size()) && (pNext->blocks[i].offset < overlap); i++)
+    {
+        dcd_chunk_block_t block = pNext->blocks[i];
+        if ((block.offset + block.size) > overlap)
+            block.size = (uint32_t)overlap - block.offset;
+        block.offset += base_offset;
+        m_pSplitChunk->blocks.push_back(block);
+    }
+
+    // next chunk takes over by the end of the overlap.
+    if (overlap < pNext->data.size())
+    {
+        pNext->overlap_limit = true;
+        pNext->overlap_end = m_pSplitChunk->blocks.back().index + m_pSplitChunk->blocks.back().size;
+    }
+
+    queueChunk(m_pSplitChunk);
+    m_pSplitChunk = 0;
+}
+
+void DecodeIDChunker::endChunk(const bool bEOT, const bool bReset)
+{
+    dcd_chunk_t *pChunk = m_pCurrChunk;
+
+    if (m_pSplitChunk)
+        queueSplitChunk();
+
+    pChunk->end_eot = bEOT;
+    if (bReset)
+    {
+        m_next_start = true;
+        m_next_reset = true;
+    }
+
+    m_pCurrChunk = newChunk();
+    if (!m_pCurrChunk)
+    {
+        // cannot continue the stream without a chunk for the input.
+        m_pCurrChunk = pChunk;
+        pChunk->data.clear();
+        pChunk->blocks.clear();
+        m_resp = OCSD_RESP_FATAL_SYS_ERR;
+        return;
+    }
+
+    if (!pChunk->data.empty() || bEOT)
+        queueChunk(pChunk);
+    else
+        delete pChunk;
+}
+
+void DecodeIDChunker::queueChunk(dcd_chunk_t *pChunk)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_decode_queue.push_back(pChunk);
+        m_output_queue.push_back(pChunk);
+    }
+    m_num_chunks++;
+    m_decode_cv.notify_one();
+}
+
+ocsd_datapath_resp_t DecodeIDChunker::outputChunks(const bool bWaitAll)
+{
+    ocsd_datapath_resp_t resp = OCSD_RESP_CONT, elem_resp;
+    dcd_chunk_t *pChunk;
+
+    while (!m_output_queue.empty() && OCSD_DATA_RESP_IS_CONT(resp))
+    {
+        pChunk = m_output_queue.front();
+
+        // wait for the next chunk in order if all required, or too many chunks queued.
+        {
+            std::unique_lock<std::mutex> lock(m_lock);
+            if (!pChunk->done && !bWaitAll && (m_output_queue.size() <= m_max_chunks))
+                break;
+            while (!pChunk->done)
+                m_done_cv.wait(lock);
+        }
+
+        // chunks following a fatal error are discarded.
+        if (OCSD_DATA_RESP_IS_FATAL(m_resp))
+        {
+            pChunk->out_pos = pChunk->elems.size();
+            pChunk->err_pos = pChunk->errs.size();
+        }
+
+        while ((pChunk->out_pos < pChunk->elems.size()) && OCSD_DATA_RESP_IS_CONT(resp))
+        {
+            outputErrors(pChunk, pChunk->out_pos);
+            const ocsd_gen_elem_batch_entry_t &entry = pChunk->elems[pChunk->out_pos++];
+            if (m_i_gen_elem_out)
+            {
+                static_cast<ocsd_generic_trace_elem &>(m_out_elem) = entry.elem;
+                elem_resp = m_i_gen_elem_out->TraceElemIn(entry.index_sop, entry.trc_chan_id, m_out_elem);
+                if (elem_resp > resp)
+                    resp = elem_resp;
+            }
+        }
+
+        // pass on the decode response once the chunk elements are output.
+        if (pChunk->out_pos == pChunk->elems.size())
+        {
+            outputErrors(pChunk, pChunk->out_pos);
+            if (OCSD_DATA_RESP_IS_FATAL(pChunk->resp))
+            {
+                if (!OCSD_DATA_RESP_IS_FATAL(m_resp))
+                    m_resp = pChunk->resp;
+            }
+            else if (OCSD_DATA_RESP_IS_CONT(resp) && (pChunk->resp > resp))
+                resp = pChunk->resp;
+            m_output_queue.pop_front();
+            delete pChunk;
+        }
+    }
+
+    if (m_output_queue.empty())
+        m_flush_all = false;
+    if (OCSD_DATA_RESP_IS_FATAL(resp))
+        m_resp = resp;
+    return OCSD_DATA_RESP_IS_FATAL(m_resp) ? m_resp : resp;
+}
+
+void DecodeIDChunker::outputErrors(dcd_chunk_t *pChunk, const size_t elem_pos)
+{
+    while ((pChunk->err_pos < pChunk->errs.size()) && (pChunk->errs[pChunk->err_pos].elem_pos <= elem_pos))
+    {
+        const dcd_chunk_err_t &chunk_err = pChunk->errs[pChunk->err_pos++];
+        if (m_i_err_log)
+            m_i_err_log->LogError(chunk_err.handle, &chunk_err.error);
+    }
+}
+
+void DecodeIDChunker::workerFn(DecodeChunkWorker *pWorker)
+{
+    dcd_chunk_t *pChunk;
+    std::unique_lock<std::mutex> lock(m_lock);
+
+    while (!m_stop)
+    {
+        if (m_decode_queue.empty())
+        {
+            m_decode_cv.wait(lock);
+            continue;
+        }
+        pChunk = m_decode_queue.front();
+        m_decode_queue.pop_front();
+
+        lock.unlock();
+        decodeChunk(pWorker, pChunk);
+        lock.lock();
+
+        pChunk->done = true;
+        m_done_cv.notify_all();
+    }
+}
+
+void DecodeIDChunker::decodeChunk(DecodeChunkWorker *pWorker, dcd_chunk_t *pChunk)
+{
+    ocsd_datapath_resp_t resp = OCSD_RESP_CONT, dcd_resp;
+    uint32_t offset, processed;
+
+    pWorker->m_pChunk = pChunk;
+    pWorker->m_num_elem = 0;
+    pWorker->initHandover(pWorker->m_start_handover, pChunk->blocks.empty() ? 0 : pChunk->blocks[0].index);
+    pWorker->m_start_handover.use_limit = pChunk->overlap_limit;
+    pWorker->m_start_handover.limit = pChunk->overlap_end;
+    pWorker->initHandover(pWorker->m_end_handover, pChunk->split_index);
+
+    // clear state from any previous chunk - a reset sets the unsync reason seen after an input reset.
+    if (pWorker->m_used || pChunk->after_reset)
+        resp = pWorker->m_pDataIn->TraceDataIn(OCSD_OP_RESET, 0, 0, 0, 0);
+    pWorker->m_used = true;
+
+    for (size_t i = 0; (i < pChunk->blocks.size()) && !OCSD_DATA_RESP_IS_FATAL(resp); i++)
+    {
+        const dcd_chunk_block_t &block = pChunk->blocks[i];
+        offset = 0;
+        while ((offset < block.size) && !OCSD_DATA_RESP_IS_FATAL(resp))
+        {
+            processed = 0;
+            dcd_resp = pWorker->m_pDataIn->TraceDataIn(OCSD_OP_DATA, block.index + offset, block.size - offset,
+                                                       &pChunk->data[block.offset + offset], &processed);
+            if (dcd_resp > resp)
+                resp = dcd_resp;
+            if (!processed)
+                break;
+            offset += processed;
+        }
+    }
+
+    // end of trace commits remaining elements - not at a reset, which discards them, or at a split,
+    // where the overlap has output pending elements and ends part way through a packet.
+    if (pChunk->end_eot && !OCSD_DATA_RESP_IS_FATAL(resp))
+    {
+        dcd_resp = pWorker->m_pDataIn->TraceDataIn(OCSD_OP_EOT, 0, 0, 0, 0);
+        if (dcd_resp > resp)
+            resp = dcd_resp;
+    }
+    pChunk->resp = resp;
+    pWorker->m_pChunk = 0;
+}
+
+/* End of File ocsd_dcd_chunk.cpp */
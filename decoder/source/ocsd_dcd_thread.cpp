@@ -0,0 +1,398 @@
+/*
+ * \file       ocsd_dcd_thread.cpp
+ * \brief      OpenCSD : Threaded decode of individual trace ID streams.
+ * 
+ * \copyright  Copyright (c) 2026, ARM Limited. All Rights Reserved.
+ */
+
+
+/* 
+ * Redistribution and use in source and binary forms, with or without modification, 
+ * are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, 
+ * this list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright notice, 
+ * this list of conditions and the following disclaimer in the documentation 
+ * and/or other materials provided with the distribution. 
+ * 
+ * 3. Neither the name of the copyright holder nor the names of its contributors 
+ * may be used to endorse or promote products derived from this software without 
+ * specific prior written permission. 
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 'AS IS' AND 
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED 
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. 
+ * IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, 
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES 
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; 
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND 
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT 
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS 
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. 
+ */ 
+
+#include <cstring>
+#include <chrono>
+
+#include "common/ocsd_dcd_thread.h"
+
+/***************************************************************/
+/* lock free single producer / single consumer byte queue */
+
+ocsd_err_t TrcSpscByteQueue::init(const uint32_t size)
+{
+    if ((size < DCD_THREAD_QUEUE_MIN_SIZE) || (size > DCD_THREAD_QUEUE_MAX_SIZE) || (size & (size - 1)))
+        return OCSD_ERR_INVALID_PARAM_VAL;
+    m_buffer.resize(size);
+    m_mask = size - 1;
+    m_head.store(0);
+    m_tail.store(0);
+    return OCSD_OK;
+}
+
+void TrcSpscByteQueue::copyIn(const size_t pos, const uint8_t *p_data, const uint32_t len)
+{
+    size_t offset = pos & m_mask;
+    size_t first = m_buffer.size() - offset;
+
+    if (first >= len)
+        memcpy(&m_buffer[offset], p_data, len);
+    else
+    {
+        memcpy(&m_buffer[offset], p_data, first);
+        memcpy(&m_buffer[0], p_data + first, len - first);
+    }
+}
+
+void TrcSpscByteQueue::copyOut(const size_t pos, uint8_t *p_data, const uint32_t len) const
+{
+    size_t offset = pos & m_mask;
+    size_t first = m_buffer.size() - offset;
+
+    if (first >= len)
+        memcpy(p_data, &m_buffer[offset], len);
+    else
+    {
+        memcpy(p_data, &m_buffer[offset], first);
+        memcpy(p_data + first, &m_buffer[0], len - first);
+    }
+}
+
+bool TrcSpscByteQueue::push(const void *p_hdr, const uint32_t hdr_len, const uint8_t *p_data, const uint32_t data_len)
+{
+    size_t head = m_head.load(std::memory_order_relaxed);
+    size_t tail = m_tail.load(std::memory_order_acquire);
+
+    if ((m_buffer.size() - (head - tail)) < (size_t)(hdr_len + data_len))
+        return false;
+
+    copyIn(head, (const uint8_t *)p_hdr, hdr_len);
+    if (data_len)
+        copyIn(head + hdr_len, p_data, data_len);
+    m_head.store(head + hdr_len + data_len, std::memory_order_release);
+    return true;
+}
+
+bool TrcSpscByteQueue::pop(void *p_buffer, const uint32_t len)
+{
+    size_t tail = m_tail.load(std::memory_order_relaxed);
+    size_t head = m_head.load(std::memory_order_acquire);
+
+    if ((head - tail) < len)
+        return false;
+
+    copyOut(tail, (uint8_t *)p_buffer, len);
+    m_tail.store(tail + len, std::memory_order_release);
+    return true;
+}
+
+/***************************************************************/
+/* per ID decode thread */
+
+DecodeIDThread::DecodeIDThread(const uint8_t CSID) :
+    m_CSID(CSID),
+    m_pDataIn(0),
+    m_stop(false),
+    m_worker_sleeping(false),
+    m_recs_pushed(0),
+    m_recs_done(0),
+    m_resp(OCSD_RESP_CONT)
+{
+}
+
+DecodeIDThread::~DecodeIDThread()
+{
+    stop();
+}
+
+ocsd_err_t DecodeIDThread::start(ITrcDataIn *pDataIn, const uint32_t queue_size)
+{
+    ocsd_err_t err;
+
+    if (m_thread.joinable() || !pDataIn)
+        return OCSD_ERR_INVALID_PARAM_VAL;
+
+    if ((err = m_queue.init(queue_size)) != OCSD_OK)
+        return err;
+
+    m_pDataIn = pDataIn;
+    m_stop.store(false);
+    m_recs_pushed = 0;
+    m_recs_done.store(0);
+    m_resp.store(OCSD_RESP_CONT);
+
+    try {
+        m_thread = std::thread(&DecodeIDThread::threadFn, this);
+    }
+    catch (...) {
+        return OCSD_ERR_FAIL;
+    }
+    return OCSD_OK;
+}
+
+void DecodeIDThread::stop()
+{
+    if (m_thread.joinable())
+    {
+        m_stop.store(true);
+        wakeWorker();
+        m_thread.join();
+    }
+}
+
+void DecodeIDThread::waitIdle()
+{
+    if (!m_thread.joinable())
+        return;
+
+    int spin = 0;
+    wakeWorker();
+    while (m_recs_done.load(std::memory_order_acquire) != m_recs_pushed)
+        producerBackoff(spin);
+}
+
+void DecodeIDThread::producerBackoff(int &spin)
+{
+    // yield while the worker is likely to finish soon, then sleep rather than hold a core.
+    if (spin < 64)
+    {
+        spin++;
+        std::this_thread::yield();
+    }
+    else
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+}
+
+void DecodeIDThread::wakeWorker()
+{
+    // fence orders the queue update before the sleeping check - pairs with the fence in waitForData.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_worker_sleeping.load(std::memory_order_relaxed))
+    {
+        std::lock_guard<std::mutex> lock(m_wake_mutex);
+        m_wake_cv.notify_one();
+    }
+}
+
+bool DecodeIDThread::pushRecord(const ocsd_datapath_op_t op, const ocsd_trc_index_t index, const uint8_t *p_data, const uint32_t size)
+{
+    queue_rec_hdr_t hdr;
+    int spin = 0;
+
+    hdr.index = index;
+    hdr.op = (uint32_t)op;
+    hdr.data_size = size;
+
+    // wait for the worker to make space - a reset is always queued, the worker discards data after a fatal error.
+    while (!m_queue.push(&hdr, sizeof(hdr), p_data, size))
+    {
+        if ((op != OCSD_OP_RESET) && OCSD_DATA_RESP_IS_FATAL(m_resp.load()))
+            return false;
+        wakeWorker();
+        producerBackoff(spin);
+    }
+    m_recs_pushed++;
+    wakeWorker();
+    return true;
+}
+
+ocsd_datapath_resp_t DecodeIDThread::TraceDataIn(const ocsd_datapath_op_t op,
+                                                 const ocsd_trc_index_t index,
+                                                 const uint32_t dataBlockSize,
+                                                 const uint8_t *pDataBlock,
+                                                 uint32_t *numBytesProcessed)
+{
+    ocsd_datapath_resp_t resp = m_resp.load();
+    uint32_t offset = 0, rec_size;
+
+    if (numBytesProcessed)
+        *numBytesProcessed = 0;
+
+    // after a fatal error only a reset will restart decode.
+    if (OCSD_DATA_RESP_IS_FATAL(resp) && (op != OCSD_OP_RESET))
+        return resp;
+
+    if ((op == OCSD_OP_DATA) && (!dataBlockSize || !pDataBlock))
+    {
+        // pass on invalid blocks for the packet processor to report.
+        pushRecord(op, index, 0, 0);
+    }
+    else if (op == OCSD_OP_DATA)
+    {
+        while (offset < dataBlockSize)
+        {
+            rec_size = dataBlockSize - offset;
+            if (rec_size > MAX_REC_DATA)
+                rec_size = MAX_REC_DATA;
+            if (!pushRecord(op, index + offset, pDataBlock + offset, rec_size))
+                break;
+            offset += rec_size;
+        }
+        if (numBytesProcessed)
+            *numBytesProcessed = offset;
+    }
+    else if (op == OCSD_OP_RESET)
+    {
+        // reset clears any fatal error - wait for the worker so the response is from after the reset.
+        pushRecord(op, index, 0, 0);
+        waitIdle();
+        return m_resp.load();
+    }
+    else
+    {
+        // no data to pass on for flush - worker waits on the decoder itself.
+        if (op != OCSD_OP_FLUSH)
+            pushRecord(op, index, 0, 0);
+    }
+
+    resp = m_resp.load();
+    if (!OCSD_DATA_RESP_IS_FATAL(resp))
+        resp = OCSD_RESP_CONT;
+    return resp;
+}
+
+bool DecodeIDThread::waitForData()
+{
+    int spin = 0;
+
+    while (m_queue.empty())
+    {
+        if (m_stop.load())
+            return false;
+
+        if (spin < 64)
+        {
+            spin++;
+            std::this_thread::yield();
+        }
+        else
+        {
+            std::unique_lock<std::mutex> lock(m_wake_mutex);
+            m_worker_sleeping.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (m_queue.empty() && !m_stop.load())
+                m_wake_cv.wait_for(lock, std::chrono::milliseconds(1));
+            m_worker_sleeping.store(false, std::memory_order_relaxed);
+        }
+    }
+    return !m_stop.load();
+}
+
+void DecodeIDThread::processRecord(const queue_rec_hdr_t &hdr, const uint8_t *p_data)
+{
+    ocsd_datapath_resp_t resp = m_resp.load();
+    ocsd_datapath_op_t op = (ocsd_datapath_op_t)hdr.op;
+    uint32_t offset = 0, processed;
+    bool bResend;
+
+    if (op == OCSD_OP_RESET)
+        resp = OCSD_RESP_CONT;
+    else if (OCSD_DATA_RESP_IS_FATAL(resp))
+        return; // discard after fatal error.
+
+    do {
+        processed = 0;
+        if (op == OCSD_OP_DATA)
+        {
+            resp = m_pDataIn->TraceDataIn(op, hdr.index + offset, hdr.data_size - offset, hdr.data_size ? p_data + offset : 0, &processed);
+            offset += processed;
+        }
+        else
+            resp = m_pDataIn->TraceDataIn(op, hdr.index, 0, 0, 0);
+        bResend = (processed != 0);
+
+        // decoder waiting on the output - flush until it continues, then send any remaining data.
+        while (OCSD_DATA_RESP_IS_WAIT(resp) && !m_stop.load())
+        {
+            bResend = true;
+            resp = m_pDataIn->TraceDataIn(OCSD_OP_FLUSH, 0, 0, 0, 0);
+            if (OCSD_DATA_RESP_IS_WAIT(resp))
+                std::this_thread::yield();
+        }
+    } while ((offset < hdr.data_size) && bResend && OCSD_DATA_RESP_IS_CONT(resp) && !m_stop.load());
+
+    m_resp.store(resp);
+}
+
+void DecodeIDThread::threadFn()
+{
+    queue_rec_hdr_t hdr;
+    uint8_t data[MAX_REC_DATA];
+
+    while (waitForData())
+    {
+        // records are pushed complete - data always follows the header.
+        m_queue.pop(&hdr, sizeof(hdr));
+        if (hdr.data_size)
+            m_queue.pop(data, hdr.data_size);
+        processRecord(hdr, data);
+        m_recs_done.fetch_add(1, std::memory_order_release);
+    }
+}
+
+/***************************************************************/
+/* locked memory access */
+
+ocsd_err_t TrcMemAccLocked::ReadTargetMemory(const ocsd_vaddr_t address, const uint8_t cs_trace_id, const ocsd_mem_space_acc_t mem_space,
+                                             uint32_t *num_bytes, uint8_t *p_buffer)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_p_mem_acc->ReadTargetMemory(address, cs_trace_id, mem_space, num_bytes, p_buffer);
+}
+
+ocsd_err_t TrcMemAccLocked::ReadTargetMemoryCtxt(const ocsd_vaddr_t address, const uint8_t cs_trace_id, const ocsd_mem_space_acc_t mem_space,
+                                                 const ocsd_pe_context *p_context, uint32_t *num_bytes, uint8_t *p_buffer)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_p_mem_acc->ReadTargetMemoryCtxt(address, cs_trace_id, mem_space, p_context, num_bytes, p_buffer);
+}
+
+ocsd_err_t TrcMemAccLocked::ReadTargetMemoryPtr(const ocsd_vaddr_t address, const uint8_t cs_trace_id, const ocsd_mem_space_acc_t mem_space,
+                                                const ocsd_pe_context *p_context, uint32_t *num_bytes, const uint8_t **pp_data)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_p_mem_acc->ReadTargetMemoryPtr(address, cs_trace_id, mem_space, p_context, num_bytes, pp_data);
+}
+
+void TrcMemAccLocked::InvalidateMemAccCache(const uint8_t cs_trace_id)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_p_mem_acc->InvalidateMemAccCache(cs_trace_id);
+}
+
+/***************************************************************/
+/* locked generic element output */
+
+ocsd_datapath_resp_t TrcGenElemLocked::TraceElemIn(const ocsd_trc_index_t index_sop,
+                                                   const uint8_t trc_chan_id,
+                                                   const OcsdTraceElement &elem)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_p_gen_elem_out)
+        return OCSD_RESP_FATAL_NOT_INIT;
+    return m_p_gen_elem_out->TraceElemIn(index_sop, trc_chan_id, elem);
+}
+
+/* End of File ocsd_dcd_thread.cpp */
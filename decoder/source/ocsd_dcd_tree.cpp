@@ -101,10 +101,22 @@ DecodeTree::DecodeTree() :
     m_frame_deformatter_root(0),
     m_decode_elem_iter(0),
     m_default_mapper(0),
-    m_created_mapper(false)
+    m_created_mapper(false),
+    m_elem_out_mask(OCSD_GEN_TRC_ELEM_MASK_ALL),
+    m_threaded_decode(false),
+    m_thread_queue_size(DCD_THREAD_QUEUE_DEFAULT_SIZE),
+    m_num_id_chunkers(0),
+    m_sync_indexer(0),
+    m_ring_buf_in(0),
+    m_afdo_sink(0)
 {
     for(int i = 0; i < 0x80; i++)
+    {
         m_decode_elements[i] = 0;
+        m_id_threads[i] = 0;
+        m_id_gen_elem_out[i] = 0;
+        m_id_chunkers[i] = 0;
+    }
 
      // reset the global demux stats.
     m_demux_stats.frame_bytes = 0;
@@ -112,10 +124,18 @@ DecodeTree::DecodeTree() :
     m_demux_stats.valid_id_bytes = 0;  
     m_demux_stats.unknown_id_bytes = 0;
     m_demux_stats.reserved_id_bytes = 0;     
+
+    setMemAccAddContext(0);
 }
 
 DecodeTree::~DecodeTree()
 {
+    // stop decode threads before removing the components they use.
+    for(uint8_t i = 0; i < 0x80; i++)
+    {
+        destroyIDThread(i);
+        destroyIDChunker(i);
+    }
     destroyMemAccessors();
     destroyMemAccMapper();
     for(uint8_t i = 0; i < 0x80; i++)
@@ -124,6 +144,12 @@ DecodeTree::~DecodeTree()
     }
     PktPrinterFact::destroyAllPrinters(m_printer_list);
     delete m_frame_deformatter_root;
+    if (m_sync_indexer)
+        delete m_sync_indexer;
+    if (m_ring_buf_in)
+        delete m_ring_buf_in;
+    if (m_afdo_sink)
+        delete m_afdo_sink;
 }
 
 
@@ -134,8 +160,41 @@ ocsd_datapath_resp_t DecodeTree::TraceDataIn( const ocsd_datapath_op_t op,
                                                const uint8_t *pDataBlock,
                                                uint32_t *numBytesProcessed)
 {
+    ocsd_datapath_resp_t resp, batch_resp;
+    bool bDecodeIdle = true;
+
     if(m_i_decoder_root)
-        return m_i_decoder_root->TraceDataIn(op,index,dataBlockSize,pDataBlock,numBytesProcessed);
+    {
+        resp = m_i_decoder_root->TraceDataIn(op,index,dataBlockSize,pDataBlock,numBytesProcessed);
+
+        // fatal error ahead of chunked decoders - output the trace already input before passing on the error.
+        if (OCSD_DATA_RESP_IS_FATAL(resp) && (m_num_id_chunkers > 0))
+        {
+            for (int i = 0; i < 0x80; i++)
+            {
+                if (m_id_chunkers[i])
+                    m_id_chunkers[i]->flushInput();
+            }
+        }
+
+        // threaded decode - end of trace and reset complete once all IDs decoded.
+        // fatal error ahead of the workers - decode the trace already queued before passing on the error.
+        if (m_threaded_decode)
+        {
+            bDecodeIdle = (op == OCSD_OP_EOT) || (op == OCSD_OP_RESET) || OCSD_DATA_RESP_IS_FATAL(resp);
+            if (bDecodeIdle)
+                waitIDThreadsIdle(&resp);
+        }
+
+        // end of block - pass on any batched elements.
+        if (usingGenElemBatch() && bDecodeIdle)
+        {
+            batch_resp = m_gen_elem_batcher.flush();
+            if (OCSD_DATA_RESP_IS_CONT(resp))
+                resp = batch_resp;
+        }
+        return resp;
+    }
     *numBytesProcessed = 0;
     return OCSD_RESP_FATAL_NOT_INIT;
 }
@@ -146,10 +205,12 @@ void DecodeTree::setInstrDecoder(IInstrDecode *i_instr_decode)
     uint8_t elemID;
     DecodeTreeElement *pElem = 0;
 
+    waitIDThreadsIdle();
     pElem = getFirstElement(elemID);
     while(pElem != 0)
     {
         pElem->getDecoderMngr()->attachInstrDecoder(pElem->getDecoderHandle(),i_instr_decode);
+        setIDChunkerInterfaces(elemID, i_instr_decode);
         pElem = getNextElement(elemID);
     }
 }
@@ -158,14 +219,19 @@ void DecodeTree::setMemAccessI(ITargetMemAccess *i_mem_access)
 {
     uint8_t elemID;
     DecodeTreeElement *pElem = 0;
-   
+
+    waitIDThreadsIdle();
+    m_i_mem_access = i_mem_access;
+    m_mem_acc_locked.setMemAccessI(i_mem_access);
+
     pElem = getFirstElement(elemID);
     while(pElem != 0)
     {
-        pElem->getDecoderMngr()->attachMemAccessor(pElem->getDecoderHandle(),i_mem_access);
+        pElem->getDecoderMngr()->attachMemAccessor(pElem->getDecoderHandle(),getDcdMemAccessI());
+        setIDChunkerInterfaces(elemID, 0);
         pElem = getNextElement(elemID);
     }
-    m_i_mem_access = i_mem_access;
+    memImageChanged();
 }
 
 void DecodeTree::setGenTraceElemOutI(ITrcGenElemIn *i_gen_trace_elem)
@@ -173,17 +239,274 @@ void DecodeTree::setGenTraceElemOutI(ITrcGenElemIn *i_gen_trace_elem)
     uint8_t elemID;
     DecodeTreeElement *pElem = 0;
 
+    /* set local copy of interface to return in getGenTraceElemOutI */
+    waitIDThreadsIdle();
+    m_i_gen_elem_out = i_gen_trace_elem;
+    m_gen_elem_locked.setGenElemOutI(i_gen_trace_elem);
+
     pElem = getFirstElement(elemID);
     while(pElem != 0)
     {
-        pElem->getDecoderMngr()->attachOutputSink(pElem->getDecoderHandle(),i_gen_trace_elem);
+        pElem->getDecoderMngr()->attachOutputSink(pElem->getDecoderHandle(),getIDGenElemOutI(elemID));
+        setIDChunkerInterfaces(elemID, 0);
         pElem = getNextElement(elemID);
     }
-    /* set local copy of interface to return in getGenTraceElemOutI */
-    m_i_gen_elem_out = i_gen_trace_elem;
 }
 
-ocsd_err_t DecodeTree::createMemAccMapper(memacc_mapper_t type /* = MEMACC_MAP_GLOBAL*/ )
+void DecodeTree::setGenElemOutMask(const uint32_t elem_mask)
+{
+    uint8_t elemID;
+    DecodeTreeElement *pElem = 0;
+
+    waitIDThreadsIdle();
+    m_elem_out_mask = elem_mask;
+    pElem = getFirstElement(elemID);
+    while (pElem != 0)
+    {
+        TrcPktDecodeI *pDcdI = dynamic_cast<TrcPktDecodeI *>(pElem->getDecoderHandle());
+        if (pDcdI)
+            pDcdI->setElemOutMask(elem_mask);
+        if (m_id_chunkers[elemID])
+            m_id_chunkers[elemID]->setElemOutMask(elem_mask);
+        pElem = getNextElement(elemID);
+    }
+}
+
+ocsd_err_t DecodeTree::setIDGenTraceElemOutI(const uint8_t CSID, ITrcGenElemIn *i_gen_trace_elem)
+{
+    if (!usingFormatter())
+        return OCSD_ERR_DCDT_NO_FORMATTER;
+    if (!OCSD_IS_VALID_CS_SRC_ID(CSID))
+        return OCSD_ERR_INVALID_ID;
+
+    waitIDThreadsIdle();
+    m_id_gen_elem_out[CSID] = i_gen_trace_elem;
+    if (m_decode_elements[CSID])
+        m_decode_elements[CSID]->getDecoderMngr()->attachOutputSink(m_decode_elements[CSID]->getDecoderHandle(), getIDGenElemOutI(CSID));
+    setIDChunkerInterfaces(CSID, 0);
+    return OCSD_OK;
+}
+
+ITrcGenElemIn *DecodeTree::getIDGenElemOutI(const uint8_t CSID)
+{
+    if (m_afdo_sink && m_afdo_sink->isActive())
+        return m_afdo_sink->getShard(CSID);
+    if (m_id_gen_elem_out[CSID])
+        return m_id_gen_elem_out[CSID];
+    return (m_threaded_decode && m_i_gen_elem_out) ? &m_gen_elem_locked : m_i_gen_elem_out;
+}
+
+ITargetMemAccess *DecodeTree::getDcdMemAccessI()
+{
+    return (decodeOnWorkers() && m_i_mem_access) ? &m_mem_acc_locked : m_i_mem_access;
+}
+
+ocsd_err_t DecodeTree::setThreadedDecode(const bool enable, const uint32_t queue_size /* = DCD_THREAD_QUEUE_DEFAULT_SIZE */)
+{
+    ocsd_err_t err = OCSD_OK;
+    uint8_t elemID;
+    DecodeTreeElement *pElem = 0;
+
+    if (!usingFormatter())
+        return OCSD_ERR_DCDT_NO_FORMATTER;
+
+    if (enable && ((queue_size < DCD_THREAD_QUEUE_MIN_SIZE) || (queue_size > DCD_THREAD_QUEUE_MAX_SIZE) || (queue_size & (queue_size - 1))))
+        return OCSD_ERR_INVALID_PARAM_VAL;
+
+    // complete any queued decode before switching.
+    waitIDThreadsIdle();
+    m_threaded_decode = enable;
+    m_thread_queue_size = queue_size;
+
+    // cache pages can be reloaded by another thread while a decoder holds a pointer.
+    if (m_default_mapper)
+        m_default_mapper->setCachePtrReads(!decodeOnWorkers());
+
+    // reconnect existing decoders through shared interfaces for the mode.
+    setMemAccessI(m_i_mem_access);
+    setGenTraceElemOutI(m_i_gen_elem_out);
+    pElem = getFirstElement(elemID);
+    while ((pElem != 0) && (err == OCSD_OK))
+    {
+        attachInstrBlockCache(pElem->getDecoderHandle());
+        err = attachIDStream(elemID);
+        pElem = getNextElement(elemID);
+    }
+    return err;
+}
+
+ocsd_err_t DecodeTree::attachIDStream(const uint8_t CSID)
+{
+    ocsd_err_t err;
+    ITrcDataIn *pDataIn = 0;
+    DecodeTreeElement *pElem = m_decode_elements[CSID];
+
+    if ((err = pElem->getDecoderMngr()->getDataInputI(pElem->getDecoderHandle(), &pDataIn)) != OCSD_OK)
+        return err;
+
+    // remove any existing thread - packet processor input then attached directly, to a new thread, or via the chunked decoder.
+    destroyIDThread(CSID);
+    if (m_id_chunkers[CSID])
+        pDataIn = m_id_chunkers[CSID];
+    else if (m_threaded_decode)
+    {
+        m_id_threads[CSID] = new (std::nothrow) DecodeIDThread(CSID);
+        if (!m_id_threads[CSID])
+            return OCSD_ERR_MEM;
+        if ((err = m_id_threads[CSID]->start(pDataIn, m_thread_queue_size)) != OCSD_OK)
+        {
+            delete m_id_threads[CSID];
+            m_id_threads[CSID] = 0;
+            return err;
+        }
+        pDataIn = m_id_threads[CSID];
+    }
+    return m_frame_deformatter_root->getIDStreamAttachPt(CSID)->replace_first(pDataIn);
+}
+
+void DecodeTree::destroyIDThread(const uint8_t CSID)
+{
+    if (m_id_threads[CSID])
+    {
+        m_id_threads[CSID]->waitIdle();
+        m_frame_deformatter_root->getIDStreamAttachPt(CSID)->detach(m_id_threads[CSID]);
+        delete m_id_threads[CSID];
+        m_id_threads[CSID] = 0;
+    }
+}
+
+void DecodeTree::waitIDThreadsIdle(ocsd_datapath_resp_t *p_resp /* = 0 */)
+{
+    ocsd_datapath_resp_t id_resp;
+
+    if (!decodeOnWorkers())
+        return;
+
+    for (int i = 0; i < 0x80; i++)
+    {
+        if (m_id_chunkers[i])
+        {
+            m_id_chunkers[i]->waitIdle();
+            id_resp = m_id_chunkers[i]->getResp();
+            if (p_resp && (id_resp > *p_resp))
+                *p_resp = id_resp;
+        }
+        if (m_id_threads[i])
+        {
+            m_id_threads[i]->waitIdle();
+            id_resp = m_id_threads[i]->getResp();
+            if (p_resp && (id_resp > *p_resp))
+                *p_resp = id_resp;
+        }
+    }
+}
+
+ocsd_err_t DecodeTree::setChunkedDecode(const uint8_t CSID, const bool enable, const uint32_t num_threads /* = 0 */, const uint32_t chunk_size /* = DCD_CHUNK_DEFAULT_SIZE */)
+{
+    ocsd_err_t err = OCSD_OK;
+    uint8_t localID = CSID;
+    DecodeTreeElement *pElem = 0;
+    ITrcDataIn *pDataIn = 0;
+
+    if (!usingFormatter())
+        localID = 0;
+    else if (!OCSD_IS_VALID_CS_SRC_ID(CSID))
+        return OCSD_ERR_INVALID_ID;
+
+    pElem = m_decode_elements[localID];
+    if (!pElem)
+        return OCSD_ERR_INVALID_ID;
+
+    // complete any queued decode before switching.
+    waitIDThreadsIdle();
+    destroyIDChunker(localID);
+    if (enable)
+    {
+        m_id_chunkers[localID] = new (std::nothrow) DecodeIDChunker(localID);
+        if (!m_id_chunkers[localID])
+            return OCSD_ERR_MEM;
+        err = m_id_chunkers[localID]->init(pElem->getDecoderMngr(), pElem->getDecoderHandle(), usingFormatter(), num_threads, chunk_size);
+        if (err != OCSD_OK)
+        {
+            delete m_id_chunkers[localID];
+            m_id_chunkers[localID] = 0;
+        }
+        else
+        {
+            m_num_id_chunkers++;
+            setIDChunkerInterfaces(localID, m_i_instr_decode);
+        }
+    }
+
+    // memory access from the workers is serialised - reconnect all decoders and set the chunker interfaces.
+    if (m_default_mapper)
+        m_default_mapper->setCachePtrReads(!decodeOnWorkers());
+    setMemAccessI(m_i_mem_access);
+    setGenTraceElemOutI(m_i_gen_elem_out);
+
+    if (err == OCSD_OK)
+    {
+        if (usingFormatter())
+            err = attachIDStream(localID);
+        else if (m_id_chunkers[localID])
+            m_i_decoder_root = m_id_chunkers[localID];
+        else if ((err = pElem->getDecoderMngr()->getDataInputI(pElem->getDecoderHandle(), &pDataIn)) == OCSD_OK)
+            m_i_decoder_root = pDataIn;
+    }
+    return err;
+}
+
+void DecodeTree::destroyIDChunker(const uint8_t CSID)
+{
+    ITrcDataIn *pDataIn = 0;
+
+    if (m_id_chunkers[CSID])
+    {
+        m_id_chunkers[CSID]->waitIdle();
+        if (usingFormatter())
+            m_frame_deformatter_root->getIDStreamAttachPt(CSID)->detach(m_id_chunkers[CSID]);
+        else if (m_i_decoder_root == m_id_chunkers[CSID])
+        {
+            m_i_decoder_root = 0;
+            if (m_decode_elements[CSID] && (m_decode_elements[CSID]->getDecoderMngr()->getDataInputI(m_decode_elements[CSID]->getDecoderHandle(), &pDataIn) == OCSD_OK))
+                m_i_decoder_root = pDataIn;
+        }
+        delete m_id_chunkers[CSID];
+        m_id_chunkers[CSID] = 0;
+        m_num_id_chunkers--;
+    }
+}
+
+void DecodeTree::setIDChunkerInterfaces(const uint8_t CSID, IInstrDecode *i_instr_decode)
+{
+    if (m_id_chunkers[CSID])
+        m_id_chunkers[CSID]->setInterfaces(i_instr_decode, getDcdMemAccessI(), s_i_error_logger, getIDGenElemOutI(CSID));
+}
+
+ocsd_err_t DecodeTree::setGenTraceElemBatchOutI(ITrcGenElemBatchIn *i_gen_elem_batch, const uint32_t batch_size /* = GEN_ELEM_BATCH_DEFAULT_SIZE */)
+{
+    ocsd_err_t err;
+
+    if (usingGenElemBatch())
+        m_gen_elem_batcher.flush();
+
+    err = m_gen_elem_batcher.init(i_gen_elem_batch, batch_size);
+    if (err == OCSD_OK)
+    {
+        if (i_gen_elem_batch)
+            setGenTraceElemOutI(&m_gen_elem_batcher);
+        else if (usingGenElemBatch())
+            setGenTraceElemOutI(0);
+    }
+    return err;
+}
+
+ITrcGenElemBatchIn *DecodeTree::getGenTraceElemBatchOutI() const
+{
+    return usingGenElemBatch() ? m_gen_elem_batcher.getBatchOutI() : 0;
+}
+
+ocsd_err_t DecodeTree::createMemAccMapper(memacc_mapper_t type /* = MEMACC_MAP_GLOBAL_IDX*/ )
 {
     // clean up any old one
     destroyMemAccMapper();
@@ -191,10 +514,18 @@ ocsd_err_t DecodeTree::createMemAccMapper(memacc_mapper_t type /* = MEMACC_MAP_G
     // make a new one
     switch(type)
     {
-    default:
     case MEMACC_MAP_GLOBAL:
         m_default_mapper = new (std::nothrow) TrcMemAccMapGlobalSpace();
         break;
+
+    case MEMACC_MAP_CTXT:
+        m_default_mapper = new (std::nothrow) TrcMemAccMapCtxtSpace();
+        break;
+
+    default:
+    case MEMACC_MAP_GLOBAL_IDX:
+        m_default_mapper = new (std::nothrow) TrcMemAccMapGlobalSpaceIdx();
+        break;
     }
 
     // set the access interface
@@ -205,6 +536,7 @@ ocsd_err_t DecodeTree::createMemAccMapper(memacc_mapper_t type /* = MEMACC_MAP_G
         
 
         m_created_mapper = true;
+        m_default_mapper->setCachePtrReads(!m_threaded_decode);
         setMemAccessI(m_default_mapper);
         m_default_mapper->setErrorLog(s_i_error_logger);
         TrcMemAccCache::getenvMemaccCacheSizes(enableCaching, cachePageSize, cachePageNum);
@@ -220,12 +552,16 @@ void DecodeTree::setExternMemAccMapper(TrcMemAccMapper* pMapper)
 {
     destroyMemAccMapper();  // destroy any existing mapper - if decode tree created it.
     m_default_mapper = pMapper;
+    if (m_default_mapper && m_threaded_decode)
+        m_default_mapper->setCachePtrReads(false);
+    memImageChanged();
 }
 
 void DecodeTree::destroyMemAccMapper()
 {
     if(m_default_mapper && m_created_mapper)
     {
+        waitIDThreadsIdle();
         m_default_mapper->RemoveAllAccessors();
         delete m_default_mapper;
         m_default_mapper = 0;
@@ -236,6 +572,29 @@ void DecodeTree::destroyMemAccMapper()
 void DecodeTree::addMemAccessorToList(TrcMemAccessorBase* p_accessor)
 {
     m_mem_accessors.push_back(p_accessor);
+
+    // new memory image - drop any decoded blocks
+    memImageChanged();
+}
+
+ocsd_err_t DecodeTree::addAccessorToMapper(TrcMemAccessorBase* p_accessor)
+{
+    waitIDThreadsIdle();
+
+    // shared file accessors are per context - setting the context again leaves them unchanged.
+    p_accessor->setMemContext(m_mem_acc_add_ctxt);
+    return m_default_mapper->AddAccessor(p_accessor, 0);
+}
+
+void DecodeTree::setMemAccAddContext(const ocsd_mem_acc_ctxt_t *p_ctxt)
+{
+    if (p_ctxt)
+        m_mem_acc_add_ctxt = *p_ctxt;
+    else
+    {
+        m_mem_acc_add_ctxt.context_id = m_mem_acc_add_ctxt.vmid = 0;
+        m_mem_acc_add_ctxt.ctxt_id_valid = m_mem_acc_add_ctxt.vmid_valid = 0;
+    }
 }
 
 // destroy mem accessors in use by this object
@@ -258,6 +617,66 @@ void DecodeTree::logMappedRanges()
         m_default_mapper->logMappedRanges();
 }
 
+ocsd_err_t DecodeTree::setInstrBlockCacheing(const bool enable, const int nr_entries)
+{
+    ocsd_err_t err = OCSD_OK;
+    uint8_t elemID;
+    DecodeTreeElement *pElem = 0;
+
+    waitIDThreadsIdle();
+    if (enable)
+    {
+        // set number of entries - error if params out of limits
+        err = m_instr_blk_cache.setNumEntries(nr_entries, true);
+        if (err == OCSD_OK)
+            err = m_instr_blk_cache.enableCaching(true);
+    }
+    else
+        err = m_instr_blk_cache.enableCaching(false);
+
+    // attach or detach on any existing decoders
+    pElem = getFirstElement(elemID);
+    while (pElem != 0)
+    {
+        attachInstrBlockCache(pElem->getDecoderHandle());
+        pElem = getNextElement(elemID);
+    }
+    return err;
+}
+
+void DecodeTree::invalidateInstrBlockCache()
+{
+    waitIDThreadsIdle();
+    m_instr_blk_cache.invalidateAll();
+}
+
+void DecodeTree::memImageChanged()
+{
+    uint8_t elemID;
+    DecodeTreeElement *pElem = 0;
+
+    // drop any decoded blocks, and any memory held by decoders for sequential reads.
+    waitIDThreadsIdle();
+    m_instr_blk_cache.invalidateAll();
+    pElem = getFirstElement(elemID);
+    while (pElem != 0)
+    {
+        TrcPktDecodeI *pDcdI = dynamic_cast<TrcPktDecodeI *>(pElem->getDecoderHandle());
+        if (pDcdI)
+            pDcdI->clearMemAccSpan();
+        pElem = getNextElement(elemID);
+    }
+}
+
+void DecodeTree::attachInstrBlockCache(TraceComponent *pComponent)
+{
+    // only full PE decoders walk memory images - cache attached to those only.
+    // cache is shared between decoders so not used for threaded decode.
+    TrcPktDecodeI *pDcdI = dynamic_cast<TrcPktDecodeI *>(pComponent);
+    if (pDcdI && pDcdI->getUsesMemAccess() && pDcdI->getUsesIDecode())
+        pDcdI->getInstrBlockCacheAttachPt()->replace_first((m_instr_blk_cache.enabled() && !m_threaded_decode) ? &m_instr_blk_cache : 0);
+}
+
 ocsd_err_t DecodeTree::setMemAccCacheing(const bool enable, const uint16_t page_size, const int nr_pages)
 {
     ocsd_err_t err = OCSD_OK;
@@ -265,6 +684,7 @@ ocsd_err_t DecodeTree::setMemAccCacheing(const bool enable, const uint16_t page_
     if (!m_default_mapper)
         return OCSD_ERR_NOT_INIT;
 
+    waitIDThreadsIdle();
     if (enable)
     {
         // set cache sizes - error if params out of limits
@@ -295,7 +715,7 @@ ocsd_err_t DecodeTree::addBufferMemAcc(const ocsd_vaddr_t address, const ocsd_me
         if(pMBuffAcc)
         {
             pMBuffAcc->setMemSpace(mem_space);
-            err = m_default_mapper->AddAccessor(p_accessor,0);
+            err = addAccessorToMapper(p_accessor);
         }
         else
             err = OCSD_ERR_MEM;    // wrong type of object - treat as mem error
@@ -308,7 +728,7 @@ ocsd_err_t DecodeTree::addBufferMemAcc(const ocsd_vaddr_t address, const ocsd_me
     return err;
 }
 
-ocsd_err_t DecodeTree::addBinFileMemAcc(const ocsd_vaddr_t address, const ocsd_mem_space_acc_t mem_space, const std::string &filepath)
+ocsd_err_t DecodeTree::addBinFileMemAcc(const ocsd_vaddr_t address, const ocsd_mem_space_acc_t mem_space, const std::string &filepath, const bool use_mmap /* = false */)
 {
     if(!hasMemAccMapper())
         return OCSD_ERR_NOT_INIT;
@@ -317,7 +737,7 @@ ocsd_err_t DecodeTree::addBinFileMemAcc(const ocsd_vaddr_t address, const ocsd_m
         return OCSD_ERR_INVALID_PARAM_VAL;
 
     TrcMemAccessorBase *p_accessor;
-    ocsd_err_t err = TrcMemAccFactory::CreateFileAccessor(&p_accessor,filepath,address);
+    ocsd_err_t err = TrcMemAccFactory::CreateFileAccessor(&p_accessor,filepath,address,0,0,use_mmap,&m_mem_acc_add_ctxt);
 
     if(err == OCSD_OK)
     {
@@ -325,7 +745,7 @@ ocsd_err_t DecodeTree::addBinFileMemAcc(const ocsd_vaddr_t address, const ocsd_m
         if(pAcc)
         {
             pAcc->setMemSpace(mem_space);
-            err = m_default_mapper->AddAccessor(pAcc,0);
+            err = addAccessorToMapper(pAcc);
         }
         else
             err = OCSD_ERR_MEM;    // wrong type of object - treat as mem error
@@ -339,7 +759,7 @@ ocsd_err_t DecodeTree::addBinFileMemAcc(const ocsd_vaddr_t address, const ocsd_m
 
 }
 
-ocsd_err_t DecodeTree::addBinFileRegionMemAcc(const ocsd_file_mem_region_t *region_array, const int num_regions, const ocsd_mem_space_acc_t mem_space, const std::string &filepath)
+ocsd_err_t DecodeTree::addBinFileRegionMemAcc(const ocsd_file_mem_region_t *region_array, const int num_regions, const ocsd_mem_space_acc_t mem_space, const std::string &filepath, const bool use_mmap /* = false */)
 {
     if(!hasMemAccMapper())
         return OCSD_ERR_NOT_INIT;
@@ -351,7 +771,7 @@ ocsd_err_t DecodeTree::addBinFileRegionMemAcc(const ocsd_file_mem_region_t *regi
     int curr_region_idx = 0;
 
     // add first region during the creation of the file accessor.
-    ocsd_err_t err = TrcMemAccFactory::CreateFileAccessor(&p_accessor,filepath,region_array[curr_region_idx].start_address,region_array[curr_region_idx].file_offset, region_array[curr_region_idx].region_size);            
+    ocsd_err_t err = TrcMemAccFactory::CreateFileAccessor(&p_accessor,filepath,region_array[curr_region_idx].start_address,region_array[curr_region_idx].file_offset, region_array[curr_region_idx].region_size, use_mmap, &m_mem_acc_add_ctxt);
     if(err == OCSD_OK)
     {
         TrcMemAccessorFile *pAcc = dynamic_cast<TrcMemAccessorFile *>(p_accessor);
@@ -369,7 +789,7 @@ ocsd_err_t DecodeTree::addBinFileRegionMemAcc(const ocsd_file_mem_region_t *regi
             pAcc->setMemSpace(mem_space);
 
             // add the accessor to the map.
-            err = m_default_mapper->AddAccessor(pAcc,0);
+            err = addAccessorToMapper(pAcc);
         }
         else
             err = OCSD_ERR_MEM;    // wrong type of object - treat as mem error
@@ -390,10 +810,13 @@ ocsd_err_t DecodeTree::updateBinFileRegionMemAcc(const ocsd_file_mem_region_t *r
     if ((region_array == 0) || (num_regions == 0) || (filepath.length() == 0))
         return OCSD_ERR_INVALID_PARAM_VAL;
 
-    TrcMemAccessorFile *pAcc = TrcMemAccessorFile::getExistingFileAccessor(filepath);
+    TrcMemAccessorFile *pAcc = TrcMemAccessorFile::getExistingFileAccessor(filepath, &m_mem_acc_add_ctxt);
     if (!pAcc) 
         return OCSD_ERR_INVALID_PARAM_VAL;
 
+    // memory image changing - drop any decoded blocks
+    memImageChanged();
+
     int curr_region_idx = 0;
     while (curr_region_idx < num_regions)
     {
@@ -431,7 +854,7 @@ ocsd_err_t DecodeTree::initCallbackMemAcc(const ocsd_vaddr_t st_address, const o
             else
                 pCBAcc->setCBIfFn((Fn_MemAcc_CB)p_cb_func, p_context);
 
-            err = m_default_mapper->AddAccessor(p_accessor,0);
+            err = addAccessorToMapper(p_accessor);
         }
         else
             err = OCSD_ERR_MEM;    // wrong type of object - treat as mem error
@@ -458,6 +881,7 @@ ocsd_err_t DecodeTree::removeMemAccByAddress(const ocsd_vaddr_t address, const o
 {
     if(!hasMemAccMapper())
         return OCSD_ERR_NOT_INIT;
+    memImageChanged();
     return m_default_mapper->RemoveAccessorByAddress(address,mem_space,0);
 }
 
@@ -512,24 +936,42 @@ ocsd_err_t DecodeTree::createDecoder(const std::string &decoderName, const int c
             err = OCSD_OK;
 
         if(m_i_mem_access && (err == OCSD_OK))
-            err = pDecoderMngr->attachMemAccessor(pTraceComp,m_i_mem_access);
+            err = pDecoderMngr->attachMemAccessor(pTraceComp,getDcdMemAccessI());
 
         if(err == OCSD_ERR_DCD_INTERFACE_UNUSED)    // ignore if mem accessor refused
             err = OCSD_OK;
 
-        if( m_i_gen_elem_out && (err == OCSD_OK))
-            err = pDecoderMngr->attachOutputSink(pTraceComp,m_i_gen_elem_out);
+        if(m_instr_blk_cache.enabled() && (err == OCSD_OK))
+            attachInstrBlockCache(pTraceComp);
+
+        if(err == OCSD_OK)
+        {
+            TrcPktDecodeI *pDcdI = dynamic_cast<TrcPktDecodeI *>(pTraceComp);
+            if(pDcdI)
+                pDcdI->setElemOutMask(m_elem_out_mask);
+        }
+
+        // profile shard for the new ID
+        if(m_afdo_sink && m_afdo_sink->isActive() && (err == OCSD_OK))
+            err = m_afdo_sink->addShard(CSID);
+
+        if(getIDGenElemOutI(CSID) && (err == OCSD_OK))
+            err = pDecoderMngr->attachOutputSink(pTraceComp,getIDGenElemOutI(CSID));
     }
 
+    // index sync points for the new ID
+    if(m_sync_indexer && m_sync_indexer->isActive() && (err == OCSD_OK))
+        err = m_sync_indexer->attachToDecoder(this, CSID);
+
     // finally attach the packet processor input to the demux output channel
     if(err == OCSD_OK)
     {
         ITrcDataIn *pDataIn = 0;
         if((err = pDecoderMngr->getDataInputI(pTraceComp,&pDataIn)) == OCSD_OK)
         {
-            // got the interface -> attach to demux, or direct to input of decode tree
+            // got the interface -> attach to demux (via decode thread if threaded), or direct to input of decode tree
             if(usingFormatter())
-                err = m_frame_deformatter_root->getIDStreamAttachPt(CSID)->attach(pDataIn);
+                err = attachIDStream(CSID);
             else
                 m_i_decoder_root = pDataIn;
         }
@@ -564,6 +1006,7 @@ ocsd_err_t DecodeTree::getDecoderStats(const uint8_t CSID, ocsd_decode_stats_t *
     TrcPktProcI *pPktProc = getPktProcI(CSID);
     if (!pPktProc)
         return OCSD_ERR_INVALID_PARAM_VAL;
+    waitIDThreadsIdle();
     err = pPktProc->getStatsBlock(p_stats_block);
     if (err == OCSD_OK) {
         // copy in the global demux stats.
@@ -581,6 +1024,7 @@ ocsd_err_t DecodeTree::resetDecoderStats(const uint8_t CSID)
     TrcPktProcI *pPktProc = getPktProcI(CSID);
     if (!pPktProc)
         return OCSD_ERR_INVALID_PARAM_VAL;
+    waitIDThreadsIdle();
     pPktProc->resetStats();
 
     // reset the global demux stats.
@@ -712,6 +1156,8 @@ void DecodeTree::destroyDecodeElement(const uint8_t CSID)
     {
         if(m_decode_elements[CSID] != 0)
         {
+            destroyIDThread(CSID);
+            destroyIDChunker(CSID);
             m_decode_elements[CSID]->DestroyElem();
             delete m_decode_elements[CSID];
             m_decode_elements[CSID] = 0;
@@ -741,6 +1187,188 @@ ocsd_err_t DecodeTree::clearIDFilter()
     return err;
 }
 
+ocsd_err_t DecodeTree::setSyncIndexing(const bool enable)
+{
+    ocsd_err_t err = OCSD_OK;
+
+    // packet monitors may be called from decode threads.
+    waitIDThreadsIdle();
+
+    if (!enable)
+    {
+        if (m_sync_indexer)
+            m_sync_indexer->setActive(false);
+        return OCSD_OK;
+    }
+
+    // index entries must be exact byte indexes.
+    if (usingIDRuns())
+        return OCSD_ERR_INVALID_PARAM_VAL;
+
+    if (!m_sync_indexer)
+    {
+        m_sync_indexer = new (std::nothrow) TrcSyncIndexer();
+        if (!m_sync_indexer)
+            return OCSD_ERR_MEM;
+    }
+
+    // (re)attach to all components in the tree.
+    err = m_sync_indexer->attachToTree(this);
+    m_sync_indexer->setActive(err == OCSD_OK);
+    return err;
+}
+
+ocsd_err_t DecodeTree::loadSyncIndex(const std::string &filename)
+{
+    if (usingIDRuns())
+        return OCSD_ERR_INVALID_PARAM_VAL;
+
+    waitIDThreadsIdle();
+
+    // loaded index used for seek only until indexing enabled.
+    if (!m_sync_indexer)
+    {
+        m_sync_indexer = new (std::nothrow) TrcSyncIndexer();
+        if (!m_sync_indexer)
+            return OCSD_ERR_MEM;
+        m_sync_indexer->setActive(false);
+    }
+    return m_sync_indexer->loadIndex(filename);
+}
+
+ocsd_err_t DecodeTree::seekToIndex(const ocsd_trc_index_t target_index, ocsd_trc_index_t &restart_index, const uint8_t CSID /* = OCSD_BAD_CS_SRC_ID */)
+{
+    ocsd_sync_idx_entry_t entry;
+
+    if (usingIDRuns())
+        return OCSD_ERR_INVALID_PARAM_VAL;
+
+    if (m_sync_indexer && m_sync_indexer->findSeekEntry(target_index, false, CSID, entry))
+        return seekRestart(entry.restart_index, entry.trc_id, restart_index);
+
+    // no sync point known - restart at the frame containing the target and resync from there.
+    if (usingFormatter() && (m_frame_deformatter_root->getConfigFlags() & OCSD_DFRMTR_FRAME_MEM_ALIGN))
+        return seekRestart(target_index & ~((ocsd_trc_index_t)OCSD_DFRMTR_FRAME_SIZE - 1), OCSD_BAD_CS_SRC_ID, restart_index);
+    return seekRestart(target_index, OCSD_BAD_CS_SRC_ID, restart_index);
+}
+
+ocsd_err_t DecodeTree::seekToTimestamp(const uint64_t timestamp, ocsd_trc_index_t &restart_index, const uint8_t CSID /* = OCSD_BAD_CS_SRC_ID */)
+{
+    ocsd_sync_idx_entry_t entry;
+
+    if (!m_sync_indexer)
+        return OCSD_ERR_NOT_INIT;
+
+    if (usingIDRuns())
+        return OCSD_ERR_INVALID_PARAM_VAL;
+
+    if (m_sync_indexer->findSeekEntry(timestamp, true, CSID, entry))
+        return seekRestart(entry.restart_index, entry.trc_id, restart_index);
+    return seekRestart(0, OCSD_BAD_CS_SRC_ID, restart_index);
+}
+
+const bool DecodeTree::usingIDRuns() const
+{
+    return usingFormatter() && ((m_frame_deformatter_root->getConfigFlags() & OCSD_DFRMTR_ID_RUNS) != 0);
+}
+
+ocsd_err_t DecodeTree::seekRestart(const ocsd_trc_index_t index, const uint8_t restart_ID, ocsd_trc_index_t &restart_index)
+{
+    if (!m_i_decoder_root)
+        return OCSD_ERR_NOT_INIT;
+
+    // drop all current decode state - completes any queued threaded decode.
+    if (OCSD_DATA_RESP_IS_FATAL(TraceDataIn(OCSD_OP_RESET, index, 0, 0, 0)))
+        return OCSD_ERR_DATA_DECODE_FATAL;
+
+    if (usingFormatter() && OCSD_IS_VALID_CS_SRC_ID(restart_ID))
+        m_frame_deformatter_root->SetRestartID(restart_ID);
+
+    restart_index = index;
+    return OCSD_OK;
+}
+
+ocsd_err_t DecodeTree::setRingBufferInput(const uint8_t *p_buffer, const uint64_t buffer_size, const volatile uint64_t *p_head, volatile uint64_t *p_tail)
+{
+    uint32_t align = 1;
+
+    if (!m_i_decoder_root)
+        return OCSD_ERR_NOT_INIT;
+
+    // formatted input is passed to the deformatter in whole frames, or pairs of bytes with sync patterns.
+    if (usingFormatter())
+        align = (m_frame_deformatter_root->getConfigFlags() & OCSD_DFRMTR_FRAME_MEM_ALIGN) ? OCSD_DFRMTR_FRAME_SIZE : 4;
+
+    if (!m_ring_buf_in)
+    {
+        m_ring_buf_in = new (std::nothrow) TrcRingBufferIn();
+        if (!m_ring_buf_in)
+            return OCSD_ERR_MEM;
+    }
+    return m_ring_buf_in->init(this, p_buffer, buffer_size, p_head, p_tail, align);
+}
+
+ocsd_datapath_resp_t DecodeTree::processRingBuffer()
+{
+    if (!m_ring_buf_in)
+        return OCSD_RESP_FATAL_NOT_INIT;
+    return m_ring_buf_in->processData();
+}
+
+ocsd_err_t DecodeTree::setAutoFdoProfiling(const bool enable)
+{
+    ocsd_err_t err = OCSD_OK;
+    uint8_t elemID;
+    DecodeTreeElement *pElem = 0;
+
+    // shards are updated from decode threads.
+    waitIDThreadsIdle();
+
+    if (enable)
+    {
+        if (!m_afdo_sink)
+        {
+            m_afdo_sink = new (std::nothrow) TrcAfdoSink();
+            if (!m_afdo_sink)
+                return OCSD_ERR_MEM;
+        }
+
+        pElem = getFirstElement(elemID);
+        while ((pElem != 0) && (err == OCSD_OK))
+        {
+            err = m_afdo_sink->addShard(elemID);
+            pElem = getNextElement(elemID);
+        }
+    }
+
+    if (m_afdo_sink)
+    {
+        // reconnect the decoders to the shards, or to the element outputs.
+        m_afdo_sink->setActive(enable && (err == OCSD_OK));
+        setGenTraceElemOutI(m_i_gen_elem_out);
+    }
+    return err;
+}
+
+ocsd_err_t DecodeTree::setAutoFdoContextFilter(const ocsd_mem_acc_ctxt_t *p_filter)
+{
+    if (!m_afdo_sink)
+        return OCSD_ERR_NOT_INIT;
+
+    waitIDThreadsIdle();
+    return m_afdo_sink->setContextFilter(p_filter);
+}
+
+ocsd_err_t DecodeTree::saveAutoFdoProfile(const std::string &filename)
+{
+    if (!m_afdo_sink)
+        return OCSD_ERR_NOT_INIT;
+
+    // shards merged once the decode threads have completed.
+    waitIDThreadsIdle();
+    return m_afdo_sink->saveTextProfile(filename);
+}
+
 /** add a protocol packet printer */
 ocsd_err_t DecodeTree::addPacketPrinter(uint8_t CSID, bool bMonitor, ItemPrinter **ppPrinter)
 {
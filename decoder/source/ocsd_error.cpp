@@ -98,6 +98,10 @@ static const char *s_errorCodeDescs[][2] = {
     {"OCSD_ERR_INVALID_OPCODE","Illegal Opode found while decoding program memory."},
     {"OCSD_ERR_I_RANGE_LIMIT_OVERRUN","An optional limit on consecutive instructions in range during decode has been exceeded."},
     {"OCSD_ERR_BAD_DECODE_IMAGE","Mismatch between trace packets and decode image."},
+    /* trace indexing */
+    {"OCSD_ERR_SYNC_IDX_FILE","Sync index file could not be opened, or is not a valid sync index."},
+    /* profile output */
+    {"OCSD_ERR_PROFILE_FILE","Profile output file could not be opened or written."},
     /* end marker*/
     {"OCSD_ERR_LAST", "No error - error code end marker"}
 };
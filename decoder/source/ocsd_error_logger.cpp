@@ -102,6 +102,8 @@ void ocsdDefaultErrorLogger::LogError(const ocsd_hndl_err_log_t handle, const oc
     // only log errors that match or exceed the current verbosity
     if(m_Verbosity >= Error->getErrorSeverity())
     {
+        std::lock_guard<std::mutex> lock(m_log_mutex);
+
         // print out only if required
         if(m_output_logger)
         {
@@ -137,6 +139,8 @@ void ocsdDefaultErrorLogger::LogMessage(const ocsd_hndl_err_log_t handle, const
     // only log errors that match or exceed the current verbosity
     if((m_Verbosity >= filter_level))
     {
+        std::lock_guard<std::mutex> lock(m_log_mutex);
+
         if(m_output_logger)
         {
             if(m_output_logger->isLogging())
@@ -43,6 +43,7 @@ OcsdGenElemList::OcsdGenElemList()
 
     m_elemArraySize = 0;
     m_sendIf = 0;
+    m_pElemOutMask = 0;
     m_CSID = 0;
     m_pElemArray = 0;
 }
@@ -91,6 +92,14 @@ const ocsd_gen_trc_elem_t OcsdGenElemList::getElemType(const int entryN) const
     return elem_type;
 }
 
+OcsdTraceElement *OcsdGenElemList::getElem(const int entryN) const
+{
+    OcsdTraceElement *pElem = 0;
+    if(entryN < getNumElem())
+        pElem = m_pElemArray[getAdjustedIdx(m_firstElemIdx + entryN)].pElem;
+    return pElem;
+}
+
 ocsd_datapath_resp_t OcsdGenElemList::sendElements()
 {
     ocsd_datapath_resp_t resp = OCSD_RESP_CONT;
@@ -103,7 +112,9 @@ ocsd_datapath_resp_t OcsdGenElemList::sendElements()
 
     while(elemToSend() && OCSD_DATA_RESP_IS_CONT(resp))
     {
-        resp = m_sendIf->first()->TraceElemIn(m_pElemArray[m_firstElemIdx].trc_pkt_idx, m_CSID, *(m_pElemArray[m_firstElemIdx].pElem));
+        const OcsdTraceElement *pElem = m_pElemArray[m_firstElemIdx].pElem;
+        if(!m_pElemOutMask || (*m_pElemOutMask & OCSD_GEN_TRC_ELEM_MASK(pElem->getType())))
+            resp = m_sendIf->first()->TraceElemIn(m_pElemArray[m_firstElemIdx].trc_pkt_idx, m_CSID, *pElem);
         m_firstElemIdx++;
         if(m_firstElemIdx >= m_elemArraySize)
             m_firstElemIdx = 0;
@@ -43,6 +43,7 @@ OcsdGenElemStack::OcsdGenElemStack() :
     m_send_elem_idx(0),
     m_CSID(0),
     m_sendIf(NULL),
+    m_pElemOutMask(NULL),
     m_is_init(false)
 {
 
@@ -126,7 +127,9 @@ ocsd_datapath_resp_t OcsdGenElemStack::sendElements()
 
     while (m_elem_to_send && OCSD_DATA_RESP_IS_CONT(resp))
     {
-        resp = m_sendIf->first()->TraceElemIn(m_pElemArray[m_send_elem_idx].trc_pkt_idx, m_CSID, *(m_pElemArray[m_send_elem_idx].pElem));
+        const OcsdTraceElement *pElem = m_pElemArray[m_send_elem_idx].pElem;
+        if (!m_pElemOutMask || (*m_pElemOutMask & OCSD_GEN_TRC_ELEM_MASK(pElem->getType())))
+            resp = m_sendIf->first()->TraceElemIn(m_pElemArray[m_send_elem_idx].trc_pkt_idx, m_CSID, *pElem);
         m_send_elem_idx++;
         m_elem_to_send--;
     }
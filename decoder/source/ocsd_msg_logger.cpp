@@ -83,6 +83,8 @@ void ocsdMsgLogger::setStrOutFn(ocsdMsgLogStrOutI *p_IstrOut)
 
 void ocsdMsgLogger::LogMsg(const std::string &msg)
 {
+    std::lock_guard<std::mutex> lock(m_log_mutex);
+
     if(m_outFlags & OUT_STDOUT)
     {
         std::cout << msg;
@@ -197,6 +197,7 @@ void TrcPktDecodePtm::initDecoder()
     m_instr_info.pe_type.arch = ARCH_UNKNOWN;
     m_instr_info.dsb_dmb_waypoints = 0;
     m_unsync_info = UNSYNC_INIT_DECODER;
+    m_p_mem_acc_ctxt = &m_pe_context;
     resetDecoder();
 }
 
@@ -258,6 +259,8 @@ ocsd_datapath_resp_t TrcPktDecodePtm::decodePacket()
         break;
 
     case PTM_PKT_TRIGGER:
+        if(!isElemOut(OCSD_GEN_TRC_ELEM_EVENT))
+            break;
         m_output_elem.setType(OCSD_GEN_TRC_ELEM_EVENT);
         m_output_elem.setEvent(EVENT_TRIGGER, 0);
         resp = outputTraceElement(m_output_elem);
@@ -310,9 +313,11 @@ ocsd_datapath_resp_t TrcPktDecodePtm::decodePacket()
         break;
 
     case PTM_PKT_TIMESTAMP:
+        if(!isElemOut(OCSD_GEN_TRC_ELEM_TIMESTAMP))
+            break;
         m_output_elem.setType(OCSD_GEN_TRC_ELEM_TIMESTAMP);
         m_output_elem.timestamp = m_curr_packet_in->timestamp;
-        if(m_curr_packet_in->cc_valid)
+        if(m_curr_packet_in->cc_valid && isElemOut(OCSD_GEN_TRC_ELEM_CYCLE_COUNT))
             m_output_elem.setCycleCount(m_curr_packet_in->cycle_count);
         resp = outputTraceElement(m_output_elem);
         break;
@@ -361,7 +366,7 @@ ocsd_datapath_resp_t TrcPktDecodePtm::processIsync()
                 m_output_elem.trace_on_reason = TRACE_ON_OVERFLOW;
             else if(m_curr_packet_in->iSyncReason() == iSync_DebugExit)
                 m_output_elem.trace_on_reason = TRACE_ON_EX_DEBUG;
-            if(m_curr_packet_in->hasCC())
+            if(m_curr_packet_in->hasCC() && isElemOut(OCSD_GEN_TRC_ELEM_CYCLE_COUNT))
                 m_output_elem.setCycleCount(m_curr_packet_in->getCCVal());
             resp = outputTraceElement(m_output_elem);           
         }
@@ -412,7 +417,7 @@ ocsd_datapath_resp_t TrcPktDecodePtm::processBranch()
                 m_output_elem.en_addr = m_curr_pe_state.instr_addr;
             }
             // could be an associated cycle count
-            if(m_curr_packet_in->hasCC())
+            if(m_curr_packet_in->hasCC() && isElemOut(OCSD_GEN_TRC_ELEM_CYCLE_COUNT))
                 m_output_elem.setCycleCount(m_curr_packet_in->getCCVal());
 
             // output the element
@@ -590,7 +595,7 @@ ocsd_datapath_resp_t TrcPktDecodePtm::processAtomRange(const ocsd_atm_val A, con
         
         m_output_elem.setLastInstrInfo((A == ATOM_E),m_instr_info.type, m_instr_info.sub_type,m_instr_info.instr_size);
         m_output_elem.setISA(m_curr_pe_state.isa);
-        if(m_curr_packet_in->hasCC())
+        if(m_curr_packet_in->hasCC() && isElemOut(OCSD_GEN_TRC_ELEM_CYCLE_COUNT))
             m_output_elem.setCycleCount(m_curr_packet_in->getCCVal());
         m_output_elem.setLastInstrCond(m_instr_info.is_conditional);
         resp = outputTraceElementIdx(m_index_curr_pkt,m_output_elem);
@@ -624,6 +629,13 @@ ocsd_err_t TrcPktDecodePtm::traceInstrToWP(bool &bWPFound, const waypoint_trace_
 
     ocsd_mem_space_acc_t mem_space = (m_pe_context.security_level == ocsd_sec_secure) ? OCSD_MEM_SPACE_S : OCSD_MEM_SPACE_N;
 
+    // blocks walked to a waypoint are saved in the instruction block cache, for the current context.
+    TrcInstrBlockCache *pBlkCache = m_instr_blk_cache.first();
+    const uint32_t ctxt_id = m_pe_context.ctxt_id_valid ? m_pe_context.context_id : 0;
+    const uint32_t vmid = m_pe_context.vmid_valid ? m_pe_context.vmid : 0;
+    ocsd_vaddr_t blkStAddr = m_instr_info.instr_addr;
+    uint32_t blkNumInstr = 0;
+
     m_output_elem.st_addr = m_output_elem.en_addr = m_instr_info.instr_addr;
     m_output_elem.num_instr_range = 0;
 
@@ -631,6 +643,66 @@ ocsd_err_t TrcPktDecodePtm::traceInstrToWP(bool &bWPFound, const waypoint_trace_
 
     while(!bWPFound && !m_mem_nacc_pending)
     {
+        // at a block start - use a cached block unless the address to match is within it.
+        if(pBlkCache && !blkNumInstr)
+        {
+            ocsd_instr_info blkInfo = m_instr_info;
+            uint32_t numInstr = 0;
+
+            if(pBlkCache->findBlock(m_CSID, mem_space, ctxt_id, vmid, &blkInfo, &numInstr))
+            {
+                bool bMatchInBlk = false;
+                if(traceWPOp == TRACE_TO_ADDR_EXCL)
+                    bMatchInBlk = (nextAddrMatch > blkStAddr) && (nextAddrMatch < blkInfo.instr_addr);
+                else if(traceWPOp == TRACE_TO_ADDR_INCL)
+                    bMatchInBlk = (nextAddrMatch >= blkStAddr) && (nextAddrMatch < blkInfo.instr_addr);
+
+                if(!bMatchInBlk)
+                {
+                    m_instr_info = blkInfo;
+                    m_output_elem.en_addr = m_instr_info.instr_addr;
+                    m_output_elem.num_instr_range += numInstr;
+                    m_output_elem.last_i_type = m_instr_info.type;
+
+                    if(traceWPOp == TRACE_WAYPOINT)
+                        bWPFound = true;
+                    else if(traceWPOp == TRACE_TO_ADDR_EXCL)
+                        bWPFound = (m_output_elem.en_addr == nextAddrMatch);
+                    blkStAddr = m_instr_info.instr_addr;
+                    continue;
+                }
+            }
+        }
+
+        // walking to a waypoint - decode a block of opcodes in place if memory is directly accessible.
+        if(traceWPOp == TRACE_WAYPOINT)
+        {
+            const uint8_t *p_opcodes;
+            uint32_t num_blk_instr = 0;
+
+            bytesReq = 4;
+            p_opcodes = accessMemoryPtr(m_instr_info.instr_addr,mem_space,&bytesReq);
+            if(p_opcodes)
+            {
+                err = instrDecodeBlock(&m_instr_info,p_opcodes,bytesReq,0xFFFFFFFF,&num_blk_instr);
+                m_output_elem.num_instr_range += num_blk_instr;
+                if(err != OCSD_OK) break;
+            }
+
+            if(num_blk_instr)
+            {
+                // block decode leaves last instruction address - increment as single decode.
+                m_instr_info.instr_addr += m_instr_info.instr_size;
+                m_output_elem.en_addr = m_instr_info.instr_addr;
+                m_output_elem.last_i_type = m_instr_info.type;
+                bWPFound = (m_instr_info.type != OCSD_INSTR_OTHER);
+                blkNumInstr += num_blk_instr;
+                if(pBlkCache && bWPFound)
+                    pBlkCache->addBlock(m_CSID, mem_space, ctxt_id, vmid, blkStAddr, &m_instr_info, blkNumInstr);
+                continue;
+            }
+        }
+
         // start off by reading next opcode;
         bytesReq = 4;
         curr_op_address = m_instr_info.instr_addr;  // save the start address for the current opcode
@@ -661,6 +733,16 @@ ocsd_err_t TrcPktDecodePtm::traceInstrToWP(bool &bWPFound, const waypoint_trace_
             }
             else
                 bWPFound = (m_instr_info.type != OCSD_INSTR_OTHER);
+
+            // walked to a waypoint - save the block and start the next one.
+            blkNumInstr++;
+            if(m_instr_info.type != OCSD_INSTR_OTHER)
+            {
+                if(pBlkCache)
+                    pBlkCache->addBlock(m_CSID, mem_space, ctxt_id, vmid, blkStAddr, &m_instr_info, blkNumInstr);
+                blkStAddr = m_instr_info.instr_addr;
+                blkNumInstr = 0;
+            }
         }
         else
         {
@@ -35,6 +35,7 @@
 #include "opencsd/ptm/trc_pkt_proc_ptm.h"
 #include "opencsd/ptm/trc_cmp_cfg_ptm.h"
 #include "common/ocsd_error.h"
+#include "common/trc_sync_scan.h"
 
 
 #ifdef __GNUC__
@@ -124,13 +125,17 @@ ocsd_datapath_resp_t TrcPktProcPtm::processData(  const ocsd_trc_index_t index,
                 {
                     // sequencing error - should not get to the point where readByte
                     // fails and m_DataInProcessed  < dataBlockSize
-                    // throw data overflow error
-                    throw ocsdError(OCSD_ERR_SEV_ERROR,OCSD_ERR_PKT_INTERP_FAIL,m_curr_pkt_index,this->m_chanIDCopy,"Data Buffer Overrun");
+                    // data overflow error
+                    setPktError(OCSD_ERR_PKT_INTERP_FAIL,m_curr_pkt_index,this->m_chanIDCopy,"Data Buffer Overrun");
+                    resp = processPktError();
+                    break;
                 }
                 m_process_state = PROC_DATA;
 
             case PROC_DATA:
-                (this->*m_pIPktFn)();                
+                (this->*m_pIPktFn)();
+                if(pktErrorSet())
+                    resp = processPktError();
                 break;
 
             case SEND_PKT:
@@ -140,21 +145,6 @@ ocsd_datapath_resp_t TrcPktProcPtm::processData(  const ocsd_trc_index_t index,
                 break;
             }
         }
-        catch(ocsdError &err)
-        {
-            LogError(err);
-            if( (err.getErrorCode() == OCSD_ERR_BAD_PACKET_SEQ) ||
-                (err.getErrorCode() == OCSD_ERR_INVALID_PCKT_HDR))
-            {
-                // send invalid packets up the pipe to let the next stage decide what to do.
-                m_process_state = SEND_PKT; 
-            }
-            else
-            {
-                // bail out on any other error.
-                resp = OCSD_RESP_FATAL_INVALID_DATA;
-            }
-        }
         catch(...)
         {
             /// vv bad at this point.
@@ -168,6 +158,20 @@ ocsd_datapath_resp_t TrcPktProcPtm::processData(  const ocsd_trc_index_t index,
     return resp;
 }
 
+ocsd_datapath_resp_t TrcPktProcPtm::processPktError()
+{
+    ocsd_err_t err = logPktError();
+    if( (err == OCSD_ERR_BAD_PACKET_SEQ) ||
+        (err == OCSD_ERR_INVALID_PCKT_HDR))
+    {
+        // send invalid packets up the pipe to let the next stage decide what to do.
+        m_process_state = SEND_PKT; 
+        return OCSD_RESP_CONT;
+    }
+    // bail out on any other error.
+    return OCSD_RESP_FATAL_INVALID_DATA;
+}
+
 ocsd_datapath_resp_t TrcPktProcPtm::onEOT()
 {
     ocsd_datapath_resp_t err = OCSD_RESP_FATAL_NOT_INIT;
@@ -258,6 +262,15 @@ ocsd_datapath_resp_t TrcPktProcPtm::outputPacket()
 }
 
 /*** sync and packet functions ***/
+
+// count the unsynced bytes removed from the packet buffer that were carried in from the previous input buffer.
+static int carriedBytes(int &carried_remaining, const int removed)
+{
+    int carried = (carried_remaining < removed) ? carried_remaining : removed;
+    carried_remaining -= carried;
+    return carried;
+}
+
 ocsd_datapath_resp_t TrcPktProcPtm::waitASync()
 {
     ocsd_datapath_resp_t resp = OCSD_RESP_CONT;
@@ -278,8 +291,9 @@ ocsd_datapath_resp_t TrcPktProcPtm::waitASync()
     bool bSendUnsyncedData = false;
     bool bHaveASync = false;
     int unsynced_bytes = 0;
-    int unsync_scan_block_start = 0;
+    int unsync_scan_block_start = m_dataInProcessed;
     int pktBytesOnEntry = m_currPacketData.size();  // did we have part of a potential async last time?
+    int unsyncedOnEntry = 0;    // unsynced bytes from the previous input buffer - not in the raw buffer
 
     while(doScan && OCSD_DATA_RESP_IS_CONT(resp))
     {
@@ -300,12 +314,14 @@ ocsd_datapath_resp_t TrcPktProcPtm::waitASync()
             case THROW_0:
                 // remove a bunch of 0s 
                 unsynced_bytes += ASYNC_PAD_0_LIMIT;
+                unsyncedOnEntry += carriedBytes(pktBytesOnEntry, ASYNC_PAD_0_LIMIT);
                 m_waitASyncSOPkt = false;
                 m_currPacketData.erase( m_currPacketData.begin(), m_currPacketData.begin()+ASYNC_PAD_0_LIMIT);                
                 break;
 
             case NOT_ASYNC:
                 unsynced_bytes += m_currPacketData.size();
+                unsyncedOnEntry += carriedBytes(pktBytesOnEntry, (int)m_currPacketData.size());
                 m_waitASyncSOPkt = false;
                 m_currPacketData.clear();
                 break;
@@ -318,7 +334,18 @@ ocsd_datapath_resp_t TrcPktProcPtm::waitASync()
         }
         else 
         {
-            if(m_pDataIn[m_dataInProcessed++] == 0x00)
+            // skip bytes that cannot start an async - limited to the unsynced packet size for a raw monitor.
+            uint32_t scan_max = m_dataInLen - m_dataInProcessed;
+            if(m_bAsyncRawOp && (scan_max > (uint32_t)(UNSYNC_PKT_MAX - unsynced_bytes)))
+                scan_max = UNSYNC_PKT_MAX - unsynced_bytes;
+            uint32_t skip_bytes = TrcSyncScan::findByte(m_pDataIn + m_dataInProcessed, scan_max, 0x00);
+
+            if(skip_bytes)
+            {
+                m_dataInProcessed += skip_bytes;
+                unsynced_bytes += skip_bytes;
+            }
+            else if(m_pDataIn[m_dataInProcessed++] == 0x00)
             {
                 m_waitASyncSOPkt = true;
                 m_currPacketData.push_back(0); 
@@ -348,12 +375,15 @@ ocsd_datapath_resp_t TrcPktProcPtm::waitASync()
             {
                 // there were some 0's in the packet buyffer from the last pass that are no longer in the raw buffer,
                 // and these turned out not to be an async
-                if(pktBytesOnEntry)
+                if(unsyncedOnEntry)
                 {
-                    outputRawPacketToMonitor(m_curr_pkt_index,&m_curr_packet,pktBytesOnEntry,spare_zeros);
-                    m_curr_pkt_index += pktBytesOnEntry;
+                    outputRawPacketToMonitor(m_curr_pkt_index,&m_curr_packet,unsyncedOnEntry,spare_zeros);
+                    m_curr_pkt_index += unsyncedOnEntry;
+                    unsynced_bytes -= unsyncedOnEntry;
+                    unsyncedOnEntry = 0;
                 }
-                outputRawPacketToMonitor(m_curr_pkt_index,&m_curr_packet,unsynced_bytes,m_pDataIn+unsync_scan_block_start);
+                if(unsynced_bytes)
+                    outputRawPacketToMonitor(m_curr_pkt_index,&m_curr_packet,unsynced_bytes,m_pDataIn+unsync_scan_block_start);
             }
             if (!m_bOPNotSyncPkt)
             {
@@ -390,7 +420,7 @@ void TrcPktProcPtm::pktASync()
 
     case THROW_0:
     case NOT_ASYNC:
-        throwMalformedPacketErr("Bad Async packet");
+        setMalformedPacketErr("Bad Async packet");
         break;
 
     case ASYNC_INCOMPLETE:
@@ -527,6 +557,8 @@ void TrcPktProcPtm::pktISync()
         if(m_needCycleCount)
         {
             extractCycleCount(optIdx,cycleCount);
+            if(pktErrorSet())
+                return;
             m_curr_packet.SetCycleCount(cycleCount);
             optIdx+=m_gotCCBytes;
         }
@@ -534,6 +566,8 @@ void TrcPktProcPtm::pktISync()
         if(m_numCtxtIDBytes)
         {
             extractCtxtID(optIdx,ctxtID);
+            if(pktErrorSet())
+                return;
             m_curr_packet.UpdateContextID(ctxtID);
         }
         m_process_state = SEND_PKT;
@@ -671,6 +705,8 @@ void TrcPktProcPtm::pktCtxtID()
         if(m_numCtxtIDBytes)
         {
             extractCtxtID(1,ctxtID);
+            if(pktErrorSet())
+                return;
         }
         m_curr_packet.UpdateContextID(ctxtID);
         m_process_state = SEND_PKT;
@@ -728,6 +764,8 @@ void TrcPktProcPtm::pktAtom()
         {
             uint32_t cycleCount = 0;
             extractCycleCount(0,cycleCount);
+            if(pktErrorSet())
+                return;
             m_curr_packet.SetCycleCount(cycleCount);
             m_curr_packet.SetCycleAccAtomFromPHdr(pHdr);
             m_process_state = SEND_PKT;
@@ -787,9 +825,13 @@ void TrcPktProcPtm::pktTimeStamp()
         uint32_t cycleCount = 0;
         uint8_t tsUpdateBits = 0;
         int ts_end_idx = extractTS(tsVal,tsUpdateBits);
+        if(pktErrorSet())
+            return;
         if(m_needCycleCount)
         {
             extractCycleCount(ts_end_idx,cycleCount);
+            if(pktErrorSet())
+                return;
             m_curr_packet.SetCycleCount(cycleCount);
         }
         m_curr_packet.UpdateTimestamp(tsVal,tsUpdateBits); 
@@ -902,8 +944,11 @@ void TrcPktProcPtm::pktBranchAddr()
                 m_gotCCBytes++;
             }
             else
+            {
                 // this should never be reached.
-                throwMalformedPacketErr("sequencing error analysing branch packet");
+                setMalformedPacketErr("sequencing error analysing branch packet");
+                return;
+            }
         }
         else
             bBytesAvail = false;
@@ -964,6 +1009,8 @@ void TrcPktProcPtm::pktBranchAddr()
             int countIdx = m_numAddrBytes + m_numExcepBytes;
             uint32_t cycleCount = 0;
             extractCycleCount(countIdx,cycleCount);
+            if(pktErrorSet())
+                return;
             m_curr_packet.SetCycleCount(cycleCount);
         }
         m_process_state = SEND_PKT;
@@ -982,7 +1029,10 @@ void TrcPktProcPtm::extractCtxtID(int idx, uint32_t &ctxtID)
     for(int i=0; i < m_numCtxtIDBytes; i++)
     {
         if((size_t)idx+i >= m_currPacketData.size())
-            throwMalformedPacketErr("Insufficient packet bytes for Context ID value.");
+        {
+            setMalformedPacketErr("Insufficient packet bytes for Context ID value.");
+            return;
+        }
         ctxtID |= ((uint32_t)m_currPacketData[idx+i]) << shift;
         shift+=8;
     }
@@ -999,7 +1049,10 @@ void TrcPktProcPtm::extractCycleCount(int offset, uint32_t &cycleCount)
     while(bCont)
     {
         if((size_t)by_idx+offset >= m_currPacketData.size())
-            throwMalformedPacketErr("Insufficient packet bytes for Cycle Count value.");
+        {
+            setMalformedPacketErr("Insufficient packet bytes for Cycle Count value.");
+            return;
+        }
 
         currByte = m_currPacketData[offset+by_idx];
         if(by_idx == 0)
@@ -1034,7 +1087,10 @@ int TrcPktProcPtm::extractTS(uint64_t &tsVal,uint8_t &tsUpdateBits)
     while(bCont)
     {
         if((size_t)tsIdx >= m_currPacketData.size())
-            throwMalformedPacketErr("Insufficient packet bytes for Timestamp value.");
+        {
+            setMalformedPacketErr("Insufficient packet bytes for Timestamp value.");
+            return tsIdx;
+        }
         
         byteVal = m_currPacketData[tsIdx];
        
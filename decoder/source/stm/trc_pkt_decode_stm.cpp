@@ -243,7 +243,7 @@ ocsd_datapath_resp_t TrcPktDecodeStm::decodePacket(bool &bPktDone)
 
     }
 
-    if(bSendPacket)
+    if(bSendPacket && isElemOut(OCSD_GEN_TRC_ELEM_SWTRACE))
     {
         if(m_curr_packet_in->isTSPkt())
         {
@@ -264,6 +264,10 @@ void TrcPktDecodeStm::clearSWTPerPcktInfo()
 
 void TrcPktDecodeStm::updatePayload(bool &bSendPacket)
 {
+    // no payload copy if not output
+    if(!isElemOut(OCSD_GEN_TRC_ELEM_SWTRACE))
+        return;
+
     // without buffering similar packets - this function is quite simple
     bSendPacket = true;
     m_swt_packet_info.swt_payload_num_packets = 1;
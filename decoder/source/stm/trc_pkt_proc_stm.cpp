@@ -33,6 +33,7 @@
  */ 
 
 #include "opencsd/stm/trc_pkt_proc_stm.h"
+#include "common/trc_sync_scan.h"
 
 
 // processor object construction
@@ -106,6 +107,12 @@ ocsd_datapath_resp_t TrcPktProcStm::processData(  const ocsd_trc_index_t index,
             case PROC_DATA:
                 (this->*m_pCurrPktFn)();
 
+                if(pktErrorSet())
+                {
+                    resp = processPktError();
+                    break;
+                }
+
                 // if we have enough to send, fall through, otherwise stop
                 if(m_proc_state != SEND_PKT)
                     break;
@@ -115,24 +122,6 @@ ocsd_datapath_resp_t TrcPktProcStm::processData(  const ocsd_trc_index_t index,
                 break;
             }
         }
-        catch(ocsdError &err)
-        {
-            LogError(err);
-            if( ((err.getErrorCode() == OCSD_ERR_BAD_PACKET_SEQ) ||
-                 (err.getErrorCode() == OCSD_ERR_INVALID_PCKT_HDR)) &&
-                 !(getComponentOpMode() & OCSD_OPFLG_PKTPROC_ERR_BAD_PKTS))
-            {
-                // send invalid packets up the pipe to let the next stage decide what to do.
-                resp = outputPacket();
-                if(getComponentOpMode() & OCSD_OPFLG_PKTPROC_UNSYNC_ON_BAD_PKTS)
-                    m_proc_state = WAIT_SYNC;
-            }
-            else
-            {
-                // bail out on any other error.
-                resp = OCSD_RESP_FATAL_INVALID_DATA;
-            }
-        }
         catch(...)
         {
             /// vv bad at this point.
@@ -194,16 +183,33 @@ ocsd_datapath_resp_t TrcPktProcStm::outputPacket()
     return resp;
 }
 
-void TrcPktProcStm::throwBadSequenceError(const char *pszMessage /*= ""*/)
+void TrcPktProcStm::setBadSequenceError(const char *pszMessage /*= ""*/)
 {
     m_curr_packet.updateErrType(STM_PKT_BAD_SEQUENCE);
-    throw ocsdError(OCSD_ERR_SEV_ERROR,OCSD_ERR_BAD_PACKET_SEQ,m_packet_index,this->m_config->getTraceID(),pszMessage);
+    setPktError(OCSD_ERR_BAD_PACKET_SEQ,m_packet_index,this->m_config->getTraceID(),pszMessage);
 }
 
-void TrcPktProcStm::throwReservedHdrError(const char *pszMessage /*= ""*/)
+void TrcPktProcStm::setReservedHdrError(const char *pszMessage /*= ""*/)
 {
     m_curr_packet.setPacketType(STM_PKT_RESERVED,false);
-    throw ocsdError(OCSD_ERR_SEV_ERROR,OCSD_ERR_INVALID_PCKT_HDR,m_packet_index,this->m_config->getTraceID(),pszMessage);
+    setPktError(OCSD_ERR_INVALID_PCKT_HDR,m_packet_index,this->m_config->getTraceID(),pszMessage);
+}
+
+ocsd_datapath_resp_t TrcPktProcStm::processPktError()
+{
+    ocsd_err_t err = logPktError();
+    if( ((err == OCSD_ERR_BAD_PACKET_SEQ) ||
+         (err == OCSD_ERR_INVALID_PCKT_HDR)) &&
+         !(getComponentOpMode() & OCSD_OPFLG_PKTPROC_ERR_BAD_PKTS))
+    {
+        // send invalid packets up the pipe to let the next stage decide what to do.
+        ocsd_datapath_resp_t resp = outputPacket();
+        if(getComponentOpMode() & OCSD_OPFLG_PKTPROC_UNSYNC_ON_BAD_PKTS)
+            m_proc_state = WAIT_SYNC;
+        return resp;
+    }
+    // bail out on any other error.
+    return OCSD_RESP_FATAL_INVALID_DATA;
 }
 
 // processor / packet init
@@ -251,6 +257,8 @@ void TrcPktProcStm::waitForSync(const ocsd_trc_index_t blk_st_index)
 
     while(bGotData && !m_is_sync)
     {
+        if(!m_sync_start && !m_nibble_2nd_valid)
+            skipNotSyncBytes();
         bGotData = readNibble();    // read until we have a sync or run out of data
     }
 
@@ -277,8 +285,12 @@ void TrcPktProcStm::waitForSync(const ocsd_trc_index_t blk_st_index)
         if(mon_in_use.usingMonitor())
         {
             uint8_t nibbles_to_send = m_num_nibbles - (m_is_sync ? 22 : m_num_F_nibbles);
-            uint8_t bytes_to_send = (nibbles_to_send / 2) + (nibbles_to_send % 2);
-            for(uint8_t i = 0; i < bytes_to_send; i++)
+            uint32_t bytes_to_send = (nibbles_to_send / 2) + (nibbles_to_send % 2);
+
+            // nibble count includes any F nibbles carried from the previous buffer - only send bytes read from this one.
+            if(bytes_to_send > (m_data_in_used - start_offset))
+                bytes_to_send = m_data_in_used - start_offset;
+            for(uint32_t i = 0; i < bytes_to_send; i++)
                 savePacketByte(m_p_data_in[start_offset+i]);
         }
 
@@ -310,7 +322,7 @@ void TrcPktProcStm::stmPktReserved()
 {
     uint16_t bad_opcode = (uint16_t)m_nibble;    
     m_curr_packet.setD16Payload(bad_opcode);
-    throwReservedHdrError("STM: Unsupported or Reserved STPv2 Header");
+    setReservedHdrError("STM: Unsupported or Reserved STPv2 Header");
 }
 
 void TrcPktProcStm::stmPktNull()
@@ -560,7 +572,7 @@ void TrcPktProcStm::stmPktReservedFn()
     uint16_t bad_opcode = 0x00F;
     bad_opcode |= ((uint16_t)m_nibble) << 4;
     m_curr_packet.setD16Payload(bad_opcode);
-    throwReservedHdrError("STM: Unsupported or Reserved STPv2 Header");
+    setReservedHdrError("STM: Unsupported or Reserved STPv2 Header");
 }
 
 void TrcPktProcStm::stmPktF0Ext()
@@ -697,7 +709,7 @@ void TrcPktProcStm::stmPktReservedF0n()
     uint16_t bad_opcode = 0x00F;
     bad_opcode |= ((uint16_t)m_nibble) << 8;
     m_curr_packet.setD16Payload(bad_opcode);
-    throwReservedHdrError("STM: Unsupported or Reserved STPv2 Header");
+    setReservedHdrError("STM: Unsupported or Reserved STPv2 Header");
 }
 
 void TrcPktProcStm::stmPktVersion()
@@ -716,7 +728,8 @@ void TrcPktProcStm::stmPktVersion()
             m_curr_packet.onVersionPkt(STM_TS_GREY); break;
         default:
             // not a version we support.
-            throwBadSequenceError("STM VERSION packet : unrecognised version number.");
+            setBadSequenceError("STM VERSION packet : unrecognised version number.");
+            return;
         }
         sendPacket();
     }
@@ -783,7 +796,8 @@ void TrcPktProcStm::stmPktASync()
             }
             else if(!m_sync_start)  // no longer valid sync packet
             {
-                throwBadSequenceError("STM: Invalid ASYNC sequence");
+                setBadSequenceError("STM: Invalid ASYNC sequence");
+                return;
             }
         }
     }
@@ -819,6 +833,18 @@ bool TrcPktProcStm::readNibble()
     return dataFound;
 }
 
+// A sync sequence has at least 10 0xFF bytes, and may start in the upper nibble of the 
+// byte before the first of these. Bytes before that cannot be part of a sync sequence.
+void TrcPktProcStm::skipNotSyncBytes()
+{
+    uint32_t ff_pos = TrcSyncScan::findByte(m_p_data_in + m_data_in_used, m_data_in_size - m_data_in_used, 0xFF);
+    if(ff_pos > 1)
+    {
+        m_data_in_used += ff_pos - 1;
+        m_num_nibbles += (uint8_t)((ff_pos - 1) * 2);
+    }
+}
+
 void TrcPktProcStm::pktNeedsTS()
 {
     m_bNeedsTS = true;
@@ -841,7 +867,10 @@ void TrcPktProcStm::stmExtractTS()
                 m_req_ts_nibbles = 16;
 
             if(m_nibble == 0xF)
-                throwBadSequenceError("STM: Invalid timestamp size 0xF"); 
+            {
+                setBadSequenceError("STM: Invalid timestamp size 0xF"); 
+                return;
+            }
             m_ts_req_set = true;
         }
     }
@@ -889,7 +918,10 @@ void TrcPktProcStm::stmExtractTS()
                 m_curr_packet.setTS(m_ts_update_value, new_bits);
             }
             else
-                throwBadSequenceError("STM: unknown timestamp encoding");
+            {
+                setBadSequenceError("STM: unknown timestamp encoding");
+                return;
+            }
 
             sendPacket();
         }
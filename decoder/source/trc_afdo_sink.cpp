@@ -0,0 +1,405 @@
+/*
+ * \file       trc_afdo_sink.cpp
+ * \brief      OpenCSD : Aggregate instruction ranges and branches into AutoFDO profile counts.
+ *
+ * \copyright  Copyright (c) 2026, ARM Limited. All Rights Reserved.
+ */
+
+
+/*
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 'AS IS' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <algorithm>
+#include <fstream>
+#include <new>
+
+#include "common/trc_afdo_sink.h"
+
+/***************************************************************/
+/* count table */
+
+TrcAfdoCountTable::TrcAfdoCountTable() :
+    m_entries(0),
+    m_size(0),
+    m_used(0)
+{
+}
+
+TrcAfdoCountTable::~TrcAfdoCountTable()
+{
+    delete [] m_entries;
+}
+
+ocsd_err_t TrcAfdoCountTable::resize(const uint32_t size)
+{
+    afdo_count_t *old_entries = m_entries;
+    uint32_t old_size = m_size;
+
+    if (size > AFDO_COUNT_TABLE_MAX_SIZE)
+        return OCSD_ERR_MEM;
+
+    m_entries = new (std::nothrow) afdo_count_t[size];
+    if (!m_entries)
+    {
+        m_entries = old_entries;
+        return OCSD_ERR_MEM;
+    }
+    for (uint32_t i = 0; i < size; i++)
+        m_entries[i].count = 0;
+    m_size = size;
+
+    // re-insert into the new table - all unique so no match checks needed.
+    for (uint32_t i = 0; i < old_size; i++)
+    {
+        if (old_entries[i].count)
+        {
+            uint32_t idx = hashIdx(old_entries[i].from, old_entries[i].to);
+            while (m_entries[idx].count)
+                idx = (idx + 1) & (m_size - 1);
+            m_entries[idx] = old_entries[i];
+        }
+    }
+    delete [] old_entries;
+    return OCSD_OK;
+}
+
+ocsd_err_t TrcAfdoCountTable::merge(const TrcAfdoCountTable &table)
+{
+    ocsd_err_t err = OCSD_OK;
+
+    for (uint32_t i = 0; (i < table.m_size) && (err == OCSD_OK); i++)
+    {
+        if (table.m_entries[i].count)
+            err = add(table.m_entries[i].from, table.m_entries[i].to, table.m_entries[i].count);
+    }
+    return err;
+}
+
+void TrcAfdoCountTable::clear()
+{
+    delete [] m_entries;
+    m_entries = 0;
+    m_size = 0;
+    m_used = 0;
+}
+
+const uint64_t TrcAfdoCountTable::totalCount() const
+{
+    uint64_t total = 0;
+
+    for (uint32_t i = 0; i < m_size; i++)
+        total += m_entries[i].count;
+    return total;
+}
+
+static bool afdoCountLess(const afdo_count_t &a, const afdo_count_t &b)
+{
+    return (a.from < b.from) || ((a.from == b.from) && (a.to < b.to));
+}
+
+void TrcAfdoCountTable::getEntries(std::vector<afdo_count_t> &entries) const
+{
+    entries.clear();
+    entries.reserve(m_used);
+    for (uint32_t i = 0; i < m_size; i++)
+    {
+        if (m_entries[i].count)
+            entries.push_back(m_entries[i]);
+    }
+    std::sort(entries.begin(), entries.end(), afdoCountLess);
+}
+
+/***************************************************************/
+/* per ID shard */
+
+TrcAfdoIDShard::TrcAfdoIDShard() :
+    m_range_open(false),
+    m_range_st(0),
+    m_range_en(0),
+    m_last_instr(0),
+    m_br_taken(false),
+    m_ctxt_valid(false),
+    m_ctxt_match(true)
+{
+    m_ctxt_filter.context_id = m_ctxt_filter.vmid = 0;
+    m_ctxt_filter.ctxt_id_valid = m_ctxt_filter.vmid_valid = 0;
+}
+
+ocsd_datapath_resp_t TrcAfdoIDShard::TraceElemIn(const ocsd_trc_index_t /* index_sop */,
+                                                 const uint8_t /* trc_chan_id */,
+                                                 const OcsdTraceElement &el)
+{
+    ocsd_err_t err = OCSD_OK;
+
+    switch (el.getType())
+    {
+    case OCSD_GEN_TRC_ELEM_INSTR_RANGE:
+        if (m_ctxt_match)
+            err = addRange(el);
+        break;
+
+    case OCSD_GEN_TRC_ELEM_EXCEPTION:
+        // exception taken at the target of the last branch, before it executed.
+        err = endRange(el.excep_ret_addr_br_tgt, el.en_addr);
+        break;
+
+    case OCSD_GEN_TRC_ELEM_PE_CONTEXT:
+        if (contextChanged(el.getContext()))
+            err = endRange(false, 0);
+        m_ctxt_match = contextMatch();
+        break;
+
+    // discontinuity - next range does not follow from this one.
+    case OCSD_GEN_TRC_ELEM_NO_SYNC:
+    case OCSD_GEN_TRC_ELEM_TRACE_ON:
+    case OCSD_GEN_TRC_ELEM_EO_TRACE:
+    case OCSD_GEN_TRC_ELEM_I_RANGE_NOPATH:
+    case OCSD_GEN_TRC_ELEM_ADDR_NACC:
+    case OCSD_GEN_TRC_ELEM_ADDR_UNKNOWN:
+    case OCSD_GEN_TRC_ELEM_EXCEPTION_RET:
+        err = endRange(false, 0);
+        break;
+
+    default:
+        break;
+    }
+    return (err == OCSD_OK) ? OCSD_RESP_CONT : OCSD_RESP_FATAL_SYS_ERR;
+}
+
+ocsd_err_t TrcAfdoIDShard::addRange(const OcsdTraceElement &el)
+{
+    ocsd_err_t err = OCSD_OK;
+
+    // join ranges till a taken branch - branch counted to the start of this range.
+    if (m_range_open && (m_br_taken || (el.st_addr != m_range_en)))
+        err = endRange(true, el.st_addr);
+
+    if (!m_range_open)
+    {
+        m_range_open = true;
+        m_range_st = el.st_addr;
+    }
+    m_range_en = el.en_addr;
+    m_last_instr = el.en_addr - el.last_instr_sz;
+    m_br_taken = el.last_instr_exec && ((el.last_i_type == OCSD_INSTR_BR) || (el.last_i_type == OCSD_INSTR_BR_INDIRECT));
+    return err;
+}
+
+ocsd_err_t TrcAfdoIDShard::endRange(const bool bBranchValid, const ocsd_vaddr_t br_target)
+{
+    ocsd_err_t err = OCSD_OK;
+
+    if (m_range_open)
+    {
+        err = m_ranges.add(m_range_st, m_last_instr);
+        if (m_br_taken && bBranchValid && (err == OCSD_OK))
+            err = m_branches.add(m_last_instr, br_target);
+        m_range_open = false;
+    }
+    return err;
+}
+
+const bool TrcAfdoIDShard::contextChanged(const ocsd_pe_context &context)
+{
+    bool bChanged = m_ctxt_valid &&
+        ((context.security_level != m_context.security_level) ||
+         (context.bits64 != m_context.bits64) ||
+         (context.el_valid != m_context.el_valid) ||
+         (context.el_valid && (context.exception_level != m_context.exception_level)) ||
+         (context.ctxt_id_valid != m_context.ctxt_id_valid) ||
+         (context.ctxt_id_valid && (context.context_id != m_context.context_id)) ||
+         (context.vmid_valid != m_context.vmid_valid) ||
+         (context.vmid_valid && (context.vmid != m_context.vmid)));
+
+    m_context = context;
+    m_ctxt_valid = true;
+    return bChanged;
+}
+
+const bool TrcAfdoIDShard::contextMatch() const
+{
+    if (!m_ctxt_filter.ctxt_id_valid && !m_ctxt_filter.vmid_valid)
+        return true;
+
+    // filtered - no match till the context is known.
+    if (!m_ctxt_valid)
+        return false;
+    if (m_ctxt_filter.ctxt_id_valid && (!m_context.ctxt_id_valid || (m_context.context_id != m_ctxt_filter.context_id)))
+        return false;
+    if (m_ctxt_filter.vmid_valid && (!m_context.vmid_valid || (m_context.vmid != m_ctxt_filter.vmid)))
+        return false;
+    return true;
+}
+
+ocsd_err_t TrcAfdoIDShard::setContextFilter(const ocsd_mem_acc_ctxt_t &filter)
+{
+    // range open under the previous filter is counted.
+    ocsd_err_t err = endRange(false, 0);
+
+    m_ctxt_filter = filter;
+    m_ctxt_match = contextMatch();
+    return err;
+}
+
+ocsd_err_t TrcAfdoIDShard::mergeInto(TrcAfdoCountTable &ranges, TrcAfdoCountTable &branches)
+{
+    ocsd_err_t err;
+
+    if ((err = endRange(false, 0)) != OCSD_OK)
+        return err;
+    if ((err = ranges.merge(m_ranges)) != OCSD_OK)
+        return err;
+    if ((err = branches.merge(m_branches)) != OCSD_OK)
+        return err;
+    m_ranges.clear();
+    m_branches.clear();
+    return OCSD_OK;
+}
+
+void TrcAfdoIDShard::clear()
+{
+    m_ranges.clear();
+    m_branches.clear();
+    m_range_open = false;
+    m_ctxt_valid = false;
+    m_ctxt_match = contextMatch();
+}
+
+/***************************************************************/
+/* profile sink */
+
+TrcAfdoSink::TrcAfdoSink() :
+    m_active(false)
+{
+    for (int i = 0; i < 0x80; i++)
+        m_shards[i] = 0;
+    m_ctxt_filter.context_id = m_ctxt_filter.vmid = 0;
+    m_ctxt_filter.ctxt_id_valid = m_ctxt_filter.vmid_valid = 0;
+}
+
+TrcAfdoSink::~TrcAfdoSink()
+{
+    for (int i = 0; i < 0x80; i++)
+        delete m_shards[i];
+}
+
+ocsd_err_t TrcAfdoSink::addShard(const uint8_t ID)
+{
+    if (ID >= 0x80)
+        return OCSD_ERR_INVALID_ID;
+    if (!m_shards[ID])
+    {
+        m_shards[ID] = new (std::nothrow) TrcAfdoIDShard();
+        if (!m_shards[ID])
+            return OCSD_ERR_MEM;
+        return m_shards[ID]->setContextFilter(m_ctxt_filter);
+    }
+    return OCSD_OK;
+}
+
+ocsd_err_t TrcAfdoSink::setContextFilter(const ocsd_mem_acc_ctxt_t *p_filter)
+{
+    ocsd_err_t err = OCSD_OK;
+
+    if (p_filter)
+        m_ctxt_filter = *p_filter;
+    else
+    {
+        m_ctxt_filter.context_id = m_ctxt_filter.vmid = 0;
+        m_ctxt_filter.ctxt_id_valid = m_ctxt_filter.vmid_valid = 0;
+    }
+
+    for (int i = 0; (i < 0x80) && (err == OCSD_OK); i++)
+    {
+        if (m_shards[i])
+            err = m_shards[i]->setContextFilter(m_ctxt_filter);
+    }
+    return err;
+}
+
+ocsd_datapath_resp_t TrcAfdoSink::TraceElemIn(const ocsd_trc_index_t index_sop,
+                                              const uint8_t trc_chan_id,
+                                              const OcsdTraceElement &el)
+{
+    if (addShard(trc_chan_id) != OCSD_OK)
+        return OCSD_RESP_FATAL_SYS_ERR;
+    return m_shards[trc_chan_id]->TraceElemIn(index_sop, trc_chan_id, el);
+}
+
+ocsd_err_t TrcAfdoSink::mergeShards()
+{
+    ocsd_err_t err = OCSD_OK;
+
+    for (int i = 0; (i < 0x80) && (err == OCSD_OK); i++)
+    {
+        if (m_shards[i])
+            err = m_shards[i]->mergeInto(m_ranges, m_branches);
+    }
+    return err;
+}
+
+ocsd_err_t TrcAfdoSink::saveTextProfile(const std::string &filename)
+{
+    ocsd_err_t err;
+    std::vector<afdo_count_t> entries;
+
+    if ((err = mergeShards()) != OCSD_OK)
+        return err;
+
+    std::ofstream out(filename.c_str(), std::ofstream::trunc);
+    if (!out.is_open())
+        return OCSD_ERR_PROFILE_FILE;
+
+    // range counts, address counts, branch counts - hex addresses, decimal counts.
+    m_ranges.getEntries(entries);
+    out << std::dec << entries.size() << "\n";
+    for (size_t i = 0; i < entries.size(); i++)
+        out << std::hex << entries[i].from << "-" << entries[i].to << ":" << std::dec << entries[i].count << "\n";
+
+    out << "0\n";
+
+    m_branches.getEntries(entries);
+    out << std::dec << entries.size() << "\n";
+    for (size_t i = 0; i < entries.size(); i++)
+        out << std::hex << entries[i].from << "->" << entries[i].to << ":" << std::dec << entries[i].count << "\n";
+
+    out.close();
+    return out.fail() ? OCSD_ERR_PROFILE_FILE : OCSD_OK;
+}
+
+void TrcAfdoSink::clear()
+{
+    for (int i = 0; i < 0x80; i++)
+    {
+        if (m_shards[i])
+            m_shards[i]->clear();
+    }
+    m_ranges.clear();
+    m_branches.clear();
+}
+
+/* End of File trc_afdo_sink.cpp */
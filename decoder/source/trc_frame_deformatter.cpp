@@ -36,10 +36,68 @@
 #include "common/trc_frame_deformatter.h"
 #include "trc_frame_deformatter_impl.h"
 
+/* vector unpack of memory aligned frames where supported by the host */
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define DFMT_UNPACK_SSE2
+#elif (defined(__aarch64__) && defined(__ARM_NEON)) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define DFMT_UNPACK_NEON
+#endif
+
 /***************************************************************/
 /* Implementation */
 /***************************************************************/
 
+/* Unpack a frame that contains only data bytes for the current ID. 
+ * 
+ * The 15 data bytes are in frame order, with the auxiliary bits from byte 15 restored into 
+ * bit 0 of the even bytes. Writes 16 bytes to pOut, the final byte being undefined.
+ * Returns false, with nothing written, if any of the even bytes is an ID byte.
+ */
+static inline bool unpackDataOnlyFrame(const uint8_t *pFrame, uint8_t *pOut)
+{
+#if defined(DFMT_UNPACK_SSE2)
+    const __m128i frame = _mm_loadu_si128((const __m128i *)pFrame);
+
+    // bit 0 of each even byte shifted to bit 7 for movemask.
+    if (_mm_movemask_epi8(_mm_slli_epi16(frame, 7)) & 0x5555)
+        return false;
+
+    // select the flag bit for each even byte.
+    const __m128i flag_sel = _mm_set_epi8(0, (char)0x80, 0, 0x40, 0, 0x20, 0, 0x10, 0, 0x08, 0, 0x04, 0, 0x02, 0, 0x01);
+    const __m128i flags = _mm_and_si128(_mm_set1_epi8((char)pFrame[15]), flag_sel);
+    const __m128i aux_bits = _mm_and_si128(_mm_cmpeq_epi8(flags, flag_sel), _mm_set1_epi16(0x0001));
+    _mm_storeu_si128((__m128i *)pOut, _mm_or_si128(frame, aux_bits));
+
+#elif defined(DFMT_UNPACK_NEON)
+    static const uint8_t even_lsb[16] = { 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0 };
+    static const uint8_t flag_sel[16] = { 0x01, 0, 0x02, 0, 0x04, 0, 0x08, 0, 0x10, 0, 0x20, 0, 0x40, 0, 0x80, 0 };
+    const uint8x16_t frame = vld1q_u8(pFrame);
+    const uint8x16_t lsb = vld1q_u8(even_lsb);
+
+    if (vmaxvq_u8(vandq_u8(frame, lsb)))
+        return false;
+
+    const uint8x16_t aux_bits = vandq_u8(vtstq_u8(vdupq_n_u8(pFrame[15]), vld1q_u8(flag_sel)), lsb);
+    vst1q_u8(pOut, vorrq_u8(frame, aux_bits));
+
+#else
+    const uint64_t EVEN_LSB = 0x0001000100010001ULL;    // LE host bit 0 of even bytes
+    uint64_t frame_lo, frame_hi;
+
+    memcpy(&frame_lo, pFrame, sizeof(uint64_t));
+    memcpy(&frame_hi, pFrame + sizeof(uint64_t), sizeof(uint64_t));
+    if ((frame_lo | frame_hi) & EVEN_LSB)
+        return false;
+
+    memcpy(pOut, pFrame, OCSD_DFRMTR_FRAME_SIZE);
+    for (int i = 0; i < 8; i++)
+        pOut[i * 2] |= (pFrame[15] >> i) & 0x1;
+#endif
+    return true;
+}
+
 #ifdef __GNUC__
 // G++ doesn't like the ## pasting
 #define DEFORMATTER_NAME "DFMT_CSFRAMES"
@@ -177,6 +235,8 @@ ocsd_datapath_resp_t TraceFmtDcdImpl::Reset()
 ocsd_datapath_resp_t TraceFmtDcdImpl::Flush()
 {
     executeNoneDataOpAllIDs(OCSD_OP_FLUSH);    // flush any upstream data.
+    if(dataPathCont() && m_out_run.valid)
+        outputRun();    // try to flush any collated ID run remaining
     if(dataPathCont())
         outputFrame();  // try to flush any partial frame data remaining
     return highestDataPathResp();
@@ -266,7 +326,11 @@ ocsd_datapath_resp_t TraceFmtDcdImpl::processTraceData(
             bool bProcessing = true;
             while(bProcessing) 
             {
-                bProcessing = extractFrame();   // will stop on end of input data.
+                // whole frames unpacked in place - hands on to extraction at an FSYNC frame.
+                if(useBulkUnpack())
+                    bProcessing = processAlignedFrames();
+                if(bProcessing)
+                    bProcessing = extractFrame();   // will stop on end of input data.
                 if(bProcessing)
                     bProcessing = unpackFrame();
                 if(bProcessing)
@@ -317,6 +381,13 @@ ocsd_err_t  TraceFmtDcdImpl::DecodeConfigure(uint32_t flags)
         pszErrMsg = "Invalid Config Flag Combination Set";
     }
 
+    // ID runs are only collated from memory aligned frames
+    if((flags & OCSD_DFRMTR_ID_RUNS) && !(flags & OCSD_DFRMTR_FRAME_MEM_ALIGN))
+    {
+        err = OCSD_ERR_INVALID_PARAM_VAL;
+        pszErrMsg = "Invalid Config Flag Combination Set";
+    }
+
     if(err != OCSD_OK)
     {
         ocsdError errObj(OCSD_ERR_SEV_ERROR,OCSD_ERR_INVALID_PARAM_VAL);
@@ -353,6 +424,12 @@ void TraceFmtDcdImpl::resetStateParams()
     m_ex_frm_n_bytes = 0;
     m_b_fsync_start_eob = false;
     m_trc_curr_idx_sof = OCSD_BAD_TRC_INDEX;
+
+    // no frame or run data pending output
+    m_out_data_idx = 0;
+    m_out_processed = 1;
+    m_out_run.valid = 0;
+    m_out_run.used = 0;
 }
 
 bool TraceFmtDcdImpl::checkForSync()
@@ -395,6 +472,10 @@ bool TraceFmtDcdImpl::checkForSync()
             m_in_block_processed = unsynced_bytes;
             m_trc_curr_idx += unsynced_bytes;
         }
+
+        // FSYNC positions are indexed as frames are extracted.
+        if(m_frame_synced && !(m_cfgFlags & OCSD_DFRMTR_HAS_FSYNCS) && m_SrcIndexer.hasAttachedAndEnabled())
+            m_SrcIndexer.first()->TrcSyncIndex(m_trc_curr_idx);
     }
     return m_frame_synced;
 }
@@ -538,6 +619,11 @@ bool TraceFmtDcdImpl::extractFrame()
         // can have FSYNCS at start of frame (in middle is an error).
         if (hasFSyncs && (m_ex_frm_n_bytes == 0))
         {
+            // index the start of the FSYNC - may have begun at the end of the last buffer.
+            if (m_SrcIndexer.hasAttachedAndEnabled() &&
+                (m_b_fsync_start_eob || ((buf_left >= 4) && (*((uint32_t*)(dataPtr)) == FSYNC_PATTERN))))
+                m_SrcIndexer.first()->TrcSyncIndex(m_trc_curr_idx - (m_b_fsync_start_eob ? 2 : 0));
+
             // was there an fsync start at the end of the last buffer?
             if (m_b_fsync_start_eob) {
                 // last 2 of FSYNC look like HSYNC
@@ -647,6 +733,13 @@ bool TraceFmtDcdImpl::extractFrame()
 bool TraceFmtDcdImpl::unpackFrame()
 {
     // unpack cannot fail as never called on incomplete frame.
+    unpackFrameData(m_ex_frm_data);
+    m_ex_frm_n_bytes = 0;   // mark frame as empty;
+    return true;
+}
+
+void TraceFmtDcdImpl::unpackFrameData(const uint8_t *pFrame)
+{
     uint8_t frameFlagBit = 0x1;
     uint8_t newSrcID = OCSD_BAD_CS_SRC_ID;
     bool PrevIDandIDChange = false;
@@ -662,23 +755,33 @@ bool TraceFmtDcdImpl::unpackFrame()
     m_out_data[m_out_data_idx].index =  m_trc_curr_idx_sof;
     m_out_data[m_out_data_idx].used = 0;
 
+    // frames with no ID bytes are all data for the current ID.
+    uint8_t frame_data[OCSD_DFRMTR_FRAME_SIZE];
+    if(unpackDataOnlyFrame(pFrame, frame_data))
+    {
+        m_out_data[m_out_data_idx].valid = OCSD_DFRMTR_FRAME_SIZE - 1;
+        memcpy(m_out_data[m_out_data_idx].data, frame_data, m_out_data[m_out_data_idx].valid);
+        addToFrameStats(1);  // byte 15 is always non-data.
+        return;
+    }
+
     // work on byte pairs - bytes 0 - 13.
     for(int i = 0; i < 14; i+=2)
     {
         PrevIDandIDChange = false;
 
         // it's an ID + data
-        if(m_ex_frm_data[i] & 0x1)
+        if(pFrame[i] & 0x1)
         {
-            newSrcID = (m_ex_frm_data[i] >> 1) & 0x7f;
+            newSrcID = (pFrame[i] >> 1) & 0x7f;
             if(newSrcID != m_curr_src_ID)   // ID change
             {
-                PrevIDandIDChange = ((frameFlagBit & m_ex_frm_data[15]) != 0);
+                PrevIDandIDChange = ((frameFlagBit & pFrame[15]) != 0);
 
                 // following byte for old id? 
                 if(PrevIDandIDChange)
                     // 2nd byte always data
-                    m_out_data[m_out_data_idx].data[m_out_data[m_out_data_idx].valid++] = m_ex_frm_data[i+1];
+                    m_out_data[m_out_data_idx].data[m_out_data[m_out_data_idx].valid++] = pFrame[i+1];
 
                 // change ID
                 m_curr_src_ID = newSrcID;
@@ -695,19 +798,20 @@ bool TraceFmtDcdImpl::unpackFrame()
                 // set new ID on buffer
                 m_out_data[m_out_data_idx].id = m_curr_src_ID;
 
-                /// TBD - ID indexing in here.
+                if(m_SrcIndexer.hasAttachedAndEnabled())
+                    m_SrcIndexer.first()->TrcIDIndex(m_trc_curr_idx_sof + i, m_curr_src_ID);
             }
             noneDataBytes++;
         }
         else
         // it's just data
         {
-            m_out_data[m_out_data_idx].data[m_out_data[m_out_data_idx].valid++] = m_ex_frm_data[i] | ((frameFlagBit & m_ex_frm_data[15]) ? 0x1 : 0x0);             
+            m_out_data[m_out_data_idx].data[m_out_data[m_out_data_idx].valid++] = pFrame[i] | ((frameFlagBit & pFrame[15]) ? 0x1 : 0x0);             
         }
 
         // 2nd byte always data
         if(!PrevIDandIDChange) // output only if we didn't for an ID change + prev ID.
-            m_out_data[m_out_data_idx].data[m_out_data[m_out_data_idx].valid++] = m_ex_frm_data[i+1];
+            m_out_data[m_out_data_idx].data[m_out_data[m_out_data_idx].valid++] = pFrame[i+1];
 
         frameFlagBit <<= 1;
     }
@@ -715,111 +819,190 @@ bool TraceFmtDcdImpl::unpackFrame()
     // unpack byte 14;
 
     // it's an ID
-    if(m_ex_frm_data[14] & 0x1)
+    if(pFrame[14] & 0x1)
     {
         // no matter if change or not, no associated data in byte 15 anyway so just set.
-        m_curr_src_ID = (m_ex_frm_data[14] >> 1) & 0x7f;
+        m_curr_src_ID = (pFrame[14] >> 1) & 0x7f;
+        if(m_SrcIndexer.hasAttachedAndEnabled())
+            m_SrcIndexer.first()->TrcIDIndex(m_trc_curr_idx_sof + 14, m_curr_src_ID);
         noneDataBytes++;
     }
     // it's data
     else
     {
-        m_out_data[m_out_data_idx].data[m_out_data[m_out_data_idx].valid++] = m_ex_frm_data[14] | ((frameFlagBit & m_ex_frm_data[15]) ? 0x1 : 0x0); 
+        m_out_data[m_out_data_idx].data[m_out_data[m_out_data_idx].valid++] = pFrame[14] | ((frameFlagBit & pFrame[15]) ? 0x1 : 0x0); 
     }
-    m_ex_frm_n_bytes = 0;   // mark frame as empty;
 
     noneDataBytes++;    // byte 15 is always non-data.
     addToFrameStats(noneDataBytes); // update the non data byte stats. 
-    return true;
 }
 
 // output data to channels.
 bool TraceFmtDcdImpl::outputFrame()
 {
     bool cont_processing = true;
-    ITrcDataIn *pDataIn = 0;
-    uint32_t bytes_used;
 
     // output each valid ID within the frame - stopping if we get a wait or error
     while((m_out_processed < (m_out_data_idx + 1)) && cont_processing)
     {
-        
-        // may have data prior to a valid ID appearing
-        if(m_out_data[m_out_processed].id != OCSD_BAD_CS_SRC_ID)
+        out_chan_data &chan = m_out_data[m_out_processed];
+        cont_processing = outputChanData(chan.id, chan.index, chan.data, chan.valid, chan.used);
+        if(chan.used == chan.valid)
+            m_out_processed++; // we have used up all this data.
+    }
+    return cont_processing;
+}
+
+// output a block of data for a single ID - used is updated with the bytes accepted downstream.
+bool TraceFmtDcdImpl::outputChanData(const uint8_t id, const ocsd_trc_index_t index, const uint8_t *pData, const uint32_t valid, uint32_t &used)
+{
+    bool cont_processing = true;
+    ITrcDataIn *pDataIn = 0;
+    uint32_t bytes_used;
+
+    // may have data prior to a valid ID appearing
+    if(id != OCSD_BAD_CS_SRC_ID)
+    {
+        if((pDataIn = m_IDStreams[id].first()) != 0)
         {
-            if((pDataIn = m_IDStreams[m_out_data[m_out_processed].id].first()) != 0)
+            // log the stuff we are about to put out early so as to make it visible before interpretation
+            // however, don't re-output if only part used first time round.
+            if(m_b_output_unpacked_raw && (used == 0) && rawChanEnabled(id))
             {
-                // log the stuff we are about to put out early so as to make it visible before interpretation
-                // however, don't re-output if only part used first time round.
-                if(m_b_output_unpacked_raw && (m_out_data[m_out_processed].used == 0) && rawChanEnabled( m_out_data[m_out_processed].id))
-                {
-                    outputRawMonBytes( OCSD_OP_DATA, 
-                            m_out_data[m_out_processed].index, 
-                            OCSD_FRM_ID_DATA,
-                            m_out_data[m_out_processed].valid,
-                            m_out_data[m_out_processed].data,
-                            m_out_data[m_out_processed].id);
-                }
+                outputRawMonBytes(OCSD_OP_DATA, index, OCSD_FRM_ID_DATA, valid, pData, id);
+            }
 
-                // output to the connected packet process
-                CollateDataPathResp(pDataIn->TraceDataIn(OCSD_OP_DATA,
-                    m_out_data[m_out_processed].index + m_out_data[m_out_processed].used,
-                    m_out_data[m_out_processed].valid - m_out_data[m_out_processed].used,
-                    m_out_data[m_out_processed].data + m_out_data[m_out_processed].used,
-                    &bytes_used));               
-                
-                addToIDStats((uint64_t)bytes_used);
+            // output to the connected packet process
+            CollateDataPathResp(pDataIn->TraceDataIn(OCSD_OP_DATA,
+                index + used,
+                valid - used,
+                pData + used,
+                &bytes_used));
 
-                if(!dataPathCont())
-                {
-                    cont_processing = false;
-                    m_out_data[m_out_processed].used += bytes_used;
-                    if(m_out_data[m_out_processed].used == m_out_data[m_out_processed].valid)
-                        m_out_processed++; // we have used up all this data.
-                }
-                else
-                {
-                    m_out_processed++; // we have sent this data;
-                }
+            addToIDStats((uint64_t)bytes_used);
+
+            if(!dataPathCont())
+            {
+                cont_processing = false;
+                used += bytes_used;
             }
             else
+                used = valid; // we have sent this data;
+        }
+        else
+        {
+            // optional raw output for debugging / monitor tools
+            if(m_b_output_unpacked_raw && rawChanEnabled(id))
             {
-                // optional raw output for debugging / monitor tools
-                if(m_b_output_unpacked_raw && rawChanEnabled( m_out_data[m_out_processed].id))
-                {
-                    outputRawMonBytes(  OCSD_OP_DATA, 
-                        m_out_data[m_out_processed].index, 
-                        OCSD_FRM_ID_DATA,
-                        m_out_data[m_out_processed].valid,
-                        m_out_data[m_out_processed].data,
-                        m_out_data[m_out_processed].id);
-                }  
-
-                if (isReservedID(m_out_data[m_out_processed].id))
-                    addToReservedIDStats((uint64_t)m_out_data[m_out_processed].valid);
-                else
-                    addToNoIDStats((uint64_t)m_out_data[m_out_processed].valid);
-                m_out_processed++; // skip past this data.
+                outputRawMonBytes(OCSD_OP_DATA, index, OCSD_FRM_ID_DATA, valid, pData, id);
             }
+
+            if (isReservedID(id))
+                addToReservedIDStats((uint64_t)valid);
+            else
+                addToNoIDStats((uint64_t)valid);
+            used = valid; // skip past this data.
+        }
+    }
+    else
+    {
+        // optional raw output for debugging / monitor tools of unknown src ID data
+        if(m_b_output_unpacked_raw)
+        {
+            outputRawMonBytes(OCSD_OP_DATA, index, OCSD_FRM_ID_DATA, valid, pData, id);
+        }
+        addToUnknownIDStats((uint64_t)valid);
+        used = valid; // skip past this data.
+    }
+    return cont_processing;
+}
+
+/* memory aligned frames with no raw monitor output are unpacked directly from the input block */
+const bool TraceFmtDcdImpl::useBulkUnpack() const
+{
+    return ((m_cfgFlags & OCSD_DFRMTR_FRAME_MEM_ALIGN) != 0) &&
+        !m_b_output_packed_raw && !m_b_output_unpacked_raw &&
+        (m_ex_frm_n_bytes == 0);
+}
+
+bool TraceFmtDcdImpl::processAlignedFrames()
+{
+    const uint32_t FSYNC_PATTERN = 0x7FFFFFFF;    // LE host pattern for FSYNC
+    const bool bCheckFSyncs = ((m_cfgFlags & OCSD_DFRMTR_RESET_ON_4X_FSYNC) != 0);
+    const bool bCollateRuns = ((m_cfgFlags & OCSD_DFRMTR_ID_RUNS) != 0);
+    const uint8_t *pFrame = m_in_block_base + m_in_block_processed;
+    bool cont_processing = true;
+
+    while(cont_processing && (m_in_block_processed < m_in_block_size))
+    {
+        // FSYNC reset frames are handled by the frame extraction code
+        if(bCheckFSyncs && (*((uint32_t *)(pFrame)) == FSYNC_PATTERN))
+            break;
+
+        // data only frame continuing the current run - unpack straight into the run buffer.
+        if(bCollateRuns && m_out_run.valid && (m_out_run.id == m_curr_src_ID) &&
+           ((m_out_run.valid + OCSD_DFRMTR_FRAME_SIZE - 1) <= DFMT_ID_RUN_BUFFER_SIZE) &&
+           unpackDataOnlyFrame(pFrame, m_out_run.data + m_out_run.valid))
+        {
+            m_out_run.valid += OCSD_DFRMTR_FRAME_SIZE - 1;
+            addToFrameStats(1);
         }
         else
         {
-            // optional raw output for debugging / monitor tools of unknown src ID data
-            if(m_b_output_unpacked_raw)
+            m_trc_curr_idx_sof = m_trc_curr_idx;
+            unpackFrameData(pFrame);
+            cont_processing = bCollateRuns ? collateFrameToRun() : outputFrame();
+        }
+
+        m_in_block_processed += OCSD_DFRMTR_FRAME_SIZE;
+        m_trc_curr_idx += OCSD_DFRMTR_FRAME_SIZE;
+        pFrame += OCSD_DFRMTR_FRAME_SIZE;
+    }
+
+    // runs are not held across input blocks or FSYNC resets.
+    if(cont_processing && m_out_run.valid)
+        cont_processing = outputRun();
+    return cont_processing;
+}
+
+bool TraceFmtDcdImpl::collateFrameToRun()
+{
+    bool cont_processing = true;
+
+    while((m_out_processed < (m_out_data_idx + 1)) && cont_processing)
+    {
+        out_chan_data &chan = m_out_data[m_out_processed];
+
+        // output the current run on ID change or full buffer
+        if(m_out_run.valid && ((m_out_run.id != chan.id) || ((m_out_run.valid + chan.valid) > DFMT_ID_RUN_BUFFER_SIZE)))
+            cont_processing = outputRun();
+
+        // data remaining in the frame is output from there if the run output halts the data path.
+        if(cont_processing)
+        {
+            if(chan.valid)
             {
-                outputRawMonBytes(  OCSD_OP_DATA, 
-                    m_out_data[m_out_processed].index, 
-                    OCSD_FRM_ID_DATA,
-                    m_out_data[m_out_processed].valid,
-                    m_out_data[m_out_processed].data,
-                    m_out_data[m_out_processed].id);
-            } 
-            addToUnknownIDStats((uint64_t)m_out_data[m_out_processed].valid);            
-            m_out_processed++; // skip past this data.
+                if(!m_out_run.valid)
+                {
+                    m_out_run.id = chan.id;
+                    m_out_run.index = chan.index;
+                }
+                memcpy(m_out_run.data + m_out_run.valid, chan.data, chan.valid);
+                m_out_run.valid += chan.valid;
+            }
+            m_out_processed++;
         }
     }
     return cont_processing;
 }
+
+bool TraceFmtDcdImpl::outputRun()
+{
+    bool cont_processing = outputChanData(m_out_run.id, m_out_run.index, m_out_run.data, m_out_run.valid, m_out_run.used);
+    if(m_out_run.used == m_out_run.valid)
+        m_out_run.valid = m_out_run.used = 0;
+    return cont_processing;
+}
     
 void TraceFmtDcdImpl::addToIDStats(uint64_t val)
 {
@@ -961,6 +1144,16 @@ ocsd_datapath_resp_t TraceFormatterFrameDecoder::Flush()
     return (m_pDecoder == 0) ? OCSD_RESP_FATAL_NOT_INIT : m_pDecoder->Flush();
 }
 
+ocsd_err_t TraceFormatterFrameDecoder::SetRestartID(const uint8_t ID)
+{
+    if (m_pDecoder == 0)
+        return OCSD_ERR_NOT_INIT;
+    if (!OCSD_IS_VALID_CS_SRC_ID(ID) && (ID != OCSD_BAD_CS_SRC_ID))
+        return OCSD_ERR_INVALID_PARAM_VAL;
+    m_pDecoder->m_curr_src_ID = ID;
+    return OCSD_OK;
+}
+
 void TraceFormatterFrameDecoder::SetDemuxStatsBlock(ocsd_demux_stats_t *pStatsBlock)
 {
     if (m_pDecoder)
@@ -51,6 +51,18 @@ typedef struct _out_chan_data {
     uint32_t used;          //!< Data bytes output (used by attached processor).
 } out_chan_data;
 
+/* size of the buffer used to collate ID data across frames when OCSD_DFRMTR_ID_RUNS is set */
+#define DFMT_ID_RUN_BUFFER_SIZE 0x1000
+
+//! output data run - collates bytes associated with an ID across multiple memory aligned frames.
+typedef struct _out_chan_run {
+    ocsd_trc_index_t index;     //!< trace source index for start of the run
+    uint8_t id;                 //!< Id for these bytes
+    uint32_t valid;             //!< Valid data bytes.
+    uint32_t used;              //!< Data bytes output (used by attached processor).
+    uint8_t data[DFMT_ID_RUN_BUFFER_SIZE + OCSD_DFRMTR_FRAME_SIZE]; //!< run data - sized to allow unpacking a full frame at the end of the run.
+} out_chan_run;
+
 class TraceFmtDcdImpl : public TraceComponent, ITrcDataIn
 {
 private:
@@ -89,6 +101,14 @@ private:
     bool unpackFrame(); // process a complete frame.
     bool outputFrame(); // output data to channels.
 
+    // bulk processing of memory aligned frames directly from the input buffer.
+    const bool useBulkUnpack() const;
+    bool processAlignedFrames();    // unpack and output whole frames until end of block, data path halt or FSYNC frame.
+    void unpackFrameData(const uint8_t *pFrame);   // unpack a single frame into the output channel data.
+    bool collateFrameToRun();       // add unpacked frame data to the current ID run, output run on ID change.
+    bool outputRun();               // output the current ID run.
+    bool outputChanData(const uint8_t id, const ocsd_trc_index_t index, const uint8_t *pData, const uint32_t valid, uint32_t &used);
+
 
     // managing data path responses.
     void InitCollateDataPathResp() { m_highestResp = OCSD_RESP_CONT; };
@@ -164,6 +184,8 @@ private:
     out_chan_data m_out_data[8]; // output data for a given ID
     int m_out_data_idx;          // number of out_chan_data frames used.
     int m_out_processed;         // number of complete out_chan_data frames output.
+
+    out_chan_run m_out_run;      // ID data collated across frames (OCSD_DFRMTR_ID_RUNS)
     
     /* local copy of input buffer pointers*/
     const uint8_t *m_in_block_base;
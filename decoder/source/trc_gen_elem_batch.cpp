@@ -0,0 +1,78 @@
+/*
+ * \file       trc_gen_elem_batch.cpp
+ * \brief      OpenCSD : Collect generic trace elements into batches for output.
+ * 
+ * \copyright  Copyright (c) 2026, ARM Limited. All Rights Reserved.
+ */
+
+
+/* 
+ * Redistribution and use in source and binary forms, with or without modification, 
+ * are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, 
+ * this list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright notice, 
+ * this list of conditions and the following disclaimer in the documentation 
+ * and/or other materials provided with the distribution. 
+ * 
+ * 3. Neither the name of the copyright holder nor the names of its contributors 
+ * may be used to endorse or promote products derived from this software without 
+ * specific prior written permission. 
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 'AS IS' AND 
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED 
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. 
+ * IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, 
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES 
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; 
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND 
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT 
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS 
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. 
+ */ 
+
+#include "common/trc_gen_elem_batch.h"
+#include "common/trc_gen_elem.h"
+
+TrcGenElemBatcher::TrcGenElemBatcher() :
+    m_i_batch_out(0),
+    m_num_elem(0)
+{
+}
+
+ocsd_err_t TrcGenElemBatcher::init(ITrcGenElemBatchIn *i_batch_out, const uint32_t batch_size)
+{
+    if (i_batch_out && ((batch_size < GEN_ELEM_BATCH_MIN_SIZE) || (batch_size > GEN_ELEM_BATCH_MAX_SIZE)))
+        return OCSD_ERR_INVALID_PARAM_VAL;
+
+    m_i_batch_out = i_batch_out;
+    m_num_elem = 0;
+    if (i_batch_out)
+        m_batch.resize(batch_size);
+    else
+        m_batch.clear();
+    return OCSD_OK;
+}
+
+ocsd_datapath_resp_t TrcGenElemBatcher::TraceElemIn(const ocsd_trc_index_t index_sop,
+                                                     const uint8_t trc_chan_id,
+                                                     const OcsdTraceElement &elem)
+{
+    ocsd_gen_elem_batch_entry_t *pEntry;
+
+    if (!m_i_batch_out)
+        return OCSD_RESP_FATAL_NOT_INIT;
+
+    pEntry = &m_batch[m_num_elem++];
+    pEntry->index_sop = index_sop;
+    pEntry->trc_chan_id = trc_chan_id;
+    pEntry->elem = elem;
+
+    if (elem.extended_data || (m_num_elem == m_batch.size()))
+        return flush();
+    return OCSD_RESP_CONT;
+}
+
+/* End of File trc_gen_elem_batch.cpp */
@@ -0,0 +1,114 @@
+/*!
+* \file       trc_instr_blk_cache.cpp
+* \brief      OpenCSD : Decoded instruction block cache.
+*
+* \copyright  Copyright (c) 2026, ARM Limited. All Rights Reserved.
+*/
+
+/*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright notice,
+* this list of conditions and the following disclaimer in the documentation
+* and/or other materials provided with the distribution.
+*
+* 3. Neither the name of the copyright holder nor the names of its contributors
+* may be used to endorse or promote products derived from this software without
+* specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 'AS IS' AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+* IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <cstring>
+#include <new>
+#include "common/trc_instr_blk_cache.h"
+
+ocsd_err_t TrcInstrBlockCache::enableCaching(bool bEnable)
+{
+    ocsd_err_t err = OCSD_OK;
+
+    if (bEnable)
+    {
+        // create the cache if not already in use.
+        if (!m_entries)
+            err = createCache();
+    }
+    else
+        destroyCache();
+    m_bCacheEnabled = (bool)(m_entries != 0);
+    return err;
+}
+
+ocsd_err_t TrcInstrBlockCache::setNumEntries(const int nr_entries, const bool err_on_limit /*= false*/)
+{
+    int new_entries = nr_entries;
+
+    if ((nr_entries < INSTR_BLK_CACHE_ENTRIES_MIN) || (nr_entries > INSTR_BLK_CACHE_ENTRIES_MAX))
+    {
+        if (err_on_limit)
+            return OCSD_ERR_INVALID_PARAM_VAL;
+        new_entries = (nr_entries < INSTR_BLK_CACHE_ENTRIES_MIN) ? INSTR_BLK_CACHE_ENTRIES_MIN : INSTR_BLK_CACHE_ENTRIES_MAX;
+    }
+
+    // direct mapped - round up to power of 2 for index masking.
+    int pow2_entries = INSTR_BLK_CACHE_ENTRIES_MIN;
+    while (pow2_entries < new_entries)
+        pow2_entries <<= 1;
+
+    if (pow2_entries != m_num_entries)
+    {
+        m_num_entries = pow2_entries;
+        m_idx_mask = (uint32_t)(pow2_entries - 1);
+
+        // re-create cache at new size if in use.
+        if (m_entries)
+        {
+            destroyCache();
+            if (createCache() != OCSD_OK)
+            {
+                m_bCacheEnabled = false;
+                return OCSD_ERR_MEM;
+            }
+        }
+    }
+    return OCSD_OK;
+}
+
+void TrcInstrBlockCache::invalidateAll()
+{
+    if (m_entries)
+        memset(m_entries, 0, sizeof(instr_blk_entry_t) * m_num_entries);
+}
+
+ocsd_err_t TrcInstrBlockCache::createCache()
+{
+    m_entries = new (std::nothrow) instr_blk_entry_t[m_num_entries];
+    if (!m_entries)
+        return OCSD_ERR_MEM;
+    invalidateAll();
+    return OCSD_OK;
+}
+
+void TrcInstrBlockCache::destroyCache()
+{
+    if (m_entries)
+    {
+        delete [] m_entries;
+        m_entries = 0;
+    }
+}
+
+/* End of File trc_instr_blk_cache.cpp */
@@ -39,8 +39,8 @@
 
 void trcPrintableElem::getValStr(std::string &valStr, const int valTotalBitSize, const int valValidBits, const uint64_t value, const bool asHex /* = true*/, const int updateBits /* = 0*/)
 {
-    static char szStrBuffer[128];
-    static char szFormatBuffer[32];
+    char szStrBuffer[128];
+    char szFormatBuffer[32];
 
     assert((valTotalBitSize >= 4) && (valTotalBitSize <= 64));
 
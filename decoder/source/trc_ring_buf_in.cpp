@@ -0,0 +1,167 @@
+/*
+ * \file       trc_ring_buf_in.cpp
+ * \brief      OpenCSD : Streaming trace data input from a live, wrapping ring buffer.
+ *
+ * \copyright  Copyright (c) 2026, ARM Limited. All Rights Reserved.
+ */
+
+
+/*
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 'AS IS' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "common/trc_ring_buf_in.h"
+
+/* largest block passed to the decode input in a single call */
+#define RING_BUF_MAX_BLOCK 0x40000000
+
+TrcRingBufferIn::TrcRingBufferIn() :
+    m_pDataIn(0),
+    m_p_buffer(0),
+    m_size(0),
+    m_p_head(0),
+    m_p_tail(0),
+    m_align_mask(0),
+    m_pos(0),
+    m_discont_pending(false),
+    m_discont_pos(0),
+    m_resp(OCSD_RESP_CONT),
+    m_bytes_lost(0),
+    m_num_discont(0)
+{
+}
+
+ocsd_err_t TrcRingBufferIn::init(ITrcDataIn *pDataIn, const uint8_t *p_buffer, const uint64_t buffer_size,
+                                 const volatile uint64_t *p_head, volatile uint64_t *p_tail, const uint32_t align /*= 1*/)
+{
+    // alignment a power of 2, buffer a whole number of aligned blocks.
+    if (!pDataIn || !p_buffer || !p_head || !align || (align & (align - 1)) ||
+        !buffer_size || (buffer_size & (align - 1)))
+        return OCSD_ERR_INVALID_PARAM_VAL;
+
+    m_pDataIn = pDataIn;
+    m_p_buffer = p_buffer;
+    m_size = buffer_size;
+    m_p_head = p_head;
+    m_p_tail = p_tail;
+    m_align_mask = ~((uint64_t)align - 1);
+
+    m_pos = readHead() & m_align_mask;
+    m_discont_pending = false;
+    m_resp = OCSD_RESP_CONT;
+    m_bytes_lost = 0;
+    m_num_discont = 0;
+    writeTail();
+    return OCSD_OK;
+}
+
+void TrcRingBufferIn::setDataLost()
+{
+    if (m_p_head)
+    {
+        m_discont_pending = true;
+        m_discont_pos = readHead();
+    }
+}
+
+ocsd_datapath_resp_t TrcRingBufferIn::processData()
+{
+    uint64_t head, avail, offset;
+    uint32_t block_size, bytes_used;
+
+    if (!m_pDataIn)
+        return OCSD_RESP_FATAL_NOT_INIT;
+
+    // decoder waiting at the end of the last call - flush before more input.
+    if (OCSD_DATA_RESP_IS_WAIT(m_resp))
+        m_resp = m_pDataIn->TraceDataIn(OCSD_OP_FLUSH, 0, 0, 0, 0);
+
+    while (OCSD_DATA_RESP_IS_CONT(m_resp))
+    {
+        head = readHead();
+
+        // producer has lapped the read position - restart at the oldest data still in the buffer.
+        if ((head < m_pos) || ((head - m_pos) > m_size))
+        {
+            restartInput((head > m_size) ? head - m_size : 0);
+            continue;
+        }
+
+        // marked discontinuity - decode the data before it, then restart.
+        if (m_discont_pending)
+        {
+            // less than an aligned block before the discontinuity - restart after it.
+            if ((m_discont_pos < m_pos) || ((m_discont_pos - m_pos) <= ~m_align_mask))
+            {
+                restartInput((m_discont_pos < m_pos) ? m_pos : m_discont_pos);
+                continue;
+            }
+            head = m_discont_pos;
+        }
+
+        avail = (head - m_pos) & m_align_mask;
+        if (!avail)
+            break;
+
+        // contiguous data to the head or the end of the buffer.
+        offset = m_pos % m_size;
+        if (avail > (m_size - offset))
+            avail = m_size - offset;
+        block_size = (avail > RING_BUF_MAX_BLOCK) ? RING_BUF_MAX_BLOCK : (uint32_t)avail;
+
+        bytes_used = 0;
+        m_resp = m_pDataIn->TraceDataIn(OCSD_OP_DATA, (ocsd_trc_index_t)m_pos, block_size, m_p_buffer + offset, &bytes_used);
+
+        // producer lapped the block while in the decoder - the data decoded may be a mix of old and new.
+        head = readHead();
+        if (!OCSD_DATA_RESP_IS_FATAL(m_resp) && ((head < m_pos) || ((head - m_pos) > m_size)))
+        {
+            restartInput((head > m_size) ? head - m_size : 0);
+            continue;
+        }
+        m_pos += bytes_used;
+        writeTail();
+    }
+    return m_resp;
+}
+
+// reset the decode, restarting input at the aligned position.
+void TrcRingBufferIn::restartInput(const uint64_t pos)
+{
+    uint64_t restart_pos = (pos + ~m_align_mask) & m_align_mask;
+
+    if (restart_pos > m_pos)
+        m_bytes_lost += restart_pos - m_pos;
+    m_num_discont++;
+    m_discont_pending = false;
+    m_pos = restart_pos;
+
+    // decoders report the loss of sync on the next data in.
+    m_resp = m_pDataIn->TraceDataIn(OCSD_OP_RESET, (ocsd_trc_index_t)m_pos, 0, 0, 0);
+    writeTail();
+}
+
+/* End of File trc_ring_buf_in.cpp */
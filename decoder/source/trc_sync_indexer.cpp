@@ -0,0 +1,618 @@
+/*
+ * \file       trc_sync_indexer.cpp
+ * \brief      OpenCSD : Index trace sync points for each trace ID in a capture.
+ *
+ * \copyright  Copyright (c) 2026, ARM Limited. All Rights Reserved.
+ */
+
+
+/*
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 'AS IS' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <algorithm>
+#include <fstream>
+#include <cstring>
+
+#include "common/trc_sync_indexer.h"
+#include "common/ocsd_dcd_tree.h"
+#include "common/trc_frame_deformatter.h"
+#include "interfaces/trc_pkt_raw_in_i.h"
+
+#include "opencsd/etmv4/trc_pkt_elem_etmv4i.h"
+#include "opencsd/etmv3/trc_pkt_elem_etmv3.h"
+#include "opencsd/ptm/trc_pkt_elem_ptm.h"
+#include "opencsd/stm/trc_pkt_elem_stm.h"
+#include "opencsd/itm/trc_pkt_elem_itm.h"
+
+/***************************************************************/
+/* packet classification for each protocol */
+
+static TrcSyncIndexer::sync_pkt_class_t classifyPkt(const EtmV4ITrcPacket *pkt, uint64_t &ts)
+{
+    switch (pkt->getType())
+    {
+    case ETM4_PKT_I_ASYNC: return TrcSyncIndexer::SYNC_PKT_ALIGN;
+    case ETM4_PKT_I_TRACE_INFO: return TrcSyncIndexer::SYNC_PKT_TINFO;
+    case ETM4_PKT_I_TIMESTAMP:
+        ts = pkt->getTS();
+        return TrcSyncIndexer::SYNC_PKT_TS;
+    default: break;
+    }
+    return TrcSyncIndexer::SYNC_PKT_OTHER;
+}
+
+static TrcSyncIndexer::sync_pkt_class_t classifyPkt(const EtmV3TrcPacket *pkt, uint64_t &ts)
+{
+    switch (pkt->getType())
+    {
+    case ETM3_PKT_A_SYNC: return TrcSyncIndexer::SYNC_PKT_ALIGN;
+    case ETM3_PKT_I_SYNC:
+    case ETM3_PKT_I_SYNC_CYCLE:
+        return TrcSyncIndexer::SYNC_PKT_ISYNC;
+    case ETM3_PKT_TIMESTAMP:
+        ts = pkt->getTS();
+        return TrcSyncIndexer::SYNC_PKT_TS;
+    default: break;
+    }
+    return TrcSyncIndexer::SYNC_PKT_OTHER;
+}
+
+static TrcSyncIndexer::sync_pkt_class_t classifyPkt(const PtmTrcPacket *pkt, uint64_t &ts)
+{
+    switch (pkt->getType())
+    {
+    case PTM_PKT_A_SYNC: return TrcSyncIndexer::SYNC_PKT_ALIGN;
+    case PTM_PKT_I_SYNC: return TrcSyncIndexer::SYNC_PKT_ISYNC;
+    case PTM_PKT_TIMESTAMP:
+        ts = pkt->timestamp;
+        return TrcSyncIndexer::SYNC_PKT_TS;
+    default: break;
+    }
+    return TrcSyncIndexer::SYNC_PKT_OTHER;
+}
+
+static TrcSyncIndexer::sync_pkt_class_t classifyPkt(const StmTrcPacket *pkt, uint64_t &ts)
+{
+    if (pkt->getPktType() == STM_PKT_ASYNC)
+        return TrcSyncIndexer::SYNC_PKT_ASYNC;
+    if (pkt->isTSPkt())
+    {
+        ts = pkt->getTSVal();
+        return TrcSyncIndexer::SYNC_PKT_TS;
+    }
+    return TrcSyncIndexer::SYNC_PKT_OTHER;
+}
+
+static TrcSyncIndexer::sync_pkt_class_t classifyPkt(const ItmTrcPacket *pkt, uint64_t & /* ts */)
+{
+    if (pkt->getPktType() == ITM_PKT_ASYNC)
+        return TrcSyncIndexer::SYNC_PKT_ASYNC;
+    return TrcSyncIndexer::SYNC_PKT_OTHER;
+}
+
+/***************************************************************/
+/* packet monitor attached to the packet processor for a single ID */
+
+template<class P>
+class TrcSyncIdxMon : public IPktRawDataMon<P>
+{
+public:
+    TrcSyncIdxMon(TrcSyncIndexer *pIndexer, const uint8_t ID) : m_pIndexer(pIndexer), m_ID(ID) {};
+    virtual ~TrcSyncIdxMon() {};
+
+    virtual void RawPacketDataMon(const ocsd_datapath_op_t op,
+                                  const ocsd_trc_index_t index_sop,
+                                  const P *pkt,
+                                  const uint32_t /* size */,
+                                  const uint8_t * /* p_data */)
+    {
+        uint64_t ts = 0;
+        TrcSyncIndexer::sync_pkt_class_t pkt_class;
+
+        if (!m_pIndexer->isActive())
+            return;
+
+        switch (op)
+        {
+        case OCSD_OP_DATA:
+            pkt_class = classifyPkt(pkt, ts);
+            if (pkt_class != TrcSyncIndexer::SYNC_PKT_OTHER)
+                m_pIndexer->indexPacket(m_ID, index_sop, pkt_class, ts);
+            break;
+
+        case OCSD_OP_RESET:
+            m_pIndexer->resetID(m_ID);
+            break;
+
+        default:
+            break;
+        }
+    }
+
+private:
+    TrcSyncIndexer *m_pIndexer;
+    uint8_t m_ID;
+};
+
+/***************************************************************/
+/* index file format - little endian values.
+   header : magic[8], version (u32), entry size (u32), entry count (u64)
+   entry  : pkt_index (u64), restart_index (u64), timestamp (u64), trc_id, type, flags, reserved (u8)
+*/
+static const char s_idx_magic[8] = { 'O', 'C', 'S', 'D', 'S', 'I', 'D', 'X' };
+static const uint32_t s_idx_version = 1;
+static const uint32_t s_idx_entry_size = 28;
+static const uint32_t s_idx_hdr_size = 24;
+
+static void putLE(uint8_t *pBuf, uint64_t val, const int bytes)
+{
+    for (int i = 0; i < bytes; i++)
+    {
+        pBuf[i] = (uint8_t)(val & 0xFF);
+        val >>= 8;
+    }
+}
+
+static uint64_t getLE(const uint8_t *pBuf, const int bytes)
+{
+    uint64_t val = 0;
+    for (int i = bytes - 1; i >= 0; i--)
+        val = (val << 8) | pBuf[i];
+    return val;
+}
+
+static bool entryLess(const ocsd_sync_idx_entry_t &a, const ocsd_sync_idx_entry_t &b)
+{
+    if (a.pkt_index == b.pkt_index)
+        return a.trc_id < b.trc_id;
+    return a.pkt_index < b.pkt_index;
+}
+
+/***************************************************************/
+
+TrcSyncIndexer::TrcSyncIndexer() :
+    m_sorted_valid(true),
+    m_deformatter(0),
+    m_active(true)
+{
+    for (int i = 0; i < 0x80; i++)
+    {
+        m_id_mon[i] = 0;
+        m_id_present[i] = false;
+        m_id_last_entry[i] = OCSD_BAD_TRC_INDEX;
+        resetID((uint8_t)i);
+    }
+}
+
+TrcSyncIndexer::~TrcSyncIndexer()
+{
+    destroyMonitors();
+}
+
+void TrcSyncIndexer::destroyMonitors()
+{
+    for (int i = 0; i < 0x80; i++)
+    {
+        if (m_id_mon[i])
+        {
+            delete m_id_mon[i];
+            m_id_mon[i] = 0;
+        }
+    }
+}
+
+ocsd_err_t TrcSyncIndexer::attachToTree(DecodeTree *pTree)
+{
+    ocsd_err_t err = OCSD_OK;
+    uint8_t elemID;
+
+    if (!pTree)
+        return OCSD_ERR_INVALID_PARAM_VAL;
+
+    m_deformatter = pTree->getFrameDeformatter();
+    if (m_deformatter)
+        err = m_deformatter->getTrcSrcIndexAttachPt()->replace_first(this);
+
+    DecodeTreeElement *pElement = pTree->getFirstElement(elemID);
+    while (pElement && (err == OCSD_OK))
+    {
+        err = attachToDecoder(pTree, elemID);
+        pElement = pTree->getNextElement(elemID);
+    }
+    return err;
+}
+
+ocsd_err_t TrcSyncIndexer::attachToDecoder(DecodeTree *pTree, const uint8_t CSID)
+{
+    ocsd_err_t err = OCSD_OK;
+    ITrcTypedBase *pMon = 0;
+    DecodeTreeElement *pElement = pTree ? pTree->getDecoderElement(CSID) : 0;
+
+    if (!pElement)
+        return OCSD_ERR_INVALID_PARAM_VAL;
+
+    switch (pElement->getProtocol())
+    {
+    case OCSD_PROTOCOL_ETMV4I:
+    case OCSD_PROTOCOL_ETE:
+        pMon = new (std::nothrow) TrcSyncIdxMon<EtmV4ITrcPacket>(this, CSID);
+        break;
+
+    case OCSD_PROTOCOL_ETMV3:
+        pMon = new (std::nothrow) TrcSyncIdxMon<EtmV3TrcPacket>(this, CSID);
+        break;
+
+    case OCSD_PROTOCOL_PTM:
+        pMon = new (std::nothrow) TrcSyncIdxMon<PtmTrcPacket>(this, CSID);
+        break;
+
+    case OCSD_PROTOCOL_STM:
+        pMon = new (std::nothrow) TrcSyncIdxMon<StmTrcPacket>(this, CSID);
+        break;
+
+    case OCSD_PROTOCOL_ITM:
+        pMon = new (std::nothrow) TrcSyncIdxMon<ItmTrcPacket>(this, CSID);
+        break;
+
+    default:
+        // no sync points indexed for other protocols.
+        return OCSD_OK;
+    }
+
+    if (!pMon)
+        return OCSD_ERR_MEM;
+
+    // replaces any existing monitor before the old one is deleted.
+    err = pElement->getDecoderMngr()->attachPktMonitor(pElement->getDecoderHandle(), pMon);
+    if (err != OCSD_OK)
+    {
+        delete pMon;
+        return err;
+    }
+
+    if (m_id_mon[CSID])
+        delete m_id_mon[CSID];
+    m_id_mon[CSID] = pMon;
+    return OCSD_OK;
+}
+
+void TrcSyncIndexer::setActive(const bool bActive)
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    m_active = bActive;
+}
+
+void TrcSyncIndexer::clear()
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+
+    m_entries.clear();
+    m_sorted.clear();
+    m_sorted_valid = true;
+    m_frame_syncs.clear();
+    for (int i = 0; i < 0x80; i++)
+    {
+        m_id_present[i] = false;
+        m_id_last_entry[i] = OCSD_BAD_TRC_INDEX;
+        m_id_state[i].align_pending = false;
+        m_id_state[i].ts_entry = -1;
+        m_id_state[i].ts_valid = false;
+    }
+}
+
+const std::vector<ocsd_sync_idx_entry_t> &TrcSyncIndexer::getEntries()
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+
+    if (!m_sorted_valid)
+    {
+        m_sorted = m_entries;
+        std::stable_sort(m_sorted.begin(), m_sorted.end(), entryLess);
+        m_sorted_valid = true;
+    }
+    return m_sorted;
+}
+
+/* ITrcSrcIndexCreator */
+ocsd_err_t TrcSyncIndexer::TrcIDIndex(const ocsd_trc_index_t /* src_idx */, const uint8_t ID)
+{
+    if (ID < 0x80)
+        m_id_present[ID] = true;
+    return OCSD_OK;
+}
+
+ocsd_err_t TrcSyncIndexer::TrcIDBlockMap(const ocsd_trc_index_t /* src_idx_start */, const std::vector<uint8_t> IDs)
+{
+    for (size_t i = 0; i < IDs.size(); i++)
+        TrcIDIndex(0, IDs[i]);
+    return OCSD_OK;
+}
+
+ocsd_err_t TrcSyncIndexer::TrcEventIndex(const ocsd_trc_index_t /* src_idx */, const int /* event_type */)
+{
+    return OCSD_OK;
+}
+
+void TrcSyncIndexer::TrcSyncIndex(const ocsd_trc_index_t src_idx)
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+
+    if (!m_active)
+        return;
+
+    // input restarted at an earlier index - previous sync points no longer valid.
+    if (m_frame_syncs.size() && (src_idx < m_frame_syncs.back()))
+        m_frame_syncs.clear();
+
+    if (m_frame_syncs.size() && (src_idx == m_frame_syncs.back()))
+        return;
+
+    m_frame_syncs.push_back(src_idx);
+    if (m_frame_syncs.size() > SYNC_IDX_FRAME_SYNC_HISTORY)
+        m_frame_syncs.pop_front();
+}
+
+/* packet monitor callbacks */
+void TrcSyncIndexer::indexPacket(const uint8_t ID, const ocsd_trc_index_t index_sop, const sync_pkt_class_t pkt_class, const uint64_t ts)
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    id_state_t &state = m_id_state[ID];
+
+    if (!m_active)
+        return;
+
+    switch (pkt_class)
+    {
+    case SYNC_PKT_ALIGN:
+        state.align_pending = true;
+        state.align_index = index_sop;
+        break;
+
+    case SYNC_PKT_TINFO:
+    case SYNC_PKT_ISYNC:
+        // only a restart point if it follows an alignment sync.
+        if (state.align_pending)
+        {
+            addEntry(ID, state.align_index, (pkt_class == SYNC_PKT_TINFO) ? OCSD_SYNC_IDX_TINFO : OCSD_SYNC_IDX_ISYNC);
+            state.align_pending = false;
+        }
+        break;
+
+    case SYNC_PKT_ASYNC:
+        addEntry(ID, index_sop, OCSD_SYNC_IDX_ASYNC);
+        break;
+
+    case SYNC_PKT_TS:
+        // first timestamp after the sync point replaces the last one before it.
+        if (state.ts_entry >= 0)
+        {
+            m_entries[state.ts_entry].timestamp = ts;
+            m_entries[state.ts_entry].flags |= OCSD_SYNC_IDX_FLG_TS_VALID;
+            state.ts_entry = -1;
+            m_sorted_valid = false;
+        }
+        state.ts = ts;
+        state.ts_valid = true;
+        break;
+
+    default:
+        break;
+    }
+}
+
+void TrcSyncIndexer::resetID(const uint8_t ID)
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    id_state_t &state = m_id_state[ID];
+
+    state.align_pending = false;
+    state.align_index = 0;
+    state.ts_entry = -1;
+    state.ts_valid = false;
+    state.ts = 0;
+}
+
+void TrcSyncIndexer::addEntry(const uint8_t ID, const ocsd_trc_index_t pkt_index, const ocsd_sync_idx_type_t type)
+{
+    ocsd_sync_idx_entry_t entry;
+    id_state_t &state = m_id_state[ID];
+
+    // already indexed - decode restarted at an earlier point.
+    if ((m_id_last_entry[ID] != OCSD_BAD_TRC_INDEX) && (pkt_index <= m_id_last_entry[ID]))
+        return;
+    m_id_last_entry[ID] = pkt_index;
+
+    entry.pkt_index = pkt_index;
+    entry.restart_index = getRestartIndex(pkt_index);
+    entry.timestamp = state.ts_valid ? state.ts : 0;
+    entry.trc_id = ID;
+    entry.type = (uint8_t)type;
+    entry.flags = state.ts_valid ? OCSD_SYNC_IDX_FLG_TS_VALID : 0;
+    entry.reserved = 0;
+
+    state.ts_entry = (int)m_entries.size();
+    m_entries.push_back(entry);
+    m_sorted_valid = false;
+}
+
+const bool TrcSyncIndexer::findSeekEntry(const uint64_t target, const bool bTimestamp, const uint8_t CSID, ocsd_sync_idx_entry_t &seek_entry)
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    int latest[0x80];
+    int seek_idx = -1;
+
+    // latest sync point at or before the target for each ID
+    for (int i = 0; i < 0x80; i++)
+        latest[i] = -1;
+
+    for (size_t i = 0; i < m_entries.size(); i++)
+    {
+        const ocsd_sync_idx_entry_t &entry = m_entries[i];
+        int &id_latest = latest[entry.trc_id];
+
+        if ((CSID != OCSD_BAD_CS_SRC_ID) && (entry.trc_id != CSID))
+            continue;
+
+        if (bTimestamp)
+        {
+            if (!(entry.flags & OCSD_SYNC_IDX_FLG_TS_VALID) || (entry.timestamp > target))
+                continue;
+            if ((id_latest < 0) || (entry.timestamp > m_entries[id_latest].timestamp) ||
+                ((entry.timestamp == m_entries[id_latest].timestamp) && (entry.pkt_index > m_entries[id_latest].pkt_index)))
+                id_latest = (int)i;
+        }
+        else
+        {
+            if (entry.pkt_index > target)
+                continue;
+            if ((id_latest < 0) || (entry.pkt_index > m_entries[id_latest].pkt_index))
+                id_latest = (int)i;
+        }
+    }
+
+    // earliest restart point that covers all the IDs
+    for (int i = 0; i < 0x80; i++)
+    {
+        if ((latest[i] >= 0) && ((seek_idx < 0) || (m_entries[latest[i]].restart_index < m_entries[seek_idx].restart_index)))
+            seek_idx = latest[i];
+    }
+
+    if (seek_idx < 0)
+        return false;
+    seek_entry = m_entries[seek_idx];
+    return true;
+}
+
+/* Restart input at the start of the frame containing the packet. Frame syncs reported by the
+   deformatter are the FSYNC positions, or the initial sync point for memory aligned frames */
+ocsd_trc_index_t TrcSyncIndexer::getRestartIndex(const ocsd_trc_index_t pkt_index)
+{
+    ocsd_trc_index_t sync_idx;
+
+    // packet processor only - restart at the packet.
+    if (!m_deformatter)
+        return pkt_index;
+
+    // latest frame sync at or before the packet.
+    std::deque<ocsd_trc_index_t>::reverse_iterator it = m_frame_syncs.rbegin();
+    while ((it != m_frame_syncs.rend()) && (*it > pkt_index))
+        it++;
+
+    if (m_deformatter->getConfigFlags() & OCSD_DFRMTR_FRAME_MEM_ALIGN)
+    {
+        sync_idx = (it != m_frame_syncs.rend()) ? *it : 0;
+        return sync_idx + ((pkt_index - sync_idx) & ~((ocsd_trc_index_t)OCSD_DFRMTR_FRAME_SIZE - 1));
+    }
+
+    // FSYNC frames - restart at the FSYNC before the frame.
+    return (it != m_frame_syncs.rend()) ? *it : pkt_index;
+}
+
+/* index files */
+ocsd_err_t TrcSyncIndexer::saveIndex(const std::string &filename)
+{
+    uint8_t buf[s_idx_entry_size];  // entry larger than header
+    const std::vector<ocsd_sync_idx_entry_t> &entries = getEntries();
+
+    std::ofstream out(filename.c_str(), std::ofstream::binary | std::ofstream::trunc);
+    if (!out.is_open())
+        return OCSD_ERR_SYNC_IDX_FILE;
+
+    memcpy(buf, s_idx_magic, sizeof(s_idx_magic));
+    putLE(buf + 8, s_idx_version, 4);
+    putLE(buf + 12, s_idx_entry_size, 4);
+    putLE(buf + 16, entries.size(), 8);
+    out.write((const char *)buf, s_idx_hdr_size);
+
+    for (size_t i = 0; i < entries.size(); i++)
+    {
+        putLE(buf, entries[i].pkt_index, 8);
+        putLE(buf + 8, entries[i].restart_index, 8);
+        putLE(buf + 16, entries[i].timestamp, 8);
+        buf[24] = entries[i].trc_id;
+        buf[25] = entries[i].type;
+        buf[26] = entries[i].flags;
+        buf[27] = entries[i].reserved;
+        out.write((const char *)buf, s_idx_entry_size);
+    }
+
+    out.close();
+    return out.fail() ? OCSD_ERR_SYNC_IDX_FILE : OCSD_OK;
+}
+
+ocsd_err_t TrcSyncIndexer::loadIndex(const std::string &filename)
+{
+    uint8_t buf[s_idx_entry_size];  // entry larger than header
+    ocsd_sync_idx_entry_t entry;
+    uint64_t num_entries;
+
+    std::ifstream in(filename.c_str(), std::ifstream::binary);
+    if (!in.is_open())
+        return OCSD_ERR_SYNC_IDX_FILE;
+
+    in.read((char *)buf, s_idx_hdr_size);
+    if (in.fail() ||
+        memcmp(buf, s_idx_magic, sizeof(s_idx_magic)) ||
+        (getLE(buf + 8, 4) != s_idx_version) ||
+        (getLE(buf + 12, 4) != s_idx_entry_size))
+        return OCSD_ERR_SYNC_IDX_FILE;
+    num_entries = getLE(buf + 16, 8);
+
+    clear();
+    std::lock_guard<std::mutex> lock(m_lock);
+    for (uint64_t i = 0; i < num_entries; i++)
+    {
+        in.read((char *)buf, s_idx_entry_size);
+        // reject corrupt entries - unknown ID or sync type, or restart after the sync point.
+        if (in.fail() || (buf[24] >= 0x80) || (buf[25] > OCSD_SYNC_IDX_ISYNC) ||
+            (getLE(buf + 8, 8) > getLE(buf, 8)))
+        {
+            m_entries.clear();
+            for (int id = 0; id < 0x80; id++)
+            {
+                m_id_present[id] = false;
+                m_id_last_entry[id] = OCSD_BAD_TRC_INDEX;
+            }
+            return OCSD_ERR_SYNC_IDX_FILE;
+        }
+        entry.pkt_index = getLE(buf, 8);
+        entry.restart_index = getLE(buf + 8, 8);
+        entry.timestamp = getLE(buf + 16, 8);
+        entry.trc_id = buf[24];
+        entry.type = buf[25];
+        entry.flags = buf[26];
+        entry.reserved = buf[27];
+        m_entries.push_back(entry);
+        m_id_present[entry.trc_id] = true;
+        if ((m_id_last_entry[entry.trc_id] == OCSD_BAD_TRC_INDEX) || (entry.pkt_index > m_id_last_entry[entry.trc_id]))
+            m_id_last_entry[entry.trc_id] = entry.pkt_index;
+    }
+    m_sorted_valid = false;
+    return OCSD_OK;
+}
+
+/* End of File trc_sync_indexer.cpp */
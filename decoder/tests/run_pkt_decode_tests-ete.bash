@@ -139,3 +139,9 @@ do
     ${BIN_DIR}trc_pkt_lister -ss_dir "${SNAPSHOT_DIR}/$test_dir_ms" $@ -decode -no_time_print -multi_session -logfilename "${OUT_DIR}/${test_dir_ms}_multi_sess.ppl"
     echo "Done : Return $?"
 done
+
+echo "Test Q elements and source address N atoms with instruction block cache on..."
+${BIN_DIR}trc_pkt_lister -ss_dir "${SNAPSHOT_DIR}/q_elem" $@ -decode -no_time_print -instr_blk_cache -logfilename "${OUT_DIR}/q_elem_instr_blk_cache.ppl"
+echo "Done : Return $?"
+${BIN_DIR}trc_pkt_lister -ss_dir "${SNAPSHOT_DIR}/src_addr" $@ -decode -no_time_print -src_addr_n -instr_blk_cache -logfilename "${OUT_DIR}/src_addr_src_addr_N_instr_blk_cache.ppl"
+echo "Done : Return $?"
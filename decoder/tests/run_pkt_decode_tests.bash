@@ -50,6 +50,9 @@ OUT_DIR=./results
 SNAPSHOT_DIR=./snapshots
 BIN_DIR=./bin/linux64/rel/
 
+# set by tests that check their output - script fails at the end if set.
+test_fail=0
+
 # directories for tests using full decode
 declare -a test_dirs_decode=( "juno-ret-stck"
                               "a57_single_step"
@@ -121,6 +124,293 @@ echo "Test with bad opcode detect on using flag..."
 ${BIN_DIR}trc_pkt_lister -ss_dir "${SNAPSHOT_DIR}/juno_r1_1" $@ -decode -no_time_print -aa64_opcode_chk -logfilename "${OUT_DIR}/juno_r1_1_badopcode_flag.ppl"
 echo "Done : Return $?"
 
+echo "Test with instruction block cache on..."
+${BIN_DIR}trc_pkt_lister -ss_dir "${SNAPSHOT_DIR}/juno_r1_1" $@ -decode -no_time_print -instr_blk_cache_n 256 -logfilename "${OUT_DIR}/juno_r1_1_instr_blk_cache.ppl"
+echo "Done : Return $?"
+${BIN_DIR}trc_pkt_lister -ss_dir "${SNAPSHOT_DIR}/tc2-ptm-rstk-t32" $@ -decode -no_time_print -instr_blk_cache -logfilename "${OUT_DIR}/tc2-ptm-rstk-t32_instr_blk_cache.ppl"
+echo "Done : Return $?"
+
+echo "Test with ETMv3 coalesced instruction ranges..."
+${BIN_DIR}trc_pkt_lister -ss_dir "${SNAPSHOT_DIR}/TC2" $@ -decode -no_time_print -etm3_ranges -logfilename "${OUT_DIR}/TC2_etm3_ranges.ppl"
+echo "Done : Return $?"
+
+echo "Test with element type output mask - no sync, trace on, EOT, PE context and instruction range..."
+${BIN_DIR}trc_pkt_lister -ss_dir "${SNAPSHOT_DIR}/juno_r1_1" $@ -decode -no_time_print -elem_out_mask 0x3E -logfilename "${OUT_DIR}/juno_r1_1_elem_out_mask.ppl"
+echo "Done : Return $?"
+${BIN_DIR}trc_pkt_lister -ss_dir "${SNAPSHOT_DIR}/TC2" $@ -decode -no_time_print -elem_out_mask 0x3E -logfilename "${OUT_DIR}/TC2_elem_out_mask.ppl"
+echo "Done : Return $?"
+
+echo "Test with memory mapped file accessors..."
+${BIN_DIR}trc_pkt_lister -ss_dir "${SNAPSHOT_DIR}/test-file-mem-offsets" $@ -decode -no_time_print -macc_file_mmap -logfilename "${OUT_DIR}/test-file-mem-offsets_mmap.ppl"
+echo "Done : Return $?"
+
+echo "Test with batched generic element output..."
+${BIN_DIR}trc_pkt_lister -ss_dir "${SNAPSHOT_DIR}/juno_r1_1" $@ -decode_only -no_time_print -gen_elem_batch 64 -logfilename "${OUT_DIR}/juno_r1_1_gen_elem_batch.ppl"
+echo "Done : Return $?"
+
+echo "Test with threaded decode..."
+${BIN_DIR}trc_pkt_lister -ss_dir "${SNAPSHOT_DIR}/juno_r1_1" $@ -decode -id 0x10 -no_time_print -threaded -logfilename "${OUT_DIR}/juno_r1_1_threaded.ppl"
+echo "Done : Return $?"
+
+# threaded decode must output the same packets, elements and errors per trace ID as a single thread - 
+# IDs decode in parallel so compare output sorted by ID, keeping the order within each ID.
+echo "Compare threaded and single thread multi-ID decode output..."
+declare -a thread_cmp_dirs=( "juno_r1_1" "TC2" "Snowball" "stm_only" "a55-test-tpiu" )
+for test_dir in "${thread_cmp_dirs[@]}"; do
+    rm -f "${OUT_DIR}/${test_dir}_single_thread.ppl" "${OUT_DIR}/${test_dir}_multi_thread.ppl"
+    ${BIN_DIR}trc_pkt_lister -ss_dir "${SNAPSHOT_DIR}/${test_dir}" $@ -decode -no_time_print -logfilename "${OUT_DIR}/${test_dir}_single_thread.ppl"
+    ${BIN_DIR}trc_pkt_lister -ss_dir "${SNAPSHOT_DIR}/${test_dir}" $@ -decode -no_time_print -threaded -logfilename "${OUT_DIR}/${test_dir}_multi_thread.ppl"
+    if diff <(grep "^Idx:\|ERR" "${OUT_DIR}/${test_dir}_single_thread.ppl" | sort -s -t';' -k2,2) <(grep "^Idx:\|ERR" "${OUT_DIR}/${test_dir}_multi_thread.ppl" | sort -s -t';' -k2,2) > /dev/null; then
+        echo "Done : ${test_dir} threaded output matches"
+    else
+        echo "FAILED : ${test_dir} threaded output differs from single thread decode"
+        test_fail=1
+    fi
+done
+
+echo "Test with deformatter ID runs..."
+${BIN_DIR}trc_pkt_lister -ss_dir "${SNAPSHOT_DIR}/juno_r1_1" $@ -decode_only -no_time_print -dfmt_id_runs -logfilename "${OUT_DIR}/juno_r1_1_dfmt_id_runs.ppl"
+echo "Done : Return $?"
+
+echo "Test with sync point indexing..."
+${BIN_DIR}trc_pkt_lister -ss_dir "${SNAPSHOT_DIR}/TC2" $@ -no_time_print -sync_index "${OUT_DIR}/TC2_sync.idx" -logfilename "${OUT_DIR}/TC2_sync_index.ppl"
+echo "Done : Return $?"
+
+echo "Test seek using the sync index..."
+${BIN_DIR}trc_pkt_lister -ss_dir "${SNAPSHOT_DIR}/TC2" $@ -decode -no_time_print -load_sync_index "${OUT_DIR}/TC2_sync.idx" -seek 20000 -logfilename "${OUT_DIR}/TC2_seek.ppl"
+echo "Done : Return $?"
+
+# unknown sync type in the first entry - the index file must be rejected.
+echo "Test corrupt sync index rejected..."
+rm -f "${OUT_DIR}/TC2_bad_sync_idx.ppl"
+cp "${OUT_DIR}/TC2_sync.idx" "${OUT_DIR}/TC2_bad_sync.idx"
+printf '\x07' | dd of="${OUT_DIR}/TC2_bad_sync.idx" bs=1 seek=49 conv=notrunc 2> /dev/null
+${BIN_DIR}trc_pkt_lister -ss_dir "${SNAPSHOT_DIR}/TC2" $@ -decode -no_time_print -load_sync_index "${OUT_DIR}/TC2_bad_sync.idx" -seek 20000 -logfilename "${OUT_DIR}/TC2_bad_sync_idx.ppl"
+if grep -q "Failed to load sync index" "${OUT_DIR}/TC2_bad_sync_idx.ppl"; then
+    echo "Done : corrupt sync index rejected"
+else
+    echo "FAILED : corrupt sync index loaded"
+    test_fail=1
+fi
+
+# deformatter ID runs give approximate packet indexes - indexing and seek must be rejected.
+echo "Test sync index and seek rejected with deformatter ID runs..."
+rm -f "${OUT_DIR}/juno_r1_1_id_runs_sync_index.ppl" "${OUT_DIR}/juno_r1_1_id_runs_seek.ppl"
+${BIN_DIR}trc_pkt_lister -ss_dir "${SNAPSHOT_DIR}/juno_r1_1" $@ -no_time_print -dfmt_id_runs -sync_index "${OUT_DIR}/juno_r1_1_id_runs.idx" -logfilename "${OUT_DIR}/juno_r1_1_id_runs_sync_index.ppl"
+${BIN_DIR}trc_pkt_lister -ss_dir "${SNAPSHOT_DIR}/juno_r1_1" $@ -decode -no_time_print -dfmt_id_runs -load_sync_index "${OUT_DIR}/TC2_sync.idx" -seek 20000 -logfilename "${OUT_DIR}/juno_r1_1_id_runs_seek.ppl"
+if grep -q "Failed to set sync indexing" "${OUT_DIR}/juno_r1_1_id_runs_sync_index.ppl" &&
+   grep -q "Failed to load sync index" "${OUT_DIR}/juno_r1_1_id_runs_seek.ppl" &&
+   grep -q "Seek failed" "${OUT_DIR}/juno_r1_1_id_runs_seek.ppl"; then
+    echo "Done : sync index and seek rejected with ID runs"
+else
+    echo "FAILED : sync index or seek accepted with deformatter ID runs"
+    test_fail=1
+fi
+
+echo "Test with chunked decode..."
+${BIN_DIR}trc_pkt_lister -ss_dir "${SNAPSHOT_DIR}/juno_r1_1" $@ -decode_only -id 0x10 -no_time_print -chunked 1024 -logfilename "${OUT_DIR}/juno_r1_1_chunked.ppl"
+echo "Done : Return $?"
+
+# chunked decode must output the same elements and errors as a single decoder - fail the script on any difference.
+echo "Compare chunked and single decoder output..."
+declare -a chunk_cmp_dirs=( "bugfix-exact-match" "juno-uname-002" "a55-test-tpiu" )
+declare -a chunk_cmp_opts=( "-id 0x12" "-id 0x16" "" )
+for i in "${!chunk_cmp_dirs[@]}"; do
+    test_dir=${chunk_cmp_dirs[$i]}
+    rm -f "${OUT_DIR}/${test_dir}_unchunked.ppl" "${OUT_DIR}/${test_dir}_chunked.ppl"
+    ${BIN_DIR}trc_pkt_lister -ss_dir "${SNAPSHOT_DIR}/${test_dir}" $@ -decode_only ${chunk_cmp_opts[$i]} -no_time_print -logfilename "${OUT_DIR}/${test_dir}_unchunked.ppl"
+    ${BIN_DIR}trc_pkt_lister -ss_dir "${SNAPSHOT_DIR}/${test_dir}" $@ -decode_only ${chunk_cmp_opts[$i]} -no_time_print -chunked 1024 -logfilename "${OUT_DIR}/${test_dir}_chunked.ppl"
+    if diff <(grep "^Idx:\|ERR" "${OUT_DIR}/${test_dir}_unchunked.ppl") <(grep "^Idx:\|ERR" "${OUT_DIR}/${test_dir}_chunked.ppl") > /dev/null; then
+        echo "Done : ${test_dir} chunked output matches"
+    else
+        echo "FAILED : ${test_dir} chunked output differs from single decoder"
+        test_fail=1
+    fi
+done
+
+echo "Test with ring buffer input..."
+${BIN_DIR}trc_pkt_lister -ss_dir "${SNAPSHOT_DIR}/juno_r1_1" $@ -decode -no_time_print -ring_buf 4096 -logfilename "${OUT_DIR}/juno_r1_1_ring_buf.ppl"
+echo "Done : Return $?"
+${BIN_DIR}trc_pkt_lister -ss_dir "${SNAPSHOT_DIR}/juno_r1_1" $@ -decode -no_time_print -ring_buf_lossy -logfilename "${OUT_DIR}/juno_r1_1_ring_buf_lossy.ppl"
+echo "Done : Return $?"
+rm -f "${OUT_DIR}/juno_r1_1_ring_buf_lap_dcd.ppl"
+${BIN_DIR}trc_pkt_lister -ss_dir "${SNAPSHOT_DIR}/juno_r1_1" $@ -decode -no_time_print -ring_buf_lap_dcd -logfilename "${OUT_DIR}/juno_r1_1_ring_buf_lap_dcd.ppl"
+if grep -q "overwrite during decode not detected" "${OUT_DIR}/juno_r1_1_ring_buf_lap_dcd.ppl"; then
+    echo "FAILED : ring buffer overwrite during decode not detected"
+    test_fail=1
+else
+    echo "Done : ring buffer overwrite during decode detected"
+fi
+
+# one memory aligned frame of junk for trace ID $1 - 14 data bytes given as hex in $2..$15.
+junk_frame() {
+    local id=$1 aux=0 frame i b
+    shift
+    frame=$(printf '\\x%02x' $(( (id << 1) | 1 )))
+    for (( i = 1; i <= 14; i++ )); do
+        b=$(( 0x${!i} ))
+        # data in even bytes has the LSB in the flag byte.
+        if (( i % 2 == 0 )); then
+            aux=$(( aux | ((b & 1) << (i / 2)) ))
+            b=$(( b & 0xFE ))
+        fi
+        frame+=$(printf '\\x%02x' $b)
+    done
+    frame+=$(printf '\\x%02x' $aux)
+    printf "${frame}"
+}
+
+# junk for each ID with no complete sync sequence - runs with no sync candidate bytes, short 0x00 
+# runs ending in 0x80 and long 0x00 / 0xFF runs ending in other values. Ends with a frame switching 
+# to ID 0 so the first data in the real trace is discarded as before.
+junk_prefix() {
+    local id n
+    for id in "$@"; do
+        for (( n = 0; n < 4; n++ )); do
+            junk_frame ${id} 5a a5 3c c3 12 34 56 78 9a bc de f0 11 22
+            junk_frame ${id} 5a a5 3c c3 12 34 56 78 9a bc de f0 11 22
+            junk_frame ${id} 00 00 00 00 80 55 ff ff ff ff ff ff ff ff
+            junk_frame ${id} 0f 55 00 00 00 00 00 00 00 00 00 00 55 5a
+        done
+    done
+    junk_frame 0 00 00 00 00 00 00 00 00 00 00 00 00 00 00
+}
+
+# junk before the trace in the buffer must be skipped by the resync scans without changing the decode - 
+# ETMv4 in juno_r1_1, ETMv3 and PTM in TC2 and STM in stm_only. IDs with no trace get no junk. Compare 
+# elements with and without packet monitors against the unmodified snapshot per ID, ignoring the trace 
+# indexes moved by the junk.
+echo "Test resync through junk before the trace..."
+declare -a junk_dirs=( "juno_r1_1:cstrace.bin:0x10 0x11 0x12 0x13 0x15"
+                       "TC2:cstrace.bin:0x10 0x11 0x12 0x13"
+                       "stm_only:cstraceitm.bin:0x20" )
+for junk_test in "${junk_dirs[@]}"; do
+    IFS=':' read -r test_dir trace_file junk_ids <<< "${junk_test}"
+    junk_dir="${OUT_DIR}/junk_${test_dir}"
+    rm -rf "${junk_dir}"
+    cp -r "${SNAPSHOT_DIR}/${test_dir}" "${junk_dir}"
+    { junk_prefix ${junk_ids}; cat "${SNAPSHOT_DIR}/${test_dir}/${trace_file}"; } > "${junk_dir}/${trace_file}"
+    rm -f "${OUT_DIR}/${test_dir}_junk.ppl" "${OUT_DIR}/${test_dir}_junk_no_mon.ppl"
+    ${BIN_DIR}trc_pkt_lister -ss_dir "${junk_dir}" $@ -decode -no_time_print -logfilename "${OUT_DIR}/${test_dir}_junk.ppl"
+    ${BIN_DIR}trc_pkt_lister -ss_dir "${junk_dir}" $@ -decode_only -no_time_print -logfilename "${OUT_DIR}/${test_dir}_junk_no_mon.ppl"
+    for junk_out in "${test_dir}_junk" "${test_dir}_junk_no_mon"; do
+        if diff <(grep "OCSD_GEN_TRC_ELEM" "${OUT_DIR}/${test_dir}.ppl" | sed 's/^Idx:[0-9]*;//' | sort -s -t';' -k1,1) <(grep "OCSD_GEN_TRC_ELEM" "${OUT_DIR}/${junk_out}.ppl" | sed 's/^Idx:[0-9]*;//' | sort -s -t';' -k1,1) > /dev/null; then
+            echo "Done : ${junk_out} output matches"
+        else
+            echo "FAILED : ${junk_out} output differs from decode without junk"
+            test_fail=1
+        fi
+    done
+done
+
+# reference AutoFDO counts, built from the printed element output of a full decode in the same way as the 
+# profile shards - sorted "from-to:count" range and "from->to:count" branch lines.
+afdo_ref_counts() {
+    grep "OCSD_GEN_TRC_ELEM_" "$1" | awk '
+    function hexsub(h, n,    i, d, out, hx) {
+        hx = "0123456789abcdef"
+        out = ""
+        for (i = length(h); i > 0; i--) {
+            d = index(hx, substr(h, i, 1)) - 1 - n
+            n = 0
+            if (d < 0) { d += 16; n = 1 }
+            out = substr(hx, d + 1, 1) out
+        }
+        sub(/^0+/, "", out)
+        return (out == "") ? "0" : out
+    }
+    function end_range(id, br_valid, tgt) {
+        if (open[id]) {
+            ranges[st[id] "-" last[id]]++
+            if (taken[id] && br_valid)
+                branches[last[id] "->" tgt]++
+            open[id] = 0
+        }
+    }
+    {
+        match($0, /ID:[0-9a-f]+;/)
+        id = substr($0, RSTART + 3, RLENGTH - 4)
+    }
+    /OCSD_GEN_TRC_ELEM_INSTR_RANGE\(/ {
+        match($0, /range=0x[0-9a-f]+:\[0x[0-9a-f]+\]/)
+        split(substr($0, RSTART + 8, RLENGTH - 9), a, /:\[0x/)
+        match($0, /last_sz\([0-9]+\)/)
+        sz = substr($0, RSTART + 8, RLENGTH - 9) + 0
+        if (open[id] && (taken[id] || (a[1] != en[id])))
+            end_range(id, 1, a[1])
+        if (!open[id]) { open[id] = 1; st[id] = a[1] }
+        en[id] = a[2]
+        last[id] = hexsub(a[2], sz)
+        taken[id] = ($0 ~ / E (BR  |iBR )/)
+        next
+    }
+    /OCSD_GEN_TRC_ELEM_EXCEPTION\(/ {
+        tgt = ""
+        if (match($0, /pref ret addr:0x[0-9a-f]+/))
+            tgt = substr($0, RSTART + 16, RLENGTH - 16)
+        end_range(id, ($0 ~ /addr also prev br tgt/), tgt)
+        next
+    }
+    /OCSD_GEN_TRC_ELEM_PE_CONTEXT\(/ {
+        c = $0
+        sub(/.*OCSD_GEN_TRC_ELEM_PE_CONTEXT\(\(ISA=[^)]*\) /, "", c)
+        sub(/ *\[CC=[^]]*\];/, "", c)
+        sub(/ *\) *$/, "", c)
+        if ((id in ctxt) && (ctxt[id] != c))
+            end_range(id, 0, "")
+        ctxt[id] = c
+        next
+    }
+    /OCSD_GEN_TRC_ELEM_(NO_SYNC|TRACE_ON|EO_TRACE|I_RANGE_NOPATH|ADDR_NACC|ADDR_UNKNOWN|EXCEPTION_RET)\(/ {
+        end_range(id, 0, "")
+    }
+    END {
+        for (id in open)
+            end_range(id, 0, "")
+        for (r in ranges)
+            print r ":" ranges[r]
+        for (b in branches)
+            print b ":" branches[b]
+    }' | LC_ALL=C sort
+}
+
+# profile entries without the section sizes, sorted as the reference.
+afdo_profile_counts() {
+    grep -v "^[0-9]*$" "$1" | LC_ALL=C sort
+}
+
+echo "Test AutoFDO profile aggregation..."
+rm -f "${OUT_DIR}/juno_r1_1_afdo.ppl" "${OUT_DIR}/TC2_afdo_threaded.ppl"
+${BIN_DIR}trc_pkt_lister -ss_dir "${SNAPSHOT_DIR}/juno_r1_1" $@ -no_time_print -afdo_profile "${OUT_DIR}/juno_r1_1_afdo.txt" -logfilename "${OUT_DIR}/juno_r1_1_afdo.ppl"
+echo "Done : Return $?"
+${BIN_DIR}trc_pkt_lister -ss_dir "${SNAPSHOT_DIR}/TC2" $@ -no_time_print -threaded -afdo_profile "${OUT_DIR}/TC2_afdo_threaded.txt" -logfilename "${OUT_DIR}/TC2_afdo_threaded.ppl"
+echo "Done : Return $?"
+for test_dir in "juno_r1_1:juno_r1_1_afdo" "TC2:TC2_afdo_threaded"; do
+    if diff <(afdo_ref_counts "${OUT_DIR}/${test_dir%%:*}.ppl") <(afdo_profile_counts "${OUT_DIR}/${test_dir##*:}.txt") > /dev/null; then
+        echo "Done : ${test_dir##*:} profile matches the decoded element counts"
+    else
+        echo "FAILED : ${test_dir##*:} profile differs from the decoded element counts"
+        test_fail=1
+    fi
+done
+
+# juno_r1_1 trace is all in context ID 0.
+rm -f "${OUT_DIR}/juno_r1_1_afdo_ctxt.ppl" "${OUT_DIR}/juno_r1_1_afdo_no_ctxt.ppl"
+${BIN_DIR}trc_pkt_lister -ss_dir "${SNAPSHOT_DIR}/juno_r1_1" $@ -no_time_print -afdo_profile "${OUT_DIR}/juno_r1_1_afdo_ctxt.txt" -afdo_ctxt_id 0 -logfilename "${OUT_DIR}/juno_r1_1_afdo_ctxt.ppl"
+${BIN_DIR}trc_pkt_lister -ss_dir "${SNAPSHOT_DIR}/juno_r1_1" $@ -no_time_print -afdo_profile "${OUT_DIR}/juno_r1_1_afdo_no_ctxt.txt" -afdo_ctxt_id 1 -logfilename "${OUT_DIR}/juno_r1_1_afdo_no_ctxt.ppl"
+if cmp -s "${OUT_DIR}/juno_r1_1_afdo.txt" "${OUT_DIR}/juno_r1_1_afdo_ctxt.txt" && [ "$(cat "${OUT_DIR}/juno_r1_1_afdo_no_ctxt.txt" | tr '\n' ' ')" == "0 0 0 " ]; then
+    echo "Done : AutoFDO context filter"
+else
+    echo "FAILED : AutoFDO context filter"
+    test_fail=1
+fi
+
+echo "Test strobed trace decode..."
+${BIN_DIR}trc_pkt_lister -ss_dir "${SNAPSHOT_DIR}/juno_r1_1" $@ -decode -no_time_print -strobed -logfilename "${OUT_DIR}/juno_r1_1_strobed.ppl"
+echo "Done : Return $?"
+${BIN_DIR}trc_pkt_lister -ss_dir "${SNAPSHOT_DIR}/juno_r1_1" $@ -decode -no_time_print -strobed -ring_buf_lossy -logfilename "${OUT_DIR}/juno_r1_1_strobed_lossy.ppl"
+echo "Done : Return $?"
+
 # === test a packet only example ===
 echo "Testing init-short-addr..."
 ${BIN_DIR}trc_pkt_lister -ss_dir "${SNAPSHOT_DIR}/init-short-addr" $@ -pkt_mon -no_time_print -logfilename "${OUT_DIR}/init-short-addr.ppl"
@@ -141,6 +431,56 @@ if [ "$1" != "use-installed" ]; then
     echo "moving result file."
     mv ./c_api_test.log ./${OUT_DIR}/c_api_test.ppl
 
+    # index recorded during decode must save and reload - decoded output unchanged.
+    echo "Testing C-API sync index"
+    rm -f ./${OUT_DIR}/c_api_sync_index.ppl
+    ${BIN_DIR}c_api_pkt_print_test -ss_path ${SNAPSHOT_DIR} -decode_only -test_sync_index -logfilename ./${OUT_DIR}/c_api_sync_index.ppl > /dev/null
+    echo "Done : Return $?"
+    mv ./c_api_test_sync.idx ./${OUT_DIR}/.
+    if grep -q "^Sync index: [1-9][0-9]* sync points recorded" ./${OUT_DIR}/c_api_sync_index.ppl &&
+       diff <(grep "TrcID" ./${OUT_DIR}/c_api_test.ppl) <(grep "TrcID" ./${OUT_DIR}/c_api_sync_index.ppl) > /dev/null; then
+        echo "Done : C-API sync index"
+    else
+        echo "FAILED : C-API sync index"
+        test_fail=1
+    fi
+
+    # decode after seek to an index and a timestamp must match the full decode - PTM trace has timestamps.
+    echo "Testing C-API seek"
+    for test_proto in "etmv4" "ptm"; do
+        test_opt=""
+        [ "${test_proto}" != "etmv4" ] && test_opt="-${test_proto}"
+        rm -f ./${OUT_DIR}/c_api_seek_${test_proto}.ppl
+        ${BIN_DIR}c_api_pkt_print_test -ss_path ${SNAPSHOT_DIR} -decode_only ${test_opt} -test_seek -logfilename ./${OUT_DIR}/c_api_seek_${test_proto}.ppl > /dev/null
+        if [ $? -eq 0 ] && grep -q "^Seek: decode after seek matches full decode" ./${OUT_DIR}/c_api_seek_${test_proto}.ppl; then
+            echo "Done : C-API seek ${test_proto}"
+        else
+            echo "FAILED : C-API seek ${test_proto}"
+            test_fail=1
+        fi
+    done
+    rm -f ./c_api_test_sync.idx
+    if ! grep -q "^Seek to timestamp" ./${OUT_DIR}/c_api_seek_ptm.ppl; then
+        echo "FAILED : C-API seek to timestamp not tested"
+        test_fail=1
+    fi
+
+    # ring buffer input must decode as the file input - lost data resets the decoder at each discontinuity.
+    echo "Testing C-API ring buffer input"
+    rm -f ./${OUT_DIR}/c_api_ring_buf.ppl ./${OUT_DIR}/c_api_ring_buf_lost.ppl
+    ${BIN_DIR}c_api_pkt_print_test -ss_path ${SNAPSHOT_DIR} -decode_only -test_ring_buf -logfilename ./${OUT_DIR}/c_api_ring_buf.ppl > /dev/null
+    ring_buf_ret=$?
+    ${BIN_DIR}c_api_pkt_print_test -ss_path ${SNAPSHOT_DIR} -decode_only -test_ring_buf_lost -logfilename ./${OUT_DIR}/c_api_ring_buf_lost.ppl > /dev/null
+    ring_buf_lost_ret=$?
+    if [ ${ring_buf_ret} -eq 0 ] && [ ${ring_buf_lost_ret} -eq 0 ] &&
+       diff <(grep "TrcID" ./${OUT_DIR}/c_api_test.ppl) <(grep "TrcID" ./${OUT_DIR}/c_api_ring_buf.ppl) > /dev/null &&
+       [ "$(grep -c "NO_SYNC( \[reset-decoder\])" ./${OUT_DIR}/c_api_ring_buf_lost.ppl)" == "2" ]; then
+        echo "Done : C-API ring buffer input"
+    else
+        echo "FAILED : C-API ring buffer input"
+        test_fail=1
+    fi
+
     # === run the Frame decoder test ===
     echo "Running Frame demux test"
     ${BIN_DIR}frame-demux-test > /dev/null
@@ -171,3 +511,8 @@ if [ "$1" != "use-installed" ]; then
     ${BIN_DIR}itm-decode-test -decode -logfilename  "${OUT_DIR}/itm-decode-test.ppl" 
     echo "Done : Return $?"
 fi
+
+if [ ${test_fail} -ne 0 ]; then
+    echo "FAILED : output check tests"
+    exit 1
+fi
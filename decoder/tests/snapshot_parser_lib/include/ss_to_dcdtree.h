@@ -58,6 +58,9 @@ public:
     const char *getBufferFileName() const { return m_BufferFileName.c_str(); };
     std::string getBufferFileNameFromBuffName(const std::string& buff_name);
 
+    // use memory mapped file accessors for the snapshot dump files.
+    void setMemAccFileMmap(const bool use_mmap) { m_bMemAccFileMmap = use_mmap; };
+
     // TBD: add in filters for ID list, first ID found.
 
 private:
@@ -104,6 +107,7 @@ private:
     ocsd_hndl_err_log_t m_errlog_handle;
 
     bool m_bPacketProcOnly;
+    bool m_bMemAccFileMmap;
     std::string m_BufferFileName;
 
     CoreArchProfileMap m_arch_profiles;
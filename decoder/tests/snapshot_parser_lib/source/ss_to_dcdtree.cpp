@@ -42,6 +42,7 @@ CreateDcdTreeFromSnapShot::CreateDcdTreeFromSnapShot() :
     m_pReader(0),
     m_pErrLogInterface(0),    
     m_bPacketProcOnly(false),
+    m_bMemAccFileMmap(false),
     m_BufferFileName("")
 {
     m_errlog_handle = 0;
@@ -387,7 +388,9 @@ bool CreateDcdTreeFromSnapShot::createETMv3Decoder(const std::string &coreName,
     {
         EtmV3Config config(&cfg_regs);
         ocsd_err_t err = OCSD_OK;
-        err = m_pDecodeTree->createDecoder(OCSD_BUILTIN_DCD_ETMV3, m_bPacketProcOnly ? OCSD_CREATE_FLG_PACKET_PROC : OCSD_CREATE_FLG_FULL_DECODER,&config);
+        // only the ETMv3 decode options - other protocol flags share values with the ETMv3 packet processor.
+        uint32_t create_flags = m_add_create_flags & ETMV3_OPFLG_PKTDEC_COALESCE_RANGES;
+        err = m_pDecodeTree->createDecoder(OCSD_BUILTIN_DCD_ETMV3, create_flags | (m_bPacketProcOnly ? OCSD_CREATE_FLG_PACKET_PROC : OCSD_CREATE_FLG_FULL_DECODER),&config);
 
         if(err ==  OCSD_OK)
             createdDecoder = true;
@@ -676,7 +679,7 @@ ocsd_err_t CreateDcdTreeFromSnapShot::processDumpfiles(std::vector<Parser::DumpD
         // ensure we respect optional length and offset parameter and
         // allow multiple dump entries with same file name to define regions
         if (!TrcMemAccessorFile::isExistingFileAccessor(dumpFilePathName))
-            err = m_pDecodeTree->addBinFileRegionMemAcc(&region, 1, mem_space, dumpFilePathName);
+            err = m_pDecodeTree->addBinFileRegionMemAcc(&region, 1, mem_space, dumpFilePathName, m_bMemAccFileMmap);
         else
             err = m_pDecodeTree->updateBinFileRegionMemAcc(&region, 1, mem_space, dumpFilePathName);
         if(err != OCSD_OK)
@@ -51,6 +51,7 @@
 #include <string.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <inttypes.h>
 
 /* include the C-API library header */
 #include "opencsd/c_api/opencsd_c_api.h"
@@ -116,9 +117,30 @@ static int test_printstr = 0;
 /* test the library printer API */
 static int test_lib_printers = 0;
 
+/* test the batched generic element output API */
+static int test_batch_out = 0;
+
 /* test the last error / error code api */
 static int test_error_api = 0;
 
+/* test the sync index and seek API */
+static int test_sync_index = 0;
+static int test_seek = 0;
+const char *sync_index_filename = "c_api_test_sync.idx";
+
+/* seek test - number of elements output at or after each sync point */
+static ocsd_sync_idx_entry_t *seek_entries = 0;
+static uint64_t seek_num_entries = 0;
+static uint32_t *seek_elem_counts = 0;
+
+/* test the ring buffer input API - file written into the buffer in blocks, as a live producer */
+#define RING_BUF_SIZE 4096
+static int test_ring_buf = 0;
+static int test_ring_buf_lost = 0;
+static uint8_t ring_buf[RING_BUF_SIZE];
+static volatile uint64_t ring_buf_head = 0;
+static volatile uint64_t ring_buf_tail = 0;
+
 /* log statistics */
 static int stats = 0;
 
@@ -210,6 +232,28 @@ static int process_cmd_line(int argc, char *argv[])
         {
             test_lib_printers = 1;
         }
+        else if (strcmp(argv[idx], "-test_batch") == 0)
+        {
+            test_batch_out = 1;
+        }
+        else if (strcmp(argv[idx], "-test_sync_index") == 0)
+        {
+            test_sync_index = 1;
+        }
+        else if (strcmp(argv[idx], "-test_seek") == 0)
+        {
+            test_sync_index = 1;
+            test_seek = 1;
+        }
+        else if (strcmp(argv[idx], "-test_ring_buf") == 0)
+        {
+            test_ring_buf = 1;
+        }
+        else if (strcmp(argv[idx], "-test_ring_buf_lost") == 0)
+        {
+            test_ring_buf = 1;
+            test_ring_buf_lost = 1;
+        }
         else if (strcmp(argv[idx], "-ss_path") == 0)
         {
             idx++;
@@ -278,6 +322,10 @@ static void print_cmd_line_help()
     printf("-decode | -decode_only : full decode + trace packets / full decode packets only (default trace packets only)\n");
     printf("-raw / -raw_packed: print raw unpacked / packed data;\n");
     printf("-test_printstr | -test_libprint : ttest lib printstr callback | test lib based packet printers\n");
+    printf("-test_batch : test batched generic element output callback\n");
+    printf("-test_sync_index : test sync point indexing - record, save and reload the index\n");
+    printf("-test_seek : test seek to an index and a timestamp using the reloaded sync index (implies -test_sync_index)\n");
+    printf("-test_ring_buf | -test_ring_buf_lost : test ring buffer input [producer laps the decoder once and marks lost data once]\n");
     printf("-test_region_file | -test_cb | -test_cb_id : mem accessor - test multi region file API | test callback API [with trcid] (default single memory file)\n\n");
     printf("-ss_path <path> : path from cwd to /snapshots/ directory. Test prog will append required test subdir\n");
     printf("-direct_br_cond | -strict_br_cond | -range_cont : Decoder checks for inconsistent program images.\n");
@@ -588,6 +636,16 @@ ocsd_datapath_resp_t gen_trace_elem_print(const void *p_context, const ocsd_trc_
 {
     ocsd_datapath_resp_t resp = OCSD_RESP_CONT;
     int offset = 0;
+    uint64_t i;
+
+    /* seek test - count elements from each sync point. Decode restarted at a sync point 
+       outputs the trace on and PE context again, so these are not counted. */
+    for (i = 0; (i < seek_num_entries) && (elem->elem_type != OCSD_GEN_TRC_ELEM_PE_CONTEXT) && 
+                (elem->elem_type != OCSD_GEN_TRC_ELEM_TRACE_ON) && (elem->elem_type != OCSD_GEN_TRC_ELEM_NO_SYNC); i++)
+    {
+        if (index_sop >= seek_entries[i].pkt_index)
+            seek_elem_counts[i]++;
+    }
 
     sprintf(packet_str,"Idx:%"  OCSD_TRC_IDX_STR "; TrcID:0x%02X; ", index_sop, trc_chan_id);
     offset = strlen(packet_str);
@@ -611,6 +669,19 @@ ocsd_datapath_resp_t gen_trace_elem_print(const void *p_context, const ocsd_trc_
     return resp;
 }
 
+/*
+* printer for batches of generic trace elements
+*/
+ocsd_datapath_resp_t gen_trace_elem_batch_print(const void *p_context, const ocsd_gen_elem_batch_entry_t *p_elems, const uint32_t num_elem)
+{
+    ocsd_datapath_resp_t resp = OCSD_RESP_CONT;
+    uint32_t i;
+
+    for (i = 0; i < num_elem; i++)
+        resp = gen_trace_elem_print(p_context, p_elems[i].index_sop, p_elems[i].trc_chan_id, &p_elems[i].elem);
+    return resp;
+}
+
 /************************************************************************/
 /** decoder creation **/
 
@@ -949,14 +1020,263 @@ void print_statistics(dcd_tree_handle_t dcdtree_handle)
     ocsd_def_errlog_msgout(packet_str);
 }
 
-int process_trace_data(FILE *pf)
+/* push the trace data from the file through the decode tree, from the start index to the end of trace */
+static ocsd_err_t process_trace_file(dcd_tree_handle_t dcd_tree_h, FILE *pf, ocsd_trc_index_t index)
 {
     ocsd_err_t ret = OCSD_OK;
-    dcd_tree_handle_t dcdtree_handle = C_API_INVALID_TREE_HANDLE;
     uint8_t data_buffer[INPUT_BLOCK_SIZE];
-    ocsd_trc_index_t index = 0;
     size_t data_read;
 
+    if (fseek(pf, (long)index, SEEK_SET) != 0)
+        return OCSD_ERR_FILE_ERROR;
+
+    while(!feof(pf) && (ret == OCSD_OK))
+    {
+        /* read from file */
+        data_read = fread(data_buffer,1,INPUT_BLOCK_SIZE,pf);
+        if(data_read > 0)
+        {
+            /* process a block of data - any packets from the trace stream 
+               we have configured will appear at the callback 
+            */
+            ret = process_data_block(dcd_tree_h, 
+                            index,
+                            data_buffer,
+                            data_read);
+            index += data_read;
+        }
+        else if(ferror(pf))
+            ret = OCSD_ERR_FILE_ERROR;
+    }
+
+    /* no errors - let the data path know we are at end of trace */
+    if(ret == OCSD_OK)
+        ocsd_dt_process_data(dcd_tree_h, OCSD_OP_EOT, 0,0,NULL,NULL);
+    return ret;
+}
+
+/* ring buffer producer - copy the next bytes of the file into the buffer at the head */
+static void ring_buf_write(FILE *pf, uint64_t len)
+{
+    uint64_t offset;
+    size_t chunk, data_read;
+
+    while (len > 0)
+    {
+        offset = ring_buf_head % RING_BUF_SIZE;
+        chunk = (size_t)(((RING_BUF_SIZE - offset) < len) ? (RING_BUF_SIZE - offset) : len);
+        data_read = fread(ring_buf + offset, 1, chunk, pf);
+        ring_buf_head += data_read;
+        len -= data_read;
+        if (data_read < chunk)
+            break;
+    }
+}
+
+/* push the trace data from the file through the decode tree ring buffer input */
+static ocsd_err_t process_ring_buf_file(dcd_tree_handle_t dcd_tree_h, FILE *pf)
+{
+    ocsd_err_t ret;
+    ocsd_datapath_resp_t dp_ret;
+    const uint64_t write_size = (RING_BUF_SIZE * 3 / 8) + 4;  /* writes start at varying offsets and wrap at the buffer end. */
+    uint64_t write_len, read_pos = 0, bytes_lost = 0, data_size;
+    uint32_t num_discont = 0, num_writes = 0;
+
+    ret = ocsd_dt_set_ring_buf_input(dcd_tree_h, ring_buf, RING_BUF_SIZE, &ring_buf_head, &ring_buf_tail);
+    while (!feof(pf) && (ret == OCSD_OK))
+    {
+        /* producer - write into the free space, or lap the decoder and mark lost data when testing */
+        num_writes++;
+        write_len = RING_BUF_SIZE - (ring_buf_head - ring_buf_tail);
+        if (write_len > write_size)
+            write_len = write_size;
+        if (test_ring_buf_lost && (num_writes == 8))
+            write_len = RING_BUF_SIZE + write_size;
+        ring_buf_write(pf, write_len);
+        if (ferror(pf))
+            ret = OCSD_ERR_FILE_ERROR;
+        else if (test_ring_buf_lost && (num_writes == 16))
+            ret = ocsd_dt_ring_buf_data_lost(dcd_tree_h);
+
+        /* consumer - decode all data written */
+        if (ret == OCSD_OK)
+        {
+            dp_ret = ocsd_dt_process_ring_buf(dcd_tree_h);
+            while (OCSD_DATA_RESP_IS_WAIT(dp_ret))
+                dp_ret = ocsd_dt_process_ring_buf(dcd_tree_h);
+            if (OCSD_DATA_RESP_IS_FATAL(dp_ret))
+                ret = OCSD_ERR_DATA_DECODE_FATAL;
+        }
+    }
+
+    if (ret == OCSD_OK)
+    {
+        ocsd_dt_process_data(dcd_tree_h, OCSD_OP_EOT, 0, 0, NULL, NULL);
+        ret = ocsd_dt_get_ring_buf_stats(dcd_tree_h, &read_pos, &bytes_lost, &num_discont);
+    }
+
+    if (ret == OCSD_OK)
+    {
+        /* all whole frames decoded - lost data only when testing */
+        data_size = ring_buf_head & ~((uint64_t)OCSD_DFRMTR_FRAME_SIZE - 1);
+        sprintf(packet_str, "\nRing buffer: read to %" PRIu64 " of %" PRIu64 " bytes; lost %" PRIu64 " bytes; %u discontinuities\n",
+            read_pos, (uint64_t)ring_buf_head, bytes_lost, num_discont);
+        if ((read_pos != data_size) ||
+            (test_ring_buf_lost ? ((num_discont != 2) || !bytes_lost) : ((num_discont != 0) || bytes_lost)))
+        {
+            strcat(packet_str, "Ring buffer: Error: unexpected read position or lost data.\n");
+            ret = OCSD_ERR_DATA_DECODE_FATAL;
+        }
+    }
+    else
+        sprintf(packet_str, "\nRing buffer: Error: ring buffer input failed (%d).\n", ret);
+    ocsd_def_errlog_msgout(packet_str);
+    return ret;
+}
+
+/* save the sync index recorded during decode, and reload it */
+static ocsd_err_t test_sync_index_api(dcd_tree_handle_t dcd_tree_h)
+{
+    ocsd_err_t ret;
+    const ocsd_sync_idx_entry_t *p_entries = 0;
+    uint64_t num_entries = 0, num_loaded = 0;
+
+    ret = ocsd_dt_set_sync_indexing(dcd_tree_h, 0);
+    if (ret == OCSD_OK)
+        ret = ocsd_dt_get_sync_index(dcd_tree_h, &p_entries, &num_entries);
+    if (ret == OCSD_OK)
+        ret = ocsd_dt_save_sync_index(dcd_tree_h, sync_index_filename);
+    if (ret == OCSD_OK)
+        ret = ocsd_dt_load_sync_index(dcd_tree_h, sync_index_filename);
+    if (ret == OCSD_OK)
+        ret = ocsd_dt_get_sync_index(dcd_tree_h, &p_entries, &num_loaded);
+
+    if (ret == OCSD_OK)
+    {
+        sprintf(packet_str, "\nSync index: %ld sync points recorded; %ld loaded from %s\n", (long)num_entries, (long)num_loaded, sync_index_filename);
+        if ((num_entries == 0) || (num_loaded != num_entries))
+        {
+            strcat(packet_str, "Sync index: Error: index not recorded or reloaded.\n");
+            ret = OCSD_ERR_SYNC_IDX_FILE;
+        }
+    }
+    else
+        sprintf(packet_str, "\nSync index: Error: API call failed (%d).\n", ret);
+    ocsd_def_errlog_msgout(packet_str);
+    return ret;
+}
+
+/* seek and decode to the end of the trace - count the elements output from each sync point */
+static ocsd_err_t seek_and_decode(dcd_tree_handle_t dcd_tree_h, FILE *pf, const int bTimestamp, const uint64_t target, const uint8_t cs_id, ocsd_trc_index_t *restart_index)
+{
+    ocsd_err_t ret;
+
+    if (bTimestamp)
+        ret = ocsd_dt_seek_timestamp(dcd_tree_h, target, cs_id, restart_index);
+    else
+        ret = ocsd_dt_seek_index(dcd_tree_h, (ocsd_trc_index_t)target, cs_id, restart_index);
+
+    if (ret == OCSD_OK)
+    {
+        sprintf(packet_str, "\nSeek to %s 0x%" PRIx64 ": restart input at index %" OCSD_TRC_IDX_STR "\n", bTimestamp ? "timestamp" : "index", target, *restart_index);
+        ocsd_def_errlog_msgout(packet_str);
+        memset(seek_elem_counts, 0, sizeof(uint32_t) * seek_num_entries);
+        ret = process_trace_file(dcd_tree_h, pf, *restart_index);
+    }
+    return ret;
+}
+
+/* decode after a seek must match a full decode from each sync point at or after the restart */
+static int seek_counts_match(const uint32_t *ref_counts, const ocsd_trc_index_t restart_index)
+{
+    uint64_t i;
+
+    for (i = 0; i < seek_num_entries; i++)
+    {
+        if ((seek_entries[i].restart_index >= restart_index) && (seek_elem_counts[i] != ref_counts[i]))
+            return 0;
+    }
+    return 1;
+}
+
+/* seek to an index and to a timestamp part way through the trace, using the reloaded sync index */
+static ocsd_err_t test_seek_api(dcd_tree_handle_t dcd_tree_h, FILE *pf)
+{
+    ocsd_err_t ret;
+    const ocsd_sync_idx_entry_t *p_entries = 0;
+    uint32_t *ref_counts = 0;
+    ocsd_trc_index_t restart_index = 0;
+    uint64_t target;
+    int seek_idx;
+
+    ret = ocsd_dt_get_sync_index(dcd_tree_h, &p_entries, &seek_num_entries);
+    if ((ret == OCSD_OK) && (seek_num_entries < 2))
+        ret = OCSD_ERR_NOT_INIT;
+    if (ret == OCSD_OK)
+    {
+        seek_entries = (ocsd_sync_idx_entry_t *)malloc(sizeof(ocsd_sync_idx_entry_t) * seek_num_entries);
+        seek_elem_counts = (uint32_t *)malloc(sizeof(uint32_t) * seek_num_entries);
+        ref_counts = (uint32_t *)malloc(sizeof(uint32_t) * seek_num_entries);
+        if (!seek_entries || !seek_elem_counts || !ref_counts)
+            ret = OCSD_ERR_MEM;
+        else
+            memcpy(seek_entries, p_entries, sizeof(ocsd_sync_idx_entry_t) * seek_num_entries);
+    }
+
+    /* reference - decode from the start of the trace */
+    seek_idx = (int)(seek_num_entries / 2);
+    if (ret == OCSD_OK)
+        ret = seek_and_decode(dcd_tree_h, pf, 0, 0, seek_entries[seek_idx].trc_id, &restart_index);
+    if (ret == OCSD_OK)
+        memcpy(ref_counts, seek_elem_counts, sizeof(uint32_t) * seek_num_entries);
+
+    /* seek just after a sync point - restart at that sync point */
+    if (ret == OCSD_OK)
+    {
+        target = seek_entries[seek_idx].pkt_index + 1;
+        ret = seek_and_decode(dcd_tree_h, pf, 0, target, seek_entries[seek_idx].trc_id, &restart_index);
+        if ((ret == OCSD_OK) && ((restart_index != seek_entries[seek_idx].restart_index) || !seek_counts_match(ref_counts, restart_index)))
+        {
+            ocsd_def_errlog_msgout("Seek: Error: decode after seek to index differs from full decode.\n");
+            ret = OCSD_ERR_DATA_DECODE_FATAL;
+        }
+    }
+
+    /* seek to the timestamp of a later sync point */
+    while ((seek_idx < (int)seek_num_entries) && !(seek_entries[seek_idx].flags & OCSD_SYNC_IDX_FLG_TS_VALID))
+        seek_idx++;
+    if ((ret == OCSD_OK) && (seek_idx < (int)seek_num_entries))
+    {
+        ret = seek_and_decode(dcd_tree_h, pf, 1, seek_entries[seek_idx].timestamp, seek_entries[seek_idx].trc_id, &restart_index);
+        if ((ret == OCSD_OK) && ((restart_index < seek_entries[seek_idx].restart_index) || !seek_counts_match(ref_counts, restart_index)))
+        {
+            ocsd_def_errlog_msgout("Seek: Error: decode after seek to timestamp differs from full decode.\n");
+            ret = OCSD_ERR_DATA_DECODE_FATAL;
+        }
+    }
+
+    if (ret == OCSD_OK)
+        ocsd_def_errlog_msgout("\nSeek: decode after seek matches full decode.\n");
+    else
+    {
+        sprintf(packet_str, "\nSeek: Error: seek test failed (%d).\n", ret);
+        ocsd_def_errlog_msgout(packet_str);
+    }
+
+    seek_num_entries = 0;
+    free(seek_entries);
+    free(seek_elem_counts);
+    free(ref_counts);
+    seek_entries = 0;
+    seek_elem_counts = 0;
+    return ret;
+}
+
+int process_trace_data(FILE *pf)
+{
+    ocsd_err_t ret = OCSD_OK;
+    dcd_tree_handle_t dcdtree_handle = C_API_INVALID_TREE_HANDLE;
+
 
     /*  Create a decode tree for this source data.
         source data is frame formatted, memory aligned from an ETR (no frame syncs) so create tree accordingly 
@@ -977,6 +1297,8 @@ int process_trace_data(FILE *pf)
             /* attach the generic trace element output callback */
             if (test_lib_printers)
                 ret = ocsd_dt_set_gen_elem_printer(dcdtree_handle);
+            else if (test_batch_out)
+                ret = ocsd_dt_set_gen_elem_batch_outfn(dcdtree_handle, gen_trace_elem_batch_print, 0, 64);
             else
                 ret = ocsd_dt_set_gen_elem_outfn(dcdtree_handle, gen_trace_elem_print, 0);
         }
@@ -990,29 +1312,21 @@ int process_trace_data(FILE *pf)
             ret = attach_raw_printers(dcdtree_handle);
 
 
+        /* record the sync points while decoding */
+        if ((ret == OCSD_OK) && test_sync_index)
+            ret = ocsd_dt_set_sync_indexing(dcdtree_handle, 1);
+
         /* now push the trace data through the packet processor */
-        while(!feof(pf) && (ret == OCSD_OK))
-        {
-            /* read from file */
-            data_read = fread(data_buffer,1,INPUT_BLOCK_SIZE,pf);
-            if(data_read > 0)
-            {
-                /* process a block of data - any packets from the trace stream 
-                   we have configured will appear at the callback 
-                */
-                ret = process_data_block(dcdtree_handle, 
-                                index,
-                                data_buffer,
-                                data_read);
-                index += data_read;
-            }
-            else if(ferror(pf))
-                ret = OCSD_ERR_FILE_ERROR;
-        }
+        if ((ret == OCSD_OK) && test_ring_buf)
+            ret = process_ring_buf_file(dcdtree_handle, pf);
+        else if (ret == OCSD_OK)
+            ret = process_trace_file(dcdtree_handle, pf, 0);
 
-        /* no errors - let the data path know we are at end of trace */
-        if(ret == OCSD_OK)
-            ocsd_dt_process_data(dcdtree_handle, OCSD_OP_EOT, 0,0,NULL,NULL);
+        if ((ret == OCSD_OK) && test_sync_index)
+            ret = test_sync_index_api(dcdtree_handle);
+
+        if ((ret == OCSD_OK) && test_seek)
+            ret = test_seek_api(dcdtree_handle, pf);
 
         if (stats) {
             print_statistics(dcdtree_handle);
@@ -1058,6 +1372,8 @@ int test_err_api()
             /* attach the generic trace element output callback */
             if (test_lib_printers)
                 ret = ocsd_dt_set_gen_elem_printer(dcdtree_handle);
+            else if (test_batch_out)
+                ret = ocsd_dt_set_gen_elem_batch_outfn(dcdtree_handle, gen_trace_elem_batch_print, 0, 64);
             else
                 ret = ocsd_dt_set_gen_elem_outfn(dcdtree_handle, gen_trace_elem_print, 0);
         }
@@ -300,6 +300,21 @@ static int testDemuxInit()
         oss << "PASS\n";
     logger.LogMsg(oss.str());
 
+    // ID runs need memory aligned frames
+    oss.str("");
+    oss << "\nCheck ID runs without mem align flag error: ";
+    err = initDecoder(OCSD_DFRMTR_HAS_FSYNCS | OCSD_DFRMTR_ID_RUNS);
+    if (err) {
+        err = err_log.GetLastError()->getErrorCode();
+    }
+    if (err != OCSD_ERR_INVALID_PARAM_VAL) {
+        oss << "FAIL: expected error code not returned\n";
+        failed++;
+    }
+    else
+        oss << "PASS\n";
+    logger.LogMsg(oss.str());
+
     return failed;
 }
 
@@ -443,6 +458,23 @@ static int runMemAlignTest()
         failed);
     checkInOutSizes("MemAlignFrame-rst_en", buf_mem_align_en_rst_sz, processed, failed);
 
+    // collate ID runs - no raw output so frames unpacked in bulk from the input buffer
+    setConfig(OCSD_DFRMTR_FRAME_MEM_ALIGN | OCSD_DFRMTR_ID_RUNS);
+    printSubTestName(6, "MemAlignFrame-id_runs");
+    resetDecoder(failed);
+    checkDataPathValue(
+        pDecoder->TraceDataIn(OCSD_OP_DATA, 0, buf_mem_align_8id_sz, buf_mem_align_8id, &processed),
+        failed);
+    checkInOutSizes("MemAlignFrame-id_runs", buf_mem_align_8id_sz, processed, failed);
+
+    setConfig(OCSD_DFRMTR_FRAME_MEM_ALIGN | OCSD_DFRMTR_ID_RUNS | OCSD_DFRMTR_RESET_ON_4X_FSYNC);
+    printSubTestName(7, "MemAlignFrame-id_runs-rst_mid");
+    resetDecoder(failed);
+    checkDataPathValue(
+        pDecoder->TraceDataIn(OCSD_OP_DATA, 0, buf_mem_align_mid_rst_sz, buf_mem_align_mid_rst, &processed),
+        failed);
+    checkInOutSizes("MemAlignFrame-id_runs-rst_mid", buf_mem_align_mid_rst_sz, processed, failed);
+
     setConfig(base_cfg);
     return checkResult(failed);
 }
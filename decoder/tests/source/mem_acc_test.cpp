@@ -44,6 +44,7 @@
 #include <iostream>
 #include <sstream>
 #include <cstring>
+#include <fstream>
 
 #include "opencsd.h"  
 
@@ -77,8 +78,11 @@ static uint32_t el3_root_blocks[NUM_BLOCKS][BLOCK_NUM_WORDS];
 
 #define BLOCK_VAL(mem_space, block_num, index) (uint32_t)(((uint32_t)mem_space << 24) | ((uint32_t)block_num << 16) | (uint32_t)index)
 
-// memory access mapper - used for tests
-static TrcMemAccMapGlobalSpace mapper;
+// memory access mappers - tests run on each mapper type
+static TrcMemAccMapGlobalSpace mapper_global;
+static TrcMemAccMapGlobalSpaceIdx mapper_global_idx;
+static TrcMemAccMapCtxtSpace mapper_ctxt;
+static TrcMemAccMapper *p_mapper = &mapper_global;
 
 
 
@@ -187,7 +191,7 @@ void test_overlap_regions()
     // add single accessor
     Acc1.initAccessor(0x0000, (const uint8_t*)&el01_ns_blocks[0], BLOCK_SIZE_BYTES);
     Acc1.setMemSpace(OCSD_MEM_SPACE_EL1N);
-    err = mapper.AddAccessor(&Acc1, 0);
+    err = p_mapper->AddAccessor(&Acc1, 0);
     if (err != OCSD_OK) {
         log_error(ocsdError(OCSD_ERR_SEV_ERROR, err, "Failed to set memory accessor"));
         failed++;
@@ -198,7 +202,7 @@ void test_overlap_regions()
     // overlapping region - same memory space.
     Acc2.initAccessor(0x1000, (const uint8_t*)&el01_ns_blocks[1], BLOCK_SIZE_BYTES);
     Acc2.setMemSpace(OCSD_MEM_SPACE_EL1N);
-    err = mapper.AddAccessor(&Acc2, 0);
+    err = p_mapper->AddAccessor(&Acc2, 0);
     if (err != OCSD_ERR_MEM_ACC_OVERLAP) {
         oss.str("");
         oss << "Error: expected OCSD_ERR_MEM_ACC_OVERLAP error for overlapping accessor range.\n";
@@ -210,7 +214,7 @@ void test_overlap_regions()
 
     // non overlapping region - same memory space.
     Acc2.setRange(0x8000, 0x8000 + BLOCK_SIZE_BYTES - 1);
-    err = mapper.AddAccessor(&Acc2, 0);
+    err = p_mapper->AddAccessor(&Acc2, 0);
     if (err != OCSD_OK) {
         log_error(ocsdError(OCSD_ERR_SEV_ERROR, err, "Failed to set non overlapping memory accessor"));
         failed++;
@@ -221,7 +225,7 @@ void test_overlap_regions()
     // overlapping region - different memory space
     Acc3.initAccessor(0x0000, (const uint8_t*)&el01_s_blocks[0], BLOCK_SIZE_BYTES);
     Acc3.setMemSpace(OCSD_MEM_SPACE_EL1S);
-    err = mapper.AddAccessor(&Acc3, 0);
+    err = p_mapper->AddAccessor(&Acc3, 0);
     if (err != OCSD_OK) {
         log_error(ocsdError(OCSD_ERR_SEV_ERROR, err, "Failed to set overlapping memory accessor in other memory space"));
         failed++;
@@ -232,7 +236,7 @@ void test_overlap_regions()
     // overlapping region - more general memory space.
     Acc4.initAccessor(0x0000, (const uint8_t*)&el2_s_blocks[0], BLOCK_SIZE_BYTES);
     Acc4.setMemSpace(OCSD_MEM_SPACE_S);
-    err = mapper.AddAccessor(&Acc4, 0);
+    err = p_mapper->AddAccessor(&Acc4, 0);
     if (err != OCSD_ERR_MEM_ACC_OVERLAP) {
         oss.str("");
         oss << "Error: expected OCSD_ERR_MEM_ACC_OVERLAP error for overlapping general _S accessor range.\n";
@@ -243,7 +247,7 @@ void test_overlap_regions()
         passed++;
 
     // clean up mapper
-    mapper.RemoveAllAccessors();
+    p_mapper->RemoveAllAccessors();
     tests_passed += passed;
     tests_failed += failed;
 
@@ -342,7 +346,7 @@ bool read_and_check_from_range(const int test_idx, const int range, test_range_a
     oss << memSpaceStr << "; Traced ID 0x" << std::setw(2) << (uint32_t)traceID << "; ";
     logger.LogMsg(oss.str());
 
-    err = mapper.ReadTargetMemory(read_address, ranges.ranges[range].trcID, OCSD_MEM_SPACE_EL1N, &num_bytes_read, p_local_buff);
+    err = p_mapper->ReadTargetMemory(read_address, ranges.ranges[range].trcID, OCSD_MEM_SPACE_EL1N, &num_bytes_read, p_local_buff);
 
     mem_callback_occurred = (bool)(PrevAccCallbackCount != AccCallbackCount);
     if (mem_callback_occurred)
@@ -433,7 +437,7 @@ void test_trcid_cache_mem_cb()
     // add the callback to the mapper
     CBAcc.initAccessor(0, 0xFFFFFFFF, OCSD_MEM_SPACE_ANY);
     CBAcc.setCBIDIfFn(TestMemAccCB, (void*)&ranges);
-    err = mapper.AddAccessor(&CBAcc, 0);
+    err = p_mapper->AddAccessor(&CBAcc, 0);
     if (err != OCSD_OK) {
         log_error(ocsdError(OCSD_ERR_SEV_ERROR, err, "Failed to set callback memory accessor"));
         failed++;
@@ -456,7 +460,159 @@ void test_trcid_cache_mem_cb()
 
     // clean up mapper
 cleanup:
-    mapper.RemoveAllAccessors();
+    p_mapper->RemoveAllAccessors();
+    tests_passed += passed;
+    tests_failed += failed;
+    delete[] ranges.ranges;
+
+    log_test_end(__FUNCTION__, passed, failed);
+}
+
+/************************************************************************
+ * Test cache page lookup and LRU eviction - using callback function to
+ * detect cache page loads. Uses small pages to force page evictions.
+ */
+void test_cache_lru()
+{
+    TrcMemAccCB CBAcc;
+    test_range_array_t ranges;
+    int passed = 0, failed = 0;
+    ocsd_err_t err;
+    int read_test_idx = 1;
+
+    log_test_start(__FUNCTION__);
+
+    ranges.num_ranges = 1;
+    ranges.ranges = new test_range_t[1];
+    set_test_range(ranges.ranges[0], 0x0000, BLOCK_SIZE_BYTES, (const uint8_t*)&el01_ns_blocks[0], OCSD_MEM_SPACE_EL1N, 0x10);
+
+    // 4 pages of 64 bytes
+    err = p_mapper->setCacheSizes(MEM_ACC_CACHE_PAGE_SIZE_MIN, MEM_ACC_CACHE_MRU_SIZE_MIN, true);
+    if (err == OCSD_OK) {
+        CBAcc.initAccessor(0, 0xFFFFFFFF, OCSD_MEM_SPACE_ANY);
+        CBAcc.setCBIDIfFn(TestMemAccCB, (void*)&ranges);
+        err = p_mapper->AddAccessor(&CBAcc, 0);
+    }
+    if (err != OCSD_OK) {
+        log_error(ocsdError(OCSD_ERR_SEV_ERROR, err, "Failed to set up cache and callback memory accessor"));
+        failed++;
+        goto cleanup;
+    }
+
+    // fill all 4 pages - page 0 loaded from an offset that is not page aligned
+    read_and_check_from_range(read_test_idx++, 0, ranges, 0x030, true) ? passed++ : failed++;
+    read_and_check_from_range(read_test_idx++, 0, ranges, 0x100, true) ? passed++ : failed++;
+    read_and_check_from_range(read_test_idx++, 0, ranges, 0x200, true) ? passed++ : failed++;
+    read_and_check_from_range(read_test_idx++, 0, ranges, 0x300, true) ? passed++ : failed++;
+
+    // page 0 data in the following page sized block - cached
+    read_and_check_from_range(read_test_idx++, 0, ranges, 0x068, false) ? passed++ : failed++;
+
+    // page 1 is now least recently used - evicted for a new page.
+    read_and_check_from_range(read_test_idx++, 0, ranges, 0x400, true) ? passed++ : failed++;
+    read_and_check_from_range(read_test_idx++, 0, ranges, 0x030, false) ? passed++ : failed++;
+    read_and_check_from_range(read_test_idx++, 0, ranges, 0x200, false) ? passed++ : failed++;
+    read_and_check_from_range(read_test_idx++, 0, ranges, 0x300, false) ? passed++ : failed++;
+    read_and_check_from_range(read_test_idx++, 0, ranges, 0x100, true) ? passed++ : failed++;
+
+    // page 4 (0x400) was least recently used - evicted to reload 0x100.
+    read_and_check_from_range(read_test_idx++, 0, ranges, 0x400, true) ? passed++ : failed++;
+
+    // invalidate for the trace ID - all pages reloaded.
+    p_mapper->InvalidateMemAccCache(0x10);
+    read_and_check_from_range(read_test_idx++, 0, ranges, 0x400, true) ? passed++ : failed++;
+    read_and_check_from_range(read_test_idx++, 0, ranges, 0x404, false) ? passed++ : failed++;
+
+cleanup:
+    p_mapper->RemoveAllAccessors();
+    p_mapper->setCacheSizes(MEM_ACC_CACHE_DEFAULT_PAGE_SIZE, MEM_ACC_CACHE_DEFAULT_MRU_SIZE);
+    tests_passed += passed;
+    tests_failed += failed;
+    delete[] ranges.ranges;
+
+    log_test_end(__FUNCTION__, passed, failed);
+}
+
+/************************************************************************
+ * Test zero copy reads - pointers direct into buffer accessors, or 
+ * into cache pages for callback accessors.
+ */
+bool check_read_ptr(ocsd_vaddr_t addr, uint32_t req_bytes, const uint8_t *p_expected, uint32_t expected_avail, bool data_cmp)
+{
+    const uint8_t *p_data = 0;
+    uint32_t num_bytes = req_bytes;
+    std::ostringstream oss;
+    ocsd_err_t err;
+
+    oss << "Read Ptr Test: Address 0x" << std::hex << std::setw(8) << std::setfill('0') << addr << "; ";
+    err = p_mapper->ReadTargetMemoryPtr(addr, 0, OCSD_MEM_SPACE_EL1N, 0, &num_bytes, &p_data);
+    if (err != OCSD_OK) {
+        log_error(ocsdError(OCSD_ERR_SEV_ERROR, err, "Failed to read pointer from mapper"));
+        return false;
+    }
+
+    if (!p_expected) {
+        if (p_data || num_bytes) {
+            oss << "Fail: expected no data\n";
+            logger.LogMsg(oss.str());
+            return false;
+        }
+    }
+    else if (!p_data || (num_bytes != expected_avail) ||
+             (!data_cmp && (p_data != p_expected)) ||
+             (data_cmp && memcmp(p_data, p_expected, num_bytes))) {
+        oss << "Fail: bad pointer or data; available bytes 0x" << num_bytes << " (expected 0x" << expected_avail << ")\n";
+        logger.LogMsg(oss.str());
+        return false;
+    }
+    oss << "Passed\n";
+    logger.LogMsg(oss.str());
+    return true;
+}
+
+void test_read_ptr()
+{
+    TrcMemAccBufPtr AccBuf;
+    TrcMemAccCB CBAcc;
+    test_range_array_t ranges;
+    int passed = 0, failed = 0;
+    ocsd_err_t err;
+    const uint8_t *p_buf = (const uint8_t *)&el01_ns_blocks[0];
+    const uint8_t *p_cb_buf = (const uint8_t *)&el01_ns_blocks[1];
+
+    log_test_start(__FUNCTION__);
+
+    // buffer accessor at 0x0000, callback accessor at 0x10000
+    ranges.num_ranges = 1;
+    ranges.ranges = new test_range_t[1];
+    set_test_range(ranges.ranges[0], 0x10000, BLOCK_SIZE_BYTES, p_cb_buf, OCSD_MEM_SPACE_EL1N, 0);
+
+    AccBuf.initAccessor(0x0000, p_buf, BLOCK_SIZE_BYTES);
+    CBAcc.initAccessor(0x10000, 0x10000 + BLOCK_SIZE_BYTES - 1, OCSD_MEM_SPACE_ANY);
+    CBAcc.setCBIDIfFn(TestMemAccCB, (void*)&ranges);
+    if (((err = p_mapper->AddAccessor(&AccBuf, 0)) != OCSD_OK) ||
+        ((err = p_mapper->AddAccessor(&CBAcc, 0)) != OCSD_OK)) {
+        log_error(ocsdError(OCSD_ERR_SEV_ERROR, err, "Failed to set memory accessors"));
+        failed++;
+        goto cleanup;
+    }
+
+    // buffer - pointer into client buffer, all bytes to end of buffer available
+    check_read_ptr(0x0000, 4, p_buf, BLOCK_SIZE_BYTES, false) ? passed++ : failed++;
+    check_read_ptr(0x0100, 4, p_buf + 0x100, BLOCK_SIZE_BYTES - 0x100, false) ? passed++ : failed++;
+
+    // not enough bytes at end of buffer
+    check_read_ptr(BLOCK_SIZE_BYTES - 2, 4, 0, 0, false) ? passed++ : failed++;
+
+    // callback - pointer into cache page, bytes to end of page
+    check_read_ptr(0x10000, 4, p_cb_buf, MEM_ACC_CACHE_DEFAULT_PAGE_SIZE, true) ? passed++ : failed++;
+    check_read_ptr(0x10010, 4, p_cb_buf + 0x10, MEM_ACC_CACHE_DEFAULT_PAGE_SIZE - 0x10, true) ? passed++ : failed++;
+
+    // unmapped address
+    check_read_ptr(0x30000, 4, 0, 0, false) ? passed++ : failed++;
+
+cleanup:
+    p_mapper->RemoveAllAccessors();
     tests_passed += passed;
     tests_failed += failed;
     delete[] ranges.ranges;
@@ -481,7 +637,7 @@ cleanup:
 #define TEST_ADDR_EL2R   0x038000
 #define TEST_ADDR_EL3R   0x040000
 
-bool read_and_check_value(ocsd_vaddr_t addr, const uint8_t* p_block_buffer, ocsd_mem_space_acc_t space)
+bool read_and_check_value(ocsd_vaddr_t addr, const uint8_t* p_block_buffer, ocsd_mem_space_acc_t space, const ocsd_pe_context *p_ctxt = 0)
 {
     ocsd_err_t err;
     uint32_t read_val, check_val, num_bytes;
@@ -496,7 +652,10 @@ bool read_and_check_value(ocsd_vaddr_t addr, const uint8_t* p_block_buffer, ocsd
 
 
     num_bytes = 4;
-    err = mapper.ReadTargetMemory(addr, 0, space, &num_bytes, (uint8_t*)&read_val);
+    if (p_ctxt)
+        err = p_mapper->ReadTargetMemoryCtxt(addr, 0, space, p_ctxt, &num_bytes, (uint8_t*)&read_val);
+    else
+        err = p_mapper->ReadTargetMemory(addr, 0, space, &num_bytes, (uint8_t*)&read_val);
     if (err != OCSD_OK) {
         log_error(ocsdError(OCSD_ERR_SEV_ERROR, err, "Failed to read from mapper"));
         return false;
@@ -573,7 +732,7 @@ void test_mem_spaces()
 
     // add accessors to mapper.
     for (int i = 0; i < NUM_ACCS; i++) {
-        err = mapper.AddAccessor(&accs[i], 0);
+        err = p_mapper->AddAccessor(&accs[i], 0);
         if (err != OCSD_OK) {
             log_error(ocsdError(OCSD_ERR_SEV_ERROR, err, "Failed to set callback memory accessor"));
             failed++;
@@ -639,7 +798,7 @@ void test_mem_spaces()
     read_and_check_value(TEST_ADDR_EL3R, (const uint8_t*)&el3_root_blocks[1], OCSD_MEM_SPACE_ANY) ? passed++ : failed++;
 
     // clear for this test 
-    mapper.RemoveAllAccessors();
+    p_mapper->RemoveAllAccessors();
 
     // test access more global from specific - set ANY, N S and R spaces
     accs[0].initAccessor(TEST_ADDR_COMMON, (const uint8_t*)&el01_ns_blocks[0], BLOCK_SIZE_BYTES);
@@ -652,7 +811,7 @@ void test_mem_spaces()
     accs[3].setMemSpace(OCSD_MEM_SPACE_R);
 
     for (int i = 0; i < 4; i++) {
-        err = mapper.AddAccessor(&accs[i], 0);
+        err = p_mapper->AddAccessor(&accs[i], 0);
         if (err != OCSD_OK) {
             log_error(ocsdError(OCSD_ERR_SEV_ERROR, err, "Failed to set callback memory accessor"));
             failed++;
@@ -718,7 +877,7 @@ void test_mem_spaces()
     offset += 4;
 
     // clean up
-    mapper.RemoveAllAccessors();
+    p_mapper->RemoveAllAccessors();
     tests_passed += passed;
     tests_failed += failed;
     log_test_end(__FUNCTION__, passed, failed);
@@ -727,6 +886,441 @@ void test_mem_spaces()
 /************************************************************************
  * main program 
  */
+/************************************************************************
+ * Test indexed mapper overlap detection where the new range contains 
+ * an existing range, or spans the gap between regions.
+ */
+void test_contained_regions()
+{
+    TrcMemAccBufPtr Acc1, Acc2, Acc3;
+    ocsd_err_t err;
+    std::ostringstream oss;
+    int passed = 0, failed = 0;
+
+    log_test_start(__FUNCTION__);
+
+    // small region in the middle of the address space
+    Acc1.initAccessor(0x4000, (const uint8_t*)&el01_ns_blocks[0], 0x1000);
+    Acc1.setMemSpace(OCSD_MEM_SPACE_EL1N);
+    err = p_mapper->AddAccessor(&Acc1, 0);
+    if (err != OCSD_OK) {
+        log_error(ocsdError(OCSD_ERR_SEV_ERROR, err, "Failed to set memory accessor"));
+        failed++;
+    }
+    else
+        passed++;
+
+    // larger region containing the first - same memory space.
+    Acc2.initAccessor(0x0000, (const uint8_t*)&el01_ns_blocks[1], BLOCK_SIZE_BYTES);
+    Acc2.setMemSpace(OCSD_MEM_SPACE_EL1N);
+    err = p_mapper->AddAccessor(&Acc2, 0);
+    if (err != OCSD_ERR_MEM_ACC_OVERLAP) {
+        oss.str("");
+        oss << "Error: expected OCSD_ERR_MEM_ACC_OVERLAP error for accessor range containing existing range.\n";
+        logger.LogMsg(oss.str());
+        failed++;
+    }
+    else
+        passed++;
+
+    // larger region containing the first - general N memory space.
+    Acc3.initAccessor(0x0000, (const uint8_t*)&el2_ns_blocks[0], BLOCK_SIZE_BYTES);
+    Acc3.setMemSpace(OCSD_MEM_SPACE_N);
+    err = p_mapper->AddAccessor(&Acc3, 0);
+    if (err != OCSD_ERR_MEM_ACC_OVERLAP) {
+        oss.str("");
+        oss << "Error: expected OCSD_ERR_MEM_ACC_OVERLAP error for general _N accessor range containing existing range.\n";
+        logger.LogMsg(oss.str());
+        failed++;
+    }
+    else
+        passed++;
+
+    // larger region containing the first - other memory space.
+    Acc3.setMemSpace(OCSD_MEM_SPACE_EL2);
+    err = p_mapper->AddAccessor(&Acc3, 0);
+    if (err != OCSD_OK) {
+        log_error(ocsdError(OCSD_ERR_SEV_ERROR, err, "Failed to set containing memory accessor in other memory space"));
+        failed++;
+    }
+    else
+        passed++;
+
+    // reads in the contained region and around it, in each space.
+    if (read_and_check_value(0x4000, (const uint8_t*)&el01_ns_blocks[0][0], OCSD_MEM_SPACE_EL1N) &&
+        read_and_check_value(0x4ffc, (const uint8_t*)&el01_ns_blocks[0][0x3ff], OCSD_MEM_SPACE_EL1N) &&
+        read_and_check_value(0x4000, (const uint8_t*)&el2_ns_blocks[0][0x1000], OCSD_MEM_SPACE_EL2) &&
+        read_and_check_value(0x0000, (const uint8_t*)&el2_ns_blocks[0][0], OCSD_MEM_SPACE_EL2))
+        passed++;
+    else
+        failed++;
+
+    // clean up mapper
+    p_mapper->RemoveAllAccessors();
+    tests_passed += passed;
+    tests_failed += failed;
+
+    log_test_end(__FUNCTION__, passed, failed);
+}
+
+/************************************************************************
+ * Test indexed mapper with a large number of small regions, 
+ * reading either end of each region, the gaps between, 
+ * and after removal of alternate regions.
+ */
+#define MANY_REGIONS_NUM 1024
+#define MANY_REGIONS_SIZE 32    // bytes in each region - regions are at twice this stride
+
+void test_many_regions()
+{
+    TrcMemAccBufPtr *accs = new TrcMemAccBufPtr[MANY_REGIONS_NUM];
+    const uint8_t *p_buf;
+    ocsd_vaddr_t addr;
+    ocsd_err_t err = OCSD_OK;
+    uint32_t num_bytes, read_val;
+    int passed = 0, failed = 0;
+    int i, read_fails = 0;
+
+    log_test_start(__FUNCTION__);
+
+    // add in reverse order to check sorting.
+    for (i = MANY_REGIONS_NUM - 1; (i >= 0) && (err == OCSD_OK); i--)
+    {
+        p_buf = ((const uint8_t*)&el01_ns_blocks[0]) + (i * MANY_REGIONS_SIZE);
+        accs[i].initAccessor(i * MANY_REGIONS_SIZE * 2, p_buf, MANY_REGIONS_SIZE);
+        accs[i].setMemSpace(OCSD_MEM_SPACE_EL1N);
+        err = p_mapper->AddAccessor(&accs[i], 0);
+    }
+    if (err != OCSD_OK) {
+        log_error(ocsdError(OCSD_ERR_SEV_ERROR, err, "Failed to set memory accessors"));
+        failed++;
+    }
+    else
+        passed++;
+
+    // read first and last word in each region, and the first word in the gap after each.
+    for (i = 0; i < MANY_REGIONS_NUM; i++)
+    {
+        addr = i * MANY_REGIONS_SIZE * 2;
+        p_buf = ((const uint8_t*)&el01_ns_blocks[0]) + (i * MANY_REGIONS_SIZE);
+
+        num_bytes = 4;
+        err = p_mapper->ReadTargetMemory(addr, 0, OCSD_MEM_SPACE_EL1N, &num_bytes, (uint8_t*)&read_val);
+        if ((err != OCSD_OK) || (num_bytes != 4) || (read_val != *((const uint32_t*)p_buf)))
+            read_fails++;
+
+        num_bytes = 4;
+        err = p_mapper->ReadTargetMemory(addr + MANY_REGIONS_SIZE - 4, 0, OCSD_MEM_SPACE_EL1N, &num_bytes, (uint8_t*)&read_val);
+        if ((err != OCSD_OK) || (num_bytes != 4) || (read_val != *((const uint32_t*)(p_buf + MANY_REGIONS_SIZE - 4))))
+            read_fails++;
+
+        num_bytes = 4;
+        err = p_mapper->ReadTargetMemory(addr + MANY_REGIONS_SIZE, 0, OCSD_MEM_SPACE_EL1N, &num_bytes, (uint8_t*)&read_val);
+        if ((err != OCSD_OK) || (num_bytes != 0))
+            read_fails++;
+
+        // wrong memory space
+        num_bytes = 4;
+        err = p_mapper->ReadTargetMemory(addr, 0, OCSD_MEM_SPACE_EL2, &num_bytes, (uint8_t*)&read_val);
+        if ((err != OCSD_OK) || (num_bytes != 0))
+            read_fails++;
+    }
+
+    // remove alternate regions - check removed not found, remaining still are.
+    for (i = 0; i < MANY_REGIONS_NUM; i += 2)
+    {
+        if (p_mapper->RemoveAccessorByAddress(i * MANY_REGIONS_SIZE * 2, OCSD_MEM_SPACE_EL1N) != OCSD_OK)
+            read_fails++;
+    }
+    for (i = 0; i < MANY_REGIONS_NUM; i++)
+    {
+        addr = i * MANY_REGIONS_SIZE * 2;
+        p_buf = ((const uint8_t*)&el01_ns_blocks[0]) + (i * MANY_REGIONS_SIZE);
+        num_bytes = 4;
+        err = p_mapper->ReadTargetMemory(addr, 0, OCSD_MEM_SPACE_EL1N, &num_bytes, (uint8_t*)&read_val);
+        if (i & 0x1) 
+        {
+            if ((err != OCSD_OK) || (num_bytes != 4) || (read_val != *((const uint32_t*)p_buf)))
+                read_fails++;
+        }
+        else if ((err != OCSD_OK) || (num_bytes != 0))
+            read_fails++;
+    }
+
+    if (read_fails) {
+        std::ostringstream oss;
+        oss << "Error: " << std::dec << read_fails << " read failures on mapper with " << MANY_REGIONS_NUM << " regions.\n";
+        logger.LogMsg(oss.str());
+        failed++;
+    }
+    else
+        passed++;
+
+    // clean up mapper
+    p_mapper->RemoveAllAccessors();
+    delete [] accs;
+    tests_passed += passed;
+    tests_failed += failed;
+
+    log_test_end(__FUNCTION__, passed, failed);
+}
+
+/************************************************************************
+ * Test context aware mapper - same VA mapped for different context IDs
+ * and VMIDs, with fallback to accessors that have no context.
+ */
+#define TEST_ADDR_CTXT 0x8000
+
+bool read_check_no_data(ocsd_vaddr_t addr, ocsd_mem_space_acc_t space, const ocsd_pe_context *p_ctxt)
+{
+    uint32_t read_val, num_bytes = 4;
+    ocsd_err_t err = p_mapper->ReadTargetMemoryCtxt(addr, 0, space, p_ctxt, &num_bytes, (uint8_t*)&read_val);
+    if ((err != OCSD_OK) || (num_bytes != 0)) {
+        std::ostringstream oss;
+        oss << "Read Fail: expected no data at 0x" << std::hex << addr << "\n";
+        logger.LogMsg(oss.str());
+        return false;
+    }
+    return true;
+}
+
+void test_ctxt_regions()
+{
+    TrcMemAccBufPtr AccGlobal, AccProc1, AccProc2, AccProc2Dup, AccVMProc1;
+    ocsd_mem_acc_ctxt_t mem_ctxt;
+    ocsd_pe_context pe_ctxt;
+    ocsd_err_t err;
+    std::ostringstream oss;
+    int passed = 0, failed = 0;
+
+    log_test_start(__FUNCTION__);
+
+    // no context - visible in all contexts.
+    AccGlobal.initAccessor(0x0000, (const uint8_t*)&el01_s_blocks[0], 0x1000);
+    AccGlobal.setMemSpace(OCSD_MEM_SPACE_EL1N);
+
+    // same VA, context IDs 0x10 and 0x20.
+    mem_ctxt.context_id = 0x10;
+    mem_ctxt.ctxt_id_valid = 1;
+    mem_ctxt.vmid = 0;
+    mem_ctxt.vmid_valid = 0;
+    AccProc1.initAccessor(TEST_ADDR_CTXT, (const uint8_t*)&el01_ns_blocks[0], BLOCK_SIZE_BYTES);
+    AccProc1.setMemSpace(OCSD_MEM_SPACE_EL1N);
+    AccProc1.setMemContext(mem_ctxt);
+
+    mem_ctxt.context_id = 0x20;
+    AccProc2.initAccessor(TEST_ADDR_CTXT, (const uint8_t*)&el01_ns_blocks[1], BLOCK_SIZE_BYTES);
+    AccProc2.setMemSpace(OCSD_MEM_SPACE_EL1N);
+    AccProc2.setMemContext(mem_ctxt);
+    AccProc2Dup.initAccessor(TEST_ADDR_CTXT + 0x1000, (const uint8_t*)&el01_ns_blocks[1], 0x1000);
+    AccProc2Dup.setMemSpace(OCSD_MEM_SPACE_EL1N);
+    AccProc2Dup.setMemContext(mem_ctxt);
+
+    // context ID 0x10 in VMID 1.
+    mem_ctxt.context_id = 0x10;
+    mem_ctxt.vmid = 0x1;
+    mem_ctxt.vmid_valid = 1;
+    AccVMProc1.initAccessor(TEST_ADDR_CTXT, (const uint8_t*)&el2_ns_blocks[0], BLOCK_SIZE_BYTES);
+    AccVMProc1.setMemSpace(OCSD_MEM_SPACE_EL1N);
+    AccVMProc1.setMemContext(mem_ctxt);
+
+    if (((err = p_mapper->AddAccessor(&AccGlobal, 0)) != OCSD_OK) ||
+        ((err = p_mapper->AddAccessor(&AccProc1, 0)) != OCSD_OK) ||
+        ((err = p_mapper->AddAccessor(&AccProc2, 0)) != OCSD_OK) ||
+        ((err = p_mapper->AddAccessor(&AccVMProc1, 0)) != OCSD_OK)) {
+        log_error(ocsdError(OCSD_ERR_SEV_ERROR, err, "Failed to set memory accessors with context"));
+        failed++;
+        goto cleanup;
+    }
+    passed++;
+
+    // overlap in the same context
+    if (p_mapper->AddAccessor(&AccProc2Dup, 0) != OCSD_ERR_MEM_ACC_OVERLAP) {
+        oss << "Error: expected OCSD_ERR_MEM_ACC_OVERLAP error for accessor overlapping range in same context.\n";
+        logger.LogMsg(oss.str());
+        failed++;
+    }
+    else
+        passed++;
+
+    // switch between contexts at the same address - including back to a previous context.
+    pe_ctxt.security_level = ocsd_sec_nonsecure;
+    pe_ctxt.exception_level = ocsd_EL1;
+    pe_ctxt.bits64 = 1;
+    pe_ctxt.el_valid = 1;
+    pe_ctxt.context_id = 0x10;
+    pe_ctxt.ctxt_id_valid = 1;
+    pe_ctxt.vmid = 0;
+    pe_ctxt.vmid_valid = 0;
+    if (read_and_check_value(TEST_ADDR_CTXT, (const uint8_t*)&el01_ns_blocks[0][0], OCSD_MEM_SPACE_EL1N, &pe_ctxt) &&
+        read_and_check_value(0x0000, (const uint8_t*)&el01_s_blocks[0][0], OCSD_MEM_SPACE_EL1N, &pe_ctxt))
+        passed++;
+    else
+        failed++;
+
+    pe_ctxt.context_id = 0x20;
+    if (read_and_check_value(TEST_ADDR_CTXT + 0x10, (const uint8_t*)&el01_ns_blocks[1][4], OCSD_MEM_SPACE_EL1N, &pe_ctxt) &&
+        read_and_check_value(0x0010, (const uint8_t*)&el01_s_blocks[0][4], OCSD_MEM_SPACE_EL1N, &pe_ctxt))
+        passed++;
+    else
+        failed++;
+
+    pe_ctxt.context_id = 0x10;
+    p_mapper->InvalidateMemAccCache(0);
+    if (read_and_check_value(TEST_ADDR_CTXT + 0x10, (const uint8_t*)&el01_ns_blocks[0][4], OCSD_MEM_SPACE_EL1N, &pe_ctxt))
+        passed++;
+    else
+        failed++;
+
+    // context ID + VMID more specific than context ID alone.
+    pe_ctxt.vmid = 0x1;
+    pe_ctxt.vmid_valid = 1;
+    if (read_and_check_value(TEST_ADDR_CTXT + 0x10, (const uint8_t*)&el2_ns_blocks[0][4], OCSD_MEM_SPACE_EL1N, &pe_ctxt))
+        passed++;
+    else
+        failed++;
+
+    // context ID 0x20 in VMID 1 - falls back to context ID only accessor.
+    pe_ctxt.context_id = 0x20;
+    if (read_and_check_value(TEST_ADDR_CTXT + 0x10, (const uint8_t*)&el01_ns_blocks[1][4], OCSD_MEM_SPACE_EL1N, &pe_ctxt))
+        passed++;
+    else
+        failed++;
+
+    // unmapped context and no context - global accessor only.
+    pe_ctxt.context_id = 0x30;
+    pe_ctxt.vmid_valid = 0;
+    if (read_check_no_data(TEST_ADDR_CTXT, OCSD_MEM_SPACE_EL1N, &pe_ctxt) &&
+        read_and_check_value(0x0000, (const uint8_t*)&el01_s_blocks[0][0], OCSD_MEM_SPACE_EL1N, &pe_ctxt) &&
+        read_check_no_data(TEST_ADDR_CTXT, OCSD_MEM_SPACE_EL1N, 0) &&
+        read_and_check_value(0x0000, (const uint8_t*)&el01_s_blocks[0][0], OCSD_MEM_SPACE_EL1N))
+        passed++;
+    else
+        failed++;
+
+    // remove a context accessor - others at the same address remain.
+    pe_ctxt.context_id = 0x10;
+    if ((p_mapper->RemoveAccessor(&AccProc1) == OCSD_OK) &&
+        read_check_no_data(TEST_ADDR_CTXT, OCSD_MEM_SPACE_EL1N, &pe_ctxt))
+    {
+        pe_ctxt.context_id = 0x20;
+        if (read_and_check_value(TEST_ADDR_CTXT, (const uint8_t*)&el01_ns_blocks[1][0], OCSD_MEM_SPACE_EL1N, &pe_ctxt))
+            passed++;
+        else
+            failed++;
+    }
+    else
+        failed++;
+
+cleanup:
+    p_mapper->RemoveAllAccessors();
+    tests_passed += passed;
+    tests_failed += failed;
+
+    log_test_end(__FUNCTION__, passed, failed);
+}
+
+// same image file mapped at different addresses in two processes.
+void test_ctxt_file_regions()
+{
+    TrcMemAccessorFile *pAccProc1 = 0, *pAccProc2 = 0, *pAccProc1Dup = 0;
+    ocsd_mem_acc_ctxt_t mem_ctxt1, mem_ctxt2;
+    ocsd_pe_context pe_ctxt;
+    ocsd_err_t err;
+    std::ostringstream oss;
+    int passed = 0, failed = 0;
+    const std::string filename = "mem_acc_test_ctxt.bin";
+    const ocsd_vaddr_t proc2_addr = TEST_ADDR_CTXT + 0x40000;
+
+    log_test_start(__FUNCTION__);
+
+    std::ofstream bin_file(filename.c_str(), std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+    bin_file.write((const char *)&el01_ns_blocks[0], BLOCK_SIZE_BYTES);
+    bin_file.close();
+
+    mem_ctxt1.context_id = 0x10;
+    mem_ctxt1.ctxt_id_valid = 1;
+    mem_ctxt1.vmid = 0;
+    mem_ctxt1.vmid_valid = 0;
+    mem_ctxt2 = mem_ctxt1;
+    mem_ctxt2.context_id = 0x20;
+
+    // one accessor per context - different start addresses are not a range clash.
+    if (((err = TrcMemAccessorFile::createFileAccessor(&pAccProc1, filename, TEST_ADDR_CTXT, 0, 0, false, &mem_ctxt1)) != OCSD_OK) ||
+        ((err = TrcMemAccessorFile::createFileAccessor(&pAccProc2, filename, proc2_addr, 0, 0, false, &mem_ctxt2)) != OCSD_OK)) {
+        log_error(ocsdError(OCSD_ERR_SEV_ERROR, err, "Failed to create file accessors in two contexts"));
+        failed++;
+        goto cleanup;
+    }
+    if ((pAccProc1 != pAccProc2) &&
+        TrcMemAccessorFile::isExistingFileAccessor(filename, &mem_ctxt1) &&
+        TrcMemAccessorFile::isExistingFileAccessor(filename, &mem_ctxt2) &&
+        !TrcMemAccessorFile::isExistingFileAccessor(filename))
+        passed++;
+    else {
+        logger.LogMsg("Error: expected separate file accessors for each context.\n");
+        failed++;
+    }
+
+    // same file and context shares the accessor.
+    if ((TrcMemAccessorFile::createFileAccessor(&pAccProc1Dup, filename, TEST_ADDR_CTXT, 0, 0, false, &mem_ctxt1) == OCSD_OK) &&
+        (pAccProc1Dup == pAccProc1))
+        passed++;
+    else {
+        logger.LogMsg("Error: expected shared file accessor in the same context.\n");
+        failed++;
+    }
+
+    pAccProc1->setMemSpace(OCSD_MEM_SPACE_EL1N);
+    pAccProc2->setMemSpace(OCSD_MEM_SPACE_EL1N);
+    if (((err = p_mapper->AddAccessor(pAccProc1, 0)) != OCSD_OK) ||
+        ((err = p_mapper->AddAccessor(pAccProc2, 0)) != OCSD_OK)) {
+        log_error(ocsdError(OCSD_ERR_SEV_ERROR, err, "Failed to add file accessors with context"));
+        failed++;
+        goto cleanup;
+    }
+    passed++;
+
+    // each context sees the image at its own address only - invalidate between switches.
+    pe_ctxt.security_level = ocsd_sec_nonsecure;
+    pe_ctxt.exception_level = ocsd_EL1;
+    pe_ctxt.bits64 = 1;
+    pe_ctxt.el_valid = 1;
+    pe_ctxt.context_id = 0x10;
+    pe_ctxt.ctxt_id_valid = 1;
+    pe_ctxt.vmid = 0;
+    pe_ctxt.vmid_valid = 0;
+    if (read_and_check_value(TEST_ADDR_CTXT + 0x10, (const uint8_t*)&el01_ns_blocks[0][4], OCSD_MEM_SPACE_EL1N, &pe_ctxt) &&
+        read_check_no_data(proc2_addr + 0x10, OCSD_MEM_SPACE_EL1N, &pe_ctxt))
+    {
+        p_mapper->InvalidateMemAccCache(0);
+        pe_ctxt.context_id = 0x20;
+        if (read_and_check_value(proc2_addr + 0x10, (const uint8_t*)&el01_ns_blocks[0][4], OCSD_MEM_SPACE_EL1N, &pe_ctxt) &&
+            read_check_no_data(TEST_ADDR_CTXT + 0x10, OCSD_MEM_SPACE_EL1N, &pe_ctxt))
+            passed++;
+        else
+            failed++;
+    }
+    else
+        failed++;
+
+cleanup:
+    p_mapper->RemoveAllAccessors();
+    TrcMemAccessorFile::destroyFileAccessor(pAccProc1Dup);
+    TrcMemAccessorFile::destroyFileAccessor(pAccProc1);
+    TrcMemAccessorFile::destroyFileAccessor(pAccProc2);
+    if (TrcMemAccessorFile::isExistingFileAccessor(filename, &mem_ctxt1) ||
+        TrcMemAccessorFile::isExistingFileAccessor(filename, &mem_ctxt2)) {
+        logger.LogMsg("Error: file accessor not released.\n");
+        failed++;
+    }
+    std::remove(filename.c_str());
+    tests_passed += passed;
+    tests_failed += failed;
+
+    log_test_end(__FUNCTION__, passed, failed);
+}
+
 int main(int argc, char* argv[])
 {
 	std::ostringstream oss;
@@ -752,17 +1346,57 @@ int main(int argc, char* argv[])
     // set up test data
     populate_all_blocks();
 
-    // init the mapper
-    mapper.setErrorLog(&err_log);
-    mapper.enableCaching(true);
+    // init the mappers
+    mapper_global.setErrorLog(&err_log);
+    mapper_global.enableCaching(true);
+    mapper_global_idx.setErrorLog(&err_log);
+    mapper_global_idx.enableCaching(true);
+    mapper_ctxt.setErrorLog(&err_log);
+    mapper_ctxt.enableCaching(true);
+
+    // call the test routines for each mapper
+    logger.LogMsg("*** Global space mapper.\n");
+    p_mapper = &mapper_global;
+    test_overlap_regions();
+
+    test_trcid_cache_mem_cb();
+
+    test_cache_lru();
+
+    test_read_ptr();
+
+    test_mem_spaces();
+
+    logger.LogMsg("*** Global space indexed mapper.\n");
+    p_mapper = &mapper_global_idx;
+    test_overlap_regions();
+
+    test_trcid_cache_mem_cb();
 
-    // call the test routines
+    test_mem_spaces();
+
+    test_contained_regions();
+
+    test_many_regions();
+
+    logger.LogMsg("*** Context aware mapper.\n");
+    p_mapper = &mapper_ctxt;
     test_overlap_regions();
 
     test_trcid_cache_mem_cb();
 
     test_mem_spaces();
 
+    test_contained_regions();
+
+    test_many_regions();
+
+    test_read_ptr();
+
+    test_ctxt_regions();
+
+    test_ctxt_file_regions();
+
        
     oss.str("");
     oss << "\n*** Memory access tests complete.***\nPassed: " << tests_passed << "; Failed: " << tests_failed << "\n";
@@ -85,6 +85,24 @@ static uint32_t add_create_flags = 0;
 static bool macc_cache_disable = false;
 static uint32_t macc_cache_page_size = 0;
 static uint32_t macc_cache_page_num = 0;
+static bool instr_blk_cache = false;
+static uint32_t instr_blk_cache_entries = 0;
+static bool macc_file_mmap = false;
+static uint32_t gen_elem_batch_size = 0;
+static bool threaded_decode = false;
+static uint32_t chunk_size = 0;
+static bool dfmt_id_runs = false;
+static std::string sync_index_file = "";
+static std::string load_sync_index_file = "";
+static bool seek_index = false;
+static bool seek_ts = false;
+static uint64_t seek_target = 0;
+static uint32_t ring_buf_size = 0;
+static bool ring_buf_lossy = false;
+static bool ring_buf_lap_dcd = false;
+static uint32_t elem_out_mask = OCSD_GEN_TRC_ELEM_MASK_ALL;
+static std::string afdo_profile_file = "";
+static ocsd_mem_acc_ctxt_t afdo_ctxt_filter = { 0, 0, 0, 0 };
 
 static SnapShotReader ss_reader;
 
@@ -207,6 +225,13 @@ void print_help()
     oss << "-o_raw_packed       Output raw packed trace frames\n";
     oss << "-o_raw_unpacked     Output raw unpacked trace data per ID\n";
     oss << "-src_addr_n         ETE protocol: Split source address ranges on N atoms\n";
+    oss << "-etm3_ranges        ETMv3 protocol: Output a single range for consecutive atoms to a waypoint\n";
+    oss << "-strobed            ETMv4 / ETE protocol: Strobed trace - keep memory access caching over trace windows with a repeated context.\n";
+    oss << "-elem_out_mask <mask> Output only the element types set in <mask> - bit N for ocsd_gen_trc_elem_t value N.\n";
+    oss << "-afdo_profile <file> Aggregate the decode into AutoFDO range and branch counts, saved to <file> in the text profile format.\n";
+    oss << "                    Replaces the decoded element output. Implies -decode_only.\n";
+    oss << "-afdo_ctxt_id <id>  Count only the trace executed with context ID <id> in the AutoFDO profile.\n";
+    oss << "-afdo_vmid <id>     Count only the trace executed with VMID <id> in the AutoFDO profile.\n";
     oss << "-stats              Output packet processing statistics (if available).\n";
     oss << "-no_time_print      Do not output the elapsed time for tests.\n";
     oss << "\nConsistency checks\n\n";
@@ -221,6 +246,20 @@ void print_help()
     oss << "-macc_cache_disable Switch off caching on memory accessor\n";
     oss << "-macc_cache_p_size  Set size of caching pages\n";
     oss << "-macc_cache_p_num   Set number of caching pages\n";
+    oss << "-macc_file_mmap     Use memory mapped files for memory image file accessors\n";
+    oss << "-instr_blk_cache    Switch on caching of decoded instruction blocks\n";
+    oss << "-instr_blk_cache_n <N> Set number of instruction block cache entries (implies -instr_blk_cache)\n";
+    oss << "-gen_elem_batch <N> Output decoded elements to the printer in batches of up to N elements\n";
+    oss << "-threaded           Decode each trace ID on a separate thread. Output for different IDs is interleaved.\n";
+    oss << "-chunked <size>     Decode ETMv4 / ETE trace IDs in parallel, split into chunks of at least <size> bytes at sync points.\n";
+    oss << "-dfmt_id_runs       Deformatter collates ID data across memory aligned frames. Packet indexes are approximate - no sync index or seek.\n";
+    oss << "-sync_index <file>  Index the sync points for each trace ID, list them and save to <file>. Replaces -pkt_mon printers.\n";
+    oss << "-load_sync_index <file> Load a sync index saved by -sync_index, for use by -seek / -seek_ts.\n";
+    oss << "-seek <index>       Decode from the sync point before <index> in the trace buffer.\n";
+    oss << "-seek_ts <ts>       Decode from the sync point before timestamp <ts>. Requires a sync index.\n";
+    oss << "-ring_buf <size>    Input trace through a ring buffer of <size> bytes, written in blocks as a live producer.\n";
+    oss << "-ring_buf_lossy     Ring buffer producer overwrites unread data on every 8th block (implies -ring_buf 4096 if not set).\n";
+    oss << "-ring_buf_lap_dcd   Ring buffer producer overwrites the block being decoded every 256 elements (implies -ring_buf 4096 if not set).\n";
     oss << "\nOutput:\n";
     oss << "   Setting any of these options cancels the default output to file & stdout,\n   using _only_ the options supplied.\n\n";
     oss << "-logstdout          Output to stdout -> console.\n";
@@ -429,6 +468,52 @@ bool process_cmd_line_opts(int argc, char* argv[])
             {
                 add_create_flags |= ETE_OPFLG_PKTDEC_SRCADDR_N_ATOMS;
             }
+            else if (strcmp(argv[optIdx], "-etm3_ranges") == 0)
+            {
+                add_create_flags |= ETMV3_OPFLG_PKTDEC_COALESCE_RANGES;
+            }
+            else if (strcmp(argv[optIdx], "-strobed") == 0)
+            {
+                add_create_flags |= ETM4_OPFLG_PKTDEC_STROBED_TRACE;
+            }
+            else if (strcmp(argv[optIdx], "-elem_out_mask") == 0)
+            {
+                options_to_process--;
+                optIdx++;
+                if (options_to_process)
+                    elem_out_mask = (uint32_t)strtoul(argv[optIdx], 0, 0);
+            }
+            else if (strcmp(argv[optIdx], "-afdo_profile") == 0)
+            {
+                options_to_process--;
+                optIdx++;
+                if (options_to_process)
+                {
+                    afdo_profile_file = argv[optIdx];
+                    no_undecoded_packets = true;
+                    decode = true;
+                }
+            }
+            else if (strcmp(argv[optIdx], "-afdo_ctxt_id") == 0)
+            {
+                options_to_process--;
+                optIdx++;
+                if (options_to_process)
+                {
+                    afdo_ctxt_filter.context_id = (uint32_t)strtoul(argv[optIdx], 0, 0);
+                    afdo_ctxt_filter.ctxt_id_valid = 1;
+                }
+            }
+            else if (strcmp(argv[optIdx], "-afdo_vmid") == 0)
+            {
+                options_to_process--;
+                optIdx++;
+                if (options_to_process)
+                {
+                    afdo_ctxt_filter.vmid = (uint32_t)strtoul(argv[optIdx], 0, 0);
+                    afdo_ctxt_filter.vmid_valid = 1;
+                }
+            }
             else if (strcmp(argv[optIdx], "-stats") == 0)
             {
                 stats = true;
@@ -509,6 +594,113 @@ bool process_cmd_line_opts(int argc, char* argv[])
                 if (options_to_process)
                     macc_cache_page_num = (uint32_t)strtoul(argv[optIdx], 0, 0);
             }
+            else if (strcmp(argv[optIdx], "-macc_file_mmap") == 0)
+            {
+                macc_file_mmap = true;
+            }
+            else if (strcmp(argv[optIdx], "-instr_blk_cache") == 0)
+            {
+                instr_blk_cache = true;
+            }
+            else if (strcmp(argv[optIdx], "-instr_blk_cache_n") == 0)
+            {
+                options_to_process--;
+                optIdx++;
+                if (options_to_process)
+                {
+                    instr_blk_cache = true;
+                    instr_blk_cache_entries = (uint32_t)strtoul(argv[optIdx], 0, 0);
+                }
+            }
+            else if (strcmp(argv[optIdx], "-gen_elem_batch") == 0)
+            {
+                options_to_process--;
+                optIdx++;
+                if (options_to_process)
+                    gen_elem_batch_size = (uint32_t)strtoul(argv[optIdx], 0, 0);
+            }
+            else if (strcmp(argv[optIdx], "-threaded") == 0)
+            {
+                threaded_decode = true;
+            }
+            else if (strcmp(argv[optIdx], "-chunked") == 0)
+            {
+                options_to_process--;
+                optIdx++;
+                if (options_to_process)
+                    chunk_size = (uint32_t)strtoul(argv[optIdx], 0, 0);
+                else
+                {
+                    logger.LogMsg("Trace Packet Lister : Error: Missing chunk size.\n");
+                    bOptsOK = false;
+                }
+            }
+            else if (strcmp(argv[optIdx], "-dfmt_id_runs") == 0)
+            {
+                dfmt_id_runs = true;
+            }
+            else if (strcmp(argv[optIdx], "-sync_index") == 0)
+            {
+                options_to_process--;
+                optIdx++;
+                if (options_to_process)
+                    sync_index_file = argv[optIdx];
+                else
+                {
+                    logger.LogMsg("Trace Packet Lister : Error: Missing sync index file name.\n");
+                    bOptsOK = false;
+                }
+            }
+            else if (strcmp(argv[optIdx], "-load_sync_index") == 0)
+            {
+                options_to_process--;
+                optIdx++;
+                if (options_to_process)
+                    load_sync_index_file = argv[optIdx];
+                else
+                {
+                    logger.LogMsg("Trace Packet Lister : Error: Missing sync index file name.\n");
+                    bOptsOK = false;
+                }
+            }
+            else if (strcmp(argv[optIdx], "-ring_buf") == 0)
+            {
+                options_to_process--;
+                optIdx++;
+                if (options_to_process)
+                    ring_buf_size = (uint32_t)strtoul(argv[optIdx], 0, 0);
+                else
+                {
+                    logger.LogMsg("Trace Packet Lister : Error: Missing ring buffer size.\n");
+                    bOptsOK = false;
+                }
+            }
+            else if (strcmp(argv[optIdx], "-ring_buf_lossy") == 0)
+            {
+                ring_buf_lossy = true;
+                if (!ring_buf_size)
+                    ring_buf_size = 4096;
+            }
+            else if (strcmp(argv[optIdx], "-ring_buf_lap_dcd") == 0)
+            {
+                ring_buf_lap_dcd = true;
+                if (!ring_buf_size)
+                    ring_buf_size = 4096;
+            }
+            else if ((strcmp(argv[optIdx], "-seek") == 0) || (strcmp(argv[optIdx], "-seek_ts") == 0))
+            {
+                seek_ts = (strcmp(argv[optIdx], "-seek_ts") == 0);
+                seek_index = !seek_ts;
+                options_to_process--;
+                optIdx++;
+                if (options_to_process)
+                    seek_target = strtoull(argv[optIdx], 0, 0);
+                else
+                {
+                    logger.LogMsg("Trace Packet Lister : Error: Missing seek value.\n");
+                    bOptsOK = false;
+                }
+            }
             else
             {
                 std::ostringstream errstr;
@@ -610,6 +802,8 @@ void ConfigureFrameDeMux(DecodeTree *dcd_tree, RawFramePrinter **framePrinter)
         {
             configFlags = OCSD_DFRMTR_FRAME_MEM_ALIGN;
         }
+        if (dfmt_id_runs && (configFlags & OCSD_DFRMTR_FRAME_MEM_ALIGN))
+            configFlags |= OCSD_DFRMTR_ID_RUNS;
         pDeformatter->Configure(configFlags);
 
         if (outRawPacked || outRawUnpacked)
@@ -621,6 +815,105 @@ void ConfigureFrameDeMux(DecodeTree *dcd_tree, RawFramePrinter **framePrinter)
     }
 }
 
+void PrintSyncIndex(DecodeTree *dcd_tree)
+{
+    std::ostringstream oss;
+    TrcSyncIndexer *pIndexer = dcd_tree->getSyncIndexer();
+    static const char *type_names[] = { "ASYNC", "TINFO", "ISYNC" };
+
+    if (!pIndexer)
+        return;
+
+    const std::vector<ocsd_sync_idx_entry_t> &entries = pIndexer->getEntries();
+    oss << "\nTrace sync index : " << std::dec << entries.size() << " sync points.\n";
+    for (size_t i = 0; i < entries.size(); i++)
+    {
+        oss << "Idx:" << std::dec << entries[i].pkt_index << "; ID:0x" << std::hex << (uint32_t)entries[i].trc_id;
+        oss << "; " << ((entries[i].type <= OCSD_SYNC_IDX_ISYNC) ? type_names[entries[i].type] : "UNKNOWN");
+        oss << "; Restart:" << std::dec << entries[i].restart_index;
+        if (entries[i].flags & OCSD_SYNC_IDX_FLG_TS_VALID)
+            oss << "; TS:0x" << std::hex << entries[i].timestamp;
+        oss << "\n";
+    }
+
+    if (pIndexer->saveIndex(sync_index_file) == OCSD_OK)
+        oss << "Trace Packet Lister : Saved sync index to " << sync_index_file << "\n\n";
+    else
+        oss << "Trace Packet Lister : Error: Failed to save sync index to " << sync_index_file << "\n\n";
+    logger.LogMsg(oss.str());
+}
+
+void PrintAutoFdoProfile(DecodeTree *dcd_tree)
+{
+    std::ostringstream oss;
+    TrcAfdoSink *pSink = dcd_tree->getAutoFdoSink();
+
+    if (!pSink)
+        return;
+
+    if (dcd_tree->saveAutoFdoProfile(afdo_profile_file) == OCSD_OK)
+    {
+        const TrcAfdoCountTable &ranges = pSink->getRangeCounts();
+        const TrcAfdoCountTable &branches = pSink->getBranchCounts();
+
+        oss << "\nAutoFDO profile : " << std::dec << ranges.numEntries() << " ranges, executed " << ranges.totalCount() << " times; ";
+        oss << branches.numEntries() << " branches, taken " << branches.totalCount() << " times.\n";
+        oss << "Trace Packet Lister : Saved AutoFDO profile to " << afdo_profile_file << "\n\n";
+    }
+    else
+        oss << "Trace Packet Lister : Error: Failed to save AutoFDO profile to " << afdo_profile_file << "\n\n";
+    logger.LogMsg(oss.str());
+}
+
+void SetChunkedDecode(DecodeTree *dcd_tree)
+{
+    uint8_t elemID;
+    std::vector<uint8_t> ids;
+    std::ostringstream oss;
+    ocsd_err_t err;
+
+    // collect the IDs first - setting chunked decode iterates the tree elements.
+    DecodeTreeElement *pElement = dcd_tree->getFirstElement(elemID);
+    while (pElement)
+    {
+        if (!element_filtered(elemID))
+            ids.push_back(elemID);
+        pElement = dcd_tree->getNextElement(elemID);
+    }
+
+    for (size_t i = 0; i < ids.size(); i++)
+    {
+        // only ETMv4 / ETE streams can be chunked - other protocols decode as normal.
+        err = dcd_tree->setChunkedDecode(ids[i], true, 0, chunk_size);
+        if (err == OCSD_ERR_INVALID_PARAM_TYPE)
+            continue;
+        oss.str("");
+        if (err == OCSD_OK)
+            oss << "Trace Packet Lister : Chunked decode on Trace ID 0x" << std::hex << (uint32_t)ids[i] << "\n";
+        else
+            oss << "Trace Packet Lister : Error: Failed to set chunked decode on Trace ID 0x" << std::hex << (uint32_t)ids[i] << "\n";
+        logger.LogMsg(oss.str());
+    }
+}
+
+void PrintChunkedDecode(DecodeTree *dcd_tree)
+{
+    std::ostringstream oss;
+    DecodeIDChunker *pChunker;
+
+    for (uint8_t id = 0; id < 0x80; id++)
+    {
+        pChunker = dcd_tree->getIDChunker(id);
+        if (pChunker && (pChunker->getCSID() == id))
+        {
+            oss.str("");
+            oss << "Trace Packet Lister : Chunked decode on Trace ID 0x" << std::hex << (uint32_t)id;
+            oss << " : " << std::dec << pChunker->getNumChunks() << " chunks decoded.\n";
+            logger.LogMsg(oss.str());
+        }
+    }
+}
+
 void PrintDecodeStats(DecodeTree *dcd_tree)
 {
     uint8_t elemID;
@@ -675,6 +968,144 @@ void PrintDecodeStats(DecodeTree *dcd_tree)
     }
 }
 
+/* live producer writing the input file into the ring buffer */
+class RingBufProducer
+{
+public:
+    RingBufProducer(std::ifstream &in, const uint32_t size) : 
+        m_in(in), m_buffer(size), m_size(size), head(0), tail(0) {};
+
+    void write(uint64_t write_len)
+    {
+        while (write_len && !m_in.eof())
+        {
+            uint64_t offset = head % m_size;
+            uint64_t len = std::min(write_len, m_size - offset);
+
+            m_in.read((char *)m_buffer.data() + offset, len);
+            head = head + m_in.gcount();
+            write_len -= m_in.gcount();
+        }
+    }
+
+    uint8_t *buffer() { return m_buffer.data(); };
+
+private:
+    std::ifstream &m_in;
+    std::vector<uint8_t> m_buffer;
+    uint64_t m_size;
+
+public:
+    volatile uint64_t head;
+    volatile uint64_t tail;
+};
+
+/* pass elements on to the generic element printer - the producer laps the block being decoded every 256 elements */
+class RingBufLapElemOut : public ITrcGenElemIn
+{
+public:
+    RingBufLapElemOut() : m_pPrinter(0), m_pProducer(0), m_size(0), m_num_elem(0), m_num_laps(0) {};
+    virtual ~RingBufLapElemOut() {};
+
+    void setOutput(TrcGenericElementPrinter *pPrinter, RingBufProducer *pProducer, const uint32_t size)
+    {
+        m_pPrinter = pPrinter;
+        m_pProducer = pProducer;
+        m_size = size;
+    };
+    const uint32_t getNumLaps() const { return m_num_laps; };
+
+    virtual ocsd_datapath_resp_t TraceElemIn(const ocsd_trc_index_t index_sop,
+                                             const uint8_t trc_chan_id,
+                                             const OcsdTraceElement &elem)
+    {
+        // overwrite the start of the block in the decoder - the tail is the start of the block.
+        if (m_pProducer && ((++m_num_elem % 256) == 0))
+        {
+            uint64_t lap_head = m_pProducer->tail + m_size + 16;
+            if (lap_head > m_pProducer->head)
+            {
+                m_pProducer->write(lap_head - m_pProducer->head);
+                if (m_pProducer->head == lap_head)
+                    m_num_laps++;
+            }
+        }
+        return m_pPrinter->TraceElemIn(index_sop, trc_chan_id, elem);
+    }
+
+private:
+    TrcGenericElementPrinter *m_pPrinter;
+    RingBufProducer *m_pProducer;
+    uint64_t m_size;
+    uint32_t m_num_elem;
+    uint32_t m_num_laps;
+};
+
+/* pass the input file through the decode tree ring buffer input - file written into the buffer in blocks as a live producer */
+ocsd_datapath_resp_t ProcessRingBuffer(DecodeTree *dcd_tree, std::ifstream &in, uint32_t &trace_index, TrcGenericElementPrinter* genElemPrinter)
+{
+    RingBufProducer producer(in, ring_buf_size);
+    RingBufLapElemOut lapElemOut;
+    const uint64_t write_size = (ring_buf_size * 3 / 8) + 4;  // writes start at varying offsets and wrap at the buffer end.
+    uint32_t num_writes = 0;
+    ocsd_datapath_resp_t dataPathResp;
+    ocsd_err_t err;
+    std::ostringstream oss;
+
+    err = dcd_tree->setRingBufferInput(producer.buffer(), ring_buf_size, &producer.head, &producer.tail);
+    if (err != OCSD_OK)
+    {
+        oss << "Trace Packet Lister : Error: Ring buffer input - " << ocsdError::getErrorString(ocsdError(OCSD_ERR_SEV_ERROR, err)) << "\n";
+        logger.LogMsg(oss.str());
+        return OCSD_RESP_FATAL_INVALID_PARAM;
+    }
+
+    // producer writes from the element output while the decoder is using the buffer.
+    if (ring_buf_lap_dcd && genElemPrinter)
+    {
+        lapElemOut.setOutput(genElemPrinter, &producer, ring_buf_size);
+        dcd_tree->setGenTraceElemOutI(&lapElemOut);
+    }
+
+    dataPathResp = OCSD_RESP_CONT;
+    while (!in.eof() && !OCSD_DATA_RESP_IS_FATAL(dataPathResp))
+    {
+        // producer - write into the free space, or lap the consumer when testing lost data.
+        uint64_t write_len = ring_buf_size - (producer.head - producer.tail);
+        if (ring_buf_lossy && ((++num_writes % 8) == 0))
+            write_len = ring_buf_size + write_size;
+        else if (write_len > write_size)
+            write_len = write_size;
+        producer.write(write_len);
+
+        // consumer - decode all data written.
+        dataPathResp = dcd_tree->processRingBuffer();
+        while (OCSD_DATA_RESP_IS_WAIT(dataPathResp))
+        {
+            if (genElemPrinter->needAckWait())
+                genElemPrinter->ackWait();
+            dataPathResp = dcd_tree->processRingBuffer();
+        }
+    }
+
+    TrcRingBufferIn *pRingBuf = dcd_tree->getRingBufferIn();
+    trace_index = (uint32_t)pRingBuf->getReadPos();
+    if (ring_buf_lossy || ring_buf_lap_dcd)
+    {
+        oss << "Trace Packet Lister : Ring buffer lost " << pRingBuf->getBytesLost() << " bytes; ";
+        oss << pRingBuf->getNumDiscontinuities() << " discontinuities.\n";
+    }
+    if (ring_buf_lap_dcd && genElemPrinter)
+    {
+        oss << "Trace Packet Lister : Ring buffer block overwritten during decode " << lapElemOut.getNumLaps() << " times.\n";
+        if (pRingBuf->getNumDiscontinuities() < lapElemOut.getNumLaps())
+            oss << "Trace Packet Lister : Error: Ring buffer overwrite during decode not detected.\n";
+        dcd_tree->setGenTraceElemOutI(genElemPrinter);
+    }
+    logger.LogMsg(oss.str());
+    return dataPathResp;
+}
+
 bool ProcessInputFile(DecodeTree *dcd_tree, std::string &in_filename, 
                       TrcGenericElementPrinter* genElemPrinter, ocsdDefaultErrorLogger& err_logger)
 {
@@ -692,8 +1123,38 @@ bool ProcessInputFile(DecodeTree *dcd_tree, std::string &in_filename,
         uint8_t trace_buffer[bufferSize];   // temporary buffer to load blocks of data from the file
         uint32_t trace_index = 0;           // index into the overall trace buffer (file).
 
+        // seek - start input from the restart point given by the decode tree.
+        if ((seek_index || seek_ts) && !multi_session)
+        {
+            std::ostringstream oss;
+            ocsd_trc_index_t restart_index = 0;
+            ocsd_err_t err;
+
+            if (dstream_format)
+                err = OCSD_ERR_INVALID_PARAM_VAL;   // index is not the file offset
+            else if (seek_ts)
+                err = dcd_tree->seekToTimestamp(seek_target, restart_index);
+            else
+                err = dcd_tree->seekToIndex((ocsd_trc_index_t)seek_target, restart_index);
+
+            if (err == OCSD_OK)
+            {
+                oss << "Trace Packet Lister : Seek to " << (seek_ts ? "timestamp 0x" : "index 0x") << std::hex << seek_target;
+                oss << "; restart input at index " << std::dec << restart_index << "\n";
+                trace_index = (uint32_t)restart_index;
+                in.seekg(trace_index);
+            }
+            else
+                oss << "Trace Packet Lister : Error: Seek failed - " << ocsdError::getErrorString(ocsdError(OCSD_ERR_SEV_ERROR, err)) << "\n";
+            logger.LogMsg(oss.str());
+        }
+
         start = std::chrono::steady_clock::now();
 
+        // ring buffer input reads the whole file.
+        if (ring_buf_size && !dstream_format)
+            dataPathResp = ProcessRingBuffer(dcd_tree, in, trace_index, genElemPrinter);
+
         // process the file, a buffer load at a time
         while (!in.eof() && !OCSD_DATA_RESP_IS_FATAL(dataPathResp))
         {
@@ -763,6 +1224,14 @@ bool ProcessInputFile(DecodeTree *dcd_tree, std::string &in_filename,
             }
         }
 
+        // a wait on the final buffer may leave data in the decoder - flush it through
+        while (OCSD_DATA_RESP_IS_WAIT(dataPathResp))
+        {
+            if (genElemPrinter->needAckWait())
+                genElemPrinter->ackWait();
+            dataPathResp = dcd_tree->TraceDataIn(OCSD_OP_FLUSH, 0, 0, 0, 0);
+        }
+
         // fatal error - no futher processing
         if (OCSD_DATA_RESP_IS_FATAL(dataPathResp))
         {
@@ -811,12 +1280,43 @@ bool ProcessInputFile(DecodeTree *dcd_tree, std::string &in_filename,
     return bOK;
 }
 
+/* pass batched elements on to the generic element printer - tests batched output from the decode tree */
+class GenElemBatchPrinter : public ITrcGenElemBatchIn
+{
+public:
+    GenElemBatchPrinter() : m_pPrinter(0) {};
+    virtual ~GenElemBatchPrinter() {};
+
+    void setPrinter(TrcGenericElementPrinter *pPrinter) { m_pPrinter = pPrinter; };
+
+    virtual ocsd_datapath_resp_t TraceElemBatchIn(const ocsd_gen_elem_batch_entry_t *p_elems, const uint32_t num_elem)
+    {
+        ocsd_datapath_resp_t resp = OCSD_RESP_CONT, elem_resp;
+
+        for (uint32_t i = 0; i < num_elem; i++)
+        {
+            m_elem = &p_elems[i].elem;
+            elem_resp = m_pPrinter->TraceElemIn(p_elems[i].index_sop, p_elems[i].trc_chan_id, m_elem);
+            if (OCSD_DATA_RESP_IS_CONT(resp))
+                resp = elem_resp;
+        }
+        return resp;
+    }
+
+private:
+    TrcGenericElementPrinter *m_pPrinter;
+    OcsdTraceElement m_elem;
+};
+
+static GenElemBatchPrinter genElemBatchPrinter;
+
 void ListTracePackets(ocsdDefaultErrorLogger &err_logger, SnapShotReader &reader, const std::string &trace_buffer_name)
 {
     CreateDcdTreeFromSnapShot tree_creator;
     uint32_t createFlags = add_create_flags;
 
     tree_creator.initialise(&reader, &err_logger);
+    tree_creator.setMemAccFileMmap(macc_file_mmap);
 
     if(tree_creator.createDecodeTree(trace_buffer_name, (decode == false), createFlags))
     {
@@ -860,6 +1360,54 @@ void ListTracePackets(ocsdDefaultErrorLogger &err_logger, SnapShotReader &reader
                     dcd_tree->setMemAccCacheing(true, macc_cache_page_size, macc_cache_page_num);
                 }
             }
+            if (instr_blk_cache)
+            {
+                if (!instr_blk_cache_entries)
+                    instr_blk_cache_entries = INSTR_BLK_CACHE_DEFAULT_ENTRIES;
+                if (dcd_tree->setInstrBlockCacheing(true, (int)instr_blk_cache_entries) != OCSD_OK)
+                    logger.LogMsg("Trace Packet Lister : Error: Failed to set instruction block cache.\n");
+            }
+            if (elem_out_mask != OCSD_GEN_TRC_ELEM_MASK_ALL)
+                dcd_tree->setGenElemOutMask(elem_out_mask);
+            if (gen_elem_batch_size)
+            {
+                genElemBatchPrinter.setPrinter(genElemPrinter);
+                if (dcd_tree->setGenTraceElemBatchOutI(&genElemBatchPrinter, gen_elem_batch_size) != OCSD_OK)
+                    logger.LogMsg("Trace Packet Lister : Error: Failed to set batched element output.\n");
+            }
+        }
+
+        if (sync_index_file.length())
+        {
+            if (dcd_tree->setSyncIndexing(true) != OCSD_OK)
+                logger.LogMsg("Trace Packet Lister : Error: Failed to set sync indexing.\n");
+        }
+
+        if (load_sync_index_file.length())
+        {
+            if (dcd_tree->loadSyncIndex(load_sync_index_file) != OCSD_OK)
+                logger.LogMsg("Trace Packet Lister : Error: Failed to load sync index " + load_sync_index_file + ".\n");
+        }
+
+        // threaded decode applies to the IDs in frame formatted trace.
+        if (threaded_decode && dcd_tree->getFrameDeformatter())
+        {
+            if (dcd_tree->setThreadedDecode(true) != OCSD_OK)
+                logger.LogMsg("Trace Packet Lister : Error: Failed to set threaded decode.\n");
+        }
+
+        if (chunk_size && decode)
+            SetChunkedDecode(dcd_tree);
+
+        // profile counts replace the element printer - only the element types used need be built.
+        if (afdo_profile_file.length())
+        {
+            if (elem_out_mask == OCSD_GEN_TRC_ELEM_MASK_ALL)
+                dcd_tree->setGenElemOutMask(OCSD_GEN_TRC_ELEM_MASK_AFDO);
+            if (dcd_tree->setAutoFdoProfiling(true) != OCSD_OK)
+                logger.LogMsg("Trace Packet Lister : Error: Failed to set AutoFDO profiling.\n");
+            else if (dcd_tree->setAutoFdoContextFilter(&afdo_ctxt_filter) != OCSD_OK)
+                logger.LogMsg("Trace Packet Lister : Error: Failed to set AutoFDO context filter.\n");
         }
 
         if(decode)
@@ -921,6 +1469,15 @@ void ListTracePackets(ocsdDefaultErrorLogger &err_logger, SnapShotReader &reader
                 logger.LogMsg(oss.str());
         }
 
+        if (sync_index_file.length())
+            PrintSyncIndex(dcd_tree);
+
+        if (chunk_size && decode)
+            PrintChunkedDecode(dcd_tree);
+
+        if (afdo_profile_file.length())
+            PrintAutoFdoProfile(dcd_tree);
+
         // clean up
 
         // get rid of the decode tree.